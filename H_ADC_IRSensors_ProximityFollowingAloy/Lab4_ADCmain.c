@@ -72,18 +72,35 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/Tachometer.h"
 #include "../inc/PWM.h"
 #include "../inc/TA3InputCapture.h"
-
-#define TARGET_DISTANCE 150    // Desired following distance in mm
-#define TOO_CLOSE 100          // Minimum safe distance
-#define TOO_FAR 300            // Maximum tracking distance
-#define LOST_THRESHOLD 400     // Object is lost if farther than this
-
-#define BASE_SPEED 1000        // Base motor speed (adjust for your robot)
-#define SLOW_SPEED 800
-#define FAST_SPEED 1500
-#define TURN_SPEED 1000
-
-#define TOLERANCE 30           // Deadband - ignore small differences
+#include "../inc/EUSCIA0.h"
+#include "../inc/Param.h"
+
+// tuning, change live with tools/paramcli.py, e.g.
+//   python paramcli.py COM5 set BaseSpeed 1200
+int32_t TargetDistance;        // Desired following distance in mm
+int32_t TooClose;              // Minimum safe distance
+int32_t TooFar;                // Maximum tracking distance
+int32_t LostThreshold;         // Object is lost if farther than this
+
+int32_t BaseSpeed;             // Base motor speed (adjust for your robot)
+int32_t SlowSpeed;
+int32_t FastSpeed;
+
+int32_t Tolerance;             // Deadband - ignore small differences
+uint32_t FilterSize;           // LPF depth
+void NewFilterSize(void);
+Param_t Params[] = {
+// name              variable         type          min   max  default change
+  {"TargetDistance", &TargetDistance, PARAM_INT32,   50,  800,  150,   0},
+  {"TooClose",       &TooClose,       PARAM_INT32,   50,  800,  100,   0},
+  {"TooFar",         &TooFar,         PARAM_INT32,   50,  800,  300,   0},
+  {"LostThreshold",  &LostThreshold,  PARAM_INT32,   50,  800,  400,   0},
+  {"BaseSpeed",      &BaseSpeed,      PARAM_INT32,    0, 7000, 1000,   0},
+  {"SlowSpeed",      &SlowSpeed,      PARAM_INT32,    0, 7000,  800,   0},
+  {"FastSpeed",      &FastSpeed,      PARAM_INT32,    0, 7000, 1500,   0},
+  {"Tolerance",      &Tolerance,      PARAM_INT32,    0,  300,   30,   0},
+  {"FilterSize",     &FilterSize,     PARAM_UINT32,   2,  512,  256,   &NewFilterSize},
+};
 
 volatile uint32_t ADCvalue;
 volatile uint32_t ADCflag;
@@ -113,21 +130,29 @@ void SensorRead_ISR(void){  // runs at 2000 Hz
   P1OUT ^= 0x01;         // profile
 }
 
+void NewFilterSize(void){ // restart the filters at their present outputs
+  uint32_t sr = StartCritical();
+  LPF_Init(nr,FilterSize);
+  LPF_Init2(nc,FilterSize);
+  LPF_Init3(nl,FilterSize);
+  EndCritical(sr);
+}
+
 int main(void){
   uint32_t raw12, raw16, raw17;
-  int32_t n; uint32_t s;
+  int32_t n;
   Clock_Init48MHz();  //SMCLK=12Mhz
   ADCflag = 0;
-  s = 256; // replace with your choice
+  Param_Init(Params, PARAM_COUNT(Params)); // saved values, or defaults
   ADC0_InitSWTriggerCh17_12_16();   // initialize channels 17,12,16
   ADC_In17_12_16(&raw17,&raw12,&raw16);  // sample
-  LPF_Init(raw17,s);     // P9.0/channel 17
-  LPF_Init2(raw12,s);     // P4.1/channel 12
-  LPF_Init3(raw16,s);     // P9.1/channel 16
-  UART0_Init();          // initialize UART0 115,200 baud rate
+  LPF_Init(raw17,FilterSize);     // P9.0/channel 17
+  LPF_Init2(raw12,FilterSize);     // P4.1/channel 12
+  LPF_Init3(raw16,FilterSize);     // P9.1/channel 16
+  EUSCIA0_Init();        // initialize UART0 115,200 baud rate, interrupt driven for Param_Poll
   LaunchPad_Init();
   TimerA1_Init(&SensorRead_ISR,250);    // 2000 Hz sampling
-  UART0_OutString("GP2Y0A21YK0F test\nValvano Oct 2017\nConnect analog signals to P9.0,P4.1,P9.1\n");
+  EUSCIA0_OutString("GP2Y0A21YK0F test\nValvano Oct 2017\nConnect analog signals to P9.0,P4.1,P9.1\n");
   EnableInterrupts();
   Motor_Init();
   TimedPause(500);
@@ -135,26 +160,29 @@ int main(void){
   while(1){
 
     for(n=0; n<200; n++){
-      while(ADCflag == 0){};
+      while(ADCflag == 0){
+        Param_Poll();  // host reads and writes parameters while we wait
+      };
       ADCflag = 0; // show every 10th point
     }
+    Param_Apply();   // new values take effect here, between control steps
     left = LeftConvert(nl);
     center = CenterConvert(nc);
     right = RightConvert(nr);
 
-    if (center > LOST_THRESHOLD) {
+    if (center > LostThreshold) {
         // Object lost - stop and search
         Motor_Stop();
         // Optionally: rotate slowly to search
         // Motor_Right(1500, 1500);
     }
-    else if (center < TOO_CLOSE) {
+    else if (center < TooClose) {
         // Too close - back up slowly
-        Motor_Backward(SLOW_SPEED, SLOW_SPEED);
+        Motor_Backward(SlowSpeed, SlowSpeed);
     }
-    else if (center > TOO_FAR) {
+    else if (center > TooFar) {
         // Too far - move forward faster
-        Motor_Forward(FAST_SPEED, FAST_SPEED);
+        Motor_Forward(FastSpeed, FastSpeed);
     }
     else {
         // In the good range - adjust based on left/right
@@ -162,21 +190,21 @@ int main(void){
 
         int32_t left_right_diff = (int32_t)left - (int32_t)right;
 
-        if (left_right_diff < -TOLERANCE) {
+        if (left_right_diff < -Tolerance) {
             // Object is on the right - turn right while moving forward
-            Motor_Forward(BASE_SPEED, BASE_SPEED / 2);
+            Motor_Forward(BaseSpeed, BaseSpeed / 2);
         }
-        else if (left_right_diff > TOLERANCE) {
+        else if (left_right_diff > Tolerance) {
             // Object is on the left - turn left while moving forward
-            Motor_Forward(BASE_SPEED / 2, BASE_SPEED);
+            Motor_Forward(BaseSpeed / 2, BaseSpeed);
         }
         else {
             // Object is centered - move straight at target distance
-            if (center < TARGET_DISTANCE) {
-                Motor_Forward(SLOW_SPEED, SLOW_SPEED);  // Slow approach
+            if (center < TargetDistance) {
+                Motor_Forward(SlowSpeed, SlowSpeed);  // Slow approach
             }
             else {
-                Motor_Forward(BASE_SPEED, BASE_SPEED);  // Normal speed
+                Motor_Forward(BaseSpeed, BaseSpeed);  // Normal speed
             }
         }
     }
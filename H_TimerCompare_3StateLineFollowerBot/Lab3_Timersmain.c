@@ -15,6 +15,7 @@
 #include "..\inc\Bump.h"
 #include "..\inc\ADC14.h"
 #include "..\inc\IRDistance.h"
+#include "..\inc\FSM.h"
 
 // Global variables
 volatile uint8_t bumpState;
@@ -38,25 +39,18 @@ volatile uint8_t collision_bumpstate = 0;
 #define IR_THRESHOLD 100
 #define LINE_DETECT_THRESHOLD 1000  // Reflectance sensor time in us
 
-// FSM for line following
-struct State {
-    uint32_t out;                // 2-bit output
-    uint32_t delay;              // time to delay in 1ms
-    const struct State *next[4]; // Next if 2-bit input is 0-3
-};
-typedef const struct State State_t;
+// FSM for line following, see FSM.h
+// (name, out, delay in 1 ms ticks, next for input 0, 1, 2, 3)
+#define LINE_FSM(S) \
+    S(Center, 0x03, 10, Right, Left,   Right,  Center) /* both motors forward */ \
+    S(Left,   0x02, 10, Left,  Center, Right,  Center) /* left motor only (turn right) */ \
+    S(Right,  0x01, 10, Right, Left,   Center, Center) /* right motor only (turn left) */
+FSM_TABLE(LINE_FSM, fsm);
 
-#define Center    &fsm[0]
-#define Left      &fsm[1]
-#define Right     &fsm[2]
-
-State_t fsm[3]={
-    {0x03, 10, { Right, Left,   Right,  Center }},  // Center: both motors forward
-    {0x02, 10, { Left,  Center, Right,  Center }},  // Left: left motor only (turn right)
-    {0x01, 10, { Right, Left,   Center, Center }}   // Right: right motor only (turn left)
-};
-
-State_t *Spt = Center;  // pointer to the current state
+FSM_t LineFSM;          // current state and dwell timer
+volatile uint8_t LinePrimed = 0;  // 1 when Reflectance_Start() ran last tick
+volatile uint32_t LostPause = 0;  // ticks left of the stop after losing the line
+#define LOST_PAUSE 200            // 1 ms ticks, brief pause before wandering
 
 // Driver test
 void TimedPause(uint32_t time){
@@ -159,24 +153,36 @@ void WanderMode(uint32_t right_mm, uint32_t center_mm, uint32_t left_mm) {
 }
 
 // Line following behavior using reflectance sensors
-void LineFollowMode(void) {
+// Runs every 1 ms in the TimerA1 ISR. The center sensors are sampled
+// every tick and the FSM reacts on the tick the input changes.
+void LineFollowTask(void) {
     uint32_t input;
-    uint32_t output;
-
-    output = Spt->out;              // Set output from FSM
-    ControlMotors(output);          // Control motors
-    Clock_Delay1ms(Spt->delay);     // Wait
-    input = Reflectance_Center(LINE_DETECT_THRESHOLD);  // Read center sensors
-
-    // If line is lost (input == 0), return to wandering mode
-    if (input == 0) {
-        Motor_Stop();
-        Clock_Delay1ms(200);  // Brief pause
-        currentMode = MODE_WANDERING;
-        Spt = Center;  // Reset FSM
-    } else {
-        Spt = Spt->next[input];  // Next state depends on input
+
+    if (currentMode != MODE_LINE_FOLLOWING) {
+        LinePrimed = 0;             // foreground owns the sensor
+        return;
+    }
+    if (LostPause) {                // stopped, then back to wandering
+        LostPause--;
+        if (LostPause == 0) {
+            currentMode = MODE_WANDERING;
+        }
+        return;
+    }
+    if (LinePrimed) {
+        input = (Reflectance_End()&0x18)>>3;  // Read center sensors
+
+        // If line is lost (input == 0), return to wandering mode
+        if (input == 0) {
+            Motor_Stop();
+            LinePrimed = 0;
+            LostPause = LOST_PAUSE;  // brief pause, timed here instead of a delay
+            return;
+        }
+        ControlMotors(FSM_Tick(&LineFSM, input));  // Next state depends on input
     }
+    Reflectance_Start();            // charge for the next tick
+    LinePrimed = 1;
 }
 
 volatile int32_t right_mm, center_mm, left_mm;
@@ -190,6 +196,7 @@ int main(void){
     Reflectance_Init();  // Initialize reflectance sensors
     TExaS_Init(LOGICANALYZER_P2);
     bumpState = 0x3F;
+    TimerA1_Init(&LineFollowTask, 500);  // 1000 Hz line following FSM
     EnableInterrupts();
 
     // IR setup
@@ -228,8 +235,9 @@ int main(void){
                 Clock_Delay1ms(100);
                 // Verify it's really a line
                 if (CheckForLine()) {
+                    FSM_Init(&LineFSM, fsm, Center, 3);  // Reset FSM to center state
+                    ControlMotors(FSM_Output(&LineFSM));
                     currentMode = MODE_LINE_FOLLOWING;
-                    Spt = Center;  // Reset FSM to center state
                     LaunchPad_LED(1);  // Turn on LED to indicate line following
                     continue;
                 }
@@ -245,7 +253,7 @@ int main(void){
             LaunchPad_LED(0);  // LED off in wander mode
         }
         else if (currentMode == MODE_LINE_FOLLOWING) {
-            LineFollowMode();
+            WaitForInterrupt();  // FSM runs in LineFollowTask
         }
     }
 }
@@ -14,10 +14,30 @@
 #include "..\inc\PWM.h"
 #include "..\inc\ADC14.h"
 #include "..\inc\IRDistance.h"
+#include "..\inc\LPF.h"
+#include "..\inc\Maze.h"
+#include "..\inc\MotorCal.h"
+#include "..\inc\MotorProfile.h"
+#include "..\inc\Pursuit.h"
 #include <stdint.h>
 #define RED 0x01
 #define SPEED 1000
 
+// Course description, edit these for a new maze instead of the route
+#define MAZE_ROWS   4       // cells north to south
+#define MAZE_COLS   4       // cells west to east
+#define START_ROW   3       // robot starts in the south-west corner
+#define START_COL   0
+#define START_HEAD  MAZE_NORTH
+#define GOAL_ROW    0
+#define GOAL_COL    3
+#define CELL_CM     30      // cell size, line to line
+#define STEP_CM     5       // forward step while looking for the next line
+#define WALL_MM     200     // IR distance below this is a wall
+#define SOLVE_BUDGET 16     // flood fill cells per Maze_Solve call
+#define TRACK_MM    145     // wheel to wheel, WHEELBASE in Motor.c
+#define RUN_HZ      100     // speed run control ticks per s, 8 or more for TimerA1
+
 
 // Check if robot has encountered a line
 volatile uint8_t reflectance;
@@ -49,9 +69,120 @@ void Port2_Init(void){
 }
 
 
+
+// Measure the walls around the robot, IR averaged through the LPFs
+int32_t Left, Center, Right;    // IR distances in mm
+void SenseWalls(void){
+  uint32_t raw17, raw12, raw16;
+  int32_t nr, nc, nl;
+  int i;
+  ADC_In17_12_16(&raw17,&raw12,&raw16);
+  LPF_Init(raw17,16);     // P9.0/channel 17
+  LPF_Init2(raw12,16);    // P4.1/channel 12
+  LPF_Init3(raw16,16);    // P9.1/channel 16
+  for(i=0; i<16; i++){
+    ADC_In17_12_16(&raw17,&raw12,&raw16);
+    nr = LPF_Calc(raw17);
+    nc = LPF_Calc2(raw12);
+    nl = LPF_Calc3(raw16);
+  }
+  Left = LeftConvert(nl);
+  Center = CenterConvert(nc);
+  Right = RightConvert(nr);
+}
+
+// Drive one cell: stop at the next line, or after CELL_CM if there is none
+// Output: MOTOR_MOVE_DONE, or why a step ended early
+uint32_t DriveCell(void){
+  int32_t dist = 0;
+  uint32_t result = MOTOR_MOVE_DONE;
+  while((dist < CELL_CM) && (result == MOTOR_MOVE_DONE)){
+    result = Motor_ProfiledForwardDist(STEP_CM,SPEED,SPEED);
+    dist = dist + STEP_CM;
+    if(CheckForLine() && (dist >= CELL_CM/2)){
+      break;            // crossed the line that marks the next cell
+    }
+  }
+  Motor_Stop();
+  return result;
+}
+
+// Plan the speed run from the start cell on the explored map: down the
+// flood fill distances through walls seen open, straight on where it
+// can, every cell one Pursuit_AddMove with the turns as arcs
+// Output: 0 if the path reaches the goal
+uint32_t PlanRun(void){
+  uint32_t row = START_ROW, col = START_COL, heading = START_HEAD;
+  uint32_t d, i, dir, r, c;
+  static const int32_t DRow[4] = {-1, 0, 1, 0};  // NORTH, EAST, SOUTH, WEST
+  static const int32_t DCol[4] = {0, 1, 0, -1};
+  static const uint32_t Turn[4] = {MAZE_FORWARD, MAZE_RIGHT, MAZE_UTURN, MAZE_LEFT};
+  Pursuit_Init(TRACK_MM, RUN_HZ);
+  Pursuit_SetPose(0, 0, TRIG_90 - START_HEAD*TRIG_90);   // north is +y
+  Pursuit_Clear();
+  while((d = Maze_Distance(row, col)) != 0){
+    for(i=0; i<4; i++){
+      dir = (heading + i)&3;        // straight on first
+      r = row + DRow[dir];
+      c = col + DCol[dir];
+      if((r < MAZE_ROWS) && (c < MAZE_COLS) &&     // wraps below 0
+         (Maze_Wall(row, col, dir) == 0) && (Maze_Distance(r, c) < d)){
+        break;
+      }
+    }
+    if((i == 4) || Pursuit_AddMove(Turn[i], CELL_CM*10, CELL_CM*10/2)){
+      return 1;
+    }
+    row = r;
+    col = c;
+    heading = dir;
+  }
+  return 0;
+}
+
+// Speed run control tick, TimerA1 sets it every 1/RUN_HZ s
+volatile uint32_t RunTick;
+uint32_t Overruns;      // speed run ticks whose update took longer than 1/RUN_HZ
+void RunTask(void){
+  RunTick = 1;
+}
+
+// Drive the planned path, returns when it is done or on a touch
+// TimerA1 paces the loop, so every tick starts 1/RUN_HZ after the last
+// one however long Pursuit_Update takes, as long as it fits in the tick
+void SpeedRun(void){
+  PursuitCmd_t cmd;
+  uint16_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps;
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  Pursuit_Odometry(leftSteps, rightSteps);
+  RunTick = 0;
+  Overruns = 0;
+  TimerA1_Init(&RunTask, 500000/RUN_HZ);   // 2 us units
+  while(LaunchPad_Input() == 0){
+    while(RunTick == 0){};
+    RunTick = 0;
+    Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+    Pursuit_Odometry(leftSteps, rightSteps);
+    if(Pursuit_Update(&cmd) == 0){
+      break;
+    }
+    Motor_Duty(MotorCal_Duty(0, cmd.Left), MotorCal_Duty(1, cmd.Right));
+    if(RunTick){
+      Overruns++;       // the next tick came before this one was done
+    }
+  }
+  TimerA1_Stop();
+  Motor_Stop();
+}
+
+
 uint8_t Data; // QTR-8RC
-int32_t Position; // 332 is right, and -332 is left of center
-uint8_t lineCount = 0;
+uint32_t Move;  // last motion primitive
+uint32_t Result;  // MOTOR_MOVE_DONE, or why the last move ended early
+MazeStats_t Stats;
+PursuitStats_t Run;     // tracking error and time of the speed run
 int main(void){
     // Initialize all subsystems
     Clock_Init48MHz();
@@ -59,48 +190,67 @@ int main(void){
     Motor_Init();
     Tachometer_Init();
     Reflectance_Init();  // Initialize reflectance sensors
+    ADC0_InitSWTriggerCh17_12_16();
     TExaS_Init(LOGICANALYZER_P2);
     EnableInterrupts();
   Port2_Init();
     Data = Reflectance_Read(1000);
+    if(Maze_Init(MAZE_ROWS,MAZE_COLS,START_ROW,START_COL,START_HEAD,GOAL_ROW,GOAL_COL,MAZE_FLOODFILL)){
+        P2->OUT |= RED;     // course description does not fit, fix the defines
+        while(1);
+    }
 
-
-//    if (Data == 0b11111111){
-////        P2->OUT ^= RED; // turn on RED LED when line detected
-//        if (lineCount == 0) {
-//            Motor_RotateAngle(90, SPEED);
-//        }
-//
-//        Clock_Delay1ms(500);
-//        Data = Reflectance_Read(1000);
-//    }
-//    P2->OUT &= ~RED;
     TimedPause(500);
-    while (CheckForLine() == 0) {
-        // move forward
-        Motor_ForwardDist(10,1000,1000);
-        Data = Reflectance_Read(1000);
-
+    while(1){
+        SenseWalls();
+        Maze_SenseIR(Left,Center,Right,WALL_MM);
+        while(Maze_Solve(SOLVE_BUDGET) == 0){}   // bounded work per call
+        Move = Maze_NextMove();
+        if(Move >= MAZE_STOP){
+            break;      // at the goal, or no way there
+        }
+        Result = MOTOR_MOVE_DONE;
+        if(Move == MAZE_RIGHT){
+            Result = Motor_ProfiledRotateAngle(90,SPEED);
+        }else if(Move == MAZE_LEFT){
+            Result = Motor_ProfiledRotateAngle(-90,SPEED);
+        }else if(Move == MAZE_UTURN){
+            Result = Motor_ProfiledRotateAngle(180,SPEED);
+        }
+        if(Result == MOTOR_MOVE_DONE){
+            Result = DriveCell();
+        }
+        if(Result != MOTOR_MOVE_DONE){
+            Motor_Stop();
+            P2->OUT |= RED;     // bumped or stalled, the map is off by a move
+            while(1);
+        }
+        if(Maze_Advance(Move)){
+            Motor_Stop();
+            P2->OUT |= RED;     // drove off the map, the course defines are wrong
+            while(1);
+        }
+        Maze_GetStats(&Stats);
     }
-    Motor_RotateAngle(90,1000);
-    Motor_ForwardDist(15,1000,1000);
-    Motor_RotateAngle(-90,1000);
-
-    while (CheckForLine() == 0) {
-        // move forward
-        Motor_Forward(1000,1000);
-        Data = Reflectance_Read(1000);
-
+    Motor_Stop();
+    if(Move == MAZE_STOP){
+        P2->OUT |= 0x02;    // green, goal reached
+    }else{
+        P2->OUT |= RED;     // red, goal walled off
+        while(1);
     }
-    Motor_RotateAngle(-90,1000);
-    while (CheckForLine() == 0) {
-        // move forward
-        Motor_Forward(1000,1000);
-        Data = Reflectance_Read(1000);
-
+    while(Maze_Solve(SOLVE_BUDGET) == 0){}
+    // speed run: put the robot back on the start cell and touch
+    while(1){
+        while(LaunchPad_Input()==0);    // wait for touch
+        while(LaunchPad_Input());       // wait for release
+        P2->OUT &= ~0x07;
+        if(PlanRun()){
+            P2->OUT |= RED;             // no known path
+            continue;
+        }
+        SpeedRun();
+        Pursuit_GetStats(&Run);
+        P2->OUT |= 0x04;                // blue, run done
     }
-    Motor_Stop();
-    while(1);
-
-    Clock_Delay1ms(10);
 }
@@ -82,6 +82,13 @@ Reflectance.obj: C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/Reflectance.c $(GEN_OP
 	@echo 'Finished building: "$<"'
 	@echo ' '
 
+SoftTimer.obj: C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/SoftTimer.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: "$<"'
+	@echo 'Invoking: MSP432 Compiler'
+	"C:/ti/ccsv7/tools/compiler/ti-cgt-arm_16.9.6.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="C:/ti/ccsv7/ccs_base/arm/include" --include_path="C:/ti/ccsv7/ccs_base/arm/include/CMSIS" --include_path="C:/Users/ALOY0058/Desktop/SC2107_LAB/H_TimerCompare_Motor_WandererBot" --include_path="C:/ti/ccsv7/tools/compiler/ti-cgt-arm_16.9.6.LTS/include" --advice:power=all --define=__MSP432P401R__ --define=ccs -g --c99 --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="SoftTimer.d_raw" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: "$<"'
+	@echo ' '
+
 TA3InputCapture.obj: C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TA3InputCapture.c $(GEN_OPTS) | $(GEN_HDRS)
 	@echo 'Building file: "$<"'
 	@echo 'Invoking: MSP432 Compiler'
@@ -110,6 +117,13 @@ TimerA1.obj: C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TimerA1.c $(GEN_OPTS) | $(
 	@echo 'Finished building: "$<"'
 	@echo ' '
 
+TimerA2.obj: C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TimerA2.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: "$<"'
+	@echo 'Invoking: MSP432 Compiler'
+	"C:/ti/ccsv7/tools/compiler/ti-cgt-arm_16.9.6.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="C:/ti/ccsv7/ccs_base/arm/include" --include_path="C:/ti/ccsv7/ccs_base/arm/include/CMSIS" --include_path="C:/Users/ALOY0058/Desktop/SC2107_LAB/H_TimerCompare_Motor_WandererBot" --include_path="C:/ti/ccsv7/tools/compiler/ti-cgt-arm_16.9.6.LTS/include" --advice:power=all --define=__MSP432P401R__ --define=ccs -g --c99 --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="TimerA2.d_raw" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: "$<"'
+	@echo ' '
+
 UART0.obj: C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/UART0.c $(GEN_OPTS) | $(GEN_HDRS)
 	@echo 'Building file: "$<"'
 	@echo 'Invoking: MSP432 Compiler'
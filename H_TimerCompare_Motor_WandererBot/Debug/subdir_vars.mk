@@ -20,10 +20,12 @@ C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/LaunchPad.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/Motor.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/PWM.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/Reflectance.c \
+C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/SoftTimer.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TA3InputCapture.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TExaS.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/Tachometer.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TimerA1.c \
+C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TimerA2.c \
 C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/UART0.c \
 ../startup_msp432p401r_ccs.c \
 ../system_msp432p401r.c 
@@ -40,10 +42,12 @@ C_DEPS += \
 ./Motor.d \
 ./PWM.d \
 ./Reflectance.d \
+./SoftTimer.d \
 ./TA3InputCapture.d \
 ./TExaS.d \
 ./Tachometer.d \
 ./TimerA1.d \
+./TimerA2.d \
 ./UART0.d \
 ./startup_msp432p401r_ccs.d \
 ./system_msp432p401r.d 
@@ -60,10 +64,12 @@ OBJS += \
 ./Motor.obj \
 ./PWM.obj \
 ./Reflectance.obj \
+./SoftTimer.obj \
 ./TA3InputCapture.obj \
 ./TExaS.obj \
 ./Tachometer.obj \
 ./TimerA1.obj \
+./TimerA2.obj \
 ./UART0.obj \
 ./startup_msp432p401r_ccs.obj \
 ./system_msp432p401r.obj 
@@ -80,10 +86,12 @@ OBJS__QUOTED += \
 "Motor.obj" \
 "PWM.obj" \
 "Reflectance.obj" \
+"SoftTimer.obj" \
 "TA3InputCapture.obj" \
 "TExaS.obj" \
 "Tachometer.obj" \
 "TimerA1.obj" \
+"TimerA2.obj" \
 "UART0.obj" \
 "startup_msp432p401r_ccs.obj" \
 "system_msp432p401r.obj" 
@@ -100,10 +108,12 @@ C_DEPS__QUOTED += \
 "Motor.d" \
 "PWM.d" \
 "Reflectance.d" \
+"SoftTimer.d" \
 "TA3InputCapture.d" \
 "TExaS.d" \
 "Tachometer.d" \
 "TimerA1.d" \
+"TimerA2.d" \
 "UART0.d" \
 "startup_msp432p401r_ccs.d" \
 "system_msp432p401r.d" 
@@ -120,10 +130,12 @@ C_SRCS__QUOTED += \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/Motor.c" \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/PWM.c" \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/Reflectance.c" \
+"C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/SoftTimer.c" \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TA3InputCapture.c" \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TExaS.c" \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/Tachometer.c" \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TimerA1.c" \
+"C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/TimerA2.c" \
 "C:/Users/ALOY0058/Desktop/SC2107_LAB/inc/UART0.c" \
 "../startup_msp432p401r_ccs.c" \
 "../system_msp432p401r.c" 
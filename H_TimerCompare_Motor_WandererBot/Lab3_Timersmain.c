@@ -62,7 +62,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "..\inc\CortexM.h"
 #include "..\inc\LaunchPad.h"
 #include "..\inc\Motor.h"
-#include "..\inc\TimerA1.h"
+#include "..\inc\SoftTimer.h"
 #include "..\inc\TExaS.h"
 #include "..\inc\Reflectance.h"
 // new
@@ -76,6 +76,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/LPF.h"
 #include "../inc/UART0.h"
 #include "../inc/BaseConvert.h"
+#include "../inc/Bits.h"
 
 volatile uint8_t bumpState;
 volatile uint8_t status;
@@ -94,8 +95,8 @@ void TimedPause(uint32_t time){
 }
 
 // Test of Periodic interrupt
-#define REDLED (*((volatile uint8_t *)(0x42098060)))
-#define BLUELED (*((volatile uint8_t *)(0x42098068)))
+#define REDLED BITS_BAND(&P2->OUT, 0)
+#define BLUELED BITS_BAND(&P2->OUT, 2)
 uint32_t Time;
 
 #define SPEED 1000
@@ -114,6 +115,16 @@ volatile uint32_t nr,nc,nl;
 //#define IR_THRESHOLD 50
 volatile uint32_t left, center, right;
 
+// both on the one Timer A2 tick, TimerA1 stays free
+SoftTimer_t Sample, BumpCheck;
+
+// runs at 100 Hz, keeps the first collision until the main loop has handled it
+void BumpTask(void){
+  if(bumpState == 0x3F){
+    bumpState = Bump_Read();
+  }
+}
+
 void SensorRead_ISR(void){  // runs at 2000 Hz
   uint32_t raw17,raw12,raw16;
   P1OUT ^= 0x01;         // profile
@@ -128,8 +139,8 @@ void SensorRead_ISR(void){  // runs at 2000 Hz
 
 int main(void){
     // Uses Timer generated PWM to move the robot
-    // Uses TimerA1 to periodically
-    // check the bump switches, stopping the robot on a collision
+    // Uses the software timers on Timer A2 to sample the IR sensors and
+    // to periodically check the bump switches, backing off on a collision
 
 
     uint32_t raw12, raw16, raw17;
@@ -146,14 +157,15 @@ int main(void){
     LPF_Init3(raw16,s);     // P9.1/channel 16
     UART0_Init();          // initialize UART0 115,200 baud rate
     LaunchPad_Init();
-    TimerA1_Init(&SensorRead_ISR,250);    // 2000 Hz sampling
+    SoftTimer_Init(2000);                 // 0.5 ms tick
+    SoftTimer_Start(&Sample, &SensorRead_ISR, 1, 1, SOFTTIMER_ISR);   // 2000 Hz sampling
 
     Bump_Init();      // bump switches
     Motor_Init();     // your function
     Tachometer_Init();
     TExaS_Init(LOGICANALYZER_P2);
     bumpState = 0x3F;           // FB: to prevent the motor to stop immediately, because the initial value of bumpState is 0x00 otherwise.
-//    TimerA1_Init(&Task,50000);  // 10 Hz
+    SoftTimer_Start(&BumpCheck, &BumpTask, 1, 20, SOFTTIMER_ISR);   // 100 Hz
     EnableInterrupts();
 
     // IR setup
@@ -76,6 +76,8 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/LPF.h"
 #include "../inc/UART0.h"
 #include "../inc/BaseConvert.h"
+#include "../inc/Line.h"
+#include "../inc/Bits.h"
 
 volatile uint8_t bumpState;
 volatile uint8_t status;
@@ -94,8 +96,8 @@ void TimedPause(uint32_t time){
 }
 
 // Test of Periodic interrupt
-#define REDLED (*((volatile uint8_t *)(0x42098060)))
-#define BLUELED (*((volatile uint8_t *)(0x42098068)))
+#define REDLED BITS_BAND(&P2->OUT, 0)
+#define BLUELED BITS_BAND(&P2->OUT, 2)
 uint32_t Time;
 
 #define SPEED 1000
@@ -140,6 +142,7 @@ uint8_t CheckForLine(void) {
 
 
 volatile  uint8_t lineCount = 0;
+volatile  uint8_t lineEvent;     // most recent event from Line_Update
 int main(void){
     // Uses Timer generated PWM to move the robot
     // Uses TimerA1 to periodically
@@ -176,17 +179,17 @@ int main(void){
     // Initialize all subsystems
     Reflectance_Init();  // Initialize reflectance sensors
     TimedPause(500);
+    Line_Init(LINE_DARK, 3, 100);   // 3 scans to confirm, ~100 ms gap
     while(1) {
         Data = Reflectance_Read(1000);
-        if (!((Data & 0x04) && (Data & 0x08))) {
-            Motor_Forward(1000,1000);
+        lineEvent = Line_Update(Data);
+        if ((lineEvent == LINE_T) || (lineEvent == LINE_CROSS)) {
+            // crossed a line that spans the sensor array
+            Motor_Stop();
+            lineCount++;
         }
-        else if ((Data & 0x04) && (Data & 0x08)) {
-            Clock_Delay1ms(100);
-            if ((Data & 0x04) && (Data & 0x08)) {
-                Motor_Stop();
-                lineCount++;
-            }
+        else {
+            Motor_Forward(1000,1000);
         }
 
         if (lineCount == 1) {
@@ -195,18 +198,19 @@ int main(void){
             Motor_RotateAngle(-90, 1000);
             Motor_ForwardDist(10,1000,1000);
             lineCount++;
+            Line_Init(LINE_DARK, 3, 100);   // robot moved, start tracking afresh
             continue;
         }
         else if (lineCount == 3) {
             Motor_RotateAngle(-100, 1000);
             Motor_ForwardDist(10,1000,1000);
             lineCount++;
+            Line_Init(LINE_DARK, 3, 100);
         }
         else if (lineCount == 5) {
             Motor_Stop();
             while(1);
         }
-        Clock_Delay1ms(100);
     }
 
 
@@ -66,6 +66,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "..\inc\Clock.h"
+#include "..\inc\Bits.h"
 
 #define BITBAND 0
 
@@ -76,9 +77,9 @@ policies, either expressed or implied, of the FreeBSD Project.
 #define BLUE      0x04
 
 //Bit Band address of P2.2 (Blue), P2.1 (Green) and P2.0 (Red)
-#define BLUEOUT     (*((volatile uint8_t *)(0x42098068)))
-#define GREENOUT    (*((volatile uint8_t *)(0x42098064)))
-#define REDOUT      (*((volatile uint8_t *)(0x42098060)))
+#define BLUEOUT     BITS_BAND(&P2->OUT, 2)
+#define GREENOUT    BITS_BAND(&P2->OUT, 1)
+#define REDOUT      BITS_BAND(&P2->OUT, 0)
 
 //Function declaration
 void Bit_Manipulation(void);
@@ -49,6 +49,9 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/LaunchPad.h"
 #include "../inc/Texas.h"
 #include "../inc/Reflectance.h"  //OHL
+#include "../inc/CortexM.h"
+#include "../inc/TimerA1.h"
+#include "../inc/FSM.h"
 
 /*(Left,Right) Motors, call LaunchPad_Output (positive logic)
 3   1,1     both motors, yellow means go straight
@@ -62,67 +65,68 @@ policies, either expressed or implied, of the FreeBSD Project.
 0   0,0     neither button      means lost
  */
 
-// Linked data structure
-struct State {
-  uint32_t out;                // 2-bit output
-  uint32_t delay;              // time to delay in 1ms
-  const struct State *next[4]; // Next if 2-bit input is 0-3
-};
-typedef const struct State State_t;
-
-#define Center          &fsm[0]
-#define Left1           &fsm[1]
-#define Left2           &fsm[2]
-#define Left_off1       &fsm[3]
-#define Left_off2       &fsm[4]
-#define Left_stop       &fsm[5]
-#define Right1          &fsm[6]
-#define Right2          &fsm[7]
-#define Right_off1      &fsm[8]
-#define Right_off2      &fsm[9]
-#define Right_stop      &fsm[10]
-
+// State table, see FSM.h
+// (name, out, delay in 1 ms ticks, next for input 0, 1, 2, 3)
 //OHL
-State_t fsm[11]={
-  {0x03,  500, { Right1,         Left1,      Right1,     Center    }},   // Center
-  {0x02,  500, { Left_off1,      Left2,      Right1,     Center    }},   // Left1
-  {0x03,  500, { Left_off1,      Left1,      Right1,     Center    }},   // Left2
-  {0x02, 5000, { Left_off2,      Left_off2,  Left_off2,  Left_off2 }},   // Left_off1
-  {0x03, 5000, { Left_stop,      Left1,      Right1,     Center    }},   // Left_off2
-  {0x00,  0,   { Left_stop,      Left_stop,  Left_stop,  Left_stop }},   // Left_stop
-  {0x01,  500, { Right_off1,     Left1,      Right2,     Center    }},   // Right1
-  {0x03,  500, { Right_off1,     Left1,      Right1,     Center    }},   // Right2
-  {0x01, 5000, { Right_off2,     Right_off2, Right_off2, Right_off2}},   // Right_off1
-  {0x03, 5000, { Right_stop,     Left1,      Right1,     Center    }},   // Right_off2
-  {0x00,  0,   { Right_stop,     Right_stop, Right_stop, Right_stop}}    // Right_stop
-};
+#define LINE_FSM(S) \
+  S(Center,     0x03,  500, Right1,     Left1,      Right1,     Center    ) \
+  S(Left1,      0x02,  500, Left_off1,  Left2,      Right1,     Center    ) \
+  S(Left2,      0x03,  500, Left_off1,  Left1,      Right1,     Center    ) \
+  S(Left_off1,  0x02, 5000, Left_off2,  Left_off2,  Left_off2,  Left_off2 ) \
+  S(Left_off2,  0x03, 5000, Left_stop,  Left1,      Right1,     Center    ) \
+  S(Left_stop,  0x00,    0, Left_stop,  Left_stop,  Left_stop,  Left_stop ) \
+  S(Right1,     0x01,  500, Right_off1, Left1,      Right2,     Center    ) \
+  S(Right2,     0x03,  500, Right_off1, Left1,      Right1,     Center    ) \
+  S(Right_off1, 0x01, 5000, Right_off2, Right_off2, Right_off2, Right_off2) \
+  S(Right_off2, 0x03, 5000, Right_stop, Left1,      Right1,     Center    ) \
+  S(Right_stop, 0x00,    0, Right_stop, Right_stop, Right_stop, Right_stop)
+FSM_TABLE(LINE_FSM, fsm);
+
+FSMReport_t Report;       // table check, look at this in the debugger
+uint32_t Recover[fsm_SIZE]; // ticks back to Center once on the line, per state
 
 
-State_t *Spt;  // pointer to the current state
+FSM_t Robot;   // current state and dwell timer
 uint32_t Input;
 uint32_t Output;
-/*Run FSM continuously
-1) Output depends on State (LaunchPad LED)
-2) Wait depends on State
-3) Input (LaunchPad buttons)
-4) Next depends on (Input,State)
+/*Run FSM every 1 ms in TimerA1 ISR
+1) Input (two center reflectance sensors) sampled every tick;
+   the sensor read is pipelined, Reflectance_Start() is called at
+   the end of one tick and Reflectance_End() at the start of the
+   next, so the 1 ms decay time overlaps the FSM period
+2) Next depends on (Input,State), either when the dwell
+   has elapsed or as soon as the input changes
+3) Output depends on State (LaunchPad LED)
  */
-int main(void){ uint32_t heart=0;
+void FSM_Task(void){
+  Input = (Reflectance_End()&0x18)>>3;  // same bits as Reflectance_Center
+  Reflectance_Start();                  // charge for the next tick
+  Output = FSM_Tick(&Robot, Input);
+  LaunchPad_Output(Output);             // do output to two motors
+  TExaS_Set(Input<<2|Output);           // optional, send data to logic analyzer
+}
+
+int main(void){ uint32_t heart=0; uint32_t count=0;
   Clock_Init48MHz();
   Reflectance_Init();
   LaunchPad_Init();
   TExaS_Init(LOGICANALYZER);  // Reflectance sensor output
-  Spt = Center;
+  if(FSM_Validate(fsm, fsm_SIZE, Center, 3, Recover, &Report)){
+    LaunchPad_Output(0x01);   // red, broken state table
+    while(1){};
+  }
+  FSM_Init(&Robot, fsm, Center, Reflectance_Center(1000));
+  Reflectance_Start();
+  TimerA1_Init(&FSM_Task, 500); // 1000 Hz FSM tick
+  EnableInterrupts();
   while(1){
-    Output = Spt->out;            // set output from FSM
-    LaunchPad_Output(Output);     // do output to two motors
-    TExaS_Set(Input<<2|Output);   // optional, send data to logic analyzer
-    Clock_Delay1ms(Spt->delay);   // wait
-    //Input = LaunchPad_Input();    // read sensors
-    Input = Reflectance_Center(1000);
-    Spt = Spt->next[Input];       // next depends on input and state
-    heart = heart^1;
-    LaunchPad_LED(heart);         // optional, debugging heartbeat
+    WaitForInterrupt();
+    count = count+1;
+    if(count >= 500){
+      count = 0;
+      heart = heart^1;
+      LaunchPad_LED(heart);       // optional, debugging heartbeat
+    }
   }
 }
 
@@ -48,6 +48,9 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/clock.h"
 #include "../inc/LaunchPad.h"
 #include "../inc/Texas.h"
+#include "../inc/CortexM.h"
+#include "../inc/TimerA1.h"
+#include "../inc/FSM.h"
 
 /*(Left,Right) Motors, call LaunchPad_Output (positive logic)
 3   1,1     both motors, yellow means go straight
@@ -61,48 +64,46 @@ policies, either expressed or implied, of the FreeBSD Project.
 0   0,0     neither button      means lost
  */
 
-// Linked data structure
-struct State {
-  uint32_t out;                // 2-bit output
-  uint32_t delay;              // time to delay in 1ms
-  const struct State *next[4]; // Next if 2-bit input is 0-3
-};
-typedef const struct State State_t;
+// State table, see FSM.h
+// (name, out, delay in 1 ms ticks, next for input 0, 1, 2, 3)
+#define LINE_FSM(S) \
+  S(Center, 0x03, 500, Right, Left,   Right,  Center) \
+  S(Left,   0x02, 500, Left,  Center, Right,  Center) \
+  S(Right,  0x01, 500, Right, Left,   Center, Center)
+FSM_TABLE(LINE_FSM, fsm);
 
-#define Center    &fsm[0]
-#define Left      &fsm[1]
-#define Right     &fsm[2]
 
-State_t fsm[3]={
-  {0x03, 500, { Right, Left,   Right,  Center }},  // Center
-  {0x02, 500, { Left,  Center, Right,  Center }},  // Left
-  {0x01, 500, { Right, Left,   Center, Center }}   // Right
-};
-
-
-State_t *Spt;  // pointer to the current state
+FSM_t Robot;   // current state and dwell timer
 uint32_t Input;
 uint32_t Output;
-/*Run FSM continuously
-1) Output depends on State (LaunchPad LED)
-2) Wait depends on State
-3) Input (LaunchPad buttons)
-4) Next depends on (Input,State)
+/*Run FSM every 1 ms in TimerA1 ISR
+1) Input (LaunchPad buttons) sampled every tick
+2) Next depends on (Input,State), either when the dwell
+   has elapsed or as soon as the input changes
+3) Output depends on State (LaunchPad LED)
  */
-int main(void){ uint32_t heart=0;
+void FSM_Task(void){
+  Input = LaunchPad_Input();      // read sensors
+  Output = FSM_Tick(&Robot, Input);
+  LaunchPad_Output(Output);       // do output to two motors
+  TExaS_Set(Input<<2|Output);     // optional, send data to logic analyzer
+}
+
+int main(void){ uint32_t heart=0; uint32_t count=0;
   Clock_Init48MHz();
   LaunchPad_Init();
   TExaS_Init(LOGICANALYZER);  // optional
-  Spt = Center;
+  FSM_Init(&Robot, fsm, Center, LaunchPad_Input());
+  TimerA1_Init(&FSM_Task, 500); // 1000 Hz FSM tick
+  EnableInterrupts();
   while(1){
-    Output = Spt->out;            // set output from FSM
-    LaunchPad_Output(Output);     // do output to two motors
-    TExaS_Set(Input<<2|Output);   // optional, send data to logic analyzer
-    Clock_Delay1ms(Spt->delay);   // wait
-    Input = LaunchPad_Input();    // read sensors
-    Spt = Spt->next[Input];       // next depends on input and state
-    heart = heart^1;
-    LaunchPad_LED(heart);         // optional, debugging heartbeat
+    WaitForInterrupt();
+    count = count+1;
+    if(count >= 500){
+      count = 0;
+      heart = heart^1;
+      LaunchPad_LED(heart);       // optional, debugging heartbeat
+    }
   }
 }
 
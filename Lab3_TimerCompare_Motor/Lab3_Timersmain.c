@@ -66,6 +66,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "..\inc\TimerA1.h"
 #include "..\inc\TExaS.h"
 #include "..\inc\Reflectance.h"
+#include "..\inc\Bits.h"
 
 
 volatile uint8_t bumpState;
@@ -82,8 +83,8 @@ void TimedPause(uint32_t time){
 }
 
 // Test of Periodic interrupt
-#define REDLED (*((volatile uint8_t *)(0x42098060)))
-#define BLUELED (*((volatile uint8_t *)(0x42098068)))
+#define REDLED BITS_BAND(&P2->OUT, 0)
+#define BLUELED BITS_BAND(&P2->OUT, 2)
 uint32_t Time;
 
 void Task(void){
@@ -49,8 +49,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "..\inc\SysTickInts.h"
 #include "..\inc\CortexM.h"
 #include "..\inc\TimerA1.h"
-//#include "..\inc\Bump.h"
-#include "..\inc\BumpInt.h"
+#include "..\inc\Bump.h"
 #include "..\inc\LaunchPad.h"
 #include "..\inc\Motor.h"
 #include "../inc/IRDistance.h"
@@ -59,12 +58,13 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "..\inc\Reflectance.h"
 #include "../inc/TA3InputCapture.h"
 #include "../inc/Tachometer.h"
+#include "../inc/Bits.h"
 
-#define P2_4 (*((volatile uint8_t *)(0x42098070)))
-#define P2_3 (*((volatile uint8_t *)(0x4209806C)))
-#define P2_2 (*((volatile uint8_t *)(0x42098068)))
-#define P2_1 (*((volatile uint8_t *)(0x42098064)))
-#define P2_0 (*((volatile uint8_t *)(0x42098060)))
+#define P2_4 BITS_BAND(&P2->OUT, 4)
+#define P2_3 BITS_BAND(&P2->OUT, 3)
+#define P2_2 BITS_BAND(&P2->OUT, 2)
+#define P2_1 BITS_BAND(&P2->OUT, 1)
+#define P2_0 BITS_BAND(&P2->OUT, 0)
 
 
 void RSLK_Reset(void){
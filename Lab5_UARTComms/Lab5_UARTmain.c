@@ -49,8 +49,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "..\inc\SysTickInts.h"
 #include "..\inc\CortexM.h"
 #include "..\inc\TimerA1.h"
-//#include "..\inc\Bump.h"
-#include "..\inc\BumpInt.h"
+#include "..\inc\Bump.h"
 #include "..\inc\LaunchPad.h"
 #include "..\inc\Motor.h"
 #include "../inc/IRDistance.h"
@@ -59,20 +58,19 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "..\inc\Reflectance.h"
 #include "../inc/TA3InputCapture.h"
 #include "../inc/Tachometer.h"
-
-#define P2_4 (*((volatile uint8_t *)(0x42098070)))
-#define P2_3 (*((volatile uint8_t *)(0x4209806C)))
-#define P2_2 (*((volatile uint8_t *)(0x42098068)))
-#define P2_1 (*((volatile uint8_t *)(0x42098064)))
-#define P2_0 (*((volatile uint8_t *)(0x42098060)))
-
-uint16_t Period0;              // (1/SMCLK) units = 83.3 ns units
-uint16_t First0=0;             // Timer A3 first edge, P10.4
-uint32_t Done0=0;              // set each rising
-
-uint16_t Period2;              // (1/SMCLK) units = 83.3 ns units
-uint16_t First2=0;             // Timer A3 first edge, P8.2
-uint32_t Done2=0;              // set each rising
+#include "../inc/Avoid.h"
+#include "../inc/Sensors.h"
+#include "../inc/Time.h"
+#include "../inc/Shell.h"
+#include "../inc/Bits.h"
+#include "../inc/MotorCal.h"
+#include "../inc/Battery.h"
+
+#define P2_4 BITS_BAND(&P2->OUT, 4)
+#define P2_3 BITS_BAND(&P2->OUT, 3)
+#define P2_2 BITS_BAND(&P2->OUT, 2)
+#define P2_1 BITS_BAND(&P2->OUT, 1)
+#define P2_0 BITS_BAND(&P2->OUT, 0)
 
 volatile uint8_t bumpState;
 volatile uint8_t status;
@@ -98,434 +96,486 @@ void RSLK_Reset(void){
 //samples data from various sensors, filters the data and sets a flag to indicate that new sensor data is available
 void SensorRead_ISR(void)   //code from Lab4_ADCmain.c
 {  // runs at 2000 Hz
-    uint32_t raw17, raw12, raw16;
+    uint32_t raw17, raw12, raw16, raw14;
     P1OUT ^= 0x01;         // profile, used to toggle the state of the LSB of P1OUT (for profiling and debugging)
     P1OUT ^= 0x01;         // profile
-    ADC_In17_12_16(&raw17, &raw12, &raw16);  // sample
+    ADC_In17_12_16_14(&raw17, &raw12, &raw16, &raw14);  // sample
     nr = LPF_Calc(raw17);  // right is channel 17 P9.0
     nc = LPF_Calc2(raw12);  // center is channel 12, P4.1
     nl = LPF_Calc3(raw16);  // left is channel 16, P9.1
+    Sensors_PutIR(nl, nc, nr);  // publish the three as one sample
+    Battery_Put(raw14);    // battery divider, filtered there
     ADCflag = 1;           // semaphore
     P1OUT ^= 0x01;         // profile
 }
 
-//initializes the infrared sensors and prepares system to read data from the sensors. Also initializes UART communication
+// runs in Battery_Poll from the main loop once when the battery gets low
+void LowBattery(uint32_t mV){
+    LaunchPad_Output(RED);
+    Shell_OutString("battery low "); Shell_OutDec(mV); Shell_OutString(" mV\r\n");
+}
+
+//initializes the infrared sensors and starts sampling them in the background
+//UART0_Init is not called, it would take EUSCI_A0 away from the interrupt driven EUSCIA0 driver the shell uses
 void IRSensor_Init(void)    //code from Lab4_ADCmain.c
 {
-    uint32_t raw12, raw16, raw17;
-    int32_t n; uint32_t s;
+    uint32_t raw12, raw16, raw17, raw14;
+    uint32_t s;
     Clock_Init48MHz();  //SMCLK=12Mhzs
     ADCflag = 0;
     s = 256; // replace with your choice
-    ADC0_InitSWTriggerCh17_12_16();   // initialize channels 17,12,16
-    ADC_In17_12_16(&raw17,&raw12,&raw16);  // sample
+    ADC0_InitSWTriggerCh17_12_16_14();   // initialize channels 17,12,16 and the battery on 14
+    Sensors_Init(&Time_NowUs32);      // IR samples stamped in us
+    Battery_Init(&LowBattery);        // compensation stays off until "batt comp on"
+    ADC_In17_12_16_14(&raw17,&raw12,&raw16,&raw14);  // sample
     LPF_Init(raw17,s);     // P9.0/channel 17
     LPF_Init2(raw12,s);     // P4.1/channel 12
     LPF_Init3(raw16,s);     // P9.1/channel 16
-    UART0_Init();          // initialize UART0 115,200 baud rate
     LaunchPad_Init();
     TimerA1_Init(&SensorRead_ISR,250);    // 2000 Hz sampling
 }
 
-volatile uint8_t CollisionData, CollisionFlag;
+// wheel speeds stored with each collision, called in the bump interrupt
+void WheelPeriods(uint16_t *left, uint16_t *right){
+    enum TachDirection dir;
+    int32_t steps;
+    Tachometer_Get(left,&dir,&steps,right,&dir,&steps);
+}
 
-//called when collision is detected. Stops motor, processes the collision data (which bumpers are activated?).
-void HandleCollision(uint8_t bumpSensor){
-    Motor_Stop();
-    CollisionData = bumpSensor;
-    CollisionFlag = 1;
-    P4->IFG &= ~0xED;   //clear interrupt flags in the Port 4 Interrupt Flag Register
-
-    //Check individual bits and print messages
-    for(bumpAct = 0; bumpAct < 6; bumpAct++){
-        int bit = (CollisionData >> bumpAct) &1;
-        if(bit == 0){
-            //char message[20];
-            //sprintf(message, "Bumper %d activated\n", bumpAct);
-            //UART0_OutString(message);
-        }
+// stop distance of the guard command, 0 when off
+#define GUARD_HYSTERESIS 30     // mm, clear again this much farther away
+int32_t GuardMm = 0;
+uint32_t BattComp = 0;          // Battery_Init leaves compensation off
+
+// ADC14 window comparator on the raw center sample, runs right after the
+// conversion that crosses the threshold, before the filter or any job sees it
+void GuardTask(uint32_t near){
+    if(near){
+        Motor_Stop();
     }
 }
 
+// signed duty cycles to the motor driver, negative is backward
+// straight ahead is refused while the guard sees an obstacle
+void Drive(int32_t left, int32_t right){
+    if((left > 0) && (right > 0) && ADC_WindowNear()){
+        Motor_Stop();
+    }else{
+        Motor_Duty(left,right);
+    }
+}
+
+AvoidCmd_t AvoidCmd;
+SensorFrame_t Frame;
+
 uint8_t ConvertCollisionData(uint8_t data){
     return data&0x3f;
 }
 
-//measure time intervals using Timer A3. Capturing the time when an edge occurs.
-void PeriodMeasure0(uint16_t time){
-  Period0 = (time - First0)&0xFFFF; // 16 bits, 83.3 ns resolution
-  First0 = time;                    // setup for next
-  Done0++;
+// free running ms for the shell jobs, Time_NowUs32 wraps after 71 minutes
+uint32_t Millis(void){
+    static uint32_t last, ms;
+    uint32_t now = Time_NowUs32();
+    while((now - last) >= 1000){
+        last += 1000;
+        ms++;
+    }
+    return ms;
 }
 
-// max period is (2^16-1)*83.3 ns = 5.4612 ms
-// min period determined by time to run ISR, which is about 1 us
-void PeriodMeasure2(uint16_t time){
-  Period2 = (time - First2)&0xFFFF; // 16 bits, 83.3 ns resolution
-  First2 = time;                    // setup for next
-  Done2++;
+void NewLine(void){
+    EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
 }
 
-// RSLK Self-Test
-// Sample program of how the text based menu can be designed.
-// Only one entry (RSLK_Reset) is coded in the switch case. Fill up with other menu entries required for Lab5 assessment.
-// Init function to various peripherals are commented off.  For reference only. Not the complete list.
+// "stream <n>hz" at the end of a command, n from 1 to 1000
+// returns the job period in ms, or 0 if the arguments are wrong
+uint32_t StreamPeriod(int argc, char *argv[]){
+    int32_t hz;
+    if((argc != 3) || strcmp(argv[1],"stream") || !Shell_Number(argv[2],"hz",&hz) || (hz < 1) || (hz > 1000)){
+        return 0;
+    }
+    return 1000/hz;
+}
 
+//*************shell commands****
+// each test mode is a command, the ones that keep running are jobs so
+// the shell, the IR sampling and the other jobs keep going meanwhile
+int ResetCmd(int argc, char *argv[]){
+    (void)argv;
+    if(argc != 1){
+        return SHELL_USAGE;
+    }
+    Shell_StopJob(0);
+    ADC_WindowStop();           // the ADC is initialized again
+    GuardMm = 0;
+    BattComp = 0;
+    RSLK_Reset();
+    return SHELL_OK;
+}
 
-int main(void) {
-  uint32_t cmd=0xDEAD, menu=0;
+void MotorTask(void){}          // nothing to do, the job only times the move
 
+// motor fwd|back|left|right [duty] [time]ms, runs until stop without a time
+int MotorCmd(int argc, char *argv[]){
+    int32_t duty = speed, time = 0;
+    if((argc < 2) || (argc > 4) || (strcmp(argv[1],"fwd") && strcmp(argv[1],"back")
+     && strcmp(argv[1],"left") && strcmp(argv[1],"right"))){
+        return SHELL_USAGE;
+    }
+    if((argc > 2) && (!Shell_Number(argv[2],0,&duty) || (duty < 0) || (duty > MOTOR_MAX))){
+        return SHELL_USAGE;
+    }
+    if((argc > 3) && (!Shell_Number(argv[3],"ms",&time) || (time < 0))){
+        return SHELL_USAGE;
+    }
+    if(ADC_WindowNear() && (strcmp(argv[1],"fwd") == 0)){
+        Shell_OutString("obstacle"); NewLine();
+        return SHELL_FAIL;
+    }
+    Shell_StopJob("avoid");     // the shell command wins
+    Shell_StopJob("motor");     // a new move replaces the old one
+    if(strcmp(argv[1],"fwd") == 0){
+        Motor_Forward(duty,duty);
+    }else if(strcmp(argv[1],"back") == 0){
+        Motor_Backward(duty,duty);
+    }else if(strcmp(argv[1],"left") == 0){
+        Motor_Left(duty,0);     // right wheel only
+    }else{
+        Motor_Right(0,duty);    // left wheel only
+    }
+    if(time){
+        Shell_StartJob("motor",&MotorTask,time,time,&Motor_Stop);
+    }
+    return SHELL_OK;
+}
+
+int SpeedCmd(int argc, char *argv[]){
+    int32_t duty;
+    if(argc == 2){
+        if(!Shell_Number(argv[1],0,&duty) || (duty < 0) || (duty > MOTOR_MAX)){
+            return SHELL_USAGE;
+        }
+        speed = duty;
+    }
+    Shell_OutString("speed "); Shell_OutDec(speed); NewLine();
+    return SHELL_OK;
+}
+
+int StopCmd(int argc, char *argv[]){
+    (void)argv;
+    if(argc != 1){
+        return SHELL_USAGE;
+    }
+    Shell_StopJob(0);
+    Motor_Stop();
+    return SHELL_OK;
+}
+
+void IRTask(void){
+    Sensors_Snapshot(&Frame);  //all three from the same sample
+    EUSCIA0_OutUDec5(LeftConvert(Frame.IRLeft));EUSCIA0_OutString(" mm,");
+    EUSCIA0_OutUDec5(CenterConvert(Frame.IRCenter));EUSCIA0_OutString(" mm,");
+    EUSCIA0_OutUDec5(RightConvert(Frame.IRRight));EUSCIA0_OutString(" mm\r\n");
+}
+
+// ir [stream <n>hz]
+int IRCmd(int argc, char *argv[]){
+    uint32_t period;
+    if(argc == 1){
+        IRTask();
+        return SHELL_OK;
+    }
+    period = StreamPeriod(argc,argv);
+    if(period == 0){
+        return SHELL_USAGE;
+    }
+    return Shell_StartJob("ir",&IRTask,period,0,0) ? SHELL_FAIL : SHELL_OK;
+}
+
+void BumpPrint(uint8_t bump){   // bit 0 first, 1 is pressed
+    for(int i = 0; i<6; i++){
+        EUSCIA0_OutChar((bump&1) ? '1' : '0');
+        bump = bump>>1;
+    }
+    NewLine();
+}
+
+void BumpTask(void){            // print each new collision
+    BumpEvent_t e;
+    while(Bump_GetEvent(&e)){
+        Shell_OutString("t "); Shell_OutDec(e.Time);
+        Shell_OutString(" us L "); Shell_OutDec(e.LeftTach);
+        Shell_OutString(" R "); Shell_OutDec(e.RightTach);
+        if(e.Lost){
+            Shell_OutString(" lost "); Shell_OutDec(e.Lost);
+        }
+        Shell_OutString(" ");
+        BumpPrint(e.Switches);
+    }
+}
+
+// bump [watch|latency]
+int BumpCmd(int argc, char *argv[]){
+    BumpEvent_t e;
+    uint32_t cycles;
+    if(argc == 1){
+        BumpPrint((~Bump_Read())&0x3F);
+        return SHELL_OK;
+    }
+    if((argc == 2) && (strcmp(argv[1],"latency") == 0)){
+        cycles = Bump_MeasureLatency();     // stops the motors
+        Shell_OutString("bump to stop "); Shell_OutDec(cycles);
+        Shell_OutString(" cycles, "); Shell_OutDec(cycles*1000/(Clock_GetFreq()/1000000));
+        Shell_OutString(" ns, worst "); Shell_OutDec(Bump_WorstLatency());
+        Shell_OutString(" cycles"); NewLine();
+        return SHELL_OK;
+    }
+    if((argc != 2) || strcmp(argv[1],"watch")){
+        return SHELL_USAGE;
+    }
+    while(Bump_GetEvent(&e)){}          // only collisions from now on
+    return Shell_StartJob("bump",&BumpTask,20,0,0) ? SHELL_FAIL : SHELL_OK;
+}
+
+void LineTask(void){
+    uint8_t refData = Reflectance_Read(1000);   // 1 ms
+    for(int i = 0; i<8;i++){          //binary format of refData, LSB first
+        EUSCIA0_OutUDec(refData%2);
+        EUSCIA0_OutString("-");
+        refData = refData >> 1;
+    }
+    NewLine();
+}
+
+// line [stream <n>hz]
+int LineCmd(int argc, char *argv[]){
+    uint32_t period;
+    if(argc == 1){
+        LineTask();
+        return SHELL_OK;
+    }
+    period = StreamPeriod(argc,argv);
+    if(period < 10){
+        return SHELL_USAGE;         // each reading blocks for 1 ms
+    }
+    return Shell_StartJob("line",&LineTask,period,0,0) ? SHELL_FAIL : SHELL_OK;
+}
+
+void TachTask(void){
+    Sensors_Snapshot(&Frame);
+    EUSCIA0_OutString("L "); EUSCIA0_OutUDec5(Frame.LeftTach); Shell_OutString(" "); Shell_OutDec(Frame.LeftSteps);
+    EUSCIA0_OutString(" R "); EUSCIA0_OutUDec5(Frame.RightTach); Shell_OutString(" "); Shell_OutDec(Frame.RightSteps);
+    NewLine();
+}
+
+// tach [stream <n>hz], period in 83.3 ns units and steps
+int TachCmd(int argc, char *argv[]){
+    uint32_t period;
+    if(argc == 1){
+        TachTask();
+        return SHELL_OK;
+    }
+    period = StreamPeriod(argc,argv);
+    if(period == 0){
+        return SHELL_USAGE;
+    }
+    return Shell_StartJob("tach",&TachTask,period,0,0) ? SHELL_FAIL : SHELL_OK;
+}
+
+// odometric heading of Frame in degrees, positive to the right, counted
+// since boot: 360 steps = 220 mm and 145 mm between the wheels, so
+// 0.2415 degrees per step of difference
+int32_t FrameHeading(void){
+    return ((Frame.LeftSteps-Frame.RightSteps)*29)/120;
+}
+
+void AvoidTask(void){           // 100 Hz
+    Sensors_Snapshot(&Frame);
+    Avoid_Update(LeftConvert(Frame.IRLeft),CenterConvert(Frame.IRCenter),RightConvert(Frame.IRRight),
+                 (~Bump_Read())&0x3F,FrameHeading(),&AvoidCmd);
+    Drive(AvoidCmd.Left,AvoidCmd.Right);
+}
+
+// avoid [time]ms, runs until stop without a time
+int AvoidStart(int argc, char *argv[]){
+    int32_t time = 0;
+    if((argc > 2) || ((argc == 2) && (!Shell_Number(argv[1],"ms",&time) || (time < 0)))){
+        return SHELL_USAGE;
+    }
+    Shell_StopJob("motor");
+    Sensors_Snapshot(&Frame);
+    Avoid_Init(speed,FrameHeading());  // keep going in the direction it faces now
+    return Shell_StartJob("avoid",&AvoidTask,10,time,&Motor_Stop) ? SHELL_FAIL : SHELL_OK;
+}
+
+// guard [<n>mm|off], stop the motors in hardware when the center
+// sensor gets closer than n mm, driving ahead resumes GUARD_HYSTERESIS
+// mm farther away
+int GuardCmd(int argc, char *argv[]){
+    int32_t mm, hi;
+    if(argc == 2){
+        if(strcmp(argv[1],"off") == 0){
+            ADC_WindowStop();
+            GuardMm = 0;
+        }else if(Shell_Number(argv[1],"mm",&mm) && (mm > 0) && (mm <= 800)){
+            hi = CenterToADC(mm);   // n >= hi is closer than mm, the comparator is n > HI
+            if(hi){
+                hi--;
+            }
+            ADC_WindowInit(1,CenterToADC(mm + GUARD_HYSTERESIS),hi,&GuardTask); // MEM1 is P4.1/A12
+            GuardMm = mm;
+        }else{
+            return SHELL_USAGE;
+        }
+    }else if(argc != 1){
+        return SHELL_USAGE;
+    }
+    if(GuardMm == 0){
+        Shell_OutString("guard off");
+    }else{
+        Shell_OutString("guard "); Shell_OutDec(GuardMm);
+        Shell_OutString(ADC_WindowNear() ? " mm, obstacle" : " mm, clear");
+    }
+    NewLine();
+    return SHELL_OK;
+}
+
+const char *CalNames[4] = {"L+ ", "L- ", "R+ ", "R- "};
+
+void CalPrintCurves(void){
+    const MotorCalCurve_t *curve;
+    uint32_t c;
+    for(c=0; c<4; c++){
+        curve = MotorCal_Curve(c);
+        Shell_OutString(CalNames[c]);
+        Shell_OutString("deadband "); Shell_OutDec(curve->Deadband);
+        Shell_OutString(" gain "); Shell_OutDec((curve->Gain*1000)>>16);
+        Shell_OutString(" mm/s per 1000 duty, max "); Shell_OutDec(curve->MaxSpeed);
+        Shell_OutString(" mm/s"); NewLine();
+    }
+}
+
+// prints the measured sweep, then the fitted curves, when it is done
+void CalTask(void){
+    uint32_t i, c;
+    if(MotorCal_Run()){
+        return;
+    }
+    Shell_OutString("duty L+ L- R+ R- (mm/s)"); NewLine();
+    for(i=0; i<MOTORCAL_POINTS; i++){
+        Shell_OutDec(i*MOTORCAL_STEP);
+        for(c=0; c<4; c++){
+            Shell_OutString(" "); Shell_OutDec(MotorCal_Sample(c,i));
+        }
+        NewLine();
+    }
+    CalPrintCurves();
+    Shell_StopJob("cal");
+}
+
+// cal [run|save], run spins in place both ways for about a minute,
+// save keeps the curves in flash
+int CalCmd(int argc, char *argv[]){
+    if(argc == 1){
+        CalPrintCurves();
+        return SHELL_OK;
+    }
+    if(argc != 2){
+        return SHELL_USAGE;
+    }
+    if(strcmp(argv[1],"save") == 0){
+        return MotorCal_Save() ? SHELL_FAIL : SHELL_OK;
+    }
+    if(strcmp(argv[1],"run")){
+        return SHELL_USAGE;
+    }
+    Shell_StopJob("avoid");     // nothing else may drive the motors
+    Shell_StopJob("motor");
+    MotorCal_Start(&Time_NowUs32);
+    return Shell_StartJob("cal",&CalTask,10,0,&MotorCal_Abort) ? SHELL_FAIL : SHELL_OK;
+}
+
+// batt [log|comp on|comp off]
+int BattCmd(int argc, char *argv[]){
+    uint32_t i, mV;
+    if((argc == 2) && (strcmp(argv[1],"log") == 0)){
+        for(i=0; (mV = Battery_History(i)) != 0; i++){  // newest first
+            Shell_OutString("-"); Shell_OutDec(i*BATTERY_LOG*BATTERY_DECIMATE/2000);
+            Shell_OutString(" s "); Shell_OutDec(mV); Shell_OutString(" mV"); NewLine();
+        }
+        return SHELL_OK;
+    }
+    if((argc == 3) && (strcmp(argv[1],"comp") == 0)){
+        if(strcmp(argv[2],"on") == 0){
+            BattComp = 1;
+        }else if(strcmp(argv[2],"off") == 0){
+            BattComp = 0;
+        }else{
+            return SHELL_USAGE;
+        }
+        Battery_Compensate(BattComp);
+    }else if(argc != 1){
+        return SHELL_USAGE;
+    }
+    mV = Battery_Voltage();
+    Shell_OutString("battery "); Shell_OutDec(mV);
+    if(BattComp){
+        Shell_OutString(" mV, duty scaled to "); Shell_OutDec((Battery_Gain(mV)*100 + 8192)>>14);
+        Shell_OutString("%");
+    }else{
+        Shell_OutString(" mV, compensation off");
+    }
+    if(Battery_Low()){
+        Shell_OutString(", low");
+    }
+    NewLine();
+    return SHELL_OK;
+}
+
+ShellCmd_t Commands[] = {
+  {"reset", &ResetCmd,     "reset"},
+  {"motor", &MotorCmd,     "motor fwd|back|left|right [duty] [time]ms"},
+  {"speed", &SpeedCmd,     "speed [duty]"},
+  {"stop",  &StopCmd,      "stop"},
+  {"ir",    &IRCmd,        "ir [stream <n>hz]"},
+  {"bump",  &BumpCmd,      "bump [watch|latency]"},
+  {"line",  &LineCmd,      "line [stream <n>hz]"},
+  {"tach",  &TachCmd,      "tach [stream <n>hz]"},
+  {"avoid", &AvoidStart,   "avoid [time]ms"},
+  {"guard", &GuardCmd,     "guard [<n>mm|off]"},
+  {"cal",   &CalCmd,       "cal [run|save]"},
+  {"batt",  &BattCmd,      "batt [log|comp on|comp off]"},
+};
+
+// RSLK Self-Test
+// Command shell on the UART, type help for the list of commands.
+// The shell reads whatever has arrived and returns, so the IR sampling
+// (TimerA1), the bump interrupt and the background jobs keep running
+// while a command is typed. Several jobs can run at once, e.g.
+//   ir stream 10hz
+//   motor fwd 3000 1000ms
+// kill <job> or stop ends them.
+int main(void) {
   DisableInterrupts();
   Clock_Init48MHz();  // makes SMCLK=12 MHz
-  //SysTick_Init(48000,2);  // set up SysTick for 1000 Hz interrupts
+  Time_Init();        // us timebase for sensor timestamps and the shell
   Motor_Init();
-  //Motor_Stop();
+  MotorCal_Init();    // speed curves from flash, or nominal ones
   LaunchPad_Init();
-  //Bump_Init();
-  //Bumper_Init();
-  BumpInt_Init(&HandleCollision);
-  //IRSensor_Init();
-  //Tachometer_Init();
+  Bump_Init();        // a touch stops the motors from now on
+  Bump_SetSources(&Time_NowUs32,&WheelPeriods);
+  IRSensor_Init();    // samples in the background from now on
+  Tachometer_Init();
+  Reflectance_Init();
   EUSCIA0_Init();     // initialize UART
   EnableInterrupts();
 
-  while(1){                     // Loop forever
-      // write this as part of Lab 5
-      EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF); //CR for \r and LF for \n (carriage return and new line)
-      EUSCIA0_OutString("RSLK Testing"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[0] RSLK Reset"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[1] Motor Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[2] IR Sensor Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[3] Bumper Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[4] Reflectance Sensor Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[5] Tachometer Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[6] Control Robot"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-      EUSCIA0_OutString("[7] Obstacle Avoidance"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-
-      EUSCIA0_OutString("CMD: ");
-      cmd=EUSCIA0_InUDec();
-      EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-
-      switch(cmd){
-          case 0:   //RSLK Reset
-              RSLK_Reset();
-              menu =1;
-              cmd=0xDEAD;
-              break;
-
-          case 1:   //Motor Test
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("Selected: Motor Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("Control Instructions:"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("[f] forward"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("[b] backward"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("[l] left-turn (right wheel only)"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("[r] right-turn (left wheel only)"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-
-              uint32_t motorMode =EUSCIA0_InChar();
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              switch(motorMode){
-                case 'f':
-                    Motor_Forward(3000,3000);
-                    Clock_Delay1ms(1000);
-                    Motor_Stop();
-                    break;
-                case 'b':
-                    Motor_Backward(3000,3000);
-                    Clock_Delay1ms(1000);
-                    Motor_Stop();
-                    break;
-                case 'l':
-                    Motor_Left(3000,0);
-                    Clock_Delay1ms(1000);
-                    Motor_Stop();
-                    break;
-                case 'r':
-                    Motor_Right(0,3000);
-                    Clock_Delay1ms(1000);
-                    Motor_Stop();
-                    break;
-                default:
-                    break;
-              }
-              menu = 1;
-              cmd=0xDEAD;
-              break;
-
-          case 2:   //IR Sensor Test
-              //Code given in Lab4_ADCmain.c
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("Selected: IR Sensor Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              IRSensor_Init();
-
-              int32_t loopCounter;  //for inner loop: collects IR sensor data
-              Clock_Init48MHz();
-
-              EnableInterrupts();
-              for(int i = 0; i<20; i++) //make 20 IR readings
-              {
-              for(loopCounter=0; loopCounter < 2000; loopCounter++){    //duration specified bz loopCounter, wait for ADCflag to become non-zero (indication that it has processed the data)
-                    while(ADCflag == 0){};
-                    ADCflag = 0;
-                  }
-              UART0_OutUDec5(LeftConvert(nl));UART0_OutString(" mm,");      //LeftConvert converts the raw sensor data into distance measurements in mm
-              UART0_OutUDec5(CenterConvert(nc));UART0_OutString(" mm,");    //UART0_OutDec5 displays the IR sensor readings on the terminal
-              UART0_OutUDec5(RightConvert(nr));UART0_OutString(" mm\r\n");
-              }
-              menu = 1;
-              cmd=0xDEAD;
-              break;
-
-          case 3:   //Bumper Test
-
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("Selected: Bumper Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("Do you want the bump switches to cause an interrupt and the motor to stop after a bump switch has been activated?"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("[y] yes (track one bump switch activation at a time)"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("[n] no (track several bump switch activations simultaneously)"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              uint32_t volatile answer = EUSCIA0_InChar();
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              if(answer != 'y' && answer != 'n'){
-                  EUSCIA0_OutString("Your selection must either be [y] or [n]!"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                  EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                  break;
-              }
-
-              CollisionData = 0xED;
-              CollisionFlag = 0;
-
-               while(1){
-                  Motor_Forward(3000,3000);
-                  CollisionFlag = 0;
-                  WaitForInterrupt();
-                  if(CollisionFlag==1)
-                  {
-                      uint8_t tmp = CollisionData & 0x3F;
-                      for(int i = 0; i<6; i++){
-                          int digit = tmp & 1;
-                          tmp=tmp>>1;
-                          if(digit == 1){
-                              UART0_OutString("1");
-                          }else{
-                              UART0_OutString("0");
-                          }
-                      }
-                      //sprintf(message, "Bumper %d activated\n", bumpAct);
-                      //UART0_OutString(message);
-
-
-                      //UART0_OutUDec5(ConvertCollisionData(CollisionData));
-                      int8_t bumpAbs = ConvertCollisionData(CollisionData);
-                      EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                  if(answer == 'y'){
-                      switch(bumpAbs){
-                          case 31:
-                              Clock_Delay1ms(100);
-                              EUSCIA0_OutString("1st Bumper Activated! Object to the far left."); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                              break;
-                          case 47:
-                              Clock_Delay1ms(100);
-                              EUSCIA0_OutString("2nd Bumper Activated! Object to the left."); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                              break;
-                          case 55:
-                              Clock_Delay1ms(100);
-                              EUSCIA0_OutString("3rd Bumper Activated! Object slightly to the left."); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                              break;
-                          case 59:
-                              Clock_Delay1ms(100);
-                              EUSCIA0_OutString("4th Bumper Activated! Object slightly to the right."); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                              break;
-                          case 61:
-                              Clock_Delay1ms(100);
-                              EUSCIA0_OutString("5th Bumper Activated! Object to the right."); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                              break;
-                          case 62:
-                              Clock_Delay1ms(100);
-                              EUSCIA0_OutString("6th Bumper Activated! Object to the far right."); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                              break;
-                          default:
-                              break;
-                      }
-                  }
-                      if(answer == 'y'){
-                          break;
-                      }
-                  }
-              }
-              menu = 1;
-              cmd=0xDEAD;
-              break;
-
-
-          case 4:   //Reflectance Sensor Test
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("Selected: Reflectance Sensor Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              Reflectance_Init();
-              uint8_t refData = 0;  //used to store data read from the reflectance sensors
-              for(int i = 0; i<30; i++){    //repeat for 30 readings
-                  refData = Reflectance_Read(1000);
-                  for(int i = 0; i<8;i++){          //binary format of refData (8 iterations for 8 bits)
-                      EUSCIA0_OutUDec(refData%2);   //send 0 or 1 to the terminal (LSB of refData)
-                      EUSCIA0_OutString("-");
-                      refData = refData >> 1;
-                  }
-                  EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                  Clock_Delay1ms(500);  //repeat reading every half second
-              }
-              menu = 1;
-              cmd=0xDEAD;
-              break;
-
-          case 5:   //Tachometer Test
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutString("Selected: Tachometer Test"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-              EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-
-              uint32_t main_count=0;                                    //to keep track of the number of iterations of the loop
-              TimerA3Capture_Init(&PeriodMeasure0,&PeriodMeasure2);     //initializes Timer A3 capture module
-                  Clock_Delay1ms(500);
-                  Motor_Forward(3000,3000);
-              while(LaunchPad_Input()==0){
-                    WaitForInterrupt();
-                    main_count++;                                       //increment for every iteration
-                    if(main_count%50000 == 0){                                //
-                        UART0_OutString("Period0 = ");UART0_OutUDec5(Period0);UART0_OutString(" Period2 = ");UART0_OutUDec5(Period2);UART0_OutString(" \r\n");
-                    }       //give the values to UART
-                  }
-                  Motor_Stop();
-
-              //RSLK_Reset();
-              menu = 1;
-              cmd=0xDEAD;
-              break;
-
-          case 6:   //Advanced Topic1: Remote Control Robot
-              //options: forward, backwards, left, right, stop, accelerate, decelerate, switch LED's on?
-                RSLK_Reset();
-
-                EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("Selected: Control Robot"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("Control Instructions:"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("[w] forward"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("[x] backward"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("[a] left-turn (right wheel only)"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("[d] right-turn (left wheel only)"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("[s] stop motor"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("[q] accelerate"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("[z] decelerate"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-
-                while(LaunchPad_Input()==0){
-                    uint32_t motorModeC =EUSCIA0_InChar();
-                    EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                    switch(motorModeC){
-                      case 'w': //forwards
-                          Motor_Forward(speed,speed);
-                          //Clock_Delay1ms(1000);
-                          break;
-                      case 'a': //turn left
-                          Motor_Left(speed,0);
-                          //Clock_Delay1ms(1000);
-                          break;
-                      case 'd': //turn right
-                          Motor_Right(0,speed);
-                          //Clock_Delay1ms(1000);
-                          break;
-                      case 'x': //backwards
-                          Motor_Backward(speed,speed);
-                          //Clock_Delay1ms(1000);
-                          break;
-                      case 's': //stop
-                          Motor_Stop();
-                          break;
-                      case 'q': //accelerate
-                          speed *= 1.2;
-                          break;
-                      case 'z': //decelerate
-                          speed *= 0.8;
-                          break;
-                  }
-
-//                  default:
-//                     break;
-                }
-                menu = 1;
-                cmd=0xDEAD;
-                break;
-
-          case 7:           //Advanced Topic2: Obstacle Avoidance
-                EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutString("Selected: Obstacle Avoidance"); EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-                EUSCIA0_OutChar(CR); EUSCIA0_OutChar(LF);
-
-                //int32_t loopCounter;  //for inner loop: collects IR sensor data
-                Clock_Init48MHz();
-                IRSensor_Init();
-
-                while(LaunchPad_Input()==0){
-
-                    Motor_Forward(speed,speed);
-
-                    EnableInterrupts();
-                    int32_t loopCounter = 0;
-                    for(loopCounter = 0; loopCounter < 2000; loopCounter++){    //duration specified bz loopCounter, wait for ADCflag to become non-zero (indication that it has processed the data)
-                          while(ADCflag == 0){};
-                          ADCflag = 0;
-                        }
-                    UART0_OutUDec5(LeftConvert(nl));UART0_OutString(" mm,");      //LeftConvert converts the raw sensor data into distance measurements in mm
-                    UART0_OutUDec5(CenterConvert(nc));UART0_OutString(" mm,");    //UART0_OutDec5 displays the IR sensor readings on the terminal
-                    UART0_OutUDec5(RightConvert(nr));UART0_OutString(" mm\r\n");
-
-                    if(LeftConvert(nl) < 80){
-                        Motor_Stop();
-                        Motor_Backward(speed,speed);
-                        Clock_Delay1ms(250);
-                        Motor_Stop();
-                        Motor_Right(0,speed);
-                        Clock_Delay1ms(500);
-                    }
-                    else if(CenterConvert(nc) < 80){
-                        Motor_Stop();
-                        Motor_Backward(speed,speed);
-                        Clock_Delay1ms(250);
-                        Motor_Stop();
-                        Motor_Right(0,speed);
-                        Clock_Delay1ms(250);
-                    }
-                    else if(RightConvert(nr) < 80){
-                        Motor_Stop();
-                        Motor_Backward(speed,speed);
-                        Clock_Delay1ms(250);
-                        Motor_Stop();
-                        Motor_Left(0,speed);
-                        Clock_Delay1ms(500);
-                    }
-                }
-
-                menu = 1;
-                cmd=0xDEAD;
-                break;
-
-              // ....
-              // ....
-
-          default:
-              menu=1;
-              break;
-      }
-
-      if(!menu)Clock_Delay1ms(3000);
-      else{
-          menu=0;
-      }
-
-      // ....
-      // ....
+  EUSCIA0_OutString("RSLK Testing, type help"); NewLine();
+  Shell_Init(Commands, sizeof(Commands)/sizeof(Commands[0]), &EUSCIA0_OutChar);
+  while(1){
+      Shell_Poll(&EUSCIA0_InCharNonBlock);
+      Shell_Run(Millis());
+      Battery_Poll();   // low-battery LED and the battery LOG records
   }
 }
 
@@ -77,13 +77,14 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/Bump.h"
 #include "../inc/UART0.h"
 #include "../inc/SysTickInts.h"
+#include "../inc/Bits.h"
 
 
-#define P2_4 (*((volatile uint8_t *)(0x42098070)))
-#define P2_3 (*((volatile uint8_t *)(0x4209806C)))
-#define P2_2 (*((volatile uint8_t *)(0x42098068)))
-#define P2_1 (*((volatile uint8_t *)(0x42098064)))
-#define P2_0 (*((volatile uint8_t *)(0x42098060)))
+#define P2_4 BITS_BAND(&P2->OUT, 4)
+#define P2_3 BITS_BAND(&P2->OUT, 3)
+#define P2_2 BITS_BAND(&P2->OUT, 2)
+#define P2_1 BITS_BAND(&P2->OUT, 1)
+#define P2_0 BITS_BAND(&P2->OUT, 0)
 
 //#define PERIOD 1000  // must be even
 
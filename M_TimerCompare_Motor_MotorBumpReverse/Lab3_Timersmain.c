@@ -68,6 +68,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "..\inc\Reflectance.h"
 #include "../inc/Tachometer.h"
 #include "../inc/TA3InputCapture.h"
+#include "../inc/Bits.h"
 
 
 volatile uint8_t bumpState;
@@ -84,8 +85,8 @@ void TimedPause(uint32_t time){
 }
 
 // Test of Periodic interrupt
-#define REDLED (*((volatile uint8_t *)(0x42098060)))
-#define BLUELED (*((volatile uint8_t *)(0x42098068)))
+#define REDLED BITS_BAND(&P2->OUT, 0)
+#define BLUELED BITS_BAND(&P2->OUT, 2)
 uint32_t Time;
 
 void Task(void){
@@ -145,6 +146,7 @@ int main(void){
     LaunchPad_Init(); // built-in switches and LEDs
     Bump_Init();      // bump switches
     Motor_Init();     // your function
+    Motor_SetSlew(MOTOR_SLEW,MOTOR_DEADTIME);   // ramp into the reverse instead of slamming the gearbox
     TExaS_Init(LOGICANALYZER_P2);
     bumpState = 0x3F;           // FB: to prevent the motor to stop immediately, because the initial value of bumpState is 0x00 otherwise.
     TimerA1_Init(&Task,50000);  // 10 Hz
@@ -122,6 +122,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/ADC14.h"
+#include "../inc/CortexM.h"
 
 //**********software below is part of Lab 4**************
 // P4.1 = A12
@@ -273,3 +274,116 @@ void ADC_In17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16){
 
 }
 
+// P9.0 = A17, P4.1 = A12, P9.1 = A16 as above
+// P6.1 = A14 battery divider, last in the sequence
+void ADC0_InitSWTriggerCh17_12_16_14(void){
+    ADC0_InitSWTriggerCh17_12_16();  // 1-9) IR sensors in ADC14MEM0-2
+    while(ADC14->CTL0&0x00010000){}; // wait for BUSY to be zero
+    ADC14->CTL0 &= ~0x00000002;      // ADC14ENC = 0 to allow programming
+    ADC14->MCTL[2] = 0x00000010;     // 0 to 3.3V, channel 16, not end of sequence
+    ADC14->MCTL[3] = 0x0000008E;     // 0 to 3.3V, channel 14 (battery), end of sequence
+    // 7    ADC14EOS    End of sequence         1b = End of sequence
+    // 4-0  ADC14INCHx  Input channel        01110b = A14, P6.1
+    P6->SEL1 |= 0x02;                // analog mode on P6.1/A14
+    P6->SEL0 |= 0x02;
+    ADC14->CTL0 |= 0x00000002;       // enable
+}
+
+// ADC14IFGR0 bit 3 is set when the sequence is done
+void ADC_In17_12_16_14(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16, uint32_t *ch14){
+    while(ADC14->CTL0&0x00010000){}; // 1) wait for BUSY to be zero
+    ADC14->CTL0 |= 0x00000001;       // 2) start single conversion
+    while((ADC14->IFGR0&0x08) == 0){}; // 3) wait for ADC14IFG3
+    *ch17 = ADC14->MEM[0];           // 4) P9.0/A17 result 0 to 16383
+    *ch12 = ADC14->MEM[1];           //    P4.1/A12 result 0 to 16383
+    *ch16 = ADC14->MEM[2];           //    P9.1/A16 result 0 to 16383
+    *ch14 = ADC14->MEM[3];           //    P6.1/A14 result 0 to 16383
+}
+
+//**************window comparator**************
+// ADC14LO0/ADC14HI0 threshold set 0, ADC14MCTLx bit 14 ADC14WINC
+// ADC14IER1/ADC14IFGR1/ADC14CLRIFGR1
+//   bit 3 ADC14HIIFG result > ADC14HI0
+//   bit 2 ADC14LOIFG result < ADC14LO0
+//   bit 1 ADC14INIFG ADC14LO0 <= result <= ADC14HI0 (not used)
+// the flags are set by every compared conversion whether enabled or not,
+// so stale ones are cleared before switching from HI to LO and back
+#define WINDOW_HI 0x08
+#define WINDOW_LO 0x04
+void (*WindowTask)(uint32_t near);   // user function
+static volatile uint32_t WindowIsNear;
+
+// ADC14ENC must be 0 to change MCTL and the thresholds, so wait for the
+// sequence in progress inside a critical section (the timer that starts
+// conversions can not run meanwhile) and enable again afterwards
+static void windowWrite(uint32_t mem, uint32_t lo, uint32_t hi){
+    long sr = StartCritical();
+    while(ADC14->CTL0&0x00010000){}; // wait for BUSY to be zero
+    ADC14->CTL0 &= ~0x00000002;      // ADC14ENC = 0 to allow programming
+    if(mem < 32){
+        ADC14->MCTL[mem] = (ADC14->MCTL[mem]&~0x00008000)|0x00004000;
+        // 15   ADC14WINCTH Window comp threshold   0b = ADC14HI0/ADC14LO0
+        // 14   ADC14WINC   Comparator enable       1b = Comparator enabled
+    }
+    ADC14->LO0 = lo;                 // 14-bit, same format as the result
+    ADC14->HI0 = hi;
+    ADC14->CTL0 |= 0x00000002;       // enable
+    EndCritical(sr);
+}
+
+// ------------ADC_WindowInit------------
+// Interrupt when ADC14MEMx goes above hi, then when it falls below lo
+// Input: mem  ADC14MEMx index, e.g. 1 for P4.1/A12 in the 17,12,16 sequence
+//        lo   low threshold 0 to 16383
+//        hi   high threshold 0 to 16383, lo <= hi
+//        task user function, called with 1 above hi and 0 below lo
+// Output: none
+void ADC_WindowInit(uint32_t mem, uint32_t lo, uint32_t hi, void(*task)(uint32_t near)){
+    WindowTask = task;
+    WindowIsNear = 0;
+    ADC14->IER1 &= ~0x0E;
+    windowWrite(mem, lo, hi);
+    ADC14->CLRIFGR1 = 0x0E;          // old results do not count
+    ADC14->IER1 |= WINDOW_HI;        // far, wait for the result to go above hi
+    NVIC->IP[6] = (NVIC->IP[6]&0xFFFFFF00)|0x00000020; // priority 1, above the priority 2 sampling timer
+    NVIC->ISER[0] = 0x01000000;      // enable interrupt 24 in NVIC
+}
+
+// ------------ADC_WindowSet------------
+// Change the thresholds, the near/far state is kept
+// Input: lo low threshold, hi high threshold, lo <= hi
+// Output: none
+void ADC_WindowSet(uint32_t lo, uint32_t hi){
+    windowWrite(32, lo, hi);         // 32 leaves MCTL as it is
+}
+
+// ------------ADC_WindowStop------------
+// Turn off the window comparator interrupt
+// Input: none
+// Output: none
+void ADC_WindowStop(void){
+    ADC14->IER1 &= ~0x0E;
+    NVIC->ICER[0] = 0x01000000;      // disable interrupt 24 in NVIC
+    WindowIsNear = 0;
+}
+
+// ------------ADC_WindowNear------------
+// Input: none
+// Output: 1 if the last crossing was above hi, 0 otherwise
+uint32_t ADC_WindowNear(void){
+    return WindowIsNear;
+}
+
+void ADC14_IRQHandler(void){
+    uint32_t flags = ADC14->IFGR1&ADC14->IER1;
+    ADC14->CLRIFGR1 = 0x0E;          // acknowledge, including the disabled flag
+    if(flags&WINDOW_HI){
+        ADC14->IER1 = (ADC14->IER1&~WINDOW_HI)|WINDOW_LO;
+        WindowIsNear = 1;
+        (*WindowTask)(1);            // execute user task
+    }else if(flags&WINDOW_LO){
+        ADC14->IER1 = (ADC14->IER1&~WINDOW_LO)|WINDOW_HI;
+        WindowIsNear = 0;
+        (*WindowTask)(0);
+    }
+}
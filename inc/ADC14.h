@@ -12,6 +12,7 @@
  * - sample P4.6/A7 and P4.7/A6 <br>
  * - sample just P4.1/A12 <br>
  * - sample P9.0/A17, P4.1/A12, and P9.1/A16<br>
+ * - sample the same three and the battery divider on P6.1/A14<br>
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -113,6 +114,23 @@ void ADC0_InitSWTriggerCh12(void);
  */
 void ADC0_InitSWTriggerCh17_12_16(void);
 
+/**
+ * Initialize 14-bit ADC0 in software-triggered mode to take
+ * measurements when the associated function is called.  These
+ * channels are measured:<br>
+ * - Sample P9.0/A17(first)<br>
+ * - Sample P4.1/A12<br>
+ * - Sample P9.1/A16<br>
+ * - Sample P6.1/A14(last), the battery divider
+ * @param none
+ * @return none
+ * @note  The 3.3V analog supply is used as reference.  The IR
+ *        results stay in ADC14MEM0-2, so the window comparator
+ *        works the same as after ADC0_InitSWTriggerCh17_12_16().
+ * @brief  Initialize 14-bit ADC0
+ */
+void ADC0_InitSWTriggerCh17_12_16_14(void);
+
 /**
  * Trigger a single ADC measurement on P4.7/A6,
  * wait for it to complete, and return the 14-bit result
@@ -174,4 +192,71 @@ uint32_t ADC_In12(void);
  */
 void ADC_In17_12_16(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16);
 
+/**
+ * Trigger a single ADC measurement on P9.0/A17, P4.1/A12,
+ * P9.1/A16 and P6.1/A14, wait for it to complete, and put the
+ * results in the pointers given.
+ * Busy-wait synchronization used.
+ * The ADC input voltage range is 0 to 3.3V.
+ * @param ch17 is a pointer to store 32-bit P9.0/A17 conversion result<br>
+ * @param ch12 is a pointer to store 32-bit P4.1/A12 conversion result<br>
+ * @param ch16 is a pointer to store 32-bit P9.1/A16 conversion result<br>
+ * @param ch14 is a pointer to store 32-bit P6.1/A14 conversion result
+ * @return none
+ * @note  Assumes ADC0_InitSWTriggerCh17_12_16_14() has been called.
+ * @brief  Trigger ADC measurement on channels 17+12+16+14 and wait for result.
+ */
+void ADC_In17_12_16_14(uint32_t *ch17, uint32_t *ch12, uint32_t *ch16, uint32_t *ch14);
+
+/**
+ * Turn on the window comparator for one ADC14MEMx result, so the
+ * hardware checks every conversion against two thresholds and
+ * interrupts as soon as the result leaves the window, without
+ * waiting for the software filter or the main loop.<br>
+ * The comparator has hysteresis: while the input is "far" only the
+ * high threshold interrupts (result above hi), after that only the
+ * low threshold (result below lo) does, so a result wandering inside
+ * lo..hi calls the task once per crossing, not once per sample.
+ * The task runs in the ADC14 interrupt at priority 1, above the
+ * priority 2 timer that starts the conversions.
+ * @param mem is the ADC14MEMx of the channel, e.g. 1 for P4.1/A12 after ADC0_InitSWTriggerCh17_12_16()<br>
+ * @param lo is the low threshold 0 to 16383, a result below it is "far" again<br>
+ * @param hi is the high threshold 0 to 16383, lo <= hi, a result above it is "near"<br>
+ * @param task is the user function, called with 1 when the result goes above hi
+ *        and with 0 when it falls below lo
+ * @return none
+ * @note  Call after the ADC initialization.  The sampling keeps its own
+ *        busy-wait, the window only adds the interrupt.
+ * @brief  Interrupt when an ADC result crosses a threshold.
+ */
+void ADC_WindowInit(uint32_t mem, uint32_t lo, uint32_t hi, void(*task)(uint32_t near));
+
+/**
+ * Change the thresholds of the window comparator.  The state
+ * ("near" or "far") is kept, the next conversion is compared to the
+ * new values.
+ * @param lo is the low threshold 0 to 16383<br>
+ * @param hi is the high threshold 0 to 16383, lo <= hi
+ * @return none
+ * @note  Assumes ADC_WindowInit() has been called.
+ * @brief  Move the window comparator thresholds.
+ */
+void ADC_WindowSet(uint32_t lo, uint32_t hi);
+
+/**
+ * Turn off the window comparator interrupt.
+ * @param none
+ * @return none
+ * @brief  Stop the window comparator.
+ */
+void ADC_WindowStop(void);
+
+/**
+ * Current state of the window comparator.
+ * @param none
+ * @return 1 if the last crossing was above hi, 0 otherwise
+ * @brief  Window comparator state.
+ */
+uint32_t ADC_WindowNear(void);
+
 #endif /* ADC14_H_ */
@@ -68,6 +68,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 // see GPIO.c file for hardware connections 
 
 #include <stdint.h>
+#include <string.h>
 #include "../inc/CortexM.h"
 #include "../inc/UART0.h"
 #include "../inc/UART1.h"
@@ -75,6 +76,8 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/Clock.h"
 #include "msp.h"
 #include "../inc/GPIO.h"
+#include "../inc/Log.h"
+#include "../inc/NPI.h"
 
 
 #define RECVSIZE 128
@@ -82,13 +85,25 @@ uint8_t RecvBuf[RECVSIZE];
 
 uint32_t fcserr;      // debugging counts of errors
 uint32_t TimeOutErr;  // debugging counts of no response errors
-uint32_t NoSOFErr;    // debugging counts of no SOF errors
+uint32_t NoSOFErr;    // debugging counts of frames cut short by SRDY
+
+#define NOTIFYQSIZE 8     // must be power of 2, larger than AP_PIPELINE
+uint8_t NotifyQ[NOTIFYQSIZE]; // characteristic index of each notification waiting for an answer
+uint32_t NotifyPutI, NotifyGetI;
+uint32_t NotifyRejects;  // notifications the SNP answered with an error (queue full)
+uint32_t NotifyStalls;   // times pending notifications were given up as lost
+uint32_t NotifyBusy;     // calls to AP_NotifyData since the SNP last answered
+void (*NotifyAnswer)(uint32_t i, uint8_t status); // see AP_SetNotifyAnswer
 
 #define APTIMEOUT 40000   // 10 ms
 /* If you define APDEBUG then all LP-SNP traffic is displayed on UART0.
    If you do not define APDEBUG then no UART0 output is performed, and thus it runs faster.
+   If you define APLOG instead, the command and size of each message are recorded
+   with Log.h; the project must then link Log.c, call Log_Init and Log_Flush, and
+   have the .logstr section in its msp432p401r.cmd (see Log.h).
  */
-#define APDEBUG 1
+//#define APDEBUG 1
+//#define APLOG 1
 //**debug macros**********
 #ifdef APDEBUG
 #define OutString(STRING) UART0_OutString(STRING)
@@ -267,9 +282,12 @@ int AP_Init(void){int bwaiting;   int count = 0;
   UART0_OutString("\n\rReset CC2650");
 #endif
   UART1_Init();
+  NPI_Init();     // UART1 RX and SRDY now interrupt driven
   fcserr = 0;     // number of packets with FCS errors
   TimeOutErr = 0; // debugging counts of no response error
   NoSOFErr =0 ;   // debugging counts of no SOF error
+  NotifyPutI = NotifyGetI = 0;
+  NotifyRejects = NotifyStalls = NotifyBusy = 0;
   bwaiting = 1; // waiting for reset
   while(bwaiting){
     AP_Reset();
@@ -349,6 +367,11 @@ void AP_EchoReceived(int response){ uint32_t size; int i;
     OutString("\n\rfrom SNP fail");
   }
 }
+#elif defined(APLOG)
+#define AP_EchoSendMessage(MESSAGE) LOG3(LOG_DEBUG, "LP->SNP %02X%02X size %u", \
+  (MESSAGE)[3], (MESSAGE)[4], AP_GetSize(MESSAGE))
+#define AP_EchoReceived(R) LOG4(LOG_DEBUG, "SNP->LP %02X%02X size %u result %d", \
+  RecvBuf[3], RecvBuf[4], AP_GetSize(RecvBuf), R)
 #else
 #define AP_EchoSendMessage(MESSAGE)
 #define AP_EchoReceived(R)
@@ -362,41 +385,19 @@ void AP_EchoReceived(int response){ uint32_t size; int i;
 // Input: pointer to NPI encoded array
 // Output: APOK on success, APFAIL on timeout
 int AP_SendMessage(uint8_t *pt){
-  uint8_t fcs; uint32_t waitCount; uint8_t data; uint32_t size;
-// 1) Make MRDY=0
-  ClearMRDY();
-// 2) wait for SRDY to be low
-  waitCount = 0;
-  while(ReadSRDY()){
-    waitCount++;
-    if(waitCount>APTIMEOUT){
-      TimeOutErr++;  // no response error
-      return APFAIL; // timeout??
-    } 
-  }
-// 3) Send NPI package
-  size = AP_GetSize(pt);
-  fcs=0;
-  UART1_OutChar(SOF); pt++;
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // LSB length
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // MSB length
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // CMD0
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // CMD1
-  for(int i=0;i<size;i++){
-    data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++; // payload
+  uint32_t waitCount;
+// 1) queue NPI package, the handshake runs in the SRDY and UART1 ISRs
+  if(NPI_Send(pt)){
+    TimeOutErr++;    // queue full, link is stuck
+    return APFAIL;
   }
-  UART1_OutChar(fcs);                                  // FCS
-  
-// 4) Wait for entire message to be sent
-  UART1_FinishOutput();
-// 5) Make MRDY=1
-  SetMRDY();        //   MRDY=1  
-// 6) wait for SRDY to be high
+// 2) wait for entire message to be sent and SRDY to be high
   waitCount = 0;
-  while(ReadSRDY()==0){
+  while(NPI_TxIdle()==0){
     waitCount++;
-    if(waitCount>APTIMEOUT){
+    if(waitCount>3*APTIMEOUT){
       TimeOutErr++;  // no response error
+      NPI_Abort();
       return APFAIL; // timeout??
     } 
   }
@@ -407,74 +408,35 @@ int AP_SendMessage(uint8_t *pt){
   
 //------------AP_RecvMessage------------
 // receive a message from the Bluetooth module
-// 1) receive NPI package
-// 2) Wait for entire message to be received
+// 1) wait for the UART1 ISR to finish an NPI package
+// 2) copy it out of the receive queue
 // Input: pointer to empty buffer into which data is returned
 //        maximum size (discard data beyond this limit)
-// Output: APOK if ok, APFAIL on error (timeout or fcs error)
+// Output: APOK if ok, APFAIL on timeout
+// Note: frames with bad FCS never reach the queue, see fcserr
 int AP_RecvMessage(uint8_t *pt, uint32_t max){
-  uint8_t fcs; uint32_t waitCount; uint8_t data,cmd0,cmd1; 
-  uint8_t msb,lsb;
-  uint32_t size,count,SOFcount=10;
-// 1) wait for SRDY to be low
+  uint32_t waitCount,i; NPIStats_t stats;
   waitCount = 0;
-  while(ReadSRDY()){
+  while(NPI_Receive(pt,max)==0){
     waitCount++;
-    if(waitCount>APTIMEOUT){
+    if(waitCount>4*APTIMEOUT){
       TimeOutErr++;  // no response error
       return APFAIL; // timeout??
-    }      
-  }
-// 2) Make MRDY=0
-  ClearMRDY();
-// 3) receive NPI package
-  // wait for SOF
-  do{
-    data = UART1_InChar();
-    SOFcount--;
-    if(SOFcount==0){
-      SetMRDY();     //   MRDY=1  
-      NoSOFErr++;    // no SOF error
-      return APFAIL;
-    }
-  }while(data != SOF);
-  *pt = data; pt++;
-  fcs = 0;
-// get size, once we get SOF, it is highly likely for the rest to come
-  lsb = UART1_InChar(); *pt = lsb; fcs=fcs^lsb; pt++;
-  msb = UART1_InChar(); *pt = msb; fcs=fcs^msb; pt++;
-// get command
-  cmd0 = UART1_InChar(); *pt = cmd0; fcs=fcs^cmd0; pt++;
-  cmd1 = UART1_InChar(); *pt = cmd1; fcs=fcs^cmd1; pt++;
-  count = 5;
-  size = (msb<<8)+lsb;
-// get payload
-  for(int i=0;i<size;i++){
-    data = UART1_InChar(); 
-    fcs = fcs^data; 
-    count++;
-    if(count <= max){
-      *pt = data; 
-      pt++; // payload
     }
   }
-// get FCB
-  data = UART1_InChar(); 
-  count++;
-  if(count <= max){
-    *pt = data; 
-  }    
-  if(data != fcs){ 
-    fcserr++;
-    SetMRDY();        //   MRDY=1  
-    return APFAIL;
-  }
-// 4) Make MRDY=1
-  SetMRDY();        //   MRDY=1  
-// 5) wait for SRDY to be high
-  waitCount = 0;
-  while(ReadSRDY()==0){
-    waitCount++;
+  NPI_GetStats(&stats);
+  fcserr = stats.FcsErr;
+  NoSOFErr = stats.Truncated;
+  if((pt[3]==0x55)&&(pt[4]==0x89)){ // SNP Send Notification Indication response
+    NotifyBusy = 0;
+    if(pt[5]) NotifyRejects++;      // SNP could not queue it
+    if(NotifyGetI != NotifyPutI){   // answers come back in order
+      i = NotifyQ[NotifyGetI];
+      NotifyGetI = (NotifyGetI+1)&(NOTIFYQSIZE-1);
+      if(NotifyAnswer){
+        (*NotifyAnswer)(i,pt[5]);
+      }
+    }
   }
   return APOK;
 }
@@ -485,7 +447,7 @@ int AP_RecvMessage(uint8_t *pt, uint32_t max){
 // Outputs: 0 if no communication needed, 
 //          nonzero for communication ready 
 uint32_t AP_RecvStatus(void){
-  return (ReadSRDY()==0);
+  return NPI_Available();
 }
 
 //------------AP_SendMessageResponse------------
@@ -530,7 +492,7 @@ typedef struct characteristics{
   void (*callBackRead)(void);  // action if SNP Characteristic Read Indication
   void (*callBackWrite)(void); // action if SNP Characteristic Write Indication
 }characteristic_t;
-#define MAXCHARACTERISTICS 10
+#define MAXCHARACTERISTICS 32
 uint32_t CharacteristicCount=0;
 characteristic_t CharacteristicList[MAXCHARACTERISTICS];
 typedef struct NotifyCharacteristics{
@@ -542,10 +504,88 @@ typedef struct NotifyCharacteristics{
   uint8_t *pt;                 // pointer to user data array, stored little endian
   void (*callBackCCCD)(void);  // action if SNP CCCD Updated Indication
 }NotifyCharacteristic_t;
-#define NOTIFYMAXCHARACTERISTICS 4
+#define NOTIFYMAXCHARACTERISTICS 8
 uint32_t NotifyCharacteristicCount=0;
 NotifyCharacteristic_t NotifyCharacteristicList[NOTIFYMAXCHARACTERISTICS];
 
+// Handle to list index, filled in as characteristics are added, so
+// AP_BackgroundProcess does not search the lists.  SNP assigns small
+// handles in order; handles beyond the table are searched for.
+// 0 means no entry, 1 to MAXCHARACTERISTICS is CharacteristicList[n-1],
+// HANDLECCCD+n is the CCCD of NotifyCharacteristicList[n].
+#define HANDLETABLE 256
+#define HANDLECCCD 0x80
+uint8_t HandleIndex[HANDLETABLE];
+
+static void mapHandle(uint16_t h, uint8_t entry){
+  if(h<HANDLETABLE){
+    HandleIndex[h] = entry;
+  }
+}
+static uint32_t findHandle(uint16_t h){ uint32_t i;
+  if(h<HANDLETABLE){
+    return HandleIndex[h];
+  }
+  for(i=0; i<CharacteristicCount; i++){
+    if(CharacteristicList[i].theHandle == h) return i+1;
+  }
+  for(i=0; i<NotifyCharacteristicCount; i++){
+    if(NotifyCharacteristicList[i].CCCDhandle == h) return HANDLECCCD+i;
+  }
+  return 0;
+}
+
+// copy s bytes reversing their order, SNP data is big endian and user data little endian
+// 4 and 8 bytes move as words with REV; memcpy of a word compiles to a single
+// unaligned LDR/STR on the Cortex-M4, and unlike a uint32_t cast it is defined
+// for any buffer alignment and cannot be merged into an LDRD/LDM that faults
+static void reverseCopy(uint8_t *dst, const uint8_t *src, uint32_t s){ uint32_t j, lo, hi;
+  switch(s){
+    case 1: dst[0] = src[0]; break;
+    case 2: dst[0] = src[1]; dst[1] = src[0]; break;
+    case 4:
+      memcpy(&lo, src, 4);
+      lo = __REV(lo);
+      memcpy(dst, &lo, 4);
+      break;
+    case 8:
+      memcpy(&lo, src, 4);
+      memcpy(&hi, src+4, 4);
+      hi = __REV(hi);
+      lo = __REV(lo);
+      memcpy(dst, &hi, 4);
+      memcpy(dst+4, &lo, 4);
+      break;
+    default:
+      for(j=0; j<s; j++){
+        dst[j] = src[s-j-1];
+      }
+  }
+}
+
+//*********AP_SetCharacteristicData*******
+// Point a read/write characteristic at another user buffer, no data is copied
+// e.g., fill one buffer while the phone reads the other, then swap
+// Inputs:  i is index into characteristics, in the order they were added
+//          pt is the new user data, same size, stored little endian
+// Outputs: APOK if successful, APFAIL if i is not valid
+int AP_SetCharacteristicData(uint32_t i, void *pt){
+  if(i>=CharacteristicCount) return APFAIL;
+  CharacteristicList[i].pt = (uint8_t *) pt;
+  return APOK;
+}
+
+//*********AP_SetNotifyData*******
+// Point a notify characteristic at another user buffer, no data is copied
+// Inputs:  i is index into notify characteristics, in the order they were added
+//          pt is the new user data, same size, stored little endian
+// Outputs: APOK if successful, APFAIL if i is not valid
+int AP_SetNotifyData(uint32_t i, void *pt){
+  if(i>=NotifyCharacteristicCount) return APFAIL;
+  NotifyCharacteristicList[i].pt = (uint8_t *) pt;
+  return APOK;
+}
+
 
 //*********AP_GetNotifyCCCD*******
 // Return notification CCCD from the communication interface
@@ -595,7 +635,7 @@ int AP_RegisterService(void){ int r;
 //        (*ReadFunc) called before it responses with data from internal structure
 //        (*WriteFunc) called after it accepts data into internal structure
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 8 characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 32 characteristics, or if SNP failure
 int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t permission,
   uint8_t properties, char name[], void(*ReadFunc)(void), void(*WriteFunc)(void)){
   int r; uint16_t handle; int i;
@@ -628,6 +668,7 @@ int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t perm
   r=AP_SendMessageResponse((uint8_t*)NPI_AddCharDescriptor,RecvBuf,RECVSIZE);
   if(r == APFAIL) return APFAIL;
   CharacteristicList[CharacteristicCount].theHandle = handle;
+  mapHandle(handle, CharacteristicCount+1);
   CharacteristicList[CharacteristicCount].size = thesize;
   CharacteristicList[CharacteristicCount].pt = (uint8_t *) pt;
   CharacteristicList[CharacteristicCount].callBackRead = ReadFunc;
@@ -645,11 +686,11 @@ int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t perm
 //        name is a null-terminated string, maximum length of name is 20 bytes
 //        (*CCCDfunc) called after it accepts , changing CCCDvalue
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 4 notify characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 8 notify characteristics, or if SNP failure
 int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize, void *pt,   
   char name[], void(*CCCDfunc)(void)){
   int r; uint16_t handle; int i;
-  if(thesize>8) return APFAIL;
+  if(thesize>8) return APFAIL;   // 0 means AP_NotifyData only
   if(NotifyCharacteristicCount>=NOTIFYMAXCHARACTERISTICS) return APFAIL; // error
   NPI_AddCharValue[3] = 0x35;   // SNP Add Characteristic Value Declaration
   NPI_AddCharValue[4] = 0x82;  
@@ -680,6 +721,7 @@ int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize, void *pt,
   NotifyCharacteristicList[NotifyCharacteristicCount].uuid = uuid;
   NotifyCharacteristicList[NotifyCharacteristicCount].theHandle = handle;
   NotifyCharacteristicList[NotifyCharacteristicCount].CCCDhandle = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this CCCD
+  mapHandle(NotifyCharacteristicList[NotifyCharacteristicCount].CCCDhandle, HANDLECCCD+NotifyCharacteristicCount);
   NotifyCharacteristicList[NotifyCharacteristicCount].CCCDvalue = 0; // notify initially off
   NotifyCharacteristicList[NotifyCharacteristicCount].size = thesize;
   NotifyCharacteristicList[NotifyCharacteristicCount].pt = (uint8_t *) pt;
@@ -693,28 +735,105 @@ int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize, void *pt,
 // Input:  index into notify characteristic to send
 // Output: APOK if successful,
 //         APFAIL if notification not configured, or if SNP failure
-int AP_SendNotification(uint32_t i){ uint16_t handle; uint32_t j;uint8_t thedata;
-  int r1; uint32_t s;
+int AP_SendNotification(uint32_t i){ uint16_t handle; uint32_t j;
+  int r1; uint32_t s, put;
   if(i>= NotifyCharacteristicCount) return APFAIL;   // not valid
+  if(NotifyCharacteristicList[i].size == 0) return APFAIL; // stream, use AP_NotifyData
   if(NotifyCharacteristicList[i].CCCDvalue){         // send only if active
     handle = NotifyCharacteristicList[i].theHandle;
     if(handle == 0) return APFAIL; // not open   
     NPI_SendNotificationIndication[1] = 6+NotifyCharacteristicList[i].size;      // 1 to 8 bytes 
     OutString("\n\rSend data=");
     s = NotifyCharacteristicList[i].size;
+    reverseCopy(&NPI_SendNotificationIndication[11],NotifyCharacteristicList[i].pt,s); // user little endian to SNP big endian
     for(j=0; j<s; j++){
-      thedata = NotifyCharacteristicList[i].pt[s-j-1]; // fetch data from user little endian to SNP big endian
-      OutUHex(thedata); OutString(", ");      
-      NPI_SendNotificationIndication[11+j] = thedata;    // copy into message, big endian
+      OutUHex(NPI_SendNotificationIndication[11+j]); OutString(", ");      
     }
     NPI_SendNotificationIndication[7] = handle&0x0FF; // handle
     NPI_SendNotificationIndication[8] = handle>>8; 
+    if(((NotifyPutI+1)&(NOTIFYQSIZE-1)) == NotifyGetI) return APFAIL; // answers lost
+    put = NotifyPutI;         // queued first, the answer arrives inside the call below
+    NotifyQ[put] = i;         // answer is matched by AP_RecvMessage
+    NotifyPutI = (put+1)&(NOTIFYQSIZE-1);
     r1=AP_SendMessageResponse(NPI_SendNotificationIndication,RecvBuf,RECVSIZE);
+    if((r1 == APFAIL)&&(((put-NotifyGetI)&(NOTIFYQSIZE-1)) < ((NotifyPutI-NotifyGetI)&(NOTIFYQSIZE-1)))){
+      NotifyPutI = put;       // not answered, take it back so it cannot match a later answer
+    }
   }else{
     r1 = APOK; // no need to notify
   }
   return r1; // OK or fail depending on SendNotificationIndication
 }
+
+//*************AP_AddStreamCharacteristic**************
+// Add a notify characteristic for AP_NotifyData, with no user data
+// Inputs uuid is 0xFFF0, 0xFFF1, ...
+//        name is a null-terminated string, maximum length of name is 20 bytes
+//        (*CCCDfunc) called after it accepts , changing CCCDvalue
+// Output APOK if successful,
+//        APFAIL if name is empty, more than 8 notify characteristics, or if SNP failure
+int AP_AddStreamCharacteristic(uint16_t uuid, char name[], void(*CCCDfunc)(void)){
+  return AP_AddNotifyCharacteristic(uuid, 0, 0, name, CCCDfunc);
+}
+
+#define NOTIFYSTALL 100000 // busy calls with an idle link before pending answers are given up
+uint8_t NPI_StreamIndication[AP_STREAMMAX+12] = {
+  SOF,0x06,0x00,  // length = 6+data length, filled in dynamically
+  0x55,0x89,      // SNP Send Notification Indication (0x89))
+  0x00,0x00,      // handle of connection always 0
+  0x00,0x00,      // Handle of the characteristic value attribute to notify (filled in dynamically
+  0x00,           // RFU
+  0x01};          // Notification Request type, then data, then FCS (calculated by NPI_Send)
+//*************AP_NotifyData**************
+// Queue a notification of 1 to AP_STREAMMAX bytes without waiting for the SNP
+// Input:  i is index into notify characteristic
+//         pt points to the bytes, sent in order
+//         n is number of bytes
+// Output: APOK if queued, APBUSY if the SNP is full, APFAIL if not enabled
+int AP_NotifyData(uint32_t i, const uint8_t *pt, uint32_t n){ uint16_t handle; uint32_t j;
+  if(i>= NotifyCharacteristicCount) return APFAIL;   // not valid
+  if((n==0)||(n>AP_STREAMMAX)) return APFAIL;
+  if(NotifyCharacteristicList[i].CCCDvalue==0) return APFAIL; // phone is not listening
+  handle = NotifyCharacteristicList[i].theHandle;
+  if(handle == 0) return APFAIL; // not open
+  if(((NotifyPutI-NotifyGetI)&(NOTIFYQSIZE-1))>=AP_PIPELINE){
+    NotifyBusy++;
+    if((NotifyBusy>NOTIFYSTALL)&&NPI_TxIdle()&&(NPI_Available()==0)){
+      NotifyStalls++; // an answer was lost, do not wait forever
+      NotifyBusy = 0;
+      while(NotifyGetI != NotifyPutI){
+        j = NotifyQ[NotifyGetI];
+        NotifyGetI = (NotifyGetI+1)&(NOTIFYQSIZE-1);
+        if(NotifyAnswer){
+          (*NotifyAnswer)(j,0xFF);  // report as not sent
+        }
+      }
+    }
+    return APBUSY;
+  }
+  NPI_StreamIndication[1] = 6+n;
+  NPI_StreamIndication[7] = handle&0x0FF; // handle
+  NPI_StreamIndication[8] = handle>>8;
+  for(j=0; j<n; j++){
+    NPI_StreamIndication[11+j] = pt[j];
+  }
+  if(NPI_Send(NPI_StreamIndication)){
+    return APBUSY;   // NPI transmit queue full
+  }
+  NotifyQ[NotifyPutI] = i;
+  NotifyPutI = (NotifyPutI+1)&(NOTIFYQSIZE-1);
+  return APOK;
+}
+
+//*************AP_SetNotifyAnswer**************
+// Set a function to run when the SNP answers a notification
+// Input:  func is called from AP_RecvMessage with the notify characteristic
+//         index and the SNP status (0 ok, nonzero not sent, 0xFF answer lost),
+//         or 0 for none
+// Output: none
+void AP_SetNotifyAnswer(void(*func)(uint32_t i, uint8_t status)){
+  NotifyAnswer = func;
+}
 //*************AP_StartAdvertisement**************
 // Start advertisement
 // Input:  none
@@ -767,10 +886,14 @@ uint32_t AP_GetVersion(void){volatile int r;
 }
 // ****AP_BackgroundProcess****
 // handle incoming SNP frames
+// frames are already in the NPI receive queue, and confirmations are
+// queued with NPI_Send, so this returns without waiting on the SNP
 // Inputs:  none
 // Outputs: none
 void AP_BackgroundProcess(void){
-  int count; uint16_t h; int i,j;
+  int count; uint16_t h; int j;
+  uint32_t e; // entry in HandleIndex
+  characteristic_t *c; NotifyCharacteristic_t *n;
   uint32_t s; // size of user data 1,2,4,8
   uint32_t d; // difference between packet size and user data size
   uint8_t responseNeeded;
@@ -782,62 +905,55 @@ void AP_BackgroundProcess(void){
       if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x88)){// SNP Characteristic Write Indication (0x88)
         h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
         responseNeeded = RecvBuf[9];
-        i = 0;
-        while(i<MAXCHARACTERISTICS){
-          if(CharacteristicList[i].theHandle == h){
-            count = RecvBuf[1]-7;   // number of bytes in message
-            s = CharacteristicList[i].size;
+        e = findHandle(h);
+        if((e>0)&&(e<=CharacteristicCount)){
+          c = &CharacteristicList[e-1];
+          count = RecvBuf[1]-7;   // number of bytes in message
+          s = c->size;
+          if(count==s){
+            reverseCopy(c->pt,&RecvBuf[12],s);
+          }else{
             if(count>s)count=s;   // truncate to size
             d = s-count;
             for(j=0;j<s;j++){     // if message is smaller than size
-              CharacteristicList[i].pt[j] = 0; // fill MSbytes with 0
+              c->pt[j] = 0;       // fill MSbytes with 0
             }
             for(j=0;j<count;j++){ // write data
-              CharacteristicList[i].pt[s-j-1-d] = RecvBuf[12+j];
+              c->pt[s-j-1-d] = RecvBuf[12+j];
             }
-            (*CharacteristicList[i].callBackWrite)(); // process Characteristic Write Indication
-            i = MAXCHARACTERISTICS;
-          }else{
-            i++;
           }
+          (*c->callBackWrite)(); // process Characteristic Write Indication
         }
         if(responseNeeded){
-          AP_SendMessage(NPI_WriteConfirmation);
+          NPI_Send(NPI_WriteConfirmation);
           AP_EchoSendMessage(NPI_WriteConfirmation);
         }
       }
       if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x87)){// SNP Characteristic Read Indication (0x87)
         h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
-        i = 0;
-        while(i<MAXCHARACTERISTICS){
-          if(CharacteristicList[i].theHandle == h){
-            (*CharacteristicList[i].callBackRead)(); // process Characteristic Read Indication
-            NPI_ReadConfirmation[1] = 7+CharacteristicList[i].size;
-            s = CharacteristicList[i].size;
-            for(j=0;j<s;j++){ // write data
-              NPI_ReadConfirmation[j+12]=CharacteristicList[i].pt[s-j-1];
-            }
-            i = MAXCHARACTERISTICS;
-          }else{
-            i++;
-          }
+        e = findHandle(h);
+        if((e>0)&&(e<=CharacteristicCount)){
+          c = &CharacteristicList[e-1];
+          (*c->callBackRead)(); // process Characteristic Read Indication
+          NPI_ReadConfirmation[1] = 7+c->size;
+          reverseCopy(&NPI_ReadConfirmation[12],c->pt,c->size); // write data
         }
         NPI_ReadConfirmation[8] = RecvBuf[7]; // handle
         NPI_ReadConfirmation[9] = RecvBuf[8]; 
-        AP_SendMessage(NPI_ReadConfirmation);
+        NPI_Send(NPI_ReadConfirmation);
         AP_EchoSendMessage(NPI_ReadConfirmation);
       }
       if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x8B)){// SNP CCCD Updated Indication (0x8B)
         h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
         responseNeeded = RecvBuf[9];
-        for(i=0; i<NOTIFYMAXCHARACTERISTICS;i++){
-          if(NotifyCharacteristicList[i].CCCDhandle == h){  // to do
-            NotifyCharacteristicList[i].CCCDvalue = (RecvBuf[11]<<8)+RecvBuf[10];
-            NotifyCharacteristicList[i].callBackCCCD();
-          }
+        e = findHandle(h);
+        if((e>=HANDLECCCD)&&(e<HANDLECCCD+NotifyCharacteristicCount)){
+          n = &NotifyCharacteristicList[e-HANDLECCCD];
+          n->CCCDvalue = (RecvBuf[11]<<8)+RecvBuf[10];
+          n->callBackCCCD();
         }
         if(responseNeeded){
-          AP_SendMessage(NPI_CCCDUpdatedConfirmation);
+          NPI_Send(NPI_CCCDUpdatedConfirmation);
           AP_EchoSendMessage(NPI_CCCDUpdatedConfirmation);
         }
       }        
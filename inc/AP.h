@@ -87,6 +87,18 @@ policies, either expressed or implied, of the FreeBSD Project.
  * return parameters for success
  */
 #define APOK   1
+/**
+ * return parameter when the SNP cannot take more data now, try again later
+ */
+#define APBUSY 2
+/**
+ * largest AP_NotifyData payload, ATT MTU of 23 less 3 bytes of header
+ */
+#define AP_STREAMMAX 20
+/**
+ * notifications sent to the SNP and not yet answered
+ */
+#define AP_PIPELINE 4
 
 
 /**
@@ -222,7 +234,7 @@ int AP_RegisterService(void);
 //        (*ReadFunc) called before it responses with data from internal structure
 //        (*WriteFunc) called after it accepts data into internal structure
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 8 characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 32 characteristics, or if SNP failure
 int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t permission,
   uint8_t properties, char name[], void(*ReadFunc)(void), void(*WriteFunc)(void));
 
@@ -230,12 +242,12 @@ int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t perm
 // Add a notify characteristic
 //        for read, write, or read/write characteristic, call AP_AddCharacteristic 
 // Inputs uuid is 0xFFF0, 0xFFF1, ...
-//        thesize is the number of bytes in the user data 1,2,4, or 8 
+//        thesize is the number of bytes in the user data 1,2,4, or 8 (0 for AP_NotifyData only)
 //        pt is a pointer to the user data, stored little endian
 //        name is a null-terminated string, maximum length of name is 20 bytes
 //        (*CCCDfunc) called after it accepts , changing CCCDvalue
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 4 notify characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 8 notify characteristics, or if SNP failure
 int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize,  void *pt, 
   char name[], void(*CCCDfunc)(void));
   
@@ -246,6 +258,51 @@ int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize,  void *pt,
 //         APFAIL if notification not configured, or if SNP failure
 int AP_SendNotification(uint32_t i);
 
+//*********AP_SetCharacteristicData*******
+// Point a read/write characteristic at another user buffer, no data is copied
+// e.g., fill one buffer while the phone reads the other, then swap
+// Inputs:  i is index into characteristics, in the order they were added
+//          pt is the new user data, same size, stored little endian
+// Outputs: APOK if successful, APFAIL if i is not valid
+int AP_SetCharacteristicData(uint32_t i, void *pt);
+
+//*********AP_SetNotifyData*******
+// Point a notify characteristic at another user buffer, no data is copied
+// Inputs:  i is index into notify characteristics, in the order they were added
+//          pt is the new user data, same size, stored little endian
+// Outputs: APOK if successful, APFAIL if i is not valid
+int AP_SetNotifyData(uint32_t i, void *pt);
+
+//*************AP_AddStreamCharacteristic**************
+// Add a notify characteristic for AP_NotifyData, with no user data
+// Inputs uuid is 0xFFF0, 0xFFF1, ...
+//        name is a null-terminated string, maximum length of name is 20 bytes
+//        (*CCCDfunc) called after it accepts , changing CCCDvalue
+// Output APOK if successful,
+//        APFAIL if name is empty, more than 8 notify characteristics, or if SNP failure
+int AP_AddStreamCharacteristic(uint16_t uuid, char name[], void(*CCCDfunc)(void));
+
+//*************AP_NotifyData**************
+// Queue a notification of 1 to AP_STREAMMAX bytes without waiting for the SNP
+// Up to AP_PIPELINE notifications may be outstanding; AP_BackgroundProcess
+// collects the answers, so it must be called often while streaming.
+// Input:  i is index into notify characteristic
+//         pt points to the bytes, sent in order (no byte reversal)
+//         n is number of bytes
+// Output: APOK if queued,
+//         APBUSY if AP_PIPELINE notifications are pending or the NPI transmit queue is full,
+//         APFAIL if notification not configured or not enabled by the phone
+int AP_NotifyData(uint32_t i, const uint8_t *pt, uint32_t n);
+
+//*************AP_SetNotifyAnswer**************
+// Set a function to run when the SNP answers a notification
+// The SNP answers in the order notifications were sent; a nonzero status
+// means that notification was not sent (0xFF if the answer never came).
+// Input:  func is called from AP_RecvMessage with the notify characteristic
+//         index and the SNP status, or 0 for none
+// Output: none
+void AP_SetNotifyAnswer(void(*func)(uint32_t i, uint8_t status));
+
 //*************AP_StartAdvertisement**************
 // Start advertisement
 // Input:  none
@@ -0,0 +1,200 @@
+/*
+ * Avoid.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Avoid.c
+// Reactive obstacle avoidance with a polar histogram
+
+/*
+// Example usage of Avoid, 100 Hz control from the 2 kHz IR sampling
+void Drive(int32_t left, int32_t right);    // signed duty to Motor_...
+AvoidCmd_t Cmd;
+
+  Avoid_Init(5000, 0);                      // go straight ahead
+  while(LaunchPad_Input()==0){
+    for(i=0; i<20; i++){                    // 10 ms
+      while(ADCflag == 0){};
+      ADCflag = 0;
+    }
+    Tachometer_Get(&lt, &ld, &ls, &rt, &rd, &rs);
+    Avoid_Update(LeftConvert(nl), CenterConvert(nc), RightConvert(nr),
+                 Bump_Read(), (ls-rs)/4, &Cmd);
+    Drive(Cmd.Left, Cmd.Right);
+  }
+ */
+
+#include <stdint.h>
+#include "../inc/Avoid.h"
+
+#define SECTOR_DEG (360/AVOID_SECTORS)
+#define SENSOR_DEG 45     // left and right IR look 45 degrees off center
+#define KTURN      40     // duty per degree of heading error
+#define GOAL_COST  2      // weight of distance to goal in sectors
+#define TURN_COST  1      // weight of distance to current heading in sectors
+
+static uint16_t Hist[AVOID_SECTORS];
+static int32_t MaxDuty;
+static int32_t Goal;
+static int32_t Speed;     // filtered forward duty
+
+// sector that contains heading a
+static uint32_t sectorOf(int32_t a){
+  a = a%360;
+  if(a < 0){
+    a = a+360;
+  }
+  return ((a*AVOID_SECTORS + 180)/360)%AVOID_SECTORS;
+}
+
+// distance between two sectors, 0 to AVOID_SECTORS/2
+static uint32_t sectorDiff(uint32_t a, uint32_t b){
+  uint32_t d = (a-b)&(AVOID_SECTORS-1);
+  if(d > AVOID_SECTORS/2){
+    d = AVOID_SECTORS-d;
+  }
+  return d;
+}
+
+// heading error wrapped to -180 to +180
+static int32_t wrap(int32_t a){
+  a = a%360;
+  if(a > 180) a = a-360;
+  if(a < -180) a = a+360;
+  return a;
+}
+
+static void add(uint32_t s, uint32_t w){
+  uint32_t h = Hist[s&(AVOID_SECTORS-1)] + w;
+  Hist[s&(AVOID_SECTORS-1)] = (h > AVOID_MAX) ? AVOID_MAX : h;
+}
+
+// one IR reading, closer obstacles count more
+static void addIR(int32_t heading, int32_t dist){
+  uint32_t s, w;
+  if((dist <= 0) || (dist >= AVOID_RANGE)){
+    return;
+  }
+  w = ((AVOID_RANGE-dist)*(AVOID_MAX/4))/AVOID_RANGE;
+  s = sectorOf(heading);
+  add(s, w);
+  add(s+1, w/2);      // the sensor beam is wider than a sector
+  add(s-1, w/2);
+}
+
+// ------------Avoid_Init------------
+// Clear the histogram.
+// Input: maxDuty - duty cycle at full speed (0 to MOTOR_MAX)
+//        goal    - heading to travel in, degrees
+// Output: none
+void Avoid_Init(int32_t maxDuty, int32_t goal){
+  uint32_t i;
+  for(i=0; i<AVOID_SECTORS; i++){
+    Hist[i] = 0;
+  }
+  MaxDuty = maxDuty;
+  Goal = goal;
+  Speed = 0;
+}
+
+// ------------Avoid_SetGoal------------
+// Change the heading to travel in.
+// Input: goal - heading in degrees
+// Output: none
+void Avoid_SetGoal(int32_t goal){
+  Goal = goal;
+}
+
+// ------------Avoid_Update------------
+// Add one set of measurements and compute the motor command.
+// Input: left, center, right - IR distances in mm
+//        bump    - 6-bit positive logic bump data, bit 5 left, bit 0 right
+//        heading - current heading from odometry, degrees
+//        cmd     - pointer to command to fill in
+// Output: none
+void Avoid_Update(int32_t left, int32_t center, int32_t right, uint8_t bump,
+                  int32_t heading, AvoidCmd_t *cmd){
+  uint16_t smooth[AVOID_SECTORS];
+  uint32_t i, s, here, best, cost, bestCost, goal;
+  int32_t err, dir, want, turn;
+  // 1) forget slowly, 1/8 per call
+  for(i=0; i<AVOID_SECTORS; i++){
+    Hist[i] = Hist[i] - ((Hist[i]+7)>>3);
+  }
+  // 2) add the measurements
+  addIR(heading-SENSOR_DEG, left);
+  addIR(heading, center);
+  addIR(heading+SENSOR_DEG, right);
+  for(i=0; i<6; i++){
+    if(bump&(1<<i)){        // bump 5 at -75, bump 0 at +75 degrees
+      add(sectorOf(heading+75-30*(int32_t)i), AVOID_MAX);
+    }
+  }
+  // 3) smooth with neighbours
+  for(i=0; i<AVOID_SECTORS; i++){
+    smooth[i] = (Hist[(i-1)&(AVOID_SECTORS-1)] + 2*Hist[i] + Hist[(i+1)&(AVOID_SECTORS-1)])/4;
+  }
+  // 4) free sector with the lowest cost
+  here = sectorOf(heading);
+  goal = sectorOf(Goal);
+  best = AVOID_SECTORS; bestCost = 0xFFFFFFFF;
+  for(s=0; s<AVOID_SECTORS; s++){
+    if(smooth[s] < AVOID_FREE){
+      cost = GOAL_COST*sectorDiff(s, goal) + TURN_COST*sectorDiff(s, here);
+      if(cost < bestCost){
+        bestCost = cost;
+        best = s;
+      }
+    }
+  }
+  cmd->Density = smooth[here];
+  if(best == AVOID_SECTORS){
+    // 5a) boxed in, turn in place towards the emptier side
+    cmd->Blocked = 1;
+    Speed = 0;
+    turn = MaxDuty/2;
+    if(smooth[(here-AVOID_SECTORS/4)&(AVOID_SECTORS-1)] < smooth[(here+AVOID_SECTORS/4)&(AVOID_SECTORS-1)]){
+      turn = -turn;
+    }
+    dir = heading;
+  }else{
+    // 5b) steer to the sector, slow down with density ahead and with the turn
+    cmd->Blocked = 0;
+    if(best == here){
+      dir = heading;      // anywhere in the sector is fine, do not weave
+    }else{
+      dir = best*SECTOR_DEG;
+    }
+    err = wrap(dir-heading);
+    turn = KTURN*err;
+    if(err < 0){
+      err = -err;
+    }
+    want = MaxDuty*(int32_t)(AVOID_MAX-smooth[here])/AVOID_MAX;
+    want = (err >= 90) ? 0 : want*(90-err)/90;
+    if(bump&0x3F){
+      want = -MaxDuty/4;  // touching something, back off while turning
+    }
+    Speed = (3*Speed + want)/4;   // smooth changes in speed
+  }
+  if(turn > MaxDuty) turn = MaxDuty;
+  if(turn < -MaxDuty) turn = -MaxDuty;
+  cmd->Target = dir;
+  cmd->Speed = Speed;
+  cmd->Left = Speed+turn;
+  cmd->Right = Speed-turn;
+  if(cmd->Left > MaxDuty) cmd->Left = MaxDuty;
+  if(cmd->Left < -MaxDuty) cmd->Left = -MaxDuty;
+  if(cmd->Right > MaxDuty) cmd->Right = MaxDuty;
+  if(cmd->Right < -MaxDuty) cmd->Right = -MaxDuty;
+}
+
+// ------------Avoid_Density------------
+// Read the raw histogram.
+// Input: sector - 0 to AVOID_SECTORS-1, sector 0 is centered on heading 0
+// Output: obstacle density 0 to AVOID_MAX
+uint32_t Avoid_Density(uint32_t sector){
+  return Hist[sector&(AVOID_SECTORS-1)];
+}
@@ -0,0 +1,71 @@
+/*
+ * Avoid.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Reactive obstacle avoidance with a polar histogram
+// The three GP2Y0A21 distances and the six bump switches are added to a
+// small histogram of obstacle density around the robot.  The histogram
+// is kept in the world frame using the odometric heading, so obstacles
+// that have left the IR field of view while turning are remembered for
+// a short while; every call decays it.
+// Each call picks the free sector closest to the goal heading (and to
+// the current heading, so the robot does not dither), steers towards it
+// and scales the speed down with the density ahead.  The robot never
+// stops to turn unless every direction is blocked.
+// Angles are in degrees, positive is clockwise (to the right), the same
+// as Motor_RotateAngle().
+
+#ifndef AVOID_H_
+#define AVOID_H_
+
+#include <stdint.h>
+
+#define AVOID_SECTORS 16      // 22.5 degrees per sector
+#define AVOID_RANGE   400     // mm, IR readings beyond this are ignored
+#define AVOID_MAX     1000    // histogram saturation, also a bump hit
+#define AVOID_FREE    150     // smoothed density below this is free
+
+// Motor command, signed duty cycles, negative means backward
+typedef struct AvoidCmd{
+  int32_t Left;       // left wheel duty
+  int32_t Right;      // right wheel duty
+  int32_t Target;     // chosen heading in degrees
+  int32_t Speed;      // forward part of the duty
+  uint32_t Density;   // smoothed density in the current heading
+  uint32_t Blocked;   // 1 if no sector was free
+} AvoidCmd_t;
+
+// ------------Avoid_Init------------
+// Clear the histogram.
+// Input: maxDuty - duty cycle at full speed (0 to MOTOR_MAX)
+//        goal    - heading to travel in, degrees
+// Output: none
+void Avoid_Init(int32_t maxDuty, int32_t goal);
+
+// ------------Avoid_SetGoal------------
+// Change the heading to travel in.
+// Input: goal - heading in degrees
+// Output: none
+void Avoid_SetGoal(int32_t goal);
+
+// ------------Avoid_Update------------
+// Add one set of measurements and compute the motor command.
+// Call at a fixed rate, 50 to 100 Hz works well.
+// Input: left, center, right - IR distances in mm
+//        bump    - 6-bit positive logic bump data, bit 5 left, bit 0 right
+//        heading - current heading from odometry, degrees
+//        cmd     - pointer to command to fill in
+// Output: none
+void Avoid_Update(int32_t left, int32_t center, int32_t right, uint8_t bump,
+                  int32_t heading, AvoidCmd_t *cmd);
+
+// ------------Avoid_Density------------
+// Read the raw histogram, e.g. for telemetry.
+// Input: sector - 0 to AVOID_SECTORS-1, sector 0 is centered on heading 0
+// Output: obstacle density 0 to AVOID_MAX
+uint32_t Avoid_Density(uint32_t sector);
+
+#endif /* AVOID_H_ */
@@ -140,6 +140,7 @@ int main(void) {
  */
 
 #include "BaseConvert.h"
+#include "Convert.h"
 #include <stdint.h>
 
 //------------Helper Functions------------
@@ -218,9 +219,8 @@ int8_t BaseToDecimal(const char* str, uint8_t base, uint32_t* result) {
 }
 
 int8_t DecimalToBase(uint32_t num, uint8_t base, char* output, uint8_t buffer_size) {
-    uint8_t i = 0;
-    uint8_t start, end;
-    char temp;
+    char digits[CONVERT_BINSIZE];
+    uint32_t length, i;
 
     // Validate inputs
     if (output == 0) {
@@ -236,37 +236,22 @@ int8_t DecimalToBase(uint32_t num, uint8_t base, char* output, uint8_t buffer_si
         return CONVERT_ERROR_OVERFLOW;
     }
 
-    // Special case: if num is 0
-    if (num == 0) {
-        output[0] = '0';
-        output[1] = '\0';
-        return CONVERT_SUCCESS;
-    }
-
-    // Extract digits (they come out in reverse order)
-    while (num > 0 && i < (buffer_size - 1)) {
-        output[i] = digit_to_char(num % base);
-        num = num / base;
-        i++;
+    // Convert.c writes the digits in order, no divide per digit
+    if (base == 10) {
+        length = Convert_UDec(digits, num);
+    } else if (base == 16) {
+        length = Convert_UHex(digits, num);
+    } else {
+        length = Convert_UBin(digits, num);
     }
 
-    // Check if we ran out of buffer space
-    if (num > 0) {
+    // Check if the digits and the null fit
+    if (length >= buffer_size) {
         return CONVERT_ERROR_OVERFLOW;
     }
 
-    // Null terminate
-    output[i] = '\0';
-
-    // Reverse the string (digits were extracted backwards)
-    start = 0;
-    end = i - 1;
-    while (start < end) {
-        temp = output[start];
-        output[start] = output[end];
-        output[end] = temp;
-        start++;
-        end--;
+    for (i = 0; i <= length; i++) {  // including the null
+        output[i] = digits[i];
     }
 
     return CONVERT_SUCCESS;
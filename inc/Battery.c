@@ -0,0 +1,193 @@
+/*
+ * Battery.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Battery.c
+// Battery monitor and motor voltage compensation, see Battery.h
+
+/*
+// Example usage of Battery, sampled with the IR sensors at 2 kHz
+void SensorRead_ISR(void){
+  uint32_t raw17, raw12, raw16, raw14;
+  ADC_In17_12_16_14(&raw17, &raw12, &raw16, &raw14);
+  Sensors_PutIR(LPF_Calc3(raw16), LPF_Calc2(raw12), LPF_Calc(raw17));
+  Battery_Put(raw14);
+}
+
+void LowBattery(uint32_t mV){ // from Battery_Poll, not the ISR
+  LaunchPad_Output(RED);        // time to change the batteries
+}
+
+int main(void){
+  ...
+  Motor_Init();
+  ADC0_InitSWTriggerCh17_12_16_14();
+  Battery_Init(&LowBattery);
+  Battery_Compensate(1);        // the divider is fitted
+  TimerA1_Init(&SensorRead_ISR, 250);
+  EnableInterrupts();
+  Motor_Forward(3000, 3000);    // same speed at 8.4 V and at 6.5 V
+  while(1){
+    Battery_Poll();
+    ...
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/Battery.h"
+#include "../inc/Motor.h"
+#include "../inc/Log.h"
+
+static void (*LowTask)(uint32_t mV);
+static uint32_t Sum;            // ADC results of this filter step
+static uint32_t Count;          // number of results in Sum
+static uint32_t Filter;         // mV<<BATTERY_SHIFT, 0 before the first step
+static volatile uint32_t Voltage;   // mV
+static volatile uint32_t IsLow;
+static volatile uint32_t LowEvents; // low-battery events found by the ISR
+static volatile uint32_t LowVoltage;  // mV at the last one
+static uint32_t LowSeen;        // events Battery_Poll has handled
+static uint32_t Compensate;
+static uint32_t Steps;          // filter steps since the last history entry
+static uint16_t History[BATTERY_HISTORY];
+static volatile uint32_t Entries;   // number of history entries written
+static uint32_t Logged;         // entries Battery_Poll has logged
+
+// ------------Battery_Init------------
+// Clear the filter and history, compensation off.
+// Input: task - function called with the voltage in mV when the
+//               battery gets low, or 0
+// Output: none
+void Battery_Init(void (*task)(uint32_t mV)){
+  LowTask = task;
+  Sum = Count = 0;
+  Filter = 0;
+  Voltage = 0;
+  IsLow = 0;
+  LowEvents = LowSeen = 0;
+  Steps = 0;
+  Entries = Logged = 0;
+  Compensate = 0;               // P6.1 floats without the divider
+  Motor_SetGain(MOTOR_GAIN_ONE);
+}
+
+// ------------Battery_Gain------------
+// Duty cycle gain for a battery voltage
+// Input: mV - battery voltage
+// Output: BATTERY_NOMINAL/mV in Q14, limited to 2.0,
+//         MOTOR_GAIN_ONE outside BATTERY_ABSENT to BATTERY_HIGH
+uint32_t Battery_Gain(uint32_t mV){
+  if((mV < BATTERY_ABSENT) || (mV > BATTERY_HIGH)){
+    return MOTOR_GAIN_ONE;      // no battery, or not a battery reading
+  }
+  if(mV < BATTERY_NOMINAL/2){
+    return 2*MOTOR_GAIN_ONE;
+  }
+  return (BATTERY_NOMINAL*MOTOR_GAIN_ONE + mV/2)/mV;  // rounded
+}
+
+// one filter step from the average of BATTERY_DECIMATE results
+static void update(uint32_t mV){
+  if(Filter == 0){
+    Filter = mV<<BATTERY_SHIFT; // start at the first value, not at 0
+  }else{
+    Filter = Filter - (Filter>>BATTERY_SHIFT) + mV;
+  }
+  mV = Filter>>BATTERY_SHIFT;
+  Voltage = mV;
+  if(Compensate){
+    Motor_SetGain(Battery_Gain(mV));
+  }
+  if(IsLow){
+    if(mV > BATTERY_LOW + BATTERY_HYSTERESIS){
+      IsLow = 0;                // new batteries, or recovered after a load
+    }
+  }else if((mV < BATTERY_LOW) && (mV >= BATTERY_ABSENT)){
+    IsLow = 1;
+    LowVoltage = mV;
+    LowEvents++;                // Battery_Poll logs it and runs the task
+  }
+  Steps++;
+  if(Steps >= BATTERY_LOG){
+    Steps = 0;
+    History[Entries&(BATTERY_HISTORY-1)] = mV;
+    Entries++;
+  }
+}
+
+// ------------Battery_Put------------
+// Add one ADC result of the battery divider.  Call from the sampling
+// ISR only.
+// Input: raw - 14-bit ADC result, 0 to 16383
+// Output: none
+void Battery_Put(uint32_t raw){
+  Sum = Sum + (raw&0x3FFF);
+  Count++;
+  if(Count >= BATTERY_DECIMATE){
+    // average/16384*FULLSCALE, the sum of 16 results is 18 bits, so
+    // sum*FULLSCALE fits in 32 bits up to FULLSCALE 16383 mV
+    update((Sum*BATTERY_FULLSCALE/BATTERY_DECIMATE)>>14);
+    Sum = Count = 0;
+  }
+}
+
+// ------------Battery_Poll------------
+// Write the LOG records and run the low-battery task for what the
+// sampling ISR found since the last call, from the main loop.
+// Input: none
+// Output: none
+void Battery_Poll(void){
+  uint32_t n = Entries;
+  if(LowSeen != LowEvents){
+    LowSeen = LowEvents;
+    LOG1(LOG_WARN, "battery low %u mV", LowVoltage);
+    if(LowTask){
+      (*LowTask)(LowVoltage);
+    }
+  }
+  if(n - Logged > BATTERY_HISTORY){
+    Logged = n - BATTERY_HISTORY;   // the older ones are overwritten
+  }
+  while(Logged != n){
+    LOG1(LOG_INFO, "battery %u mV", History[Logged&(BATTERY_HISTORY-1)]);
+    Logged++;
+  }
+}
+
+// ------------Battery_Compensate------------
+// Turn the duty cycle compensation on or off.
+// Input: on - 1 to scale the duty cycles, 0 for a gain of 1
+// Output: none
+void Battery_Compensate(uint32_t on){
+  Compensate = on;
+  Motor_SetGain(on ? Battery_Gain(Voltage) : MOTOR_GAIN_ONE);
+}
+
+// ------------Battery_Voltage------------
+// Input: none
+// Output: filtered battery voltage in mV, 0 before the first filter step
+uint32_t Battery_Voltage(void){
+  return Voltage;
+}
+
+// ------------Battery_Low------------
+// Input: none
+// Output: 1 after the low-battery event until the voltage recovers
+uint32_t Battery_Low(void){
+  return IsLow;
+}
+
+// ------------Battery_History------------
+// Input: i - 0 for the newest entry, 1 for the one before, ...
+// Output: voltage in mV, 0 if there is no such entry
+uint32_t Battery_History(uint32_t i){
+  uint32_t n = Entries;
+  if((i >= n) || (i >= BATTERY_HISTORY)){
+    return 0;
+  }
+  return History[(n - 1 - i)&(BATTERY_HISTORY-1)];
+}
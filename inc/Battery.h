@@ -0,0 +1,106 @@
+/*
+ * Battery.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Battery monitor and motor voltage compensation
+// The motor voltage is the duty cycle times the battery voltage, so
+// the same Motor_Duty gives less speed (and different turns) as the
+// batteries sag.  This module filters the battery voltage and keeps
+// Motor_SetGain at BATTERY_NOMINAL/battery, so a duty cycle always
+// means the motor voltage it gives at BATTERY_NOMINAL mV.
+//
+// Hardware: a divider from VPWR (battery) to P6.1/A14, e.g. 20k from
+// VPWR and 10k to ground (1/3), sampled with the IR sensors by
+// ADC_In17_12_16_14().  The ADC14 internal battery channel (A23 with
+// ADC14BATMAP) measures AVCC/2, the regulated 3.3 V, not the motor
+// supply, so it can not be used here.
+//
+// Without the divider P6.1 floats and reads anything, so the
+// compensation starts off; turn it on with Battery_Compensate(1) on a
+// robot that has the divider.  Even then a reading outside
+// BATTERY_ABSENT to BATTERY_HIGH (switch off, running from USB, or an
+// open divider) is not a battery and gives a gain of 1.
+//
+// The sampling ISR passes every raw result to Battery_Put().
+// BATTERY_DECIMATE results are averaged, then a first-order filter
+// with a time constant of 2^BATTERY_SHIFT averages removes the PWM
+// current ripple.  All math is integer.  The ISR only filters, sets
+// the gain and records; Battery_Poll, called from the main loop,
+// writes the LOG records and runs the low-battery task.
+// - below BATTERY_LOW the task given to Battery_Init runs once and a
+//   LOG_WARN record is written, it runs again only after the voltage
+//   has been above BATTERY_LOW+BATTERY_HYSTERESIS
+// - every BATTERY_LOG filter steps the voltage goes into a history
+//   ring and a LOG_INFO record
+
+#ifndef BATTERY_H_
+#define BATTERY_H_
+
+#include <stdint.h>
+
+#define BATTERY_FULLSCALE  9900   // mV at ADC 16384, 3.3 V times 3 for the divider
+#define BATTERY_NOMINAL    7200   // mV the duty cycles are tuned at, 6 NiMH cells
+#define BATTERY_LOW        6000   // mV low-battery event, 1.0 V per cell
+#define BATTERY_HYSTERESIS 300    // mV above BATTERY_LOW to re-arm the event
+#define BATTERY_ABSENT     3000   // mV below which there is no battery
+#define BATTERY_HIGH       9600   // mV above which it is not a battery, 6 fresh alkaline cells
+#define BATTERY_DECIMATE   16     // ADC results per filter step, 8 ms at 2 kHz
+#define BATTERY_SHIFT      6      // filter time constant 64 steps, 0.5 s at 2 kHz
+#define BATTERY_LOG        1250   // filter steps per history entry, 10 s at 2 kHz
+#define BATTERY_HISTORY    64     // history entries, power of 2
+
+// ------------Battery_Init------------
+// Clear the filter and history, compensation off.
+// Input: task - function called with the voltage in mV when the
+//               battery gets low, runs in Battery_Poll, or 0
+// Output: none
+// Assumes: Motor_Init() has been called
+void Battery_Init(void (*task)(uint32_t mV));
+
+// ------------Battery_Poll------------
+// Write the LOG records and run the low-battery task for what the
+// sampling ISR found since the last call.  Call from the main loop,
+// at least once every BATTERY_HISTORY history entries (10 minutes).
+// Input: none
+// Output: none
+void Battery_Poll(void);
+
+// ------------Battery_Put------------
+// Add one ADC result of the battery divider.  Call from the sampling
+// ISR only.
+// Input: raw - 14-bit ADC result, 0 to 16383
+// Output: none
+void Battery_Put(uint32_t raw);
+
+// ------------Battery_Compensate------------
+// Turn the duty cycle compensation on or off.
+// Input: on - 1 to scale the duty cycles, 0 for a gain of 1
+// Output: none
+void Battery_Compensate(uint32_t on);
+
+// ------------Battery_Voltage------------
+// Input: none
+// Output: filtered battery voltage in mV, 0 before the first filter step
+uint32_t Battery_Voltage(void);
+
+// ------------Battery_Low------------
+// Input: none
+// Output: 1 after the low-battery event until the voltage recovers
+uint32_t Battery_Low(void);
+
+// ------------Battery_Gain------------
+// Duty cycle gain for a battery voltage
+// Input: mV - battery voltage
+// Output: BATTERY_NOMINAL/mV in Q14 (MOTOR_GAIN_ONE is 1.0), limited
+//         to 2.0, MOTOR_GAIN_ONE outside BATTERY_ABSENT to BATTERY_HIGH
+uint32_t Battery_Gain(uint32_t mV);
+
+// ------------Battery_History------------
+// Input: i - 0 for the newest entry, 1 for the one before, ...
+// Output: voltage in mV, 0 if there is no such entry
+uint32_t Battery_History(uint32_t i);
+
+#endif /* BATTERY_H_ */
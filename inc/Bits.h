@@ -0,0 +1,121 @@
+/*
+ * Bits.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Bit manipulation shared by the drivers
+// - BITS_BAND: one bit of a peripheral register as a byte variable,
+//   through the Cortex-M4 bit-band alias.  A store changes only that
+//   bit in one bus write, no read-modify-write, so it is safe against
+//   an ISR changing other bits of the same port.  reg must be in the
+//   peripheral region 0x40000000-0x400FFFFF (all of P1 to P10 are).
+//     #define REDOUT BITS_BAND(&P2->OUT, 0)
+//     REDOUT = 1;
+//   With a constant address the alias is folded while compiling, it
+//   costs the same as the hand-computed 0x42098060.
+// - Bits_Clz, Bits_Ctz, Bits_Rbit, Bits_Count: single instructions
+//   (CLZ, RBIT) on the MSP432, plain C elsewhere or with BITS_PORTABLE
+//   defined, e.g. for testing on a PC.
+
+#ifndef BITS_H_
+#define BITS_H_
+
+#include <stdint.h>
+
+#ifndef BITS_ARM
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) && !defined(BITS_PORTABLE)
+#define BITS_ARM 1
+#include "msp.h"              // CMSIS intrinsics
+#else
+#define BITS_ARM 0
+#endif
+#endif
+
+// bit-band alias of bit b of the peripheral register at address reg
+#define BITS_ALIAS(reg, b) (0x42000000 + (((uint32_t)(uintptr_t)(reg))-0x40000000)*32 + (b)*4)
+#ifndef BITS_BAND             // a host model may give its own
+#define BITS_BAND(reg, b)  (*((volatile uint8_t *)(uintptr_t)BITS_ALIAS(reg, b)))
+#endif
+
+// ------------Bits_Band------------
+// Bit-band alias when the register is only known at run time
+// Input: reg - peripheral register address, b - bit 0 to 31
+// Output: pointer to the alias, write 0 or 1, reads 0 or 1
+static inline volatile uint8_t *Bits_Band(volatile void *reg, uint32_t b){
+  return (volatile uint8_t *)(uintptr_t)BITS_ALIAS(reg, b);
+}
+
+// ------------Bits_Clz------------
+// Count leading zeros
+// Input: x - any value
+// Output: 0 to 32
+static inline uint32_t Bits_Clz(uint32_t x){
+#if BITS_ARM
+  return __CLZ(x);
+#else
+  uint32_t n = 0;
+  if(x == 0) return 32;
+  if((x&0xFFFF0000) == 0){ n = n + 16; x = x<<16; }
+  if((x&0xFF000000) == 0){ n = n + 8;  x = x<<8;  }
+  if((x&0xF0000000) == 0){ n = n + 4;  x = x<<4;  }
+  if((x&0xC0000000) == 0){ n = n + 2;  x = x<<2;  }
+  if((x&0x80000000) == 0){ n = n + 1; }
+  return n;
+#endif
+}
+
+// ------------Bits_Rbit------------
+// Reverse the order of the 32 bits
+// Input: x - any value
+// Output: bit 0 of x in bit 31, bit 31 in bit 0
+static inline uint32_t Bits_Rbit(uint32_t x){
+#if BITS_ARM
+  return __RBIT(x);
+#else
+  x = ((x>>1)&0x55555555) | ((x&0x55555555)<<1);
+  x = ((x>>2)&0x33333333) | ((x&0x33333333)<<2);
+  x = ((x>>4)&0x0F0F0F0F) | ((x&0x0F0F0F0F)<<4);
+  x = ((x>>8)&0x00FF00FF) | ((x&0x00FF00FF)<<8);
+  return (x>>16) | (x<<16);
+#endif
+}
+
+// ------------Bits_Ctz------------
+// Count trailing zeros, the number of the lowest set bit
+// Input: x - any value
+// Output: 0 to 31, 32 if x is 0
+static inline uint32_t Bits_Ctz(uint32_t x){
+  return Bits_Clz(Bits_Rbit(x));
+}
+
+// ------------Bits_Count------------
+// Number of set bits, no loop and no table
+// Input: x - any value
+// Output: 0 to 32
+static inline uint32_t Bits_Count(uint32_t x){
+  x = x - ((x>>1)&0x55555555);
+  x = (x&0x33333333) + ((x>>2)&0x33333333);
+  x = (x + (x>>4))&0x0F0F0F0F;
+  return (x*0x01010101)>>24;
+}
+
+// ------------Bits_Gather------------
+// Pack the bits of x selected by mask into the low bits, in order,
+// e.g. Bits_Gather(P4->IN, 0xED) is BumpGatherLUT[P4->IN] in Bump.h
+// Input: x - value, mask - bits to keep
+// Output: Bits_Count(mask) low bits
+static inline uint32_t Bits_Gather(uint32_t x, uint32_t mask){
+  uint32_t r = 0, k = 0;
+  while(mask){
+    if(x&mask&(-mask)){       // lowest remaining mask bit
+      r |= 1u<<k;
+    }
+    k++;
+    mask &= mask - 1;
+  }
+  return r;
+}
+
+#endif /* BITS_H_ */
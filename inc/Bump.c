@@ -47,25 +47,34 @@ USAGE EXAMPLE:
  *
 // In your main.c file:
 #include "msp.h"
-#include "..\inc\BumpInt.h"
+#include "..\inc\Bump.h"
+#include "..\inc\Clock.h"
+#include "..\inc\Time.h"
+#include "..\inc\Tachometer.h"
 #include "..\inc\CortexM.h"    // for EnableInterrupts()
 
-volatile uint8_t bumpState = 0;  // Declare global bump state variable
+volatile uint8_t bumpState;      // last raw reading, written by the ISR
 
-// Define your task function (called when bump interrupt occurs)
-void HandleBump(uint8_t bump_data) {
-    // Your collision handling code here
-    // bump_data is a 6-bit value (0-63) indicating which sensors triggered
+void WheelPeriods(uint16_t *left, uint16_t *right){
+    enum TachDirection dir;
+    int32_t steps;
+    Tachometer_Get(left, &dir, &steps, right, &dir, &steps);
 }
 
 int main(void) {
+    BumpEvent_t e;
     Clock_Init48MHz();
-    BumpInt_Init(&HandleBump);   // Initialize with your task function
+    Time_Init();
+    Tachometer_Init();
+    Bump_Init();                 // a touch stops the motors from now on
+    Bump_SetSources(&Time_NowUs32, &WheelPeriods);
     EnableInterrupts();          // Enable global interrupts
 
     while(1) {
-        // Your main loop code
-        // Bump interrupts handled automatically by PORT4_IRQHandler
+        if(Bump_GetEvent(&e)){
+            // e.New switches touched at e.Time us, wheel periods e.LeftTach, e.RightTach
+            // the motors are already stopped, back up or turn from here
+        }
     }
 }
  */
@@ -80,35 +89,85 @@ int main(void) {
 
 #include <stdint.h>
 #include "msp.h"
+#include "../inc/Bump.h"
+#include "../inc/Clock.h"
+#include "../inc/Bits.h"
 
-extern volatile uint8_t bumpState;
-extern volatile uint8_t status;
-void(*Port4Task)(uint8_t);
+// bit-band aliases of the motor driver sleep pins, one store each
+#define NSLP_LEFT  BITS_BAND(&P3->OUT, 7)
+#define NSLP_RIGHT BITS_BAND(&P3->OUT, 6)
 
-// Initialize Bump sensors
-// Make six Port 4 pins inputs (SEL0, SEL1 und DIR muessen 0 sein)
-// Activate interface pullup (REN && OUT muessen 1 sein)
-// pins 7,6,5,3,2,0 -> 1110.1101 -> 0xED
-void Bump_Init(void(*task)(uint8_t)){
-    // write this as part of Lab 3
-    // Initialise GPIO related registers.
-    // Registers: SEL0, SEL1, DIR, REN, OUT.
-    Port4Task = task;                 // global function pointer = user task
+extern volatile uint8_t bumpState;   // last raw reading, for the Lab 3 programs
+
+static BumpEvent_t Events[BUMP_EVENTS];
+static volatile uint32_t PutI, GetI;  // free running, PutI-GetI events queued
+static uint16_t Lost;
+static uint32_t (*Clock)(void);
+static void (*Wheels)(uint16_t *left, uint16_t *right);
+static uint32_t EdgeTime[6];          // CYCCNT of the last touch edge per switch
+static uint32_t Debounce;             // BUMP_DEBOUNCE_MS in cycles
+static volatile uint32_t Measuring, Request, Stopped;  // Bump_MeasureLatency
+static uint32_t Worst;
+
+// (p&0x01)|((p>>1)&0x06)|((p>>2)&0x38), index is P4->IN
+const uint8_t BumpGatherLUT[256]={
+  0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x02, 0x03, 0x04, 0x05, 0x04, 0x05, 0x06, 0x07, 0x06, 0x07,
+  0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x02, 0x03, 0x04, 0x05, 0x04, 0x05, 0x06, 0x07, 0x06, 0x07,
+  0x08, 0x09, 0x08, 0x09, 0x0A, 0x0B, 0x0A, 0x0B, 0x0C, 0x0D, 0x0C, 0x0D, 0x0E, 0x0F, 0x0E, 0x0F,
+  0x08, 0x09, 0x08, 0x09, 0x0A, 0x0B, 0x0A, 0x0B, 0x0C, 0x0D, 0x0C, 0x0D, 0x0E, 0x0F, 0x0E, 0x0F,
+  0x10, 0x11, 0x10, 0x11, 0x12, 0x13, 0x12, 0x13, 0x14, 0x15, 0x14, 0x15, 0x16, 0x17, 0x16, 0x17,
+  0x10, 0x11, 0x10, 0x11, 0x12, 0x13, 0x12, 0x13, 0x14, 0x15, 0x14, 0x15, 0x16, 0x17, 0x16, 0x17,
+  0x18, 0x19, 0x18, 0x19, 0x1A, 0x1B, 0x1A, 0x1B, 0x1C, 0x1D, 0x1C, 0x1D, 0x1E, 0x1F, 0x1E, 0x1F,
+  0x18, 0x19, 0x18, 0x19, 0x1A, 0x1B, 0x1A, 0x1B, 0x1C, 0x1D, 0x1C, 0x1D, 0x1E, 0x1F, 0x1E, 0x1F,
+  0x20, 0x21, 0x20, 0x21, 0x22, 0x23, 0x22, 0x23, 0x24, 0x25, 0x24, 0x25, 0x26, 0x27, 0x26, 0x27,
+  0x20, 0x21, 0x20, 0x21, 0x22, 0x23, 0x22, 0x23, 0x24, 0x25, 0x24, 0x25, 0x26, 0x27, 0x26, 0x27,
+  0x28, 0x29, 0x28, 0x29, 0x2A, 0x2B, 0x2A, 0x2B, 0x2C, 0x2D, 0x2C, 0x2D, 0x2E, 0x2F, 0x2E, 0x2F,
+  0x28, 0x29, 0x28, 0x29, 0x2A, 0x2B, 0x2A, 0x2B, 0x2C, 0x2D, 0x2C, 0x2D, 0x2E, 0x2F, 0x2E, 0x2F,
+  0x30, 0x31, 0x30, 0x31, 0x32, 0x33, 0x32, 0x33, 0x34, 0x35, 0x34, 0x35, 0x36, 0x37, 0x36, 0x37,
+  0x30, 0x31, 0x30, 0x31, 0x32, 0x33, 0x32, 0x33, 0x34, 0x35, 0x34, 0x35, 0x36, 0x37, 0x36, 0x37,
+  0x38, 0x39, 0x38, 0x39, 0x3A, 0x3B, 0x3A, 0x3B, 0x3C, 0x3D, 0x3C, 0x3D, 0x3E, 0x3F, 0x3E, 0x3F,
+  0x38, 0x39, 0x38, 0x39, 0x3A, 0x3B, 0x3A, 0x3B, 0x3C, 0x3D, 0x3C, 0x3D, 0x3E, 0x3F, 0x3E, 0x3F
+};
 
+// Initialize Bump sensors
+// Make six Port 4 pins inputs
+// Activate interface pullup
+// pins 7,6,5,3,2,0
+// Interrupt on falling edge (on touch)
+void Bump_Init(void){
+    uint32_t i;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;  // DWT cycle counter for
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;             // debounce and latency
+    Debounce = BUMP_DEBOUNCE_MS*(Clock_GetFreq()/1000);
+    for(i=0; i<6; i++){
+        EdgeTime[i] = DWT->CYCCNT - Debounce;        // no edge yet
+    }
+    PutI = GetI = 0;
+    Lost = 0;
     P4->SEL0 &= ~0xED;
-    P4->SEL1 &= ~0xED;
-    P4->DIR &= ~0xED;
-    P4->REN |= 0xED;
-    P4->OUT |= 0xED;
-    P4->IES |= 0xED;                   // P1.4 and P1.1 are falling edge event
-    P4->IFG &= ~0xED;                  // clear 0 - 7 (reduce possibility of extra interrupt)
-    P4->IE |= 0xED;                    // arm interrupt on pin above
-    NVIC->IP[9] = (NVIC->IP[9]&0xFF00FFFF)|0x00400000; // priority 2
-    NVIC->ISER[1] = 0x00000040;        // enable interrupt 38 in NVIC (I/O port 4 interrupt = IRQ38)
+    P4->SEL1 &= ~0xED;    // 1) configure P4.0, 4.2, 4.3, 4.5, 4.6, 4.7 as GPIO
+    P4->DIR &= ~0xED;     // 2) make P4.0, 4.2, 4.3, 4.5, 4.6, 4.7 input
+    P4->REN |= 0xED;      // 3) enable pullup/down resistors on P4.0, 4.2, 4.3, 4.5, 4.6, 4.7
+    P4->OUT |= 0xED;      // 4) configure for pull-up mode for P4.0, 4.2, 4.3, 4.5, 4.6, 4.7
+    P4->IES |= 0xED;      // 5) falling edge event (touch)
+    P4->IFG &= ~0xED;     // 6) clear flags (reduce possibility of extra interrupt)
+    P4->IE |= 0xED;       // 7) arm interrupt on the six pins
+    NVIC->IP[9] = NVIC->IP[9]&0xFF00FFFF; // priority 0, nothing delays the stop
+    NVIC->ISER[1] = 0x00000040;           // enable interrupt 38 in NVIC (I/O port 4 interrupt = IRQ38)
+}
+
+// ------------Bump_SetSources------------
+// Select where the event time and the wheel speeds come from
+// Input: clock  - function returning the time, or 0
+//        wheels - function storing the wheel periods, or 0
+// Output: none
+void Bump_SetSources(uint32_t (*clock)(void), void (*wheels)(uint16_t *left, uint16_t *right)){
+    Clock = clock;
+    Wheels = wheels;
 }
 
 // Read current state of 6 switches
-// Returns a 6-bit positive logic result (0 to 63)
+// Returns a 6-bit negative logic result (0 to 63), 0x3F none touched
 // bit 5 Bump5
 // bit 4 Bump4
 // bit 3 Bump3
@@ -116,36 +175,95 @@ void Bump_Init(void(*task)(uint8_t)){
 // bit 1 Bump1
 // bit 0 Bump0
 uint8_t Bump_Read(void){
-    // write this as part of Lab 3
-    // Pack the 6 valid bits in the value read from the input data
-    // register to occupy 6 lower order bits of the result variable.
-    uint8_t bump0, bump1, bump2, bump3, bump4, bump5;
-    uint8_t result;
-    bump0 = (P4->IN)&0x01;        // for bump 0 (see if P4->IN has value 1 or 0 for bit 0 --> through bitwise AND) from pin 0 stay in pos 0
-    bump1 = (((P4->IN)&0x04)>>1);        // for bump 1: from bit 2 to bit 1
-    bump2 = (((P4->IN)&0x08)>>1);         // for bump 2: from bit 3 to bit 2
-    bump3 = (((P4->IN)&0x20)>>2);        // for bump 3: from bit 5 to bit 3
-    bump4 = (((P4->IN)&0x40)>>2);         // for bump 4: from bit 6 to bit 4
-    bump5 = (((P4->IN)&0x80)>>2);        // for bump 5: from bit 7 to bit 5
-    result = bump0 + bump1 + bump2 + bump3 + bump4 + bump5;   // assemble the 6 bumps we have gathered
-    return (result);
+    return BumpGatherLUT[P4->IN];   // one read, the six pins can not tear
 }
 
-// this version of the IRQhandler will simply update the bumpState.
-// if you would like to call a user defined task, use BumpInt.c
-
-void PORT4_IRQHandler(void){
-    uint8_t status, result;
-    status = P4 -> IV;
+// ------------Bump_GetEvent------------
+// Take the oldest collision out of the queue
+// Input: event - pointer to storage
+// Output: 1 if there was one, 0 if the queue is empty
+int Bump_GetEvent(BumpEvent_t *event){
+    if(GetI == PutI){
+        return 0;
+    }
+    *event = Events[GetI&(BUMP_EVENTS-1)];
+    __DMB();              // copied before the ISR may reuse the slot
+    GetI = GetI + 1;
+    return 1;
+}
 
-    if(status != 0x00){
-        result = Bump_Read();
-//        Port4Task(result);      // call the user-defined task with the bump switch
-        bumpState = result;
+// ------------Bump_MeasureLatency------------
+// Cycles from a bump interrupt request to the motor drivers asleep
+// Input: none
+// Output: cycles, the motors are stopped
+uint32_t Bump_MeasureLatency(void){
+    uint32_t cycles;
+    Measuring = 1;
+    Request = DWT->CYCCNT;
+    P4->IFG |= 0x01;      // the request a touch of Bump0 makes
+    while(Measuring){};
+    cycles = Stopped - Request;
+    if(cycles > Worst){
+        Worst = cycles;
     }
-    P4->IFG &= 0x12;            // clear interrupt flags for bump switches
+    return cycles;
+}
 
-//    (*Port4Task)(Bump_Read());
-    //P4->IFG=0x00;
+// ------------Bump_WorstLatency------------
+// Input: none
+// Output: largest Bump_MeasureLatency() so far, cycles
+uint32_t Bump_WorstLatency(void){
+    return Worst;
 }
 
+// stops the motors before anything else, then records the touch
+// an edge on a switch within Debounce of its previous edge is bounce,
+// an edge on a switch that reads released (bounce ended, or the
+// latency test) is ignored; events are lost only if the queue is full
+void PORT4_IRQHandler(void){
+    uint32_t now, edges, raw, pressed, fresh, i;
+    BumpEvent_t *e;
+    NSLP_LEFT = 0;                   // both motor drivers to sleep
+    NSLP_RIGHT = 0;
+    now = DWT->CYCCNT;
+    if(Measuring){
+        Stopped = now;
+        Measuring = 0;
+    }
+    edges = P4->IFG&0xED;
+    P4->IFG &= ~edges;               // re-arm exactly the edges handled here
+    raw = Bump_Read();
+    bumpState = raw;
+    pressed = raw^0x3F;
+    edges = BumpGatherLUT[edges]&pressed;   // switch bits, touch edges only
+    fresh = 0;
+    while(edges){
+        i = Bits_Ctz(edges);
+        if((now - EdgeTime[i]) >= Debounce){
+            fresh |= 1u<<i;              // a new touch
+        }
+        EdgeTime[i] = now;               // bounce restarts the window
+        edges &= edges - 1;
+    }
+    if(fresh == 0){
+        return;
+    }
+    if((PutI - GetI) >= BUMP_EVENTS){
+        if(Lost < 0xFFFF){
+            Lost++;
+        }
+        return;
+    }
+    e = &Events[PutI&(BUMP_EVENTS-1)];
+    e->Time = Clock ? (*Clock)() : 0;
+    if(Wheels){
+        (*Wheels)(&e->LeftTach, &e->RightTach);
+    }else{
+        e->LeftTach = e->RightTach = 0;
+    }
+    e->Switches = pressed;
+    e->New = fresh;
+    e->Lost = Lost;
+    Lost = 0;
+    PutI = PutI + 1;
+}
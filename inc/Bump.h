@@ -4,7 +4,8 @@
  * @details   Six switches are connected to P8.7-P8.3, P8.0<br>
  1) Hardware uses negative logic with internal pullup<br>
  2) Positioned on the front of the robot to detect collisions<br>
- 3) Software returns 6-bit positive logic (1 means collision)<br>
+ 3) Software returns 6-bit negative logic (0 means collision)<br>
+ 4) A collision stops the motors in the ISR and is queued as an event<br>
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -73,24 +74,70 @@ those of the authors and should not be interpreted as representing official
 policies, either expressed or implied, of the FreeBSD Project.
 */
 
+#ifndef BUMP_H_
+#define BUMP_H_
+
+#include <stdint.h>
+
+// One driver for the six bump switches on P4.7-P4.5, P4.3, P4.2, P4.0.
+// A falling edge (touch) interrupts at priority 0 and the very first
+// thing the ISR does is put both motor drivers to sleep (nSLP P3.7 and
+// P3.6 low), so the robot stops within a few microseconds of the
+// contact whatever the main program or the other ISRs are doing.
+// The next Motor_Forward/Backward/Left/Right wakes them up again.
+// After the stop the ISR debounces in time (edges on a switch within
+// BUMP_DEBOUNCE_MS of its previous edge are bounce) and puts one event
+// per new contact into a small queue for the main program.
+
+#define BUMP_DEBOUNCE_MS 10     // contact bounce of the switches
+#define BUMP_EVENTS      8      // queue size, a power of 2
+
+// P4 input to the bump switches, negative logic like P4->IN, so the
+// switches are read with one P4->IN access and one load
+// bit 5..0 = P4.7, P4.6, P4.5, P4.3, P4.2, P4.0
+extern const uint8_t BumpGatherLUT[256];
+
+/**
+ * One collision, as recorded by the ISR right after the motors stopped.
+ */
+typedef struct BumpEvent{
+  uint32_t Time;        /**< clock() at the stop, 0 without a clock (see Bump_SetSources) */
+  uint16_t LeftTach;    /**< left wheel period at impact (units of 0.083 usec), 0 without a source */
+  uint16_t RightTach;   /**< right wheel period at impact */
+  uint8_t Switches;     /**< switches touching, positive logic, bit 0 is Bump0 */
+  uint8_t New;          /**< switches that started this event, positive logic */
+  uint16_t Lost;        /**< events dropped before this one because the queue was full */
+} BumpEvent_t;
 
 /**
  * Initialize Bump sensors<br>
- * Make P8.7-P8.3, P8.0 as inputs<br>
- * or Port 4 pins 7,6,5,3,2,0 as inputs<br>
- *
- * Activate interface pullup
+ * Make Port 4 pins 7,6,5,3,2,0 interrupt-driven inputs<br>
+ * Activate interface pullup<br>
+ * Interrupt on falling edge (touch), priority 0<br>
+ * A touch stops the motors and queues a BumpEvent_t.
  * @param none
  * @return none
+ * @note  Assumes Clock_Init48MHz() has been called
  * @brief  Initialize Bump sensors
  */
 void Bump_Init(void);
 
+/**
+ * Give the driver a clock for the event times and a source of
+ * wheel speeds at impact.  Both are called from the ISR, after the
+ * motors are stopped, and must be safe there.
+ * @param clock function returning the current time, e.g. Time_NowUs32, or 0
+ * @param wheels function storing the left and right wheel periods, or 0
+ * @return none
+ * @brief  Select the timestamp and wheel speed sources
+ */
+void Bump_SetSources(uint32_t (*clock)(void), void (*wheels)(uint16_t *left, uint16_t *right));
+
 /**
  * Read current state of 6 switches<br>
- * Read P8.7-P8.3, P8.0 inputs<br>
- * or read Port 4 pins 7,6,5,3,2,0 inputs<br>
- * Returns a 6-bit positive logic result (0 to 63)<br>
+ * Read Port 4 pins 7,6,5,3,2,0 inputs<br>
+ * Returns a 6-bit negative logic result (0 to 63),
+ * 0x3F when no switch is touched<br>
  * bit 5 Bump5<br>
  * bit 4 Bump4<br>
  * bit 3 Bump3<br>
@@ -98,9 +145,39 @@ void Bump_Init(void);
  * bit 1 Bump1<br>
  * bit 0 Bump0
  * @param none
- * @return result is 6-bit positive logic
- * @note  result is a packed, right-justified, positive logic
+ * @return result is 6-bit negative logic, 0 means touched
+ * @note  result is packed and right-justified, (~Bump_Read())&0x3F is positive logic
  * @brief  Read current state of 6 switches
  */
 uint8_t Bump_Read(void);
 
+/**
+ * Take the oldest collision out of the queue.
+ * @param event is a pointer to storage for the event
+ * @return 1 if there was one, 0 if the queue is empty
+ * @brief  Get a collision event
+ */
+int Bump_GetEvent(BumpEvent_t *event);
+
+/**
+ * Measure the bump-to-stop latency: set a bump interrupt flag in
+ * software and count CPU cycles from the request until the ISR has
+ * put the motor drivers to sleep.  Includes the exception entry, the
+ * flash wait states and any higher or equal priority ISR running at
+ * that moment.  The motors stop.
+ * @param none
+ * @return cycles from interrupt request to nSLP low
+ * @note  Interrupts must be enabled
+ * @brief  Measure bump-to-stop latency
+ */
+uint32_t Bump_MeasureLatency(void);
+
+/**
+ * Largest value returned by Bump_MeasureLatency() so far.
+ * @param none
+ * @return cycles, 0 if never measured
+ * @brief  Worst measured bump-to-stop latency
+ */
+uint32_t Bump_WorstLatency(void);
+
+#endif /* BUMP_H_ */
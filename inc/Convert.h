@@ -0,0 +1,363 @@
+/*
+ * Convert.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Integer to text and text to integer conversion shared by the drivers
+// UART0, EUSCIA0, Nokia5110 and BaseConvert format numbers through these
+// functions instead of each keeping its own recursive or
+// divide-per-digit code.
+//
+// All output functions write into a caller buffer, add a null and
+// return the number of characters written (without the null).
+// - decimal: two digits per step from a 200-byte table, the divide by
+//   100 is a multiply by its reciprocal (one UMULL), no UDIV
+// - hex: one table lookup per nibble
+// - binary: four characters per step, a nibble is spread over four
+//   bytes with one multiply
+// The N variants are fixed width.  A number that does not fit prints
+// as width '*' characters, like the old OutUDec4/OutUDec5.
+// Everything is inline, so a driver needs only this header; the
+// compiler keeps just the functions and tables a file uses.
+
+/*
+// Example usage of Convert
+#include <stdint.h>
+#include "../inc/Convert.h"
+#include "../inc/EUSCIA0.h"
+
+void Show(uint32_t mm, uint32_t mV, uint8_t bump){
+  char buf[CONVERT_BINSIZE];
+  Convert_UDecN(buf, mm, 5);      // "  123"
+  EUSCIA0_OutString(buf);
+  Convert_UFix(buf, mV, 0, 3);    // 7421 mV as "7.421"
+  EUSCIA0_OutString(buf);
+  Convert_UBinN(buf, bump, 6);    // "000101"
+  EUSCIA0_OutString(buf);
+}
+ */
+
+#ifndef CONVERT_H_
+#define CONVERT_H_
+
+#include <stdint.h>
+
+// buffer sizes that hold any value, including the null
+#define CONVERT_DECSIZE 12     // "-2147483648"
+#define CONVERT_HEXSIZE 9
+#define CONVERT_BINSIZE 33
+
+// "00" to "99", two characters per entry
+static const char convertDigits2[200] = {
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899"
+};
+static const char convertHex[16] = {
+  '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+};
+static const uint32_t convertPow10[10] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// n/100 for every 32-bit n, 0x51EB851F = ceil(2^37/100)
+static inline uint32_t convertDiv100(uint32_t n){
+  return (uint32_t)(((uint64_t)n*0x51EB851Fu)>>37);
+}
+
+// number of decimal digits in n, 1 to 10
+static inline uint32_t convertDigits10(uint32_t n){
+  uint32_t d = 1;
+  while((d < 10) && (n >= convertPow10[d])){
+    d++;
+  }
+  return d;
+}
+
+// write the digits of n so the last one is just before end
+static inline void convertWrite(char *end, uint32_t n){
+  uint32_t q, r;
+  while(n >= 100){
+    q = convertDiv100(n);
+    r = 2*(n - 100*q);
+    end = end - 2;
+    end[0] = convertDigits2[r];
+    end[1] = convertDigits2[r+1];
+    n = q;
+  }
+  if(n >= 10){
+    end[-2] = convertDigits2[2*n];
+    end[-1] = convertDigits2[2*n+1];
+  }else{
+    end[-1] = '0' + n;
+  }
+}
+
+static inline uint32_t convertFill(char *buf, char c, uint32_t n){
+  uint32_t i;
+  for(i=0; i<n; i++){
+    buf[i] = c;
+  }
+  buf[n] = 0;
+  return n;
+}
+
+// ------------Convert_UDec------------
+// Unsigned decimal, 1 to 10 digits
+// Input: buf - at least CONVERT_DECSIZE bytes
+//        n   - number
+// Output: number of characters
+static inline uint32_t Convert_UDec(char *buf, uint32_t n){
+  uint32_t d = convertDigits10(n);
+  convertWrite(buf+d, n);
+  buf[d] = 0;
+  return d;
+}
+
+// ------------Convert_UDecN------------
+// Unsigned decimal right-justified with spaces
+// Input: buf   - at least width+1 bytes
+//        n     - number
+//        width - characters, 1 to 10
+// Output: width
+static inline uint32_t Convert_UDecN(char *buf, uint32_t n, uint32_t width){
+  uint32_t d = convertDigits10(n);
+  if(d > width){
+    return convertFill(buf, '*', width);
+  }
+  convertFill(buf, ' ', width-d);
+  convertWrite(buf+width, n);
+  buf[width] = 0;
+  return width;
+}
+
+// ------------Convert_SDec------------
+// Signed decimal, '-' only for negative numbers
+// Input: buf - at least CONVERT_DECSIZE bytes
+//        n   - number
+// Output: number of characters
+static inline uint32_t Convert_SDec(char *buf, int32_t n){
+  if(n < 0){
+    buf[0] = '-';
+    return 1 + Convert_UDec(buf+1, -(uint32_t)n);
+  }
+  return Convert_UDec(buf, n);
+}
+
+// ------------Convert_SDecN------------
+// Signed decimal right-justified with spaces, the sign counts in width
+// Input: buf   - at least width+1 bytes
+//        n     - number
+//        width - characters, 1 to 11
+// Output: width
+static inline uint32_t Convert_SDecN(char *buf, int32_t n, uint32_t width){
+  uint32_t u = (n < 0) ? -(uint32_t)n : (uint32_t)n;
+  uint32_t d = convertDigits10(u) + (n < 0);
+  if(d > width){
+    return convertFill(buf, '*', width);
+  }
+  convertFill(buf, ' ', width-d);
+  if(n < 0){
+    buf[width-d] = '-';
+  }
+  convertWrite(buf+width, u);
+  buf[width] = 0;
+  return width;
+}
+
+// ------------Convert_UFix------------
+// Unsigned fixed-point decimal, n is the value times 10^decimals,
+// e.g. Convert_UFix(buf, 1234, 0, 2) gives "12.34".
+// Input: buf      - at least CONVERT_DECSIZE+1 bytes (width+decimals+2 if larger)
+//        n        - value times 10^decimals
+//        width    - characters before the point, right-justified with
+//                   spaces, or 0 for as many as needed
+//        decimals - digits after the point, 1 to 9
+// Output: number of characters
+static inline uint32_t Convert_UFix(char *buf, uint32_t n, uint32_t width, uint32_t decimals){
+  uint32_t d = convertDigits10(n), whole, i;
+  char *pt;
+  if(d <= decimals){
+    d = decimals + 1;             // leading zeros, e.g. "0.05"
+  }
+  whole = d - decimals;
+  if(width == 0){
+    width = whole;
+  }
+  if(whole > width){
+    convertFill(buf, '*', width+1+decimals);
+    buf[width] = '.';
+    return width+1+decimals;
+  }
+  pt = buf + width - whole;       // first digit
+  convertFill(buf, ' ', width-whole);
+  convertFill(pt, '0', d);
+  convertWrite(pt+d, n);
+  for(i=0; i<decimals; i++){      // open a gap for the point
+    pt[d-i] = pt[d-i-1];
+  }
+  pt[whole] = '.';
+  buf[width+1+decimals] = 0;
+  return width+1+decimals;
+}
+
+// ------------Convert_UHexN------------
+// Unsigned hexadecimal, low digits with leading zeros
+// Input: buf    - at least digits+1 bytes
+//        n      - number
+//        digits - 1 to 8
+// Output: digits
+static inline uint32_t Convert_UHexN(char *buf, uint32_t n, uint32_t digits){
+  uint32_t i;
+  for(i=digits; i; i--){
+    buf[i-1] = convertHex[n&0x0F];
+    n = n>>4;
+  }
+  buf[digits] = 0;
+  return digits;
+}
+
+// ------------Convert_UHex------------
+// Unsigned hexadecimal with upper case letters, 1 to 8 digits
+// Input: buf - at least CONVERT_HEXSIZE bytes
+//        n   - number
+// Output: number of characters
+static inline uint32_t Convert_UHex(char *buf, uint32_t n){
+  uint32_t d = 1;
+  while((d < 8) && (n>>(4*d))){
+    d++;
+  }
+  return Convert_UHexN(buf, n, d);
+}
+
+// four characters '0'/'1' for a nibble, most significant bit in the
+// low byte so it comes first in memory
+// the multiply puts copies of the nibble at bits 0, 9, 18 and 27,
+// which places bit 3 at bit 3, bit 2 at bit 11, bit 1 at 19, bit 0 at 27
+static inline uint32_t convertSpread(uint32_t nibble){
+  return (((nibble*0x08040201u)>>3)&0x01010101u) + 0x30303030u;
+}
+
+static inline void convertPut4(char *pt, uint32_t w){
+  pt[0] = w;
+  pt[1] = w>>8;
+  pt[2] = w>>16;
+  pt[3] = w>>24;
+}
+
+// ------------Convert_UBinN------------
+// Unsigned binary, low bits with leading zeros
+// Input: buf  - at least bits+1 bytes
+//        n    - number
+//        bits - 1 to 32
+// Output: bits
+static inline uint32_t Convert_UBinN(char *buf, uint32_t n, uint32_t bits){
+  uint32_t k = bits&3, s = bits - k, i;
+  char *pt = buf;
+  char first[4];
+  if(k){                          // partial top nibble
+    convertPut4(first, convertSpread((n>>s)&((1u<<k)-1)));
+    for(i=0; i<k; i++){
+      *pt++ = first[4-k+i];
+    }
+  }
+  while(s){
+    s = s - 4;
+    convertPut4(pt, convertSpread((n>>s)&0x0F));
+    pt = pt + 4;
+  }
+  buf[bits] = 0;
+  return bits;
+}
+
+// ------------Convert_UBin------------
+// Unsigned binary, 1 to 32 digits
+// Input: buf - at least CONVERT_BINSIZE bytes
+//        n   - number
+// Output: number of characters
+static inline uint32_t Convert_UBin(char *buf, uint32_t n){
+  uint32_t bits = 1;
+  while((bits < 32) && (n>>bits)){
+    bits++;
+  }
+  return Convert_UBinN(buf, n, bits);
+}
+
+// ------------Convert_ToUDec------------
+// Read an unsigned decimal number from the start of a string.
+// Input: s - text, conversion stops at the first non-digit
+//        n - pointer to result
+// Output: number of digits used, 0 if there are none or the
+//         value is above 4294967295 (n is not changed)
+static inline uint32_t Convert_ToUDec(const char *s, uint32_t *n){
+  uint32_t value = 0, digit, i = 0;
+  while((s[i] >= '0') && (s[i] <= '9')){
+    digit = s[i] - '0';
+    if((value > 429496729) || ((value == 429496729) && (digit > 5))){
+      return 0;                   // 10*value+digit > 4294967295
+    }
+    value = 10*value + digit;
+    i++;
+  }
+  if(i){
+    *n = value;
+  }
+  return i;
+}
+
+// ------------Convert_ToUHex------------
+// Read an unsigned hexadecimal number (0-9, A-F, a-f, no prefix).
+// Input: s - text, conversion stops at the first non-hex character
+//        n - pointer to result
+// Output: number of digits used, 0 if there are none or more than
+//         8 significant digits (n is not changed)
+static inline uint32_t Convert_ToUHex(const char *s, uint32_t *n){
+  uint32_t value = 0, digit, i = 0;
+  char c;
+  while(1){
+    c = s[i];
+    if((c >= '0') && (c <= '9')){
+      digit = c - '0';
+    }else if(((c|0x20) >= 'a') && ((c|0x20) <= 'f')){
+      digit = (c|0x20) - 'a' + 10; // 0x20 makes A-F lower case
+    }else{
+      break;
+    }
+    if(value>>28){
+      return 0;
+    }
+    value = (value<<4) + digit;
+    i++;
+  }
+  if(i){
+    *n = value;
+  }
+  return i;
+}
+
+// ------------Convert_ToUBin------------
+// Read an unsigned binary number (0 and 1).
+// Input: s - text, conversion stops at the first other character
+//        n - pointer to result
+// Output: number of digits used, 0 if there are none or more than
+//         32 significant digits (n is not changed)
+static inline uint32_t Convert_ToUBin(const char *s, uint32_t *n){
+  uint32_t value = 0, i = 0;
+  while((s[i] == '0') || (s[i] == '1')){
+    if(value>>31){
+      return 0;
+    }
+    value = (value<<1) + (s[i] - '0');
+    i++;
+  }
+  if(i){
+    *n = value;
+  }
+  return i;
+}
+
+#endif /* CONVERT_H_ */
@@ -48,6 +48,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 // UCA0TXD (VCP transmit) connected to P1.3
 #include <stdint.h>
 #include "../inc/FIFO0.h"
+#include "../inc/Convert.h"
 #include "EUSCIA0.h"
 #include "msp.h"
 
@@ -103,6 +104,14 @@ char EUSCIA0_InChar(void){
   return(letter);
 }
 
+//------------EUSCIA0_InCharNonBlock------------
+// Get new serial port input if there is any
+// Input: pointer to where the character is stored
+// Output: 1 if a character was received, 0 if RxFifo is empty
+int EUSCIA0_InCharNonBlock(char *datapt){
+  return (RxFifo0_Get(datapt) != FIFOFAIL);
+}
+
 //------------EUSCIA0_OutChar------------
 // Output 8-bit to serial port
 // Input: letter is an 8-bit ASCII character to be transferred
@@ -179,69 +188,9 @@ char character;
 // Output: none
 // Variable format 1-10 digits with no space before or after
 void EUSCIA0_OutUDec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    EUSCIA0_OutUDec(n/10);
-    n = n%10;
-  }
-  EUSCIA0_OutChar(n+'0'); /* n is between 0 and 9 */
-}
-
-uint32_t Messageindexc;
-char Messagec[8];
-void static fillmessagec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    fillmessagec(n/10);
-    n = n%10;
-  }
-  Messagec[Messageindexc] = (n+'0'); /* n is between 0 and 9 */
-  if(Messageindexc<7)Messageindexc++;
-}
-void static fillmessage4b(uint32_t n){
-  if(n>=1000){  // 1000 to 9999
-    Messageindexc = 0;
-  } else if(n>=100){  // 100 to 999
-    Messagec[0] = ' ';
-    Messageindexc = 1;
-  }else if(n>=10){ //
-    Messagec[0] = ' '; /* n is between 10 and 99 */
-    Messagec[1] = ' ';
-    Messageindexc = 2;
-  }else{
-    Messagec[0] = ' '; /* n is between 0 and 9 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messageindexc = 3;
-  }
-  fillmessagec(n);
-}
-void static fillmessage5b(uint32_t n){
-  if(n>99999)n=99999;
-  if(n>=10000){  // 10000 to 99999
-    Messageindexc = 0;
-  } else if(n>=1000){  // 1000 to 9999
-    Messagec[0] = ' ';
-    Messageindexc = 1;
-  }else if(n>=100){  // 100 to 999
-    Messagec[0] = ' ';
-    Messagec[1] = ' ';
-    Messageindexc = 2;
-  }else if(n>=10){ //
-    Messagec[0] = ' '; /* n is between 10 and 99 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messageindexc = 3;
-  }else{
-    Messagec[0] = ' '; /* n is between 0 and 9 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messagec[3] = ' ';
-    Messageindexc = 4;
-  }
-  fillmessagec(n);
+  char buf[CONVERT_DECSIZE];
+  Convert_UDec(buf, n);
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUDec4-----------------------
@@ -250,14 +199,9 @@ void static fillmessage5b(uint32_t n){
 // Output: none
 // Fixed format 4 digits with no space before or after
 void EUSCIA0_OutUDec4(uint32_t n){
-  if(n>9999){
-    EUSCIA0_OutString("****");
-  }else{
-    Messageindexc = 0;
-    fillmessage4b(n);
-    Messagec[Messageindexc] = 0; // terminate
-    EUSCIA0_OutString(Messagec);
-  }
+  char buf[5];
+  Convert_UDecN(buf, n, 4);  // "****" if above 9999
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUDec5-----------------------
@@ -266,14 +210,9 @@ void EUSCIA0_OutUDec4(uint32_t n){
 // Output: none
 // Fixed format 5 digits with no space before or after
 void EUSCIA0_OutUDec5(uint32_t n){
-  if(n>99999){
-    EUSCIA0_OutString("*****");
-  }else{
-    Messageindexc = 0;
-    fillmessage5b(n);
-    Messagec[Messageindexc] = 0; // terminate
-    EUSCIA0_OutString(Messagec);
-  }
+  char buf[6];
+  Convert_UDecN(buf, n, 5);  // "*****" if above 99999
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUFix1-----------------------
@@ -282,9 +221,9 @@ void EUSCIA0_OutUDec5(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit> with no space before or after
 void EUSCIA0_OutUFix1(uint32_t n){
-  EUSCIA0_OutUDec(n/10);
-  EUSCIA0_OutChar('.');
-  EUSCIA0_OutUDec(n%10);
+  char buf[CONVERT_DECSIZE+1];
+  Convert_UFix(buf, n, 0, 1);
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUFix2-----------------------
@@ -293,11 +232,9 @@ void EUSCIA0_OutUFix1(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit><digit> with no space before or after
 void EUSCIA0_OutUFix2(uint32_t n){
-  EUSCIA0_OutUDec(n/100);
-  EUSCIA0_OutChar('.');
-  n = n%100;
-  EUSCIA0_OutUDec(n/10);
-  EUSCIA0_OutUDec(n%10);
+  char buf[CONVERT_DECSIZE+1];
+  Convert_UFix(buf, n, 0, 2);
+  EUSCIA0_OutString(buf);
 }
 
 //---------------------EUSCIA0_InUHex----------------------------------------
@@ -348,20 +285,9 @@ char character;
 // Output: none
 // Variable format 1 to 8 digits with no space before or after
 void EUSCIA0_OutUHex(uint32_t number){
-// This function uses recursion to convert the number of
-//   unspecified length as an ASCII string
-  if(number >= 0x10){
-    EUSCIA0_OutUHex(number/0x10);
-    EUSCIA0_OutUHex(number%0x10);
-  }
-  else{
-    if(number < 0xA){
-      EUSCIA0_OutChar(number+'0');
-     }
-    else{
-      EUSCIA0_OutChar((number-0x0A)+'A');
-    }
-  }
+  char buf[CONVERT_HEXSIZE];
+  Convert_UHex(buf, number);
+  EUSCIA0_OutString(buf);
 }
 
 //--------------------------EUSCIA0_OutUHex2----------------------------
@@ -369,17 +295,10 @@ void EUSCIA0_OutUHex(uint32_t number){
 // Input: 32-bit number to be transferred
 // Output: none
 // Fixed format 2 digits with no space before or after
-void EUSCIA0outnibble(uint32_t n){
-  if(n < 0xA){
-    EUSCIA0_OutChar(n+'0');
-  }
-  else{
-    EUSCIA0_OutChar((n-0x0A)+'A');
-  }
-}
 void EUSCIA0_OutUHex2(uint32_t number){
-  EUSCIA0outnibble(number/0x10); // ms digit
-  EUSCIA0outnibble(number%0x10); // ls digit
+  char buf[3];
+  Convert_UHexN(buf, number, 2);
+  EUSCIA0_OutString(buf);
 }
 
 //------------EUSCIA0_InString------------
@@ -105,6 +105,18 @@ void EUSCIA0_Init(void);
 char EUSCIA0_InChar(void);
 
 
+/**
+ * @details   Receive a character from EUSCI_A0 UART if one is waiting
+ * @details   Interrupt synchronization,
+ * @details   non-blocking, returns at once if the RxFifo0 FIFO is empty
+ * @param  datapt is pointer to where the character is stored
+ * @return 1 if a character was received, 0 if none is waiting
+ * @note   EUSCIA0_Init must be called once prior
+ * @brief  Receive byte into MSP432 without waiting
+ */
+int EUSCIA0_InCharNonBlock(char *datapt);
+
+
 /**
  * @details   Transmit a character to EUSCI_A0 UART
  * @details   Interrupt synchronization,
@@ -0,0 +1,234 @@
+/*
+ * FSM.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// FSM.c
+// Table-driven Moore FSM engine with tick-based dwell
+
+/*
+// Example usage of FSM, 3-state line follower sampled every 1 ms
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/FSM.h"
+#include "../inc/LaunchPad.h"
+#include "../inc/TimerA1.h"
+
+#define LINE_FSM(S) \
+  S(Center, 0x03, 500,  Right, Left,   Right,  Center) \
+  S(Left,   0x02, 500,  Left,  Center, Right,  Center) \
+  S(Right,  0x01, 500,  Right, Left,   Center, Center)
+FSM_TABLE(LINE_FSM, fsm);
+FSM_t Robot;
+FSMReport_t Report;
+
+void Task(void){              // every 1 ms
+  LaunchPad_Output(FSM_Tick(&Robot, LaunchPad_Input()));
+}
+
+int main(void){
+  Clock_Init48MHz();
+  LaunchPad_Init();
+  if(FSM_Validate(fsm, fsm_SIZE, Center, 3, 0, &Report)){
+    while(1){};               // broken table, look at Report
+  }
+  FSM_Init(&Robot, fsm, Center, LaunchPad_Input());
+  TimerA1_Init(&Task, 500);   // 1000 Hz
+  EnableInterrupts();
+  while(1){
+    WaitForInterrupt();
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/FSM.h"
+
+// enter state s, input is the input that caused the transition,
+// reacted is 1 if the input change chose s, 0 for a timed transition
+// the entry input would have taken as well (its latency is the dwell)
+static void enter(FSM_t *fsm, uint32_t s, uint32_t input, uint32_t reacted){
+  if(s != fsm->State){
+    if(reacted){
+      fsm->Latency = fsm->Age;
+      if(fsm->Latency > fsm->MaxLatency){
+        fsm->MaxLatency = fsm->Latency;
+      }
+    }
+    fsm->Transitions++;
+  }
+  fsm->State = s;
+  fsm->Time = 0;
+  fsm->EntryInput = input;
+}
+
+// ------------FSM_Init------------
+// Start an FSM in the given state.
+// Input: fsm   - pointer to FSM run-time state
+//        table - state table declared with FSM_TABLE
+//        start - index of initial state
+//        input - current 2-bit input (0 to 3)
+// Output: none
+void FSM_Init(FSM_t *fsm, FSMState_t *table, uint32_t start, uint32_t input){
+  fsm->Table = table;
+  fsm->State = start;
+  fsm->Time = 0;
+  fsm->Input = input&0x03;
+  fsm->EntryInput = input&0x03;
+  fsm->Age = 0;
+  fsm->Latency = 0;
+  fsm->MaxLatency = 0;
+  fsm->Transitions = 0;
+}
+
+// ------------FSM_Tick------------
+// Advance the FSM by one tick with a freshly sampled input.
+// Input: fsm   - pointer to FSM run-time state
+//        input - 2-bit input (0 to 3)
+// Output: output of the (possibly new) current state
+uint32_t FSM_Tick(FSM_t *fsm, uint32_t input){
+  FSMState_t *s = &fsm->Table[fsm->State];
+  uint32_t next;
+  input = input&0x03;
+  if(input != fsm->Input){
+    fsm->Input = input;
+    fsm->Age = 0;                 // input changed this tick
+  }
+  next = s->next[input];
+  fsm->Time++;
+  if(fsm->Time >= s->delay){
+    enter(fsm, next, input, next != s->next[fsm->EntryInput]);  // dwell complete, same as the blocking loop
+  }else if((input != fsm->EntryInput) && (next != s->next[fsm->EntryInput])){
+    enter(fsm, next, input, 1);   // react now instead of at the end of the dwell
+  }
+  if(fsm->Age < 0xFFFFFFFF){
+    fsm->Age++;
+  }
+  return fsm->Table[fsm->State].out;
+}
+
+// ------------FSM_Output------------
+// Output of the current state.
+// Input: fsm - pointer to FSM run-time state
+// Output: out of the current state
+uint32_t FSM_Output(FSM_t *fsm){
+  return fsm->Table[fsm->State].out;
+}
+
+// ------------FSM_Validate------------
+// Check a state table, see FSM.h
+// Input: table        - state table
+//        size         - number of states (table##_SIZE)
+//        start        - index of the start (on-line) state
+//        recoverInput - input that means the robot is back on the line
+//        recover      - per-state recovery ticks, or 0 if not needed
+//        report       - pointer to result
+// Output: 0 if the table is consistent, 1 otherwise
+int FSM_Validate(FSMState_t *table, uint32_t size, uint32_t start,
+                 uint32_t recoverInput, uint32_t *recover, FSMReport_t *report){
+  uint32_t reached[FSM_MAXSTATES/32];  // bit set per reachable state
+  uint8_t list[FSM_MAXSTATES];         // breadth-first work list
+  uint32_t head, tail, i, j, s, n, t, steps;
+  report->BadNext = 0;
+  report->Unreachable = 0;
+  report->DeadEnds = 0;
+  report->Stops = 0;
+  report->Timed = 0;
+  report->FirstUnreachable = FSM_NEVER;
+  report->FirstDeadEnd = FSM_NEVER;
+  report->UnreachableInputs = 0;
+  report->FirstUnreachableInput = FSM_NEVER;
+  report->WorstRecover = 0;
+  report->WorstState = start;
+  if((size == 0) || (size > FSM_MAXSTATES) || (start >= size)){
+    report->BadNext = 1;
+    return 1;
+  }
+  for(i=0; i<size; i++){
+    for(j=0; j<4; j++){
+      if(table[i].next[j] >= size){
+        report->BadNext++;
+      }
+    }
+    if((table[i].next[0] == table[i].next[1]) && (table[i].next[0] == table[i].next[2])
+     && (table[i].next[0] == table[i].next[3])){
+      report->Timed++;
+    }
+  }
+  if(report->BadNext){
+    return 1;                   // cannot walk the graph safely
+  }
+  // 1) reachability from start
+  for(i=0; i<FSM_MAXSTATES/32; i++){
+    reached[i] = 0;
+  }
+  reached[start>>5] |= 1u<<(start&0x1F);
+  list[0] = start;
+  head = 0; tail = 1;
+  while(head < tail){
+    s = list[head++];
+    for(j=0; j<4; j++){
+      n = table[s].next[j];
+      if((reached[n>>5]&(1u<<(n&0x1F))) == 0){
+        reached[n>>5] |= 1u<<(n&0x1F);
+        list[tail++] = n;
+      }
+    }
+  }
+  for(i=0; i<size; i++){
+    if((reached[i>>5]&(1u<<(i&0x1F))) == 0){
+      if(report->Unreachable == 0){
+        report->FirstUnreachable = i;
+      }
+      report->Unreachable++;
+    }else if((table[i].next[0] == i) && (table[i].next[1] == i)
+          && (table[i].next[2] == i) && (table[i].next[3] == i)){
+      if(table[i].out == 0){
+        report->Stops++;        // motors off for good, e.g. after losing the line
+      }else{
+        if(report->DeadEnds == 0){
+          report->FirstDeadEnd = i;
+        }
+        report->DeadEnds++;
+      }
+    }
+  }
+  // inputs that never move a reachable state
+  for(j=0; j<4; j++){
+    for(i=0; i<size; i++){
+      if((reached[i>>5]&(1u<<(i&0x1F))) && (table[i].next[j] != i)){
+        break;
+      }
+    }
+    if(i == size){
+      if(report->UnreachableInputs == 0){
+        report->FirstUnreachableInput = j;
+      }
+      report->UnreachableInputs++;
+    }
+  }
+  // 2) worst-case recovery, input held at recoverInput from each state
+  recoverInput = recoverInput&0x03;
+  for(i=0; i<size; i++){
+    s = i; t = 0; steps = 0;
+    while((s != start) && (steps < size)){
+      t = t + ((table[s].delay == 0) ? 1 : table[s].delay); // at least one tick per state
+      s = table[s].next[recoverInput];
+      steps++;
+    }
+    if(s != start){
+      t = FSM_NEVER;            // loops without ever reaching start
+    }
+    if(recover){
+      recover[i] = t;
+    }
+    if((t > report->WorstRecover) && (reached[i>>5]&(1u<<(i&0x1F)))){
+      report->WorstRecover = t;
+      report->WorstState = i;
+    }
+  }
+  return (report->Unreachable != 0);
+}
@@ -0,0 +1,157 @@
+/*
+ * FSM.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Table-driven Moore FSM engine for the line follower labs
+// Each state has an output, a dwell time and four next states (one per
+// 2-bit input).  The dwell is counted in ticks by FSM_Tick() instead of
+// spinning in Clock_Delay1ms(), so the input is sampled every tick
+// and a transition can fire as soon as the input changes.
+// Call FSM_Tick() from a periodic interrupt (e.g. TimerA1 at 1 kHz).
+//
+// Tables are written with the FSM_TABLE() macro from a declarative
+// list of states.  The macro generates an enum of state names and a
+// const table of 8-byte rows that use 8-bit next-state indices (the
+// old pointer table used 24 bytes per state).  A misspelled state name,
+// an output above 255 or a delay above 65535 ticks is a compile error,
+// and FSM_Validate() checks the table for unreachable states, dead
+// ends, inputs no state reacts to and recovery time.
+
+/*
+ Example, 3-state line follower.
+ Each S() entry is (name, out, delay, next0, next1, next2, next3).
+
+  #define LINE_FSM(S) \
+    S(Center, 0x03, 500,  Right, Left,   Right,  Center) \
+    S(Left,   0x02, 500,  Left,  Center, Right,  Center) \
+    S(Right,  0x01, 500,  Right, Left,   Center, Center)
+  FSM_TABLE(LINE_FSM, fsm);
+ */
+
+#ifndef FSM_H_
+#define FSM_H_
+
+#include <stdint.h>
+
+// One state of an index-based table
+// Declared const so the linker places tables in flash (.const).
+struct FSMState {
+  uint8_t out;       // output
+  uint8_t next[4];   // index of next state if 2-bit input is 0-3
+  uint16_t delay;    // dwell time in FSM ticks (1 ms at 1 kHz)
+};
+typedef const struct FSMState FSMState_t;
+
+// maximum number of states in one table (8-bit indices)
+#define FSM_MAXSTATES 256
+
+// helpers for FSM_TABLE, not used directly
+#define FSM_ENUM(name, out, delay, n0, n1, n2, n3) name,
+#define FSM_ROW(name, out, delay, n0, n1, n2, n3) {out, {n0, n1, n2, n3}, delay},
+#define FSM_CHECK(name, out, delay, n0, n1, n2, n3) \
+  char name##_out[((out) >= 0 && (out) <= 0xFF) ? 1 : -1]; \
+  char name##_delay[((delay) >= 0 && (delay) <= 0xFFFF) ? 1 : -1];
+
+// Declare a state table from a state list macro
+// Defines enum constants for every state name, table##_SIZE for the
+// number of states, and FSMState_t table[table##_SIZE].
+// Fails to compile if the table has more than FSM_MAXSTATES states,
+// or if an out does not fit 8 bits or a delay 16 bits (the checks are
+// array sizes in a struct that is never instantiated).
+#define FSM_TABLE(LIST, table) \
+  enum { LIST(FSM_ENUM) table##_SIZE }; \
+  typedef char table##_fits[(table##_SIZE <= FSM_MAXSTATES) ? 1 : -1]; \
+  struct table##_check { LIST(FSM_CHECK) }; \
+  FSMState_t table[table##_SIZE] = { LIST(FSM_ROW) }
+
+// Run-time state of one FSM
+// State and Time are owned by FSM_Tick(); the statistics may be read
+// by the foreground at any time.
+typedef struct FSM {
+  FSMState_t *Table;     // state table
+  uint32_t State;        // index of the current state
+  uint32_t Time;         // ticks spent in the current state
+  uint32_t Input;        // most recent 2-bit input
+  uint32_t EntryInput;   // input when the current state was entered
+  uint32_t Age;          // ticks since the input last changed
+  uint32_t Latency;      // ticks from input change to the resulting transition (last),
+                         // timed transitions the entry input also takes are not counted
+  uint32_t MaxLatency;   // worst reaction latency seen since FSM_Init()
+  uint32_t Transitions;  // number of state changes since FSM_Init()
+} FSM_t;
+
+// Result of FSM_Validate
+#define FSM_NEVER 0xFFFFFFFF    // state never recovers
+typedef struct FSMReport {
+  uint32_t BadNext;      // number of next indices outside the table
+  uint32_t Unreachable;  // number of states not reachable from start
+  uint32_t DeadEnds;     // number of reachable states that can never leave, output not 0
+  uint32_t Stops;        // number of reachable states that can never leave, output 0
+  uint32_t Timed;        // number of states that ignore the input
+  uint32_t UnreachableInputs; // number of inputs (0-3) no reachable state reacts to
+  uint32_t FirstUnreachableInput; // lowest such input, FSM_NEVER if none
+  uint32_t FirstUnreachable; // index of first unreachable state, FSM_NEVER if none
+  uint32_t FirstDeadEnd; // index of first dead-end state, FSM_NEVER if none
+  uint32_t WorstRecover; // worst-case ticks back to start, FSM_NEVER if some state cannot
+  uint32_t WorstState;   // state with the worst recovery time
+} FSMReport_t;
+
+// ------------FSM_Init------------
+// Start an FSM in the given state.
+// Input: fsm   - pointer to FSM run-time state
+//        table - state table declared with FSM_TABLE
+//        start - index of initial state
+//        input - current 2-bit input (0 to 3)
+// Output: none
+void FSM_Init(FSM_t *fsm, FSMState_t *table, uint32_t start, uint32_t input);
+
+// ------------FSM_Tick------------
+// Advance the FSM by one tick with a freshly sampled input.
+// The FSM moves to next[input] when
+//   1) the dwell time of the current state has elapsed, or
+//   2) the input differs from the input at state entry and selects a
+//      different next state than the entry input did (early transition).
+// A state whose four next states are identical is a pure timed state
+// and is never left early.
+// Input: fsm   - pointer to FSM run-time state
+//        input - 2-bit input (0 to 3)
+// Output: output of the (possibly new) current state
+// Note: constant time, safe to call from an ISR
+uint32_t FSM_Tick(FSM_t *fsm, uint32_t input);
+
+// ------------FSM_Output------------
+// Output of the current state.
+// Input: fsm - pointer to FSM run-time state
+// Output: out of the current state
+uint32_t FSM_Output(FSM_t *fsm);
+
+// ------------FSM_Validate------------
+// Check a state table.
+// 1) every next index must be inside the table
+// 2) every state must be reachable from start
+// 3) reachable states that can only go to themselves are stops if
+//    their output is 0 (motors off), dead ends otherwise
+// 4) an input is unreachable if it takes no reachable state anywhere
+//    but back to itself, its column of the table is never used
+// 5) for every state, the worst-case time back to start once the input
+//    settles at recoverInput (full dwell in every state on the way)
+// Input: table        - state table
+//        size         - number of states (table##_SIZE)
+//        start        - index of the start (on-line) state
+//        recoverInput - input that means the robot is back on the line
+//        recover      - array of size entries to receive per-state
+//                       recovery ticks (FSM_NEVER if not recoverable),
+//                       or 0 if not needed
+//        report       - pointer to result
+// Output: 0 if the table is consistent (no bad next index, no
+//         unreachable state), 1 otherwise
+// Note: dead ends, stops, unreachable inputs and FSM_NEVER recovery
+//       are reported but are not errors here, a stop state is usually
+//       intended; a dead end keeps driving forever and seldom is
+int FSM_Validate(FSMState_t *table, uint32_t size, uint32_t start,
+                 uint32_t recoverInput, uint32_t *recover, FSMReport_t *report);
+
+#endif /* FSM_H_ */
@@ -0,0 +1,280 @@
+/*
+ * Fixed.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Saturating fixed-point math, header only
+//   Q15_t  1.15  -1.0 to 0.99997 (int16_t)
+//   Q16_t 16.16  -32768.0 to 32767.99998 (int32_t)
+//   Q31_t  1.31  -1.0 to 0.9999999995 (int32_t)
+// Results that do not fit saturate to the largest or smallest value
+// instead of wrapping, so a controller output or a filter sum can not
+// flip sign on overflow.
+//
+// On the MSP432 (Cortex-M4 with the DSP extension) the saturating add,
+// subtract and the Q31 multiply are single CMSIS intrinsics (__QADD,
+// __QSUB, __SSAT, __SMMUL).  Everywhere else, or with FIXED_PORTABLE
+// defined, plain C gives bit-for-bit the same results, so the same code
+// can be tested on a PC.
+//
+// Nothing here uses float at run time or divides a 64-bit number.
+// Q15(), Q16() and Q31() turn a constant into fixed point while
+// compiling, e.g. Fixed_Q16Mul(speed, Q16(1.2)).
+
+#ifndef FIXED_H_
+#define FIXED_H_
+
+#include <stdint.h>
+#include "Bits.h"
+
+#ifndef FIXED_DSP
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) && !defined(FIXED_PORTABLE)
+#define FIXED_DSP 1
+#include "msp.h"              // CMSIS intrinsics
+#else
+#define FIXED_DSP 0
+#endif
+#endif
+
+typedef int16_t Q15_t;
+typedef int32_t Q16_t;
+typedef int32_t Q31_t;
+
+// constants, rounded and saturated while compiling (x must be constant)
+#define FIXED_ROUND(x, s, lo, hi) (((x)*(s) >= (hi)) ? (hi) : ((x)*(s) <= (lo)) ? (lo) : \
+                                   (int32_t)((x)*(s) + (((x) >= 0) ? 0.5 : -0.5)))
+#define Q15(x) ((Q15_t)FIXED_ROUND(x, 32768.0, -32768, 32767))
+#define Q16(x) ((Q16_t)FIXED_ROUND(x, 65536.0, -2147483647-1, 2147483647))
+#define Q31(x) ((Q31_t)FIXED_ROUND(x, 2147483648.0, -2147483647-1, 2147483647))
+
+#define Q16_ONE  65536
+#define Q16_FromInt(n) ((Q16_t)((n)*65536))     // n from -32768 to 32767
+
+// ------------Fixed_Sat16------------
+// Limit to the int16_t range
+// Input: x - any int32
+// Output: x, or -32768 / 32767 if it does not fit
+static inline int32_t Fixed_Sat16(int32_t x){
+#if FIXED_DSP
+  return __SSAT(x, 16);
+#else
+  return (x > 32767) ? 32767 : (x < -32768) ? -32768 : x;
+#endif
+}
+
+// ------------Fixed_Clamp------------
+// Limit to a range
+// Input: x - value, lo and hi - limits with lo <= hi
+// Output: x limited to lo..hi
+static inline int32_t Fixed_Clamp(int32_t x, int32_t lo, int32_t hi){
+  return (x > hi) ? hi : (x < lo) ? lo : x;
+}
+
+// ------------Fixed_Add------------
+// Saturating 32-bit add, for Q16 and Q31 (and plain int32)
+// Input: a, b
+// Output: a+b limited to -2^31..2^31-1
+static inline int32_t Fixed_Add(int32_t a, int32_t b){
+#if FIXED_DSP
+  return __QADD(a, b);
+#else
+  int32_t r = (int32_t)((uint32_t)a + (uint32_t)b);
+  if(((a^r)&(b^r)) < 0){      // both inputs differ in sign from the sum
+    r = (a < 0) ? (-2147483647-1) : 2147483647;
+  }
+  return r;
+#endif
+}
+
+// ------------Fixed_Sub------------
+// Saturating 32-bit subtract, for Q16 and Q31
+// Input: a, b
+// Output: a-b limited to -2^31..2^31-1
+static inline int32_t Fixed_Sub(int32_t a, int32_t b){
+#if FIXED_DSP
+  return __QSUB(a, b);
+#else
+  int32_t r = (int32_t)((uint32_t)a - (uint32_t)b);
+  if(((a^b)&(a^r)) < 0){      // signs of a and b differ and the result took b's
+    r = (a < 0) ? (-2147483647-1) : 2147483647;
+  }
+  return r;
+#endif
+}
+
+// ------------Fixed_Q15Add------------
+// Input: a, b - Q15
+// Output: a+b in Q15, saturated
+static inline Q15_t Fixed_Q15Add(Q15_t a, Q15_t b){
+  return Fixed_Sat16((int32_t)a + b);
+}
+
+// ------------Fixed_Q15Sub------------
+// Input: a, b - Q15
+// Output: a-b in Q15, saturated
+static inline Q15_t Fixed_Q15Sub(Q15_t a, Q15_t b){
+  return Fixed_Sat16((int32_t)a - b);
+}
+
+// ------------Fixed_Q15Mul------------
+// Input: a, b - Q15
+// Output: a*b in Q15, rounded toward minus infinity, -1*-1 gives 32767
+static inline Q15_t Fixed_Q15Mul(Q15_t a, Q15_t b){
+  return Fixed_Sat16(((int32_t)a*b)>>15);
+}
+
+// ------------Fixed_Q31Mul------------
+// Input: a, b - Q31
+// Output: a*b in Q31, the last bit is 0, -1*-1 gives 0x7FFFFFFF
+static inline Q31_t Fixed_Q31Mul(Q31_t a, Q31_t b){
+#if FIXED_DSP
+  int32_t h = __SMMUL(a, b);  // upper 32 bits of the product
+#else
+  int32_t h = (int32_t)(((int64_t)a*b)>>32);
+#endif
+  return Fixed_Add(h, h);
+}
+
+// ------------Fixed_Q16Mul------------
+// Input: a, b - Q16.16
+// Output: a*b in Q16.16, rounded toward minus infinity, saturated
+static inline Q16_t Fixed_Q16Mul(Q16_t a, Q16_t b){
+  int64_t p = ((int64_t)a*b)>>16;   // SMULL and a shift, no library call
+  int32_t h = (int32_t)(p>>32);
+  if(h != ((int32_t)p>>31)){        // upper bits are not just the sign
+    return (h < 0) ? (-2147483647-1) : 2147483647;
+  }
+  return (int32_t)p;
+}
+
+// ------------Fixed_Clz------------
+// Count leading zeros
+// Input: x - any value
+// Output: 0 to 32
+static inline uint32_t Fixed_Clz(uint32_t x){
+  return Bits_Clz(x);
+}
+
+// ------------Fixed_Q16Recip------------
+// Reciprocal by Newton-Raphson, no divide
+// Input: x - Q16.16, not 0
+// Output: 1/x in Q16.16, within 1 LSB, saturated (x=0 gives the maximum)
+static inline Q16_t Fixed_Q16Recip(Q16_t x){
+  uint32_t ux = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+  uint32_t z, d, r, t, i;
+  if(ux == 0){
+    return 2147483647;
+  }
+  z = Fixed_Clz(ux);
+  d = ux<<z;                  // 0.5 <= d < 1 in Q32
+  // r = 48/17 - 32/17*d in Q30, then r = r*(2-d*r) three times
+  r = 3031741621u - (uint32_t)(((uint64_t)2021161081u*d)>>32);
+  for(i=0; i<3; i++){
+    t = 0x80000000u - (uint32_t)(((uint64_t)d*r)>>32);  // 2-d*r in Q30
+    r = (uint32_t)(((uint64_t)r*t)>>30);
+  }
+  // 1/x in Q16 = 2^32/ux = r*2^(z-30)
+  if(z >= 30){
+    if((z > 31) || (r > 0x7FFFFFFFu>>(z-30))){
+      r = 0x7FFFFFFF;
+    }else{
+      r = r<<(z-30);
+    }
+  }else{
+    r = (r + (1u<<(29-z)))>>(30-z);
+    if(r > 0x7FFFFFFF){
+      r = 0x7FFFFFFF;
+    }
+  }
+  return (x < 0) ? -(int32_t)r : (int32_t)r;
+}
+
+// ------------Fixed_SqrtU32------------
+// Integer square root, bit by bit, no multiply or divide
+// Input: x - any uint32
+// Output: floor(sqrt(x)), 0 to 65535
+static inline uint32_t Fixed_SqrtU32(uint32_t x){
+  uint32_t r = 0, b = 0x40000000;
+  while(b > x){
+    b = b>>2;
+  }
+  while(b){
+    if(x >= r + b){
+      x = x - (r + b);
+      r = (r>>1) + b;
+    }else{
+      r = r>>1;
+    }
+    b = b>>2;
+  }
+  return r;
+}
+
+// ------------Fixed_Q16Sqrt------------
+// Square root
+// Input: x - Q16.16, 0 or more (negative gives 0)
+// Output: sqrt(x) in Q16.16, error within 1 LSB or 2^-15 of the value,
+//         whichever is larger
+static inline Q16_t Fixed_Q16Sqrt(Q16_t x){
+  uint32_t k, s;
+  if(x <= 0){
+    return 0;
+  }
+  // sqrt(x*2^16) = sqrt(x*2^2k)*2^(8-k), 2k chosen so x*2^2k uses 31-32 bits
+  k = Fixed_Clz((uint32_t)x)>>1;
+  s = Fixed_SqrtU32((uint32_t)x<<(2*k));
+  if(k <= 8){
+    return (Q16_t)(s<<(8-k));
+  }
+  return (Q16_t)((s + (1u<<(k-9)))>>(k-8));
+}
+
+// ------------Fixed_Div64------------
+// Divide a 64-bit number by a 32-bit number with two 32-bit divides
+// (no __aeabi_ldivmod), e.g. a*b/c without losing the product.
+// Input: n - dividend, d - divisor, not 0
+// Output: n/d truncated toward 0, saturated to int32 (d=0 saturates)
+static inline int32_t Fixed_Div64(int64_t n, int32_t d){
+  uint64_t un = (n < 0) ? -(uint64_t)n : (uint64_t)n;
+  uint32_t v = (d < 0) ? -(uint32_t)d : (uint32_t)d;
+  uint32_t u1 = (uint32_t)(un>>32), u0 = (uint32_t)un;
+  uint32_t s, vn1, vn0, un32, un21, un10, un1, un0, q1, q0, rhat, q;
+  int negative = ((n < 0) != (d < 0));
+  if((v == 0) || (u1 >= v)){
+    q = 0xFFFFFFFF;           // quotient does not fit in 32 bits
+  }else{
+    // Hacker's Delight divlu: normalize, then two 16-bit quotient digits
+    s = Fixed_Clz(v);
+    v = v<<s;
+    vn1 = v>>16;
+    vn0 = v&0xFFFF;
+    un32 = (s == 0) ? u1 : ((u1<<s)|(u0>>(32-s)));
+    un10 = u0<<s;
+    un1 = un10>>16;
+    un0 = un10&0xFFFF;
+    q1 = un32/vn1;
+    rhat = un32 - q1*vn1;
+    while((q1 >= 0x10000) || (q1*vn0 > ((rhat<<16)|un1))){
+      q1--;                   // estimate is at most 2 too large
+      rhat = rhat + vn1;
+      if(rhat >= 0x10000) break;
+    }
+    un21 = (un32<<16) + un1 - q1*v;
+    q0 = un21/vn1;
+    rhat = un21 - q0*vn1;
+    while((q0 >= 0x10000) || (q0*vn0 > ((rhat<<16)|un0))){
+      q0--;
+      rhat = rhat + vn1;
+      if(rhat >= 0x10000) break;
+    }
+    q = (q1<<16) + q0;
+  }
+  if(negative){
+    return (q >= 0x80000000u) ? (-2147483647-1) : -(int32_t)q;
+  }
+  return (q > 0x7FFFFFFFu) ? 2147483647 : (int32_t)q;
+}
+
+#endif /* FIXED_H_ */
@@ -149,6 +149,11 @@ policies, either expressed or implied, of the FreeBSD Project.
 #define SetReset() (P6->OUT |= 0x80)      /**< Set Reset pin high */
 #define ClearReset() (P6->OUT &= ~0x80)   /**< Clear Reset pin low */
 #define ReadSRDY() (P2->IN&0x20)          /**< Read SRDY pin */
+#define SRDY_PORT P2                      /**< port with SRDY, for edge interrupts */
+#define SRDY_BIT 0x20                     /**< SRDY pin mask in SRDY_PORT */
+#define SRDY_IRQHandler PORT2_IRQHandler  /**< ISR for SRDY edges, IRQ 36 */
+#define SRDY_NVIC_ENABLE() (NVIC->ISER[1] = 0x00000010) /**< enable IRQ 36 */
+#define SRDY_NVIC_PRIORITY(p) (NVIC->IP[9] = (NVIC->IP[9]&0xFFFFFF00)|((p)<<5)) /**< set IRQ 36 priority */
 #else
 // Options 1,2,3
 #define SetMRDY() (P1->OUT |= 0x80)       /**< Set MRDY pin high */
@@ -156,6 +161,11 @@ policies, either expressed or implied, of the FreeBSD Project.
 #define SetReset() (P6->OUT |= 0x80)      /**< Set Reset pin high */
 #define ClearReset() (P6->OUT &= ~0x80)   /**< Clear Reset pin low */
 #define ReadSRDY() (P5->IN&0x04)          /**< Read SRDY pin */
+#define SRDY_PORT P5                      /**< port with SRDY, for edge interrupts */
+#define SRDY_BIT 0x04                     /**< SRDY pin mask in SRDY_PORT */
+#define SRDY_IRQHandler PORT5_IRQHandler  /**< ISR for SRDY edges, IRQ 39 */
+#define SRDY_NVIC_ENABLE() (NVIC->ISER[1] = 0x00000080) /**< enable IRQ 39 */
+#define SRDY_NVIC_PRIORITY(p) (NVIC->IP[9] = (NVIC->IP[9]&0x00FFFFFF)|((p)<<29)) /**< set IRQ 39 priority */
 #endif
 
 /**
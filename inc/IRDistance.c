@@ -54,6 +54,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 
 #include <stdint.h>
 #include "../inc/ADC14.h"
+#include "../inc/Fixed.h"
 #include "msp.h"
 
 /* ========== CALIBRATION DATA ==========
@@ -95,7 +96,7 @@ static int32_t Right_C  = 0;
 
 
 /* ========== HELPER FUNCTION FOR CALIBRATION ==========
- * Solve for A, B, C given 3 calibration points using iterative linearization.
+ * Solve for A, B, C given 3 calibration points, exact fit through all three.
  * Model: D = A/(n + B) + C
  *
  * @param adc  Array of 3 ADC readings
@@ -107,86 +108,41 @@ static int32_t Right_C  = 0;
  */
 static int32_t SolveCalibrationParams(int32_t adc[3], int32_t dist[3],
                                        int32_t *A, int32_t *B, int32_t *C) {
-    int32_t C_guess;
-    int32_t iterations;
-    int32_t iter, i;
-    int64_t sum_n, sum_y, sum_ny, sum_nn;
-    int32_t D_adjusted;
-    int64_t y, n;
-    int64_t numerator, denominator;
-    int64_t m, A_new, b, B_new;
-    int64_t residual_sum;
-    int32_t predicted;
+    int32_t dn12, dn23, dD12, dD23;
+    int32_t r12, r23, det;
+    int32_t B_new, C_new;
+    int64_t A_new;
 
     /* Check for invalid inputs */
     if (dist[0] <= 0 || dist[1] <= 0 || dist[2] <= 0) return -1;
     if (adc[0] == adc[1] || adc[1] == adc[2] || adc[0] == adc[2]) return -1;
 
-    /* Iterative linearization method */
-    /* Start with C = 0 guess */
-    C_guess = 0;
-    iterations = 5;  /* Usually converges in 2-3 iterations */
-
-    for (iter = 0; iter < iterations; iter++) {
-        /* Transform: y = 1/(D - C_guess), then y = (1/A)*n + (B/A) */
-        /* This becomes linear regression: y = m*n + b, where m = 1/A, b = B/A */
-
-        sum_n = 0;
-        sum_y = 0;
-        sum_ny = 0;
-        sum_nn = 0;
-
-        for (i = 0; i < 3; i++) {
-            D_adjusted = dist[i] - C_guess;
-            if (D_adjusted <= 0) {
-                /* Adjust C_guess if it's too large */
-                C_guess = dist[i] - 10;  /* Leave some margin */
-                D_adjusted = 10;
-            }
-
-            /* y = 1/D_adjusted (scaled by 1000000 to avoid floating point) */
-            y = (1000000LL * 1000) / D_adjusted;
-            n = adc[i];
-
-            sum_n  += n;
-            sum_y  += y;
-            sum_ny += n * y / 1000;  /* Scale down to prevent overflow */
-            sum_nn += n * n;
-        }
-
-        /* Linear regression: m = (N*sum_xy - sum_x*sum_y) / (N*sum_xx - sum_x*sum_x) */
-        numerator   = 3 * sum_ny - sum_n * sum_y / 1000;
-        denominator = 3 * sum_nn - sum_n * sum_n;
-
-        if (denominator == 0) return -1;
-
-        m = (numerator * 1000) / denominator;  /* m = 1/A (scaled) */
-
-        if (m == 0) return -1;
-
-        /* A = 1/m */
-        A_new = (1000000LL * 1000000) / m;
-
-        /* b = (sum_y - m*sum_n) / N */
-        b = (sum_y - m * sum_n / 1000) / 3;
-
-        /* B = b * A */
-        B_new = (b * A_new) / 1000000;
-
-        /* Update C estimate: average residual */
-        residual_sum = 0;
-        for (i = 0; i < 3; i++) {
-            predicted = (int32_t)(A_new / (adc[i] + B_new));
-            residual_sum += (dist[i] - predicted);
-        }
-        C_guess = (int32_t)(residual_sum / 3);
-
-        /* Store final values */
-        *A = (int32_t)A_new;
-        *B = (int32_t)B_new;
-        *C = C_guess;
-    }
-
+    /* (D - C)(n + B) = A for every point, subtracting pairs of points
+     * removes A and leaves two linear equations in B and C:
+     *   B*(D1-D2) - C*(n1-n2) = D2*n2 - D1*n1
+     *   B*(D2-D3) - C*(n2-n3) = D3*n3 - D2*n2
+     * Solved by Cramer's rule. Products need 64 bits (ADC 14 bits times
+     * mm), the quotients fit in 32 bits, so Fixed_Div64 divides them
+     * without a 64-bit library divide. */
+    dn12 = adc[0] - adc[1];
+    dn23 = adc[1] - adc[2];
+    dD12 = dist[0] - dist[1];
+    dD23 = dist[1] - dist[2];
+    r12  = dist[1]*adc[1] - dist[0]*adc[0];
+    r23  = dist[2]*adc[2] - dist[1]*adc[1];
+    det  = dn12*dD23 - dD12*dn23;
+
+    if (det == 0) return -1;   /* points on a straight line, no 1/n curve */
+
+    B_new = Fixed_Div64((int64_t)dn12*r23 - (int64_t)dn23*r12, det);
+    C_new = Fixed_Div64((int64_t)dD12*r23 - (int64_t)dD23*r12, det);
+    A_new = (int64_t)(dist[0] - C_new)*(adc[0] + B_new);
+
+    if (A_new <= 0 || A_new > 0x7FFFFFFF) return -1;
+
+    *A = (int32_t)A_new;
+    *B = B_new;
+    *C = C_new;
     return 0;
 }
 
@@ -284,3 +240,42 @@ int32_t RightConvert(int32_t nr){      /* returns right distance in mm */
     }
     return length;
 }
+
+
+/* ========== THRESHOLD FUNCTIONS ==========
+ * Inverse of the conversion, so a distance threshold can be checked on
+ * the raw sample (ADC14 window comparator) without converting samples.
+ * For n + B > 0 the distance A/(n + B) + C falls as n grows, and
+ *   A/(n + B) + C < mm  <=>  n + B > A/(mm - C)  <=>  n >= A/(mm - C) + 1 - B
+ * with integer division, the same truncation the Convert functions use.
+ */
+static int32_t ToADC(int32_t A, int32_t B, int32_t C, int32_t mm) {
+    int32_t n;
+
+    if (mm > 5000) {
+        return 0;            /* Convert never returns more than 5000 */
+    }
+    if (A <= 0 || mm - C <= 0) {
+        return 16384;        /* never closer than mm */
+    }
+    n = A / (mm - C) + 1 - B;
+    if (n < 0) {
+        return 0;
+    }
+    if (n > 16384) {
+        return 16384;
+    }
+    return n;
+}
+
+int32_t LeftToADC(int32_t mm){       /* returns left threshold in ADC counts */
+    return ToADC(Left_A, Left_B, Left_C, mm);
+}
+
+int32_t CenterToADC(int32_t mm){     /* returns center threshold in ADC counts */
+    return ToADC(Center_A, Center_B, Center_C, mm);
+}
+
+int32_t RightToADC(int32_t mm){      /* returns right threshold in ADC counts */
+    return ToADC(Right_A, Right_B, Right_C, mm);
+}
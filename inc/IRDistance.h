@@ -93,6 +93,37 @@ int32_t CenterConvert(int32_t nc);
  */
 int32_t RightConvert(int32_t nr);      // returns right distance in mm
 
+/**
+ * Inverse of LeftConvert, for thresholds on the raw ADC sample
+ * (e.g. the ADC14 window comparator): LeftConvert(n) < mm exactly
+ * when n >= LeftToADC(mm).  Uses the current calibration.<br>
+ * Samples the conversion clamps to 5000 because the formula gives a
+ * negative distance (closer than the calibrated range) count as close.
+ * @param mm is the distance in mm
+ * @return smallest 14-bit sample that is closer than mm, 0 to 16384,
+ *         16384 if no sample is that close
+ * @brief  Convert a left distance threshold to ADC counts
+ */
+int32_t LeftToADC(int32_t mm);
+
+/**
+ * Inverse of CenterConvert: CenterConvert(n) < mm exactly
+ * when n >= CenterToADC(mm), negative distances count as close.
+ * @param mm is the distance in mm
+ * @return smallest 14-bit sample that is closer than mm, 0 to 16384
+ * @brief  Convert a center distance threshold to ADC counts
+ */
+int32_t CenterToADC(int32_t mm);
+
+/**
+ * Inverse of RightConvert: RightConvert(n) < mm exactly
+ * when n >= RightToADC(mm), negative distances count as close.
+ * @param mm is the distance in mm
+ * @return smallest 14-bit sample that is closer than mm, 0 to 16384
+ * @brief  Convert a right distance threshold to ADC counts
+ */
+int32_t RightToADC(int32_t mm);
+
 /**
  * Calibrate all three IR sensors using pre-defined calibration data.
  * Reads calibration arrays from IRDistance.c and computes parameters.
@@ -0,0 +1,256 @@
+/*
+ * Line.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Line.c
+// Line tracking over all 8 reflectance sensors
+
+/*
+// Example usage of Line, sample every 1 ms in TimerA1 ISR
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/Line.h"
+#include "../inc/Motor.h"
+#include "../inc/Reflectance.h"
+#include "../inc/TimerA1.h"
+
+void LineTask(void){          // every 1 ms
+  Line_Update(Reflectance_End());
+  Reflectance_Start();
+}
+
+int main(void){
+  LineEvent_t ev;
+  Clock_Init48MHz();
+  Reflectance_Init();
+  Motor_Init();
+  Line_Init(LINE_DARK, 3, 100); // 3 ms to confirm, 100 ms gap limit
+  Reflectance_Start();
+  TimerA1_Init(&LineTask, 500);
+  EnableInterrupts();
+  Motor_Forward(3000, 3000);
+  while(1){
+    if(Line_GetEvent(&ev)){
+      if(ev.Class == LINE_LEFT_BRANCH){
+        Motor_Forward(1000, 3000);  // start the turn early
+      }else if(ev.Class == LINE_DEADEND){
+        Motor_Stop();
+      }
+    }
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/Line.h"
+#include "../inc/Reflectance.h"
+
+// Scan classification, index is the 8-bit scan with 1 = line
+// A single run of set bits is classified by its extent:
+//   5 or more set bits spanning 6 or more sensors     -> FULL
+//   3 or more bits reaching bit 6 or 7, starting at 4 or below -> LEFT
+//   3 or more bits reaching bit 0 or 1, ending at 3 or above   -> RIGHT
+//   anything else                                     -> STRAIGHT
+// A bar with one sensor missing (one gap of one bit) is still a bar
+// or branch; other split patterns are NOISE.
+#define N LINE_RAW_NONE
+#define S LINE_RAW_STRAIGHT
+#define L LINE_RAW_LEFT
+#define R LINE_RAW_RIGHT
+#define F LINE_RAW_FULL
+#define X LINE_RAW_NOISE
+const uint8_t LineClassLUT[256]={
+  N, S, S, S, S, X, S, S, S, X, X, R, S, R, R, R,
+  S, X, X, X, X, X, R, R, S, X, R, R, S, R, R, R,
+  S, X, X, X, X, X, X, X, X, X, X, X, X, X, R, F,
+  S, X, X, X, X, X, R, F, S, X, R, F, S, F, R, F,
+  S, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, L, X, X, X, L, X, F, F,
+  S, X, X, X, X, X, X, X, L, X, X, X, L, X, F, F,
+  L, X, X, X, L, X, F, F, L, X, F, F, L, F, F, F,
+  S, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  L, X, X, X, X, X, X, X, L, X, X, X, F, X, F, F,
+  S, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+  L, X, X, X, X, X, X, X, L, X, X, X, F, X, F, F,
+  S, X, X, X, X, X, X, X, L, X, X, X, F, X, F, F,
+  L, X, X, X, F, X, F, F, L, X, F, F, F, F, F, F
+};
+#undef N
+#undef S
+#undef L
+#undef R
+#undef F
+#undef X
+
+#define LINE_EVENTS 8             // must be a power of 2
+
+static uint8_t Polarity;          // LINE_DARK or LINE_LIGHT
+static uint32_t Confirm;          // scans to accept a new raw class
+static uint32_t GapLimit;         // scans lost before a dead end
+static uint8_t Candidate;         // raw class being confirmed
+static uint32_t CandidateCount;   // consecutive scans of Candidate
+static uint8_t Stable;            // confirmed raw class
+static uint8_t Class;             // tracked class, see Line_Class
+static uint8_t BarPending;        // 1 after a bar until T or cross is known
+static uint8_t LostFrom;          // raw class before the line was lost
+static uint32_t LostScans;        // scans since the line was lost
+static uint32_t Scans;            // number of calls to Line_Update
+static int32_t Position;          // last valid position
+static LineEvent_t Events[LINE_EVENTS];
+static volatile uint8_t PutI, GetI;
+
+// queue one event, drop it if the queue is full
+static void post(uint8_t class, uint8_t data){
+  uint8_t next = (PutI+1)&(LINE_EVENTS-1);
+  if(next != GetI){
+    Events[PutI].Class = class;
+    Events[PutI].Data = data;
+    Events[PutI].Scan = Scans;
+    PutI = next;
+  }
+}
+
+// ------------Line_Init------------
+// Initialize the line tracker.
+// Input: polarity - LINE_DARK or LINE_LIGHT
+//        confirm  - consecutive equal scans needed to accept a new class (1 to 255)
+//        gap      - scans without a line before a gap becomes a dead end
+// Output: none
+void Line_Init(uint8_t polarity, uint32_t confirm, uint32_t gap){
+  Polarity = polarity;
+  Confirm = (confirm == 0) ? 1 : confirm;
+  GapLimit = gap;
+  Candidate = LINE_RAW_STRAIGHT;
+  CandidateCount = 0;
+  Stable = LINE_RAW_STRAIGHT;     // assume we start on the line
+  Class = LINE_STRAIGHT;
+  BarPending = 0;
+  LostFrom = LINE_RAW_STRAIGHT;
+  LostScans = 0;
+  Scans = 0;
+  Position = 0;
+  PutI = GetI = 0;
+}
+
+// ------------Line_Update------------
+// Feed one reflectance scan into the tracker.
+// Input: data - raw 8-bit scan from the reflectance sensor
+// Output: event code, LINE_NONE if this scan produced no event
+uint8_t Line_Update(uint8_t data){
+  uint8_t raw, prev;
+  uint8_t event = LINE_NONE;
+  if(Polarity == LINE_LIGHT){
+    data = ~data;
+  }
+  Scans++;
+  raw = LineClassLUT[data];
+  if(raw != LINE_RAW_NONE){
+    Position = LinePositionLUT[data];
+  }
+  // 1) hysteresis, a new class must be seen Confirm scans in a row
+  if(raw != LINE_RAW_NOISE){
+    if(raw == Candidate){
+      if(CandidateCount < Confirm){
+        CandidateCount++;
+      }
+    }else{
+      Candidate = raw;
+      CandidateCount = 1;
+    }
+  }
+  if((CandidateCount >= Confirm) && (Candidate != Stable)){
+    prev = Stable;
+    Stable = Candidate;
+    // 2) turn confirmed class changes into events
+    switch(Stable){
+      case LINE_RAW_STRAIGHT:
+        if(BarPending){
+          event = LINE_CROSS;               // line continues past the bar
+          BarPending = 0;
+        }else if((prev == LINE_RAW_NONE) && (LostScans < GapLimit)
+               && (LostFrom == LINE_RAW_STRAIGHT)){
+          event = LINE_GAP;                 // short break in the line
+        }
+        Class = LINE_STRAIGHT;
+        break;
+      case LINE_RAW_LEFT:
+        if(!BarPending){
+          event = LINE_LEFT_BRANCH;         // anticipate the turn
+          Class = LINE_LEFT_BRANCH;
+        }
+        break;
+      case LINE_RAW_RIGHT:
+        if(!BarPending){
+          event = LINE_RIGHT_BRANCH;
+          Class = LINE_RIGHT_BRANCH;
+        }
+        break;
+      case LINE_RAW_FULL:
+        BarPending = 1;                     // T or cross, decided later
+        Class = LINE_CROSS;
+        break;
+      case LINE_RAW_NONE:
+        if(BarPending){
+          event = LINE_T;                   // nothing beyond the bar
+          BarPending = 0;
+          LostFrom = LINE_RAW_FULL;
+        }else{
+          LostFrom = prev;
+        }
+        LostScans = 0;
+        Class = LINE_GAP;
+        break;
+    }
+  }
+  // 3) a gap that lasts too long is a dead end
+  if(Stable == LINE_RAW_NONE){
+    if(LostScans < 0xFFFFFFFF){
+      LostScans++;
+    }
+    if((LostScans == GapLimit) && (LostFrom == LINE_RAW_STRAIGHT)){
+      event = LINE_DEADEND;
+    }
+    if(LostScans >= GapLimit){
+      Class = LINE_DEADEND;
+    }
+  }
+  if(event != LINE_NONE){
+    post(event, data);
+  }
+  return event;
+}
+
+// ------------Line_GetEvent------------
+// Remove the oldest event from the event queue.
+// Input: ev - pointer to storage for the event
+// Output: 1 if an event was returned, 0 if the queue was empty
+int Line_GetEvent(LineEvent_t *ev){
+  if(GetI == PutI){
+    return 0;
+  }
+  *ev = Events[GetI];
+  GetI = (GetI+1)&(LINE_EVENTS-1);
+  return 1;
+}
+
+// ------------Line_Class------------
+// Current tracked class.
+// Input: none
+// Output: tracked class, see Line.h
+uint8_t Line_Class(void){
+  return Class;
+}
+
+// ------------Line_Position------------
+// Line position of the most recent scan that saw the line.
+// Input: none
+// Output: position in 0.1mm relative to center of line
+int32_t Line_Position(void){
+  return Position;
+}
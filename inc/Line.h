@@ -0,0 +1,98 @@
+/*
+ * Line.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Line tracking over all 8 QTR-8RC reflectance sensors
+// Every 8-bit scan from Reflectance_Read() or Reflectance_End() is
+// classified with a 256-entry table, filtered with hysteresis over
+// consecutive scans, and turned into events for the navigation layer:
+// straight, left/right branch, T, cross, dead end and gap.
+// Branches are reported as soon as the outer sensors confirm them, so
+// the robot can slow down and turn before the center sensors go off
+// the line.
+// bit 7 is the robot's left sensor, bit 0 is the robot's right sensor
+
+#ifndef LINE_H_
+#define LINE_H_
+
+#include <stdint.h>
+
+// Per-scan class from the lookup table
+enum LineRaw{
+  LINE_RAW_NONE,      // no sensor on the line
+  LINE_RAW_STRAIGHT,  // one narrow line (up to 3 sensors wide)
+  LINE_RAW_LEFT,      // line extends from near center to the left edge
+  LINE_RAW_RIGHT,     // line extends from near center to the right edge
+  LINE_RAW_FULL,      // bar across (nearly) the whole array
+  LINE_RAW_NOISE      // separated blobs, ignored by the tracker
+};
+
+// Tracked class and event codes
+enum LineClass{
+  LINE_NONE,          // no event
+  LINE_STRAIGHT,      // following a line
+  LINE_LEFT_BRANCH,   // branch or corner to the left
+  LINE_RIGHT_BRANCH,  // branch or corner to the right
+  LINE_T,             // bar across the line and nothing beyond it
+  LINE_CROSS,         // bar across the line and the line continues
+  LINE_DEADEND,       // line ended and did not come back within the gap limit
+  LINE_GAP            // line lost; event when it came back within the gap limit
+};
+
+// Sensor polarity
+#define LINE_DARK  0      // 1 bits are the line (black tape on a light floor)
+#define LINE_LIGHT 1      // 0 bits are the line (light tape on a dark floor)
+
+// One event from the tracker
+typedef struct LineEvent{
+  uint8_t Class;      // LINE_LEFT_BRANCH ... LINE_GAP
+  uint8_t Data;       // scan that produced the event (after polarity)
+  uint32_t Scan;      // scan number, counts calls to Line_Update
+} LineEvent_t;
+
+// 256-entry table, index is the 8-bit scan (after polarity),
+// the position of a scan is LinePositionLUT in Reflectance.h
+extern const uint8_t LineClassLUT[256];     // enum LineRaw
+
+// ------------Line_Init------------
+// Initialize the line tracker.
+// Input: polarity - LINE_DARK or LINE_LIGHT
+//        confirm  - consecutive equal scans needed to accept a new class (1 to 255)
+//        gap      - scans without a line before a gap becomes a dead end
+// Output: none
+void Line_Init(uint8_t polarity, uint32_t confirm, uint32_t gap);
+
+// ------------Line_Update------------
+// Feed one reflectance scan into the tracker.
+// Call at the sensor rate, e.g. from the periodic interrupt that
+// calls Reflectance_End().
+// Input: data - raw 8-bit scan from the reflectance sensor
+// Output: event code, LINE_NONE if this scan produced no event
+// Note: events are also queued for Line_GetEvent()
+uint8_t Line_Update(uint8_t data);
+
+// ------------Line_GetEvent------------
+// Remove the oldest event from the event queue.
+// Input: ev - pointer to storage for the event
+// Output: 1 if an event was returned, 0 if the queue was empty
+int Line_GetEvent(LineEvent_t *ev);
+
+// ------------Line_Class------------
+// Current tracked class.
+// Input: none
+// Output: LINE_STRAIGHT, LINE_LEFT_BRANCH, LINE_RIGHT_BRANCH,
+//         LINE_CROSS (on a bar), LINE_GAP (lost, may come back)
+//         or LINE_DEADEND (lost for longer than the gap limit)
+uint8_t Line_Class(void);
+
+// ------------Line_Position------------
+// Line position of the most recent scan that saw the line.
+// Input: none
+// Output: position in 0.1mm relative to center of line,
+//         positive means the line is on the robot's right
+int32_t Line_Position(void);
+
+#endif /* LINE_H_ */
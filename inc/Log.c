@@ -0,0 +1,122 @@
+/*
+ * Log.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Log.c
+// Deferred binary logging, see Log.h
+
+/*
+// Example usage of Log
+#include "../inc/Log.h"
+#include "../inc/Time.h"
+#include "../inc/UART0.h"
+
+void Control_ISR(void){
+  ...
+  LOG3(LOG_DEBUG, "err=%d left=%u right=%u", err, left, right);
+}
+
+int main(void){
+  ...
+  UART0_Init();
+  Time_Init();
+  Log_Init(&Time_NowUs32);
+  LOG0(LOG_INFO, "start");
+  while(1){
+    Log_Flush(&UART0_OutChar, 4);   // in the background
+  }
+}
+
+ On the PC
+   python tools/logdecode.py Project.out capture.bin
+ */
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Log.h"
+
+#define MASK (LOG_SIZE-1)
+#define VALID 0x00800000      // bit 23 of word 0, set when the record is complete
+
+static uint32_t Buf[LOG_SIZE];
+static volatile uint32_t Head;    // next word to reserve, producers
+static volatile uint32_t Tail;    // next word to send, Log_Flush
+static volatile uint32_t Dropped;
+static uint32_t (*Clock)(void);
+
+// ------------Log_Init------------
+// Empty the ring and select the timestamp clock.
+// Input: clock - function returning the current time, or 0
+// Output: none
+void Log_Init(uint32_t (*clock)(void)){
+  uint32_t i;
+  for(i=0; i<LOG_SIZE; i++){
+    Buf[i] = 0;
+  }
+  Head = 0;
+  Tail = 0;
+  Dropped = 0;
+  Clock = clock;
+}
+
+// ------------Log_Write------------
+// Store one record.
+// Input: head - LOG_HEAD(level, format, number of arguments)
+//        a, b, c, d - arguments, only the first n are stored
+// Output: none
+void Log_Write(uint32_t head, uint32_t a, uint32_t b, uint32_t c, uint32_t d){
+  uint32_t n = (head>>16)&0x07;
+  uint32_t start;
+  // reserve 2+n words; a preempting writer makes the store fail and we retry
+  do{
+    start = __LDREXW((uint32_t *)&Head);
+    if((start + 2 + n - Tail) > LOG_SIZE){
+      Dropped = Dropped + 1;
+      return;
+    }
+  }while(__STREXW(start + 2 + n, (uint32_t *)&Head));
+  Buf[(start+1)&MASK] = Clock ? Clock() : start;
+  if(n > 0) Buf[(start+2)&MASK] = a;
+  if(n > 1) Buf[(start+3)&MASK] = b;
+  if(n > 2) Buf[(start+4)&MASK] = c;
+  if(n > 3) Buf[(start+5)&MASK] = d;
+  __DMB();                    // arguments are in place before the record is marked complete
+  Buf[start&MASK] = head|VALID|(Dropped<<24);
+}
+
+// ------------Log_Flush------------
+// Send complete records, oldest first.
+// Input: out - byte output function, e.g. UART0_OutChar
+//        max - maximum number of records to send
+// Output: number of records sent
+uint32_t Log_Flush(void (*out)(char), uint32_t max){
+  uint32_t count = 0, tail = Tail, w, i, n;
+  while((count < max) && (tail != Head)){
+    w = Buf[tail&MASK];
+    if((w&VALID) == 0){
+      break;                  // writer preempted before finishing, try again later
+    }
+    n = 2 + ((w>>16)&0x07);
+    (*out)((char)0xA5);
+    for(i=0; i<n; i++){
+      w = Buf[(tail+i)&MASK];
+      (*out)((char)w); (*out)((char)(w>>8)); (*out)((char)(w>>16)); (*out)((char)(w>>24));
+      Buf[(tail+i)&MASK] = 0;
+    }
+    tail = tail + n;
+    Tail = tail;              // space is free for writers
+    count++;
+  }
+  return count;
+}
+
+// ------------Log_Dropped------------
+// Number of records dropped because the ring was full.
+// Input: none
+// Output: count since Log_Init()
+uint32_t Log_Dropped(void){
+  return Dropped;
+}
@@ -0,0 +1,98 @@
+/*
+ * Log.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Deferred binary logging
+// A log call stores a 16-bit format ID, a timestamp and up to four raw
+// 32-bit arguments in a RAM ring; nothing is formatted on the robot.
+// Log_Flush() sends the records over a byte output (e.g. UART0) when
+// the main loop has time, and tools/logdecode.py turns them back into
+// text on the PC.
+//
+// The format strings are placed in section .logstr, which the linker
+// command file links at address 0 as a COPY section: the strings are
+// kept in the .out file for the decoder but are not programmed into
+// flash.  The address of a string is its ID.  Add to SECTIONS in the
+// project's msp432p401r.cmd
+//     .logstr : > 0x00000000, type = COPY
+//
+// Levels below LOG_LEVEL are removed at compile time.  Define
+// LOG_LEVEL before including Log.h (or in the project options) to
+// raise it, e.g. --define=LOG_LEVEL=LOG_WARN.
+//
+// Log calls are safe from any ISR and from the foreground, and cost a
+// few tens of cycles.  When the ring is full the record is dropped and
+// counted; the count travels in the next record header.
+//
+// Record on the wire, little endian words after a 0xA5 sync byte
+//   word 0  bits 15-0 format ID, 18-16 number of arguments,
+//           20-19 level, 23 always 1, 31-24 dropped count (mod 256)
+//   word 1  timestamp
+//   word 2- arguments
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <stdint.h>
+
+#define LOG_DEBUG 0
+#define LOG_INFO  1
+#define LOG_WARN  2
+#define LOG_ERROR 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_DEBUG
+#endif
+
+#define LOG_SIZE 256          // ring size in 32-bit words, power of 2
+
+#define LOG_HEAD(level, fmt, n) \
+  (((uint32_t)(uintptr_t)(fmt)&0xFFFF)|((uint32_t)(n)<<16)|((uint32_t)(level)<<19))
+
+// helper, not used directly
+#define LOG_CALL(level, fmt, n, a, b, c, d) do{ \
+  if((level) >= LOG_LEVEL){ \
+    static const char LogFormat[] __attribute__((section(".logstr"))) = fmt; \
+    Log_Write(LOG_HEAD(level, LogFormat, n), (uint32_t)(a), (uint32_t)(b), \
+              (uint32_t)(c), (uint32_t)(d)); \
+  } }while(0)
+
+// Log with 0 to 4 arguments, printf formats %d %i %u %x %X %c with
+// optional flags and width, e.g. LOG2(LOG_INFO, "left=%d right=%d", l, r);
+#define LOG0(level, fmt)             LOG_CALL(level, fmt, 0, 0, 0, 0, 0)
+#define LOG1(level, fmt, a)          LOG_CALL(level, fmt, 1, a, 0, 0, 0)
+#define LOG2(level, fmt, a, b)       LOG_CALL(level, fmt, 2, a, b, 0, 0)
+#define LOG3(level, fmt, a, b, c)    LOG_CALL(level, fmt, 3, a, b, c, 0)
+#define LOG4(level, fmt, a, b, c, d) LOG_CALL(level, fmt, 4, a, b, c, d)
+
+// ------------Log_Init------------
+// Empty the ring and select the timestamp clock.
+// Input: clock - function returning the current time (e.g. Time_NowUs32),
+//                or 0 to stamp records with their position in the ring
+// Output: none
+void Log_Init(uint32_t (*clock)(void));
+
+// ------------Log_Write------------
+// Store one record, use the LOGn macros instead.
+// Input: head - LOG_HEAD(level, format, number of arguments)
+//        a, b, c, d - arguments, only the first n are stored
+// Output: none
+void Log_Write(uint32_t head, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+
+// ------------Log_Flush------------
+// Send complete records, oldest first.
+// Input: out - byte output function, e.g. UART0_OutChar
+//        max - maximum number of records to send
+// Output: number of records sent
+uint32_t Log_Flush(void (*out)(char), uint32_t max);
+
+// ------------Log_Dropped------------
+// Number of records dropped because the ring was full.
+// Input: none
+// Output: count since Log_Init()
+uint32_t Log_Dropped(void);
+
+#endif /* LOG_H_ */
@@ -0,0 +1,348 @@
+/*
+ * Maze.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Maze.c
+// Maze mapping with a bit-packed wall map and an incremental flood fill
+
+/*
+// Example usage of Maze, 4 x 4 course with 30 cm cells
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/Maze.h"
+#include "../inc/Motor.h"
+
+int main(void){
+  uint32_t move;
+  ...
+  Maze_Init(4, 4, 3, 0, MAZE_NORTH, 0, 3, MAZE_FLOODFILL);
+  while(1){
+    Maze_SenseIR(left_mm, center_mm, right_mm, 150);
+    while(Maze_Solve(16) == 0){}   // 16 cells per call
+    move = Maze_NextMove();
+    if(move == MAZE_RIGHT) Motor_RotateAngle(90, 1000);
+    if(move == MAZE_LEFT)  Motor_RotateAngle(-90, 1000);
+    if(move == MAZE_UTURN) Motor_RotateAngle(180, 1000);
+    if(move >= MAZE_STOP) break;
+    Motor_ForwardDist(30, 1000, 1000);
+    Maze_Advance(move);
+  }
+  Motor_Stop();
+}
+ */
+
+#include <stdint.h>
+#include "../inc/Maze.h"
+
+#define UNREACHED MAZE_UNREACHED
+
+// Walls are shared by neighbouring cells, so each wall is one bit.
+// HWall[r] bit c is the north wall of cell (r,c) and the south wall of
+// cell (r-1,c); VWall[r] bit c is the west wall of cell (r,c) and the
+// east wall of cell (r,c-1).  HSeen/VSeen mark walls that have been
+// observed, Visited marks cells the robot has been in.
+static uint16_t HWall[MAZE_MAX+1], HSeen[MAZE_MAX+1];
+static uint32_t VWall[MAZE_MAX], VSeen[MAZE_MAX];
+static uint16_t Visited[MAZE_MAX];
+
+static uint16_t Dist[MAZE_MAX*MAZE_MAX];  // flood fill distance to goal
+static uint8_t Queue[MAZE_MAX*MAZE_MAX];  // flood fill work list
+static uint32_t QHead, QTail;             // Queue indices, done when equal
+static uint32_t Solving;                  // 1 while a flood fill is in progress
+static uint32_t Calls;                    // Maze_Solve calls in this flood fill
+
+static uint32_t Rows, Cols;
+static uint32_t Row, Col, Heading;        // robot pose
+static uint32_t GoalRow, GoalCol;
+static uint32_t Solver;
+static MazeStats_t Stats;
+
+static const int8_t DRow[4] = {-1, 0, 1, 0};  // N, E, S, W
+static const int8_t DCol[4] = { 0, 1, 0,-1};
+
+// read wall bit and seen bit of one side of a cell
+static uint32_t getWall(uint32_t r, uint32_t c, uint32_t dir, uint32_t *seen){
+  switch(dir){
+    case MAZE_NORTH: *seen = (HSeen[r]>>c)&1;   return (HWall[r]>>c)&1;
+    case MAZE_SOUTH: *seen = (HSeen[r+1]>>c)&1; return (HWall[r+1]>>c)&1;
+    case MAZE_WEST:  *seen = (VSeen[r]>>c)&1;   return (VWall[r]>>c)&1;
+    default:         *seen = (VSeen[r]>>(c+1))&1; return (VWall[r]>>(c+1))&1;
+  }
+}
+
+// write one side of a cell, return 1 if the map changed
+static uint32_t putWall(uint32_t r, uint32_t c, uint32_t dir, uint32_t present){
+  uint32_t seen, old;
+  old = getWall(r, c, dir, &seen);
+  if(seen && (old == present)){
+    return 0;
+  }
+  switch(dir){
+    case MAZE_NORTH: HSeen[r] |= 1u<<c;
+      if(present) HWall[r] |= 1u<<c; else HWall[r] &= ~(1u<<c);
+      break;
+    case MAZE_SOUTH: HSeen[r+1] |= 1u<<c;
+      if(present) HWall[r+1] |= 1u<<c; else HWall[r+1] &= ~(1u<<c);
+      break;
+    case MAZE_WEST: VSeen[r] |= 1u<<c;
+      if(present) VWall[r] |= 1u<<c; else VWall[r] &= ~(1u<<c);
+      break;
+    default: VSeen[r] |= 1u<<(c+1);
+      if(present) VWall[r] |= 1u<<(c+1); else VWall[r] &= ~(1u<<(c+1));
+      break;
+  }
+  return (old != present);    // newly seen open walls do not change distances
+}
+
+// start a new flood fill from the goal
+static void replan(void){
+  uint32_t i;
+  for(i=0; i<Rows*Cols; i++){
+    Dist[i] = UNREACHED;
+  }
+  Dist[GoalRow*Cols+GoalCol] = 0;
+  Queue[0] = GoalRow*Cols+GoalCol;
+  QHead = 0; QTail = 1;
+  Solving = 1;
+  Calls = 0;
+  Stats.SolveCells = 0;
+}
+
+// ------------Maze_Init------------
+// Clear the map and place the robot.
+// Input: rows, cols - size of the maze in cells (1 to MAZE_MAX)
+//        row, col   - start cell of the robot
+//        heading    - MAZE_NORTH, MAZE_EAST, MAZE_SOUTH or MAZE_WEST
+//        goalRow, goalCol - goal cell
+//        solver     - MAZE_FLOODFILL or MAZE_LEFTHAND
+// Output: 0 if done, 1 if the size, start or goal is out of range
+int Maze_Init(uint32_t rows, uint32_t cols, uint32_t row, uint32_t col, uint32_t heading,
+               uint32_t goalRow, uint32_t goalCol, uint32_t solver){
+  uint32_t r;
+  Rows = Cols = 0;            // no map until the arguments check out
+  Solving = 0;
+  if((rows == 0) || (rows > MAZE_MAX) || (cols == 0) || (cols > MAZE_MAX) ||
+     (row >= rows) || (col >= cols) || (goalRow >= rows) || (goalCol >= cols)){
+    return 1;
+  }
+  Rows = rows; Cols = cols;
+  for(r=0; r<=MAZE_MAX; r++){
+    HWall[r] = 0; HSeen[r] = 0;
+  }
+  for(r=0; r<MAZE_MAX; r++){
+    VWall[r] = 0; VSeen[r] = 0; Visited[r] = 0;
+  }
+  // outer boundary is a known wall
+  HWall[0] = HSeen[0] = (1u<<cols)-1;
+  HWall[rows] = HSeen[rows] = (1u<<cols)-1;
+  for(r=0; r<rows; r++){
+    VWall[r] = VSeen[r] = 1u|(1u<<cols);
+  }
+  Row = row; Col = col; Heading = heading&3;
+  GoalRow = goalRow; GoalCol = goalCol;
+  Solver = solver;
+  Visited[Row] |= 1u<<Col;
+  Stats.Explored = 1;
+  Stats.Moves = 0;
+  Stats.SolveCalls = 0;
+  replan();
+  return 0;
+}
+
+// ------------Maze_SetWall------------
+// Record one wall of the robot's cell.
+// Input: dir     - absolute direction MAZE_NORTH to MAZE_WEST
+//        present - 1 if there is a wall, 0 if open
+// Output: none
+void Maze_SetWall(uint32_t dir, uint32_t present){
+  if(putWall(Row, Col, dir&3, present ? 1 : 0)){
+    replan();
+  }
+}
+
+// ------------Maze_SenseIR------------
+// Record the walls around the robot's cell from the three IR distances.
+// Input: left, center, right - IR distances in mm
+//        threshold - wall distance limit in mm
+// Output: none
+void Maze_SenseIR(int32_t left, int32_t center, int32_t right, int32_t threshold){
+  uint32_t changed;
+  changed  = putWall(Row, Col, (Heading+3)&3, left < threshold);
+  changed |= putWall(Row, Col, Heading, center < threshold);
+  changed |= putWall(Row, Col, (Heading+1)&3, right < threshold);
+  if(changed){
+    replan();
+  }
+}
+
+// ------------Maze_Solve------------
+// Run the flood fill for at most budget cells.
+// Input: budget - maximum number of cells to process in this call
+// Output: 1 when the distances are complete, 0 if more calls are needed
+uint32_t Maze_Solve(uint32_t budget){
+  uint32_t cell, r, c, d, n, seen;
+  if(!Solving){
+    return 1;
+  }
+  Calls++;
+  while((QHead != QTail) && budget){
+    cell = Queue[QHead++];
+    r = cell/Cols; c = cell%Cols;
+    for(d=0; d<4; d++){
+      if(getWall(r, c, d, &seen) == 0){   // open or not seen yet
+        n = (r+DRow[d])*Cols+(c+DCol[d]);
+        if(Dist[n] == UNREACHED){
+          Dist[n] = Dist[cell]+1;
+          Queue[QTail++] = n;
+        }
+      }
+    }
+    Stats.SolveCells++;
+    budget--;
+  }
+  if(QHead == QTail){
+    Solving = 0;
+    Stats.SolveCalls = Calls;
+    Stats.PathLength = Dist[Row*Cols+Col];
+    return 1;
+  }
+  return 0;
+}
+
+// relative move for an absolute direction
+static uint32_t moveTo(uint32_t dir){
+  switch((dir-Heading)&3){
+    case 0:  return MAZE_FORWARD;
+    case 1:  return MAZE_RIGHT;
+    case 2:  return MAZE_UTURN;
+    default: return MAZE_LEFT;
+  }
+}
+
+// ------------Maze_NextMove------------
+// Next motion primitive from the robot's cell.
+// Input: none
+// Output: enum MazeMove
+uint32_t Maze_NextMove(void){
+  // preference on ties: straight, right, left, back
+  static const uint8_t Order[4] = {0, 1, 3, 2};
+  static const uint8_t LeftOrder[4] = {3, 0, 1, 2};
+  uint32_t i, d, best, bestDist, seen;
+  if(Rows == 0){
+    return MAZE_NOPATH;       // Maze_Init failed
+  }
+  if((Row == GoalRow) && (Col == GoalCol)){
+    return MAZE_STOP;
+  }
+  if(Solver == MAZE_LEFTHAND){
+    for(i=0; i<4; i++){
+      d = (Heading+LeftOrder[i])&3;
+      if(getWall(Row, Col, d, &seen) == 0){
+        return moveTo(d);
+      }
+    }
+    return MAZE_NOPATH;
+  }
+  if(Solving){
+    return MAZE_WAIT;
+  }
+  best = 4; bestDist = UNREACHED;
+  for(i=0; i<4; i++){
+    d = (Heading+Order[i])&3;
+    if(getWall(Row, Col, d, &seen) == 0){
+      if(Dist[(Row+DRow[d])*Cols+(Col+DCol[d])] < bestDist){
+        bestDist = Dist[(Row+DRow[d])*Cols+(Col+DCol[d])];
+        best = d;
+      }
+    }
+  }
+  if(best == 4){
+    return MAZE_NOPATH;
+  }
+  return moveTo(best);
+}
+
+// ------------Maze_Advance------------
+// Update the robot's pose after a motion primitive has been driven.
+// Input: move - MAZE_FORWARD, MAZE_RIGHT, MAZE_LEFT or MAZE_UTURN
+// Output: 0 if done, 1 if the move is not a primitive, there is no map,
+//         or the cell ahead is outside the maze (the turn is kept, the
+//         robot stays in its cell)
+int Maze_Advance(uint32_t move){
+  uint32_t row, col;
+  if(Rows == 0){
+    return 1;                 // Maze_Init failed
+  }
+  switch(move){
+    case MAZE_RIGHT: Heading = (Heading+1)&3; break;
+    case MAZE_LEFT:  Heading = (Heading+3)&3; break;
+    case MAZE_UTURN: Heading = (Heading+2)&3; break;
+    case MAZE_FORWARD: break;
+    default: return 1;
+  }
+  row = Row+DRow[Heading];    // wraps to a large value off the north or west edge
+  col = Col+DCol[Heading];
+  if((row >= Rows) || (col >= Cols)){
+    return 1;
+  }
+  Row = row;
+  Col = col;
+  if((Visited[Row]&(1u<<Col)) == 0){
+    Visited[Row] |= 1u<<Col;
+    Stats.Explored++;
+  }
+  Stats.Moves++;
+  if(!Solving){
+    Stats.PathLength = Dist[Row*Cols+Col];
+  }
+  return 0;
+}
+
+// ------------Maze_Wall------------
+// Read the map.
+// Input: row, col - cell
+//        dir - absolute direction MAZE_NORTH to MAZE_WEST
+// Output: 0 open, 1 wall (or outside the maze), 2 not seen yet
+uint32_t Maze_Wall(uint32_t row, uint32_t col, uint32_t dir){
+  uint32_t seen, wall;
+  if((row >= Rows) || (col >= Cols)){
+    return 1;                 // outside the maze
+  }
+  wall = getWall(row, col, dir&3, &seen);
+  if(!seen){
+    return 2;
+  }
+  return wall;
+}
+
+// ------------Maze_Distance------------
+// Flood fill distance of a cell to the goal.
+// Input: row, col - cell
+// Output: number of cells to the goal, MAZE_UNREACHED if unreachable
+uint32_t Maze_Distance(uint32_t row, uint32_t col){
+  if((row >= Rows) || (col >= Cols)){
+    return UNREACHED;
+  }
+  return Dist[row*Cols+col];
+}
+
+// ------------Maze_Pose------------
+// Current pose of the robot in the map.
+// Input: row, col, heading - pointers to storage, any may be 0
+// Output: none
+void Maze_Pose(uint32_t *row, uint32_t *col, uint32_t *heading){
+  if(row) *row = Row;
+  if(col) *col = Col;
+  if(heading) *heading = Heading;
+}
+
+// ------------Maze_GetStats------------
+// Copy the solver statistics.
+// Input: stats - pointer to storage
+// Output: none
+void Maze_GetStats(MazeStats_t *stats){
+  *stats = Stats;
+}
@@ -0,0 +1,132 @@
+/*
+ * Maze.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Maze mapping and solving for the maze course
+// The course is a grid of up to 16 x 16 cells.  The robot records the
+// walls it sees with the IR sensors in a bit-packed map (one bit per
+// wall plus one bit per wall saying whether it has been seen), and a
+// flood-fill from the goal gives the distance of every cell to the goal.
+// Unseen walls are assumed open, so the robot explores on the way.
+// The flood fill is incremental: Maze_Solve() processes at most a given
+// number of cells per call, so it can run in a control tick without
+// blocking.  Maze_NextMove() turns the result into a motion primitive.
+// Row 0 is the north edge of the map, column 0 the west edge.
+
+#ifndef MAZE_H_
+#define MAZE_H_
+
+#include <stdint.h>
+
+#define MAZE_MAX 16       // maximum rows and columns
+#define MAZE_UNREACHED 0xFFFF // distance of a cell with no path to the goal
+
+// absolute directions
+#define MAZE_NORTH 0
+#define MAZE_EAST  1
+#define MAZE_SOUTH 2
+#define MAZE_WEST  3
+
+// solver
+#define MAZE_FLOODFILL 0  // shortest path on the known map
+#define MAZE_LEFTHAND  1  // follow the left wall, needs no map
+
+// motion primitives, each turn is followed by one cell forward
+enum MazeMove{
+  MAZE_WAIT,          // solver still running, call Maze_Solve()
+  MAZE_FORWARD,       // go straight one cell
+  MAZE_RIGHT,         // turn right 90 degrees, then one cell
+  MAZE_LEFT,          // turn left 90 degrees, then one cell
+  MAZE_UTURN,         // turn 180 degrees, then one cell
+  MAZE_STOP,          // at the goal
+  MAZE_NOPATH         // goal is walled off
+};
+
+// Solver statistics
+typedef struct MazeStats{
+  uint32_t Explored;      // number of cells visited
+  uint32_t PathLength;    // cells from the robot to the goal, MAZE_UNREACHED if no path
+  uint32_t SolveCells;    // cells processed by the last complete flood fill
+  uint32_t SolveCalls;    // Maze_Solve() calls the last flood fill needed
+  uint32_t Moves;         // number of Maze_Advance() calls
+} MazeStats_t;
+
+// ------------Maze_Init------------
+// Clear the map and place the robot.
+// Input: rows, cols - size of the maze in cells (1 to MAZE_MAX)
+//        row, col   - start cell of the robot
+//        heading    - MAZE_NORTH, MAZE_EAST, MAZE_SOUTH or MAZE_WEST
+//        goalRow, goalCol - goal cell
+//        solver     - MAZE_FLOODFILL or MAZE_LEFTHAND
+// Output: 0 if done, 1 if the size is out of range or the start or
+//         goal is outside the maze (then there is no map, Maze_NextMove
+//         returns MAZE_NOPATH)
+int Maze_Init(uint32_t rows, uint32_t cols, uint32_t row, uint32_t col, uint32_t heading,
+               uint32_t goalRow, uint32_t goalCol, uint32_t solver);
+
+// ------------Maze_SenseIR------------
+// Record the walls around the robot's cell from the three IR distances.
+// A wall is present if the distance is below threshold.
+// Input: left, center, right - IR distances in mm
+//        threshold - wall distance limit in mm
+// Output: none
+// Note: restarts the flood fill if the map changed
+void Maze_SenseIR(int32_t left, int32_t center, int32_t right, int32_t threshold);
+
+// ------------Maze_SetWall------------
+// Record one wall of the robot's cell, e.g. from a bump or a line.
+// Input: dir     - absolute direction MAZE_NORTH to MAZE_WEST
+//        present - 1 if there is a wall, 0 if open
+// Output: none
+void Maze_SetWall(uint32_t dir, uint32_t present);
+
+// ------------Maze_Solve------------
+// Run the flood fill for at most budget cells.
+// Input: budget - maximum number of cells to process in this call
+// Output: 1 when the distances are complete, 0 if more calls are needed
+uint32_t Maze_Solve(uint32_t budget);
+
+// ------------Maze_NextMove------------
+// Next motion primitive from the robot's cell.
+// Input: none
+// Output: enum MazeMove
+uint32_t Maze_NextMove(void);
+
+// ------------Maze_Advance------------
+// Update the robot's pose after a motion primitive has been driven.
+// Input: move - MAZE_FORWARD, MAZE_RIGHT, MAZE_LEFT or MAZE_UTURN
+// Output: 0 if done, 1 if the move is not a primitive, there is no map,
+//         or the cell ahead is outside the maze (the turn is kept, the
+//         robot stays in its cell)
+int Maze_Advance(uint32_t move);
+
+// ------------Maze_Wall------------
+// Read the map.
+// Input: row, col - cell
+//        dir - absolute direction MAZE_NORTH to MAZE_WEST
+// Output: 0 open, 1 wall (or outside the maze), 2 not seen yet
+uint32_t Maze_Wall(uint32_t row, uint32_t col, uint32_t dir);
+
+// ------------Maze_Distance------------
+// Flood fill distance of a cell to the goal.
+// Input: row, col - cell
+// Output: number of cells to the goal, MAZE_UNREACHED if unreachable
+//         or outside the maze
+uint32_t Maze_Distance(uint32_t row, uint32_t col);
+
+// ------------Maze_Pose------------
+// Current pose of the robot in the map.
+// Input: row, col, heading - pointers to storage, any may be 0
+// Output: none
+void Maze_Pose(uint32_t *row, uint32_t *col, uint32_t *heading);
+
+// ------------Maze_GetStats------------
+// Copy the solver statistics.
+// Input: stats - pointer to storage
+// Output: none
+void Maze_GetStats(MazeStats_t *stats);
+
+#endif /* MAZE_H_ */
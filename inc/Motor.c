@@ -60,10 +60,83 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/PWM.h"
 #include "../inc/Tachometer.h"
 #include "../inc/UART0.h"
+#include "../inc/Motor.h"
+#include "../inc/Bits.h"
 
 #define PERIOD 7500
 
 #define RSLK_MAX 1
+#if (RSLK_MAX==0)
+#define DIR_LEFT  BITS_BAND(&P1->OUT, 7)   // 1 is backward
+#define DIR_RIGHT BITS_BAND(&P1->OUT, 6)
+#else
+#define DIR_LEFT  BITS_BAND(&P5->OUT, 4)
+#define DIR_RIGHT BITS_BAND(&P5->OUT, 5)
+#endif
+
+// Output stage, runs in the TA0 CCR0 interrupt at the top of each
+// 10 ms up/down PWM period (timer equals CCR0, both outputs low).
+// Timer_A has no shadow registers, so a duty written in the middle
+// of a pulse cuts it short or doubles it.  Here the duties are only
+// written at the top, first thing in the ISR, and were computed one
+// period earlier, so the writes land within the first timer counts
+// and every pulse is complete.  The cost is 10 ms of extra delay.
+// Per period each wheel moves at most Slew toward its target.  A
+// command in the other direction first ramps to 0, stays at 0 for
+// DeadTime periods (at least 1) and only then flips the direction pin.
+// Targets are scaled by Gain here, so a new gain also applies to a
+// command that is already running.
+static volatile int32_t Target[2];    // commanded signed duty, left and right
+static uint32_t Duty[2];              // duty written at the next period boundary
+static uint32_t Back[2];              // direction pin state, 1 is backward
+static uint32_t Hold[2];              // periods at 0 duty, up to 65535
+static uint32_t Slew = 0;             // 0 is no limit
+static uint32_t DeadTime = 0;
+static volatile uint32_t Gain = MOTOR_GAIN_ONE;
+static volatile uint32_t Periods;     // PWM periods since Motor_Init
+
+// one period of one wheel, returns the duty for the next period
+static uint32_t step(uint32_t i, volatile uint8_t *dir){
+  int32_t target = Target[i];
+  uint32_t want = (target < 0) ? -target : target;
+  uint32_t back = (target < 0);
+  uint32_t duty = Duty[i];
+  want = (want*Gain)>>14;     // at most 7492*32768, fits
+  if(want > MOTOR_MAX){
+    want = MOTOR_MAX;
+  }
+  if(want && (back != Back[i])){
+    if((duty == 0) && (Hold[i] >= DeadTime)){
+      Back[i] = back;         // stopped long enough, reverse now
+      *dir = back;
+    }else{
+      want = 0;               // brake first
+    }
+  }
+  if(Slew && (duty + Slew < want)){
+    duty = duty + Slew;
+  }else if(Slew && (want + Slew < duty)){
+    duty = duty - Slew;
+  }else{
+    duty = want;
+  }
+  if(duty){
+    Hold[i] = 0;
+  }else if(Hold[i] < 0xFFFF){
+    Hold[i]++;
+  }
+  return duty;
+}
+
+void TA0_0_IRQHandler(void){
+  TIMER_A0->CCTL[0] &= ~0x0001; // acknowledge capture/compare interrupt 0
+  PWM_Duty3(Duty[0]);           // latch before the counter reaches MOTOR_MAX
+  PWM_Duty4(Duty[1]);
+  Duty[0] = step(0, &DIR_LEFT);
+  Duty[1] = step(1, &DIR_RIGHT);
+  Periods++;
+}
+
 // *******Lab 3 solution*******
 
 // ------------Motor_Init------------
@@ -96,135 +169,143 @@ void Motor_Init(void){
     P2->SEL1 &= ~0xC0;    // 1) configure P1.6, 1.7 as GPIO
     P2->DIR |= 0xC0;      // 2) make P1.6, 1.7 output
     P2->OUT &= ~0xC0;     // 3) output LOW
+    Target[0] = Target[1] = 0;
+    Duty[0] = Duty[1] = 0;
+    Back[0] = Back[1] = 0;
+    Hold[0] = Hold[1] = 0xFFFF;
   
     PWM_Init34(PERIOD, 0, 0);
+    TIMER_A0->CCTL[0] |= 0x0010;          // interrupt at the top of each period
+    NVIC->IP[2] = (NVIC->IP[2]&0xFFFFFF00)|0x00000020; // priority 1
+    NVIC->ISER[0] = 0x00000100;           // enable interrupt 8 in NVIC
+}
 
+// ------------Motor_SetSlew------------
+// Limit how fast the duty cycles change.
+// Input: slew     - largest duty change per 10 ms period, 0 for no limit
+//        deadTime - 10 ms periods at 0 duty before a wheel reverses
+// Output: none
+void Motor_SetSlew(uint16_t slew, uint16_t deadTime){
+    Slew = slew;
+    DeadTime = deadTime;
+}
+
+// ------------Motor_SetGain------------
+// Scale the commanded duty cycles, e.g. for the battery voltage.
+// Input: gain - Q14, MOTOR_GAIN_ONE is 1.0, limited to 2.0
+// Output: none
+void Motor_SetGain(uint32_t gain){
+    Gain = (gain > 2*MOTOR_GAIN_ONE) ? 2*MOTOR_GAIN_ONE : gain;
+}
+
+// ------------Motor_Periods------------
+// PWM periods since Motor_Init, for loops that run once per period.
+// Input: none
+// Output: count, incremented in the TA0 CCR0 interrupt
+uint32_t Motor_Periods(void){
+    return Periods;
+}
+
+// ------------Motor_Duty------------
+// Command signed duty cycles, negative is backward.
+// The output stage gets there at the Motor_SetSlew rate.
+// Input: left  - duty of left wheel, -MOTOR_MAX to MOTOR_MAX
+//        right - duty of right wheel, -MOTOR_MAX to MOTOR_MAX
+//        values outside the range saturate
+// Output: none
+// Assumes: Motor_Init() has been called
+void Motor_Duty(int32_t left, int32_t right){
+    long sr;
+    left = (left > MOTOR_MAX) ? MOTOR_MAX : (left < -MOTOR_MAX) ? -MOTOR_MAX : left;
+    right = (right > MOTOR_MAX) ? MOTOR_MAX : (right < -MOTOR_MAX) ? -MOTOR_MAX : right;
+    sr = StartCritical();   // both wheels change in the same period
+    if((P3->OUT&0xC0) != 0xC0){
+        Duty[0] = Duty[1] = 0;  // asleep (Motor_Stop or a bump), ramp up from 0
+        PWM_Duty3(0);
+        PWM_Duty4(0);
+    }
+    Target[0] = left;
+    Target[1] = right;
+    //Enable L and R motor
+    P3->OUT |= 0xC0;
+    EndCritical(sr);
 }
 
 // ------------Motor_Stop------------
 // Stop the motors, power down the drivers, and
 // set the PWM speed control to 0% duty cycle.
+// Takes effect at once, without slew or dead time.
 // Input: none
 // Output: none
 void Motor_Stop(void){
   // write this as part of Lab 3
+    long sr = StartCritical();
     P2->OUT &= ~0xC0;   // off
     P3->OUT &= ~0xC0;   // low current sleep mode
+    Target[0] = Target[1] = 0;
+    Duty[0] = Duty[1] = 0;
     PWM_Duty3(0);
     PWM_Duty4(0);
+    EndCritical(sr);
 }
 
 // ------------Motor_Forward------------
 // Drive the robot forward by running left and
 // right wheels forward with the given duty
 // cycles.
-// Input: leftDuty  duty cycle of left wheel (0 to 14,998)
-//        rightDuty duty cycle of right wheel (0 to 14,998)
+// Input: leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+//        rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Forward(uint16_t leftDuty, uint16_t rightDuty){ 
-  // write this as part of Lab 3
-
-    // Forward direction
-#if (RSLK_MAX==0)
-    P1->OUT &= ~0xC0;
-#else
-    P5->OUT &= ~0x30;
-#endif
-
-    PWM_Duty3(leftDuty);
-    PWM_Duty4(rightDuty);
-
-    //Enable L and R motor
-    P3->OUT |= 0xC0;
-  
+    Motor_Duty(leftDuty, rightDuty);
 }
 
 // ------------Motor_Right------------
 // Turn the robot to the right by running the
 // left wheel forward and the right wheel
 // backward with the given duty cycles.
-// Input: leftDuty  duty cycle of left wheel (0 to 14,998)
-//        rightDuty duty cycle of right wheel (0 to 14,998)
+// Input: leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+//        rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Right(uint16_t leftDuty, uint16_t rightDuty){ 
-  // write this as part of Lab 3
-    // Right direction
-#if (RSLK_MAX == 0)
-    P1->OUT &= ~0x80;
-    P1->OUT |= 0x40;
-#else
-    P5->OUT &= ~0x10;
-    P5->OUT |= 0x20;
-#endif
-
-    PWM_Duty3(leftDuty);
-    PWM_Duty4(rightDuty);
-
-    //Enable L and R motor
-    P3->OUT |= 0xC0;
-
+    Motor_Duty(leftDuty, -(int32_t)rightDuty);
 }
 
 // ------------Motor_Left------------
 // Turn the robot to the left by running the
 // left wheel backward and the right wheel
 // forward with the given duty cycles.
-// Input: leftDuty  duty cycle of left wheel (0 to 14,998)
-//        rightDuty duty cycle of right wheel (0 to 14,998)
+// Input: leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+//        rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Left(uint16_t leftDuty, uint16_t rightDuty){ 
-  // write this as part of Lab 3
-    // Right direction
-#if (RSLK_MAX == 0)
-    P1->OUT &= ~0x40;
-    P1->OUT |= 0x80;
-#else
-    P5->OUT &= ~0x20;
-    P5->OUT |= 0x10;
-#endif
-    PWM_Duty3(leftDuty);
-    PWM_Duty4(rightDuty);
-
-    //Enable L and R motor
-    P3->OUT |= 0xC0;
-
+    Motor_Duty(-(int32_t)leftDuty, rightDuty);
 }
 
 // ------------Motor_Backward------------
 // Drive the robot backward by running left and
 // right wheels backward with the given duty
 // cycles.
-// Input: leftDuty  duty cycle of left wheel (0 to 14,998)
-//        rightDuty duty cycle of right wheel (0 to 14,998)
+// Input: leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+//        rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Backward(uint16_t leftDuty, uint16_t rightDuty){ 
-  // write this as part of Lab 3
-    // Backward direction
-#if (RSLK_MAX==0)
-    P1->OUT |= 0xC0;
-#else
-    P5->OUT |= 0x30;
-#endif
-    PWM_Duty3(leftDuty);
-    PWM_Duty4(rightDuty);
-
-    //Enable L and R motor
-    P3->OUT |= 0xC0;
-
+    Motor_Duty(-(int32_t)leftDuty, -(int32_t)rightDuty);
 }
 
 
 
 // by aloy
 #include <stdlib.h> // for abs()
+#include "../inc/Trig.h"
 // Robot physical parameters (adjust these based on your robot measurements)
 #define WHEELBASE 145          // Distance between wheels in mm
 #define WHEEL_CIRCUMFERENCE 220 // Wheel circumference in mm (from Tachometer.h: 360 steps per 220mm)
-#define STEPS_PER_REVOLUTION 360.0
+#define STEPS_PER_REVOLUTION 360
 
 // External references to tachometer step counters
 extern int Tachometer_LeftSteps;
@@ -248,7 +329,8 @@ void Motor_RotateAngle(int16_t angle, uint16_t speed) {
     // Formula: arc_length = (wheelbase * PI * angle) / 360
     //          steps = (arc_length / wheel_circumference) * 360
     // Combined: steps = (wheelbase * PI * angle * 360) / (360 * wheel_circumference)
-    targetSteps = (uint32_t)((WHEELBASE * 3.14159 * abs(angle) * 360) / (360 * WHEEL_CIRCUMFERENCE));
+    // PI in Q12 so no double math, the constant folds to 8481 (2.0706 in Q12)
+    targetSteps = (abs(angle) * ((WHEELBASE * TRIG_PI_Q12) / WHEEL_CIRCUMFERENCE)) >> 12;
 
     // Reset tachometer step counters
     DisableInterrupts();
@@ -286,8 +368,8 @@ void Motor_RotateAngle(int16_t angle, uint16_t speed) {
 /**
  * Drive the robot forward for a specified distance
  * @param distance_cm distance to travel in cm
- * @param leftDuty duty cycle of left wheel (0 to 14,998)
- * @param rightDuty duty cycle of right wheel (0 to 14,998)
+ * @param leftDuty duty cycle of left wheel (0 to MOTOR_MAX)
+ * @param rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
  * @return none
  * @note This is a blocking function that waits until distance is reached
  * @note Requires Tachometer_Init() to be called first
@@ -67,6 +67,11 @@ policies, either expressed or implied, of the FreeBSD Project.
 
 // *******Lab 13 solution*******
 
+#define MOTOR_MAX      7492   // largest duty, PWM period 7500 less 5 us to latch it
+#define MOTOR_SLEW     375    // suggested duty change per 10 ms, 0 to full in 200 ms
+#define MOTOR_DEADTIME 2      // suggested 10 ms periods at 0 before reversing
+#define MOTOR_GAIN_ONE 16384  // Motor_SetGain of 1.0, Q14
+
 /**
  * Initialize GPIO pins for output, which will be
  * used to control the direction of the motors and
@@ -80,9 +85,57 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 void Motor_Init(void);
 
+/**
+ * Limit how fast the duty cycles change.  New duty cycles are applied
+ * at the start of a PWM period, moving at most slew per 10 ms period.
+ * A wheel that must change direction ramps to 0, stays at 0 for
+ * deadTime periods (at least 1, brake), then ramps up the other way.
+ * @param slew largest duty change per 10 ms period, 0 for no limit
+ * @param deadTime 10 ms periods at 0 duty before a wheel reverses
+ * @return none
+ * @note Default is no limit and no dead time, duties change at once as
+ *       before. Motor_SetSlew(MOTOR_SLEW, MOTOR_DEADTIME) ramps them
+ * @brief  Set acceleration limit and reversing dead time
+ */
+void Motor_SetSlew(uint16_t slew, uint16_t deadTime);
+
+/**
+ * Scale every commanded duty cycle before it reaches the PWM, e.g. by
+ * nominal/actual battery voltage so a duty gives the same motor
+ * voltage on fresh and on tired batteries.  The new gain is used from
+ * the next 10 ms period on, also for a command already running.
+ * @param gain Q14 factor, MOTOR_GAIN_ONE is 1.0, up to 2*MOTOR_GAIN_ONE
+ * @return none
+ * @note Scaled duty cycles saturate at MOTOR_MAX. Default is MOTOR_GAIN_ONE
+ * @brief  Set the duty cycle gain
+ */
+void Motor_SetGain(uint32_t gain);
+
+/**
+ * Count of 10 ms PWM periods, incremented at the top of each period
+ * after the output stage has latched its duties.  A loop that waits
+ * for it to change runs once per period, in step with the PWM.
+ * @return PWM periods since Motor_Init(), wraps at 2^32
+ * @brief  PWM periods since Motor_Init
+ */
+uint32_t Motor_Periods(void);
+
+/**
+ * Command signed duty cycles for both wheels, negative is backward.
+ * The drivers are enabled at once and the duty cycles reach the
+ * command at the Motor_SetSlew rate.
+ * @param left  duty cycle of left wheel (-MOTOR_MAX to MOTOR_MAX)
+ * @param right duty cycle of right wheel (-MOTOR_MAX to MOTOR_MAX)
+ * @return none
+ * @note Values outside the range saturate. Assumes Motor_Init() has been called
+ * @brief  Drive the wheels with signed duty cycles
+ */
+void Motor_Duty(int32_t left, int32_t right);
+
 /**
  * Stop the motors, power down the drivers, and
  * set the PWM speed control to 0% duty cycle.
+ * Takes effect at once, without slew or dead time.
  * @param none
  * @return none
  * @brief  Stop the robot
@@ -93,8 +146,8 @@ void Motor_Stop(void);
  * Drive the robot forward by running left and
  * right wheels forward with the given duty
  * cycles.
- * @param leftDuty  duty cycle of left wheel (0 to 14,998)
- * @param rightDuty duty cycle of right wheel (0 to 14,998)
+ * @param leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+ * @param rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
  * @return none
  * @note Assumes Motor_Init() has been called
  * @brief  Drive the robot forward
@@ -105,8 +158,8 @@ void Motor_Forward(uint16_t leftDuty, uint16_t rightDuty);
  * Turn the robot to the right by running the
  * left wheel forward and the right wheel
  * backward with the given duty cycles.
- * @param leftDuty  duty cycle of left wheel (0 to 14,998)
- * @param rightDuty duty cycle of right wheel (0 to 14,998)
+ * @param leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+ * @param rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
  * @return none
  * @note Assumes Motor_Init() has been called
  * @brief  Turn the robot to the right
@@ -117,8 +170,8 @@ void Motor_Right(uint16_t leftDuty, uint16_t rightDuty);
  * Turn the robot to the left by running the
  * left wheel backward and the right wheel
  * forward with the given duty cycles.
- * @param leftDuty  duty cycle of left wheel (0 to 14,998)
- * @param rightDuty duty cycle of right wheel (0 to 14,998)
+ * @param leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+ * @param rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
  * @return none
  * @note Assumes Motor_Init() has been called
  * @brief  Turn the robot to the left
@@ -129,8 +182,8 @@ void Motor_Left(uint16_t leftDuty, uint16_t rightDuty);
  * Drive the robot backward by running left and
  * right wheels backward with the given duty
  * cycles.
- * @param leftDuty  duty cycle of left wheel (0 to 14,998)
- * @param rightDuty duty cycle of right wheel (0 to 14,998)
+ * @param leftDuty  duty cycle of left wheel (0 to MOTOR_MAX)
+ * @param rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
  * @return none
  * @note Assumes Motor_Init() has been called
  * @brief  Drive the robot backward
@@ -140,9 +193,10 @@ void Motor_Backward(uint16_t leftDuty, uint16_t rightDuty);
 /**
  * Rotate the robot by a specified angle
  * @param angle degrees to rotate (positive = clockwise/right, negative = counterclockwise/left)
- * @param speed PWM duty cycle (0 to 14998)
+ * @param speed PWM duty cycle (0 to MOTOR_MAX)
  * @return none
  * @note This is a blocking function that waits until rotation completes
+ * @note Motor_ProfiledRotateAngle() in MotorProfile.h ramps the speed and stops on the last step
  * @note Requires Tachometer_Init() to be called first
  * @brief Rotate robot by specified angle
  */
@@ -151,10 +205,11 @@ void Motor_RotateAngle(int16_t angle, uint16_t speed);
 /**
  * Drive the robot forward for a specified distance
  * @param distance_cm distance to travel in cm
- * @param leftDuty duty cycle of left wheel (0 to 14,998)
- * @param rightDuty duty cycle of right wheel (0 to 14,998)
+ * @param leftDuty duty cycle of left wheel (0 to MOTOR_MAX)
+ * @param rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
  * @return none
  * @note This is a blocking function that waits until distance is reached
+ * @note Motor_ProfiledForwardDist() in MotorProfile.h ramps the speed and stops on the last step
  * @note Requires Tachometer_Init() to be called first
  * @note 360 steps = 22 cm (220 mm wheel circumference)
  * @brief Drive forward for specified distance
@@ -0,0 +1,252 @@
+/*
+ * MotorCal.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// MotorCal.c
+// Duty sweep, flash storage and feed-forward lookup for the motors,
+// the fitting is in MotorFit.c
+
+/*
+// Example usage of MotorCal, robot on the floor with room to spin
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/Motor.h"
+#include "../inc/MotorCal.h"
+#include "../inc/Tachometer.h"
+#include "../inc/Time.h"
+
+int main(void){
+  Clock_Init48MHz();
+  Time_Init();
+  Motor_Init();
+  Tachometer_Init();
+  EnableInterrupts();
+  if(MotorCal_Init() == 0){     // nothing in flash yet
+    MotorCal_Start(&Time_NowUs32);
+    while(MotorCal_Run()){};    // about a minute
+    MotorCal_Save();
+  }
+  // 200 mm/s on both wheels, the motors differ but the duties
+  // make up for it, a speed controller only adds a small correction
+  Motor_Duty(MotorCal_Duty(0, 200), MotorCal_Duty(1, 200));
+  while(1){};
+}
+ */
+
+#include <stdint.h>
+#include "../inc/MotorCal.h"
+#include "../inc/Motor.h"
+#include "../inc/Tachometer.h"
+#include "../inc/FlashProgram.h"
+
+#define MAGIC 0x314C434D         // "MCL1"
+
+static MotorCalCurve_t Curves[4];
+#define WORDS (sizeof(Curves)/4)   // 32-bit flash words, Gain aligns each curve to 4 bytes
+static int16_t Speeds[4][MOTORCAL_POINTS]; // last sweep, mm/s
+static uint32_t (*Clock)(void);
+static uint32_t Phase = 2;      // 0 spinning right, 1 spinning left, 2 done
+static uint32_t Index;          // point, duty is Index*MOTORCAL_STEP
+static uint32_t Measuring;      // 0 settling, 1 counting steps
+static uint32_t Start;          // us, beginning of settling or counting
+static int32_t LeftStart, RightStart;
+static uint32_t Image[WORDS+2]; // flash record, magic, curves, check
+static uint32_t Loaded;         // Curves valid
+
+static uint32_t check(const uint32_t *words, uint32_t n){
+  uint32_t sum = 0, i;
+  for(i=0; i<n; i++){
+    sum = ((sum<<1)|(sum>>31))+words[i];
+  }
+  return ~sum;
+}
+
+// straight line, no deadband, MOTORCAL_NOMINAL mm/s at MOTOR_MAX
+static void nominal(MotorCalCurve_t *c){
+  uint32_t k;
+  c->Gain = (MOTORCAL_NOMINAL*65536)/MOTOR_MAX;
+  c->Deadband = 0;
+  c->MaxSpeed = MOTORCAL_NOMINAL;
+  for(k=0; k<MOTORCAL_LUT; k++){
+    c->Duty[k] = (k*MOTOR_MAX)/(MOTORCAL_LUT-1);
+  }
+}
+
+static void steps(int32_t *left, int32_t *right){
+  uint16_t tach;
+  enum TachDirection dir;
+  Tachometer_Get(&tach, &dir, left, &tach, &dir, right);
+}
+
+// curves from flash, or nominal, returns 1 if from flash
+static int load(void){
+  const uint32_t *flash = (const uint32_t *)MOTORCAL_FLASH_ADDR;
+  uint32_t i;
+  Loaded = 1;
+  if((flash[0] == MAGIC) && (flash[WORDS+1] == check(flash, WORDS+1))){
+    for(i=0; i<WORDS; i++){
+      ((uint32_t *)Curves)[i] = flash[i+1];
+    }
+    return 1;
+  }
+  for(i=0; i<4; i++){
+    nominal(&Curves[i]);
+  }
+  return 0;
+}
+
+// ------------MotorCal_Init------------
+// Load the curves from flash, or use the nominal straight line.
+// Input: none
+// Output: 1 if calibrated curves were loaded, 0 if nominal
+int MotorCal_Init(void){
+  Phase = 2;
+  return load();
+}
+
+// ------------MotorCal_Start------------
+// Begin a sweep, about 60 s of spinning in place.
+// Input: clock - function returning time in us
+// Output: none
+void MotorCal_Start(uint32_t (*clock)(void)){
+  if(Loaded == 0){
+    load();                     // a curve that does not fit keeps these
+  }
+  Clock = clock;
+  Phase = 0;
+  Index = 0;
+  Measuring = 0;
+  Start = Clock();
+  Motor_Duty(0, 0);
+}
+
+// ------------MotorCal_Run------------
+// Advance the sweep, call every few ms until it returns 0.
+// Input: none
+// Output: 1 while the sweep is running, 0 when done
+int MotorCal_Run(void){
+  uint16_t duty[MOTORCAL_POINTS];
+  int32_t left, right, ms, duty0;
+  uint32_t now, i, c;
+  if(Phase >= 2){
+    return 0;
+  }
+  now = Clock();
+  if(Measuring == 0){
+    if((now - Start) >= MOTORCAL_SETTLE*1000){
+      steps(&LeftStart, &RightStart);
+      Start = now;
+      Measuring = 1;
+    }
+    return 1;
+  }
+  if((now - Start) < MOTORCAL_MEASURE*1000){
+    return 1;
+  }
+  steps(&left, &right);
+  ms = (now - Start)/1000;
+  // 360 steps per 220 mm, forward steps count up
+  left = ((left - LeftStart)*220000)/(360*ms);
+  right = ((right - RightStart)*220000)/(360*ms);
+  if(Phase == 0){               // left forward, right backward
+    Speeds[MOTORCAL_LEFT_FWD][Index] = left;
+    Speeds[MOTORCAL_RIGHT_BACK][Index] = -right;
+  }else{
+    Speeds[MOTORCAL_LEFT_BACK][Index] = -left;
+    Speeds[MOTORCAL_RIGHT_FWD][Index] = right;
+  }
+  Measuring = 0;
+  Start = now;
+  Index++;
+  if(Index >= MOTORCAL_POINTS){
+    Index = 0;
+    Phase++;
+    if(Phase >= 2){
+      Motor_Stop();
+      for(i=0; i<MOTORCAL_POINTS; i++){
+        duty[i] = i*MOTORCAL_STEP;
+      }
+      for(c=0; c<4; c++){       // a wheel that never moved keeps its curve
+        MotorCal_Fit(duty, Speeds[c], MOTORCAL_POINTS, &Curves[c]);
+      }
+      return 0;
+    }
+  }
+  duty0 = Index*MOTORCAL_STEP;  // the reversal waits out the motor dead time
+  if(Phase == 0){
+    Motor_Duty(duty0, -duty0);
+  }else{
+    Motor_Duty(-duty0, duty0);
+  }
+  return 1;
+}
+
+// ------------MotorCal_Abort------------
+// Stop a sweep and the motors, the curves do not change.
+// Input: none
+// Output: none
+void MotorCal_Abort(void){
+  if(Phase < 2){
+    Phase = 2;
+    Motor_Stop();
+  }
+}
+
+// ------------MotorCal_Sample------------
+// Input: curve - MOTORCAL_LEFT_FWD ... MOTORCAL_RIGHT_BACK
+//        i     - point, duty is i*MOTORCAL_STEP
+// Output: mm/s
+int32_t MotorCal_Sample(uint32_t curve, uint32_t i){
+  if((curve > 3) || (i >= MOTORCAL_POINTS)){
+    return 0;
+  }
+  return Speeds[curve][i];
+}
+
+// ------------MotorCal_Curve------------
+// Input: curve - MOTORCAL_LEFT_FWD ... MOTORCAL_RIGHT_BACK
+// Output: pointer to the curve in use
+const MotorCalCurve_t *MotorCal_Curve(uint32_t curve){
+  if(Loaded == 0){
+    load();                     // used before MotorCal_Init
+  }
+  return &Curves[curve&3];
+}
+
+// ------------MotorCal_Save------------
+// Write the curves in use to flash.
+// Input: none
+// Output: 0 if saved, 1 if the flash erase or write failed
+int MotorCal_Save(void){
+  uint32_t i;
+  Image[0] = MAGIC;
+  for(i=0; i<WORDS; i++){
+    Image[i+1] = ((uint32_t *)Curves)[i];
+  }
+  Image[WORDS+1] = check(Image, WORDS+1);
+  if(Flash_Erase(MOTORCAL_FLASH_ADDR) == ERROR){
+    return 1;
+  }
+  if(Flash_WriteArray(Image, MOTORCAL_FLASH_ADDR, WORDS+2) != WORDS+2){
+    return 1;
+  }
+  return 0;
+}
+
+// ------------MotorCal_Duty------------
+// Feed-forward duty for a wheel speed
+// Input: wheel - 0 left, 1 right
+//        speed - mm/s, negative is backward
+// Output: signed duty for Motor_Duty
+int32_t MotorCal_Duty(uint32_t wheel, int32_t speed){
+  const MotorCalCurve_t *c = MotorCal_Curve((wheel&1)*2 + (speed < 0));
+  if(speed < 0){
+    return -(int32_t)MotorCal_Lookup(c, -speed);
+  }
+  return MotorCal_Lookup(c, speed);
+}
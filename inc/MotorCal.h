@@ -0,0 +1,138 @@
+/*
+ * MotorCal.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Motor characterization and duty feed-forward
+// MotorCal_Run sweeps the duty cycle in MOTORCAL_STEP steps, spinning
+// the robot in place both ways, so every wheel is measured in both
+// directions without the robot leaving its spot.  At each step the
+// wheels settle for MOTORCAL_SETTLE ms, then the tachometer steps are
+// counted for MOTORCAL_MEASURE ms.  Counting steps over a window still
+// works near the deadband, where the 16-bit tachometer period of a
+// barely turning wheel is stale.
+// MotorCal_Fit (MotorFit.c, plain C, also builds on a PC) turns the
+// sweep of one wheel in one direction into a curve:
+//   - speeds made nondecreasing (pool adjacent violators)
+//   - least-squares line through the points that move, its zero is
+//     the deadband and its slope the gain
+//   - inverse table, duty for MOTORCAL_LUT speeds from 0 to the
+//     fastest speed seen, nondecreasing
+// MotorCal_Duty looks up the duty for a wheel speed, the feed-forward
+// part of a speed controller; the feedback only corrects what is left.
+// MotorCal_Speed is the other way around, the speed a duty gives.
+// MotorCal_Save keeps the curves in flash, MotorCal_Init loads them
+// (the first MotorCal_Curve or MotorCal_Duty does if it was not called).
+
+#ifndef MOTORCAL_H_
+#define MOTORCAL_H_
+
+#include <stdint.h>
+
+#define MOTORCAL_STEP    250    // duty step of the sweep
+#define MOTORCAL_SETTLE  400    // ms after each step before measuring
+#define MOTORCAL_MEASURE 600    // ms of counting steps per point
+#define MOTORCAL_POINTS  30     // duty 0 to 7250, MOTOR_MAX/MOTORCAL_STEP+1
+#define MOTORCAL_MOVING  10     // mm/s, slower counts as standing still
+#define MOTORCAL_NOMINAL 500    // mm/s at MOTOR_MAX before calibration
+#define MOTORCAL_LUT     17     // inverse table entries
+#define MOTORCAL_MAXPOINTS 64   // most points MotorCal_Fit takes
+#ifndef MOTORCAL_FLASH_ADDR
+#define MOTORCAL_FLASH_ADDR 0x0003E000 // 4 KB sector below the Param sector
+#endif
+
+// curves, wheel*2 + direction
+#define MOTORCAL_LEFT_FWD   0
+#define MOTORCAL_LEFT_BACK  1
+#define MOTORCAL_RIGHT_FWD  2
+#define MOTORCAL_RIGHT_BACK 3
+
+// One wheel in one direction, speeds in mm/s, duties 0 to MOTOR_MAX
+typedef struct MotorCalCurve{
+  int32_t Gain;                   // mm/s per duty above the deadband, Q16.16
+  uint16_t Deadband;              // duty where the wheel starts to turn
+  uint16_t MaxSpeed;              // fastest speed measured
+  uint16_t Duty[MOTORCAL_LUT];    // duty for speed k*MaxSpeed/(MOTORCAL_LUT-1)
+} MotorCalCurve_t;
+
+// ------------MotorCal_Init------------
+// Load the curves from flash, or use the nominal straight line
+// (no deadband, MOTORCAL_NOMINAL at MOTOR_MAX) if none are saved.
+// Input: none
+// Output: 1 if calibrated curves were loaded, 0 if nominal
+int MotorCal_Init(void);
+
+// ------------MotorCal_Start------------
+// Begin a sweep, about 60 s of spinning in place.
+// Input: clock - function returning time in us, e.g. Time_NowUs32
+// Output: none
+// Assumes: Motor_Init() and Tachometer_Init() have been called
+void MotorCal_Start(uint32_t (*clock)(void));
+
+// ------------MotorCal_Run------------
+// Advance the sweep, call every few ms until it returns 0.
+// At the end the motors stop and the new curves are used.
+// Input: none
+// Output: 1 while the sweep is running, 0 when done (or not started)
+int MotorCal_Run(void);
+
+// ------------MotorCal_Abort------------
+// Stop a sweep and the motors, the curves do not change.
+// Input: none
+// Output: none
+void MotorCal_Abort(void);
+
+// ------------MotorCal_Sample------------
+// Speed measured by the last sweep
+// Input: curve - MOTORCAL_LEFT_FWD ... MOTORCAL_RIGHT_BACK
+//        i     - point, duty is i*MOTORCAL_STEP
+// Output: mm/s, 0 or more
+int32_t MotorCal_Sample(uint32_t curve, uint32_t i);
+
+// ------------MotorCal_Curve------------
+// Input: curve - MOTORCAL_LEFT_FWD ... MOTORCAL_RIGHT_BACK
+// Output: pointer to the curve in use
+const MotorCalCurve_t *MotorCal_Curve(uint32_t curve);
+
+// ------------MotorCal_Save------------
+// Write the curves in use to flash.
+// Input: none
+// Output: 0 if saved, 1 if the flash erase or write failed
+// Note: takes a few ms, stop the motors first
+int MotorCal_Save(void);
+
+// ------------MotorCal_Duty------------
+// Feed-forward duty for a wheel speed
+// Input: wheel - 0 left, 1 right
+//        speed - mm/s, negative is backward
+// Output: signed duty for Motor_Duty, 0 for speed 0,
+//         +-MOTOR_MAX above the fastest speed measured
+int32_t MotorCal_Duty(uint32_t wheel, int32_t speed);
+
+// ------------MotorCal_Fit------------
+// Fit one wheel in one direction from a sweep.
+// Input: duty  - duty of each point, increasing
+//        speed - mm/s of each point, in the driven direction
+//        n     - number of points, 2 to MOTORCAL_MAXPOINTS
+//        curve - result
+// Output: 0 if fitted, 1 if fewer than two points move (curve unchanged)
+int MotorCal_Fit(const uint16_t *duty, const int16_t *speed, uint32_t n, MotorCalCurve_t *curve);
+
+// ------------MotorCal_Lookup------------
+// Inverse of a curve
+// Input: curve - fitted curve
+//        speed - mm/s, 0 or more
+// Output: duty, 0 for speed 0, MOTOR_MAX above curve->MaxSpeed
+uint32_t MotorCal_Lookup(const MotorCalCurve_t *curve, uint32_t speed);
+
+// ------------MotorCal_Speed------------
+// Speed a duty gives, the other way around from MotorCal_Lookup
+// Input: curve - fitted curve
+//        duty  - 0 to MOTOR_MAX
+// Output: mm/s, 0 up to the deadband, curve->MaxSpeed at the top of
+//         the table and above
+uint32_t MotorCal_Speed(const MotorCalCurve_t *curve, uint32_t duty);
+
+#endif /* MOTORCAL_H_ */
@@ -0,0 +1,193 @@
+/*
+ * MotorFit.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// MotorFit.c
+// Curve fitting for MotorCal, no hardware access, so a recorded sweep
+// can be fitted and checked on a PC with the same code.
+
+/*
+// Example, fit a sweep copied from the "cal" shell command on a PC
+//   gcc -I../inc fit.c ../inc/MotorFit.c
+#include <stdio.h>
+#include <stdint.h>
+#include "MotorCal.h"
+
+uint16_t Duty[] = {0, 250, 500, 750, 1000, 1250, 1500};
+int16_t Speed[] = {0,   0,   0,  12,   31,   49,   70};   // mm/s
+
+int main(void){
+  MotorCalCurve_t c;
+  int k;
+  if(MotorCal_Fit(Duty, Speed, 7, &c)){
+    printf("wheel does not move\n");
+    return 1;
+  }
+  printf("deadband %u gain %.4f mm/s per duty\n", c.Deadband, c.Gain/65536.0);
+  for(k=0; k<=70; k=k+10){
+    printf("%d mm/s -> duty %u\n", k, MotorCal_Lookup(&c, k));
+  }
+  return 0;
+}
+ */
+
+#include <stdint.h>
+#include "../inc/MotorCal.h"
+#include "../inc/Motor.h"
+#include "../inc/Fixed.h"
+
+// least-squares nondecreasing fit (pool adjacent violators), in place
+// every block of points is replaced by its mean
+static void monotone(int32_t *y, uint32_t n){
+  int32_t sum[MOTORCAL_MAXPOINTS];
+  uint32_t count[MOTORCAL_MAXPOINTS];
+  uint32_t blocks = 0, i, j, k;
+  for(i=0; i<n; i++){
+    sum[blocks] = y[i];
+    count[blocks] = 1;
+    blocks++;
+    // merge while the previous block has the larger mean
+    while((blocks > 1) && (sum[blocks-2]*(int32_t)count[blocks-1] > sum[blocks-1]*(int32_t)count[blocks-2])){
+      sum[blocks-2] += sum[blocks-1];
+      count[blocks-2] += count[blocks-1];
+      blocks--;
+    }
+  }
+  k = 0;
+  for(i=0; i<blocks; i++){
+    for(j=0; j<count[i]; j++){
+      y[k++] = sum[i]/(int32_t)count[i];
+    }
+  }
+}
+
+// ------------MotorCal_Fit------------
+// Fit one wheel in one direction from a sweep.
+// Input: duty  - duty of each point, increasing
+//        speed - mm/s of each point, in the driven direction
+//        n     - number of points, 2 to MOTORCAL_MAXPOINTS
+//        curve - result
+// Output: 0 if fitted, 1 if fewer than two points move (curve unchanged)
+int MotorCal_Fit(const uint16_t *duty, const int16_t *speed, uint32_t n, MotorCalCurve_t *curve){
+  int32_t y[MOTORCAL_MAXPOINTS];
+  int32_t x0, v, d, sumY, gain, dead, still;
+  int64_t sxy;
+  uint32_t first, m, i, k, sxx;
+  if((n < 2) || (n > MOTORCAL_MAXPOINTS)){
+    return 1;
+  }
+  for(i=0; i<n; i++){
+    y[i] = (speed[i] < 0) ? 0 : speed[i];  // turning the wrong way is standing still
+  }
+  monotone(y, n);
+  first = 0;
+  while((first < n) && (y[first] < MOTORCAL_MOVING)){
+    first++;
+  }
+  m = n - first;                  // points that move
+  if(m < 2){
+    return 1;
+  }
+  // line through the moving points, x measured from its mean so the
+  // sums fit: sxx <= m*(7500/2)^2
+  sumY = 0;
+  x0 = 0;
+  for(i=first; i<n; i++){
+    x0 += duty[i];
+    sumY += y[i];
+  }
+  x0 = x0/(int32_t)m;
+  sxx = 0;
+  sxy = 0;
+  for(i=first; i<n; i++){
+    d = duty[i] - x0;
+    sxx += d*d;
+    sxy += (int64_t)d*y[i];
+  }
+  if(sxx == 0){
+    return 1;
+  }
+  gain = Fixed_Div64(sxy*65536, (int32_t)sxx);   // Q16 mm/s per duty
+  // zero of the line, between the last point standing still and the
+  // first point that moves
+  dead = duty[first];
+  if(gain > 0){
+    dead = x0 - Fixed_Div64((int64_t)sumY*65536, (int32_t)m*gain);
+  }
+  if(dead > (int32_t)duty[first]){
+    dead = duty[first];
+  }
+  still = 0;
+  for(i=0; i<first; i++){
+    if(y[i] == 0){
+      still = duty[i];
+    }
+  }
+  if(dead < still){
+    dead = still;
+  }
+  curve->Gain = gain;
+  curve->Deadband = dead;
+  curve->MaxSpeed = y[n-1];
+  // inverse table on the polyline (dead,0), (duty[first],y[first]), ...
+  curve->Duty[0] = dead;
+  i = first;
+  for(k=1; k<MOTORCAL_LUT; k++){
+    v = (k*curve->MaxSpeed)/(MOTORCAL_LUT-1);
+    while(y[i] < v){              // y[n-1] is MaxSpeed, so this stops
+      i++;
+    }
+    if(i == first){
+      d = dead + (v*((int32_t)duty[first] - dead))/y[first];
+    }else{
+      d = duty[i-1] + ((v - y[i-1])*((int32_t)duty[i] - duty[i-1]))/(y[i] - y[i-1]);
+    }
+    curve->Duty[k] = (d < curve->Duty[k-1]) ? curve->Duty[k-1] : d;
+  }
+  return 0;
+}
+
+// ------------MotorCal_Lookup------------
+// Inverse of a curve
+// Input: curve - fitted curve
+//        speed - mm/s, 0 or more
+// Output: duty, 0 for speed 0, MOTOR_MAX above curve->MaxSpeed
+uint32_t MotorCal_Lookup(const MotorCalCurve_t *curve, uint32_t speed){
+  uint32_t max = curve->MaxSpeed, k, f;
+  if(speed == 0){
+    return 0;
+  }
+  if((speed > max) || (max == 0)){
+    return MOTOR_MAX;
+  }
+  k = (speed*(MOTORCAL_LUT-1))/max;
+  if(k >= MOTORCAL_LUT-1){
+    return curve->Duty[MOTORCAL_LUT-1];
+  }
+  f = speed*(MOTORCAL_LUT-1) - k*max;   // 0 to max-1
+  return curve->Duty[k] + ((curve->Duty[k+1] - curve->Duty[k])*f)/max;
+}
+
+// ------------MotorCal_Speed------------
+// Speed a duty gives, the other way around from MotorCal_Lookup
+// Input: curve - fitted curve
+//        duty  - 0 to MOTOR_MAX
+// Output: mm/s, 0 up to the deadband, curve->MaxSpeed at the top of
+//         the table and above
+uint32_t MotorCal_Speed(const MotorCalCurve_t *curve, uint32_t duty){
+  uint32_t max = curve->MaxSpeed, k = 0;
+  if(duty <= curve->Duty[0]){
+    return 0;
+  }
+  if(duty >= curve->Duty[MOTORCAL_LUT-1]){
+    return max;
+  }
+  while(curve->Duty[k+1] <= duty){  // Duty[k] < duty < Duty[LUT-1]
+    k++;
+  }
+  // Duty[k+1] > Duty[k] here, and (duty-Duty[k])*max < 7500*65536
+  return (k*max + ((duty - curve->Duty[k])*max)/(curve->Duty[k+1] - curve->Duty[k]))/(MOTORCAL_LUT-1);
+}
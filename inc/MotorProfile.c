@@ -0,0 +1,161 @@
+/*
+ * MotorProfile.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+/*
+// Example usage of the profiled moves
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/Motor.h"
+#include "../inc/MotorCal.h"
+#include "../inc/MotorProfile.h"
+#include "../inc/Tachometer.h"
+
+void main(void){
+    DisableInterrupts();
+    Clock_Init48MHz();
+    Motor_Init();
+    Tachometer_Init();
+    MotorCal_Init();         // speed curves from flash, or nominal ones
+    EnableInterrupts();
+    if(Motor_ProfiledForwardDist(30, 3000, 3000) != MOTOR_MOVE_DONE){
+        while(1);            // bumped or stalled
+    }
+    Motor_ProfiledRotateAngle(90, 2000);
+    while(1);
+}
+ */
+
+#include <stdint.h>
+#include <stdlib.h> // for abs()
+#include "msp.h"
+#include "../inc/Motor.h"
+#include "../inc/MotorCal.h"
+#include "../inc/MotorProfile.h"
+#include "../inc/Profile.h"
+#include "../inc/Tachometer.h"
+#include "../inc/Trig.h"
+
+// Robot physical parameters, as in Motor.c
+#define WHEELBASE 145          // Distance between wheels in mm
+#define WHEEL_CIRCUMFERENCE 220 // Wheel circumference in mm (from Tachometer.h: 360 steps per 220mm)
+#define STEPS_PER_REVOLUTION 360
+
+// Each wheel is asked for the profile speed, plus MOVE_KP steps/s per
+// step it is behind, plus the acceleration times MOVE_LEAD to make up
+// for the latched output and the motor lag.  MotorCal turns that speed
+// into a duty, deadband included, so even one step of error moves it.
+#define MOVE_HZ     100        // ticks per s, one per 10 ms PWM period
+#define MOVE_ACCEL  800        // steps/s^2, 490 mm/s^2
+#define MOVE_JERK   8000       // steps/s^3
+#define MOVE_KP     12         // steps/s per step of position error
+#define MOVE_LEAD   70         // ms, 10 ms output delay and the motor lag
+#define MOVE_SETTLE 50         // periods to reach the end after the profile
+
+// wait for the start of the next PWM period
+static void period(void){
+    uint32_t last = Motor_Periods();
+    while(Motor_Periods() == last){};
+}
+
+// run a profile of distance steps, the right wheel turns the other way
+// if spin is 1, returns MOTOR_MOVE_DONE ... MOTOR_MOVE_RANGE
+static uint32_t move(int32_t distance, uint32_t vmax, uint32_t spin){
+    Profile_t p;
+    uint16_t leftTach, rightTach;
+    enum TachDirection leftDir, rightDir;
+    int32_t leftStart, rightStart, leftSteps, rightSteps;
+    int32_t leftErr, rightErr, speed, sign = spin ? -1 : 1;
+    uint32_t left, settle = 0, running = 0;
+    if(distance == 0){
+        return MOTOR_MOVE_DONE;
+    }
+    if(vmax < MOTOR_MOVE_VMIN){
+        vmax = MOTOR_MOVE_VMIN;     // a duty in the deadband still moves
+    }
+    left = Profile_Start(&p, distance, vmax, MOVE_ACCEL, MOVE_JERK, MOVE_HZ);
+    if(left == 0){
+        return MOTOR_MOVE_RANGE;
+    }
+    Tachometer_Get(&leftTach, &leftDir, &leftStart,
+                   &rightTach, &rightDir, &rightStart);
+    while(1){
+        period();
+        if(left){
+            left = Profile_Next(&p);
+        }else{
+            settle++;
+        }
+        Tachometer_Get(&leftTach, &leftDir, &leftSteps,
+                       &rightTach, &rightDir, &rightSteps);
+        leftErr = p.Position - (leftSteps - leftStart);
+        rightErr = sign*p.Position - (rightSteps - rightStart);
+        if((left == 0) && (abs(leftErr) <= 1) && (abs(rightErr) <= 1)){
+            break;
+        }
+        if(settle >= MOVE_SETTLE){
+            Motor_Stop();
+            return MOTOR_MOVE_STALLED;
+        }
+        if(running && ((P3->OUT&0xC0) != 0xC0)){
+            return MOTOR_MOVE_STOPPED;  // stopped by someone else, stay stopped
+        }
+        running = 1;
+        speed = p.Velocity + (p.Acceleration*MOVE_LEAD)/1000;  // steps/s
+        Motor_Duty(MotorCal_Duty(0, ((speed + MOVE_KP*leftErr)*WHEEL_CIRCUMFERENCE)/STEPS_PER_REVOLUTION),
+                   MotorCal_Duty(1, ((sign*speed + MOVE_KP*rightErr)*WHEEL_CIRCUMFERENCE)/STEPS_PER_REVOLUTION));
+    }
+    Motor_Stop();
+    return MOTOR_MOVE_DONE;
+}
+
+// profile speed limit in steps/s for the duties, the slower wheel sets
+// it, leftCurve and rightCurve are MOTORCAL_LEFT_FWD ... for the
+// direction each wheel turns
+static uint32_t limit(uint16_t leftDuty, uint16_t rightDuty,
+                      uint32_t leftCurve, uint32_t rightCurve){
+    uint32_t left = MotorCal_Speed(MotorCal_Curve(leftCurve), leftDuty);
+    uint32_t right = MotorCal_Speed(MotorCal_Curve(rightCurve), rightDuty);
+    if(right < left){
+        left = right;
+    }
+    return (left*STEPS_PER_REVOLUTION)/WHEEL_CIRCUMFERENCE;
+}
+
+// ------------Motor_ProfiledRotateAngle------------
+// Rotate in place by an angle, the wheels on a speed profile.
+// Input: angle - degrees, positive is clockwise (right)
+//        speed - duty cycle (0 to MOTOR_MAX) that sets the cruise speed
+// Output: MOTOR_MOVE_DONE, MOTOR_MOVE_STOPPED, MOTOR_MOVE_STALLED or
+//         MOTOR_MOVE_RANGE
+uint32_t Motor_ProfiledRotateAngle(int16_t angle, uint16_t speed){
+    // arc length of each wheel is WHEELBASE*PI*angle/360 mm, in steps
+    // WHEELBASE*PI*angle/WHEEL_CIRCUMFERENCE, PI in Q12 so no double math
+    int32_t targetSteps = (abs(angle) * ((WHEELBASE * TRIG_PI_Q12) / WHEEL_CIRCUMFERENCE)) >> 12;
+    if(angle > 0){              // left wheel forward
+        return move(targetSteps, limit(speed, speed, MOTORCAL_LEFT_FWD, MOTORCAL_RIGHT_BACK), 1);
+    }
+    return move(-targetSteps, limit(speed, speed, MOTORCAL_LEFT_BACK, MOTORCAL_RIGHT_FWD), 1);
+}
+
+// ------------Motor_ProfiledForwardDist------------
+// Drive a distance, both wheels on the same speed profile.
+// Input: distance_cm - cm, negative is backward
+//        leftDuty    - duty cycle (0 to MOTOR_MAX) of the left wheel
+//        rightDuty   - duty cycle (0 to MOTOR_MAX) of the right wheel,
+//                      the slower speed of the two is the cruise speed
+// Output: MOTOR_MOVE_DONE, MOTOR_MOVE_STOPPED, MOTOR_MOVE_STALLED or
+//         MOTOR_MOVE_RANGE
+uint32_t Motor_ProfiledForwardDist(int16_t distance_cm, uint16_t leftDuty, uint16_t rightDuty){
+    // 360 steps = 22 cm (220 mm circumference)
+    int32_t targetSteps = ((int32_t)distance_cm * 360) / 22;
+    if(distance_cm > 0){
+        return move(targetSteps, limit(leftDuty, rightDuty, MOTORCAL_LEFT_FWD, MOTORCAL_RIGHT_FWD), 0);
+    }
+    return move(targetSteps, limit(leftDuty, rightDuty, MOTORCAL_LEFT_BACK, MOTORCAL_RIGHT_BACK), 0);
+}
@@ -0,0 +1,60 @@
+/*
+ * MotorProfile.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Profiled distance moves, the optional counterpart of
+// Motor_ForwardDist and Motor_RotateAngle in Motor.c
+// The wheels follow a Profile (Profile.h) on the tachometer steps, one
+// tick per 10 ms PWM period, so they neither slip at the start nor
+// coast past the end.  MotorCal gives each wheel the duty for the
+// profile speed, and the position error corrects what is left.
+// A project that uses these links MotorProfile.c, Profile.c,
+// MotorCal.c, MotorFit.c and FlashProgram.c; one that does not keeps
+// linking Motor.c alone.
+// The duty arguments set the cruise speed, through MotorCal_Speed.  A
+// duty in the deadband would give no speed at all, so the cruise speed
+// is at least MOTOR_MOVE_VMIN and every move gets somewhere.
+
+#ifndef MOTORPROFILE_H_
+#define MOTORPROFILE_H_
+
+#include <stdint.h>
+
+#define MOTOR_MOVE_VMIN    40   // steps/s, 24 mm/s, slowest cruise speed
+
+#define MOTOR_MOVE_DONE    0    // ended within 1 step of the distance
+#define MOTOR_MOVE_STOPPED 1    // Motor_Stop or a bump stopped it
+#define MOTOR_MOVE_STALLED 2    // a wheel did not get there, stopped
+#define MOTOR_MOVE_RANGE   3    // could not be planned, did not move
+
+/**
+ * Rotate the robot in place by a specified angle on a speed profile
+ * @param angle degrees to rotate (positive = clockwise/right, negative = counterclockwise/left)
+ * @param speed PWM duty cycle (0 to MOTOR_MAX), the speed it gives is the cruise speed
+ * @return MOTOR_MOVE_DONE, or why it ended early (MOTOR_MOVE_STOPPED ...)
+ * @note This is a blocking function that waits until rotation completes
+ * @note 0 degrees returns MOTOR_MOVE_DONE at once
+ * @note Requires Motor_Init() and Tachometer_Init() to be called first
+ * @brief Rotate robot by specified angle, profiled
+ */
+uint32_t Motor_ProfiledRotateAngle(int16_t angle, uint16_t speed);
+
+/**
+ * Drive the robot a specified distance on a speed profile
+ * @param distance_cm distance to travel in cm, negative is backward
+ * @param leftDuty duty cycle of left wheel (0 to MOTOR_MAX)
+ * @param rightDuty duty cycle of right wheel (0 to MOTOR_MAX)
+ * @return MOTOR_MOVE_DONE, or why it ended early (MOTOR_MOVE_STOPPED ...)
+ * @note The slower speed the two duties give is the cruise speed, both wheels travel the same distance
+ * @note This is a blocking function that waits until distance is reached
+ * @note 0 cm returns MOTOR_MOVE_DONE at once
+ * @note Requires Motor_Init() and Tachometer_Init() to be called first
+ * @note 360 steps = 22 cm (220 mm wheel circumference)
+ * @brief Drive specified distance, profiled
+ */
+uint32_t Motor_ProfiledForwardDist(int16_t distance_cm, uint16_t leftDuty, uint16_t rightDuty);
+
+#endif /* MOTORPROFILE_H_ */
@@ -0,0 +1,329 @@
+/*
+ * NPI.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// NPI.c
+// Interrupt-driven NPI transport to the CC2650 over UART1, MRDY and SRDY
+
+/*
+// Example usage of NPI, ask for the SNP version without blocking
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/GPIO.h"
+#include "../inc/UART1.h"
+#include "../inc/NPI.h"
+
+const uint8_t GetVersion[] = {0xFE,0x00,0x00,0x35,0x03,0x36};
+uint8_t Frame[NPI_FRAMESIZE];
+
+int main(void){
+  Clock_Init48MHz();
+  GPIO_Init();
+  UART1_Init();
+  NPI_Init();
+  EnableInterrupts();
+  NPI_Send(GetVersion);
+  while(1){
+    if(NPI_Receive(Frame, NPI_FRAMESIZE)){
+      // Frame[3],Frame[4] are CMD0,CMD1
+    }
+    // robot control runs here while frames move
+  }
+}
+ */
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/CortexM.h"
+#include "../inc/GPIO.h"
+#include "../inc/UART1.h"
+#include "../inc/NPI.h"
+
+#define SOF 0xFE
+
+// parser states, the next field expected
+#define WAIT_SOF 0
+#define GET_LEN0 1
+#define GET_LEN1 2
+#define GET_CMD0 3
+#define GET_CMD1 4
+#define GET_DATA 5
+#define GET_FCS  6
+
+// handshake states
+#define IDLE         0   // MRDY high, nothing to do
+#define TX_WAIT_SRDY 1   // MRDY low, waiting for SNP to drop SRDY
+#define TX_SENDING   2   // frame going out of UART1
+#define TX_RELEASE   3   // MRDY high, waiting for SNP to raise SRDY
+#define RX           4   // SNP dropped SRDY, MRDY low, frame coming in
+
+static uint8_t RxQ[NPI_RXFRAMES][NPI_FRAMESIZE];
+static uint32_t RxSize[NPI_RXFRAMES];
+static volatile uint32_t RxPutI, RxGetI;
+static uint8_t TxQ[NPI_TXFRAMES][NPI_FRAMESIZE];
+static uint32_t TxSize[NPI_TXFRAMES];
+static volatile uint32_t TxPutI, TxGetI;
+static volatile uint32_t State;
+static NPIParser_t Parser;
+static NPIStats_t Stats;
+
+// ------------NPIParser_Init------------
+// Start a parser waiting for SOF.
+// Input: p   - pointer to parser
+//        buf - buffer for the frame
+//        max - size of buf
+// Output: none
+void NPIParser_Init(NPIParser_t *p, uint8_t *buf, uint32_t max){
+  p->Buf = buf;
+  p->Max = max;
+  p->State = WAIT_SOF;
+  p->Len = 0;
+  p->Count = 0;
+  p->Fcs = 0;
+}
+
+// ------------NPIParser_Put------------
+// Feed one received byte to the parser.
+// Input: p    - pointer to parser
+//        data - received byte
+// Output: NPI_MORE, NPI_DONE or NPI_ERROR
+int NPIParser_Put(NPIParser_t *p, uint8_t data){
+  if(p->State == WAIT_SOF){
+    if(data != SOF){
+      Stats.Junk++;
+      return NPI_MORE;
+    }
+    p->Count = 0;
+    p->Fcs = 0;
+    p->State = GET_LEN0;
+  }else{
+    p->Fcs = p->Fcs^data;
+    switch(p->State){
+      case GET_LEN0: p->Len = data; p->State = GET_LEN1; break;
+      case GET_LEN1: p->Len = p->Len+(data<<8); p->State = GET_CMD0; break;
+      case GET_CMD0: p->State = GET_CMD1; break;
+      case GET_CMD1: p->State = (p->Len) ? GET_DATA : GET_FCS; break;
+      case GET_DATA:
+        if(p->Count == p->Len+4){  // SOF, 2 length, 2 command, Len payload
+          p->State = GET_FCS;
+        }
+        break;
+      default: break;              // GET_FCS, handled below
+    }
+  }
+  if(p->Count < p->Max){
+    p->Buf[p->Count] = data;
+  }
+  p->Count++;
+  if(p->State == GET_FCS && p->Count == p->Len+6){
+    p->State = WAIT_SOF;
+    return (p->Fcs == 0) ? NPI_DONE : NPI_ERROR;  // FCS byte cancels a good running EOR
+  }
+  return NPI_MORE;
+}
+
+// ------------NPIParser_Busy------------
+// Check for a partial frame.
+// Input: p - pointer to parser
+// Output: 1 if in the middle of a frame, 0 otherwise
+int NPIParser_Busy(NPIParser_t *p){
+  return (p->State != WAIT_SOF);
+}
+
+static void txDone(void);
+
+// MRDY low and wait for the SNP, called with the link idle
+static void startTx(void){
+  if(TxGetI != TxPutI){
+    State = TX_WAIT_SRDY;
+    ClearMRDY();
+    if(ReadSRDY() == 0){           // SNP already waiting, no edge will come
+      State = TX_SENDING;
+      UART1_Write(TxQ[TxGetI], TxSize[TxGetI], &txDone);
+    }
+  }
+}
+
+// UART1 has sent the last bit of the frame, runs in EUSCIA2_IRQHandler
+static void txDone(void){
+  if(State == TX_SENDING){
+    TxGetI = (TxGetI+1)&(NPI_TXFRAMES-1);
+    Stats.TxFrames++;
+    State = TX_RELEASE;
+    SetMRDY();
+    if(ReadSRDY()){                // SNP already let go
+      State = IDLE;
+      startTx();
+    }
+  }
+}
+
+// one byte from the SNP, runs in EUSCIA2_IRQHandler
+static void rxByte(uint8_t data){
+  int r = NPIParser_Put(&Parser, data);
+  if(r == NPI_MORE){
+    return;
+  }
+  if(r == NPI_DONE){
+    if(((RxPutI+1)&(NPI_RXFRAMES-1)) == RxGetI){
+      Stats.Overrun++;             // keep the parser on the same slot
+    }else{
+      RxSize[RxPutI] = Parser.Count;
+      RxPutI = (RxPutI+1)&(NPI_RXFRAMES-1);
+      Stats.RxFrames++;
+    }
+  }else{
+    Stats.FcsErr++;
+  }
+  NPIParser_Init(&Parser, RxQ[RxPutI], NPI_FRAMESIZE);
+  if(State == RX){
+    SetMRDY();                     // frame done, SNP raises SRDY next
+  }
+}
+
+// SRDY changed, both edges are used by flipping the edge select
+void SRDY_IRQHandler(void){
+  uint8_t level;
+  do{
+    level = SRDY_PORT->IN&SRDY_BIT;
+    if(level){
+      SRDY_PORT->IES |= SRDY_BIT;  // high now, next edge is falling
+    }else{
+      SRDY_PORT->IES &= ~SRDY_BIT; // low now, next edge is rising
+    }
+    SRDY_PORT->IFG &= ~SRDY_BIT;   // writing IES may set IFG
+  }while(level != (SRDY_PORT->IN&SRDY_BIT));
+  if(level == 0){                  // SNP is ready
+    if(State == TX_WAIT_SRDY){
+      State = TX_SENDING;
+      UART1_Write(TxQ[TxGetI], TxSize[TxGetI], &txDone);
+    }else if(State == IDLE){       // SNP has a frame for us
+      State = RX;
+      ClearMRDY();
+    }
+  }else{                           // SNP is done
+    if(State == RX){
+      if(NPIParser_Busy(&Parser)){
+        Stats.Truncated++;
+        NPIParser_Init(&Parser, RxQ[RxPutI], NPI_FRAMESIZE);
+      }
+      SetMRDY();
+      State = IDLE;
+    }else if(State == TX_RELEASE){
+      State = IDLE;
+    }
+    if(State == IDLE){
+      startTx();
+    }
+  }
+}
+
+// ------------NPI_Init------------
+// Take over UART1 receive and the SRDY pin, and arm their interrupts.
+// Input: none
+// Output: none
+void NPI_Init(void){
+  RxPutI = RxGetI = 0;
+  TxPutI = TxGetI = 0;
+  State = IDLE;
+  Stats.RxFrames = Stats.TxFrames = Stats.FcsErr = Stats.Junk = 0;
+  Stats.Truncated = Stats.Overrun = Stats.Aborted = 0;
+  NPIParser_Init(&Parser, RxQ[0], NPI_FRAMESIZE);
+  SetMRDY();
+  UART1_SetRxTask(&rxByte);
+  if(ReadSRDY()){
+    SRDY_PORT->IES |= SRDY_BIT;    // falling edge first
+  }else{
+    SRDY_PORT->IES &= ~SRDY_BIT;
+  }
+  SRDY_PORT->IFG &= ~SRDY_BIT;
+  SRDY_PORT->IE |= SRDY_BIT;       // arm SRDY edge interrupt
+  SRDY_NVIC_PRIORITY(2);           // same as UART1, so the two ISRs never nest
+  SRDY_NVIC_ENABLE();
+}
+
+// ------------NPI_Send------------
+// Queue a frame for transmission, the FCS is calculated here.
+// Input: msg - NPI frame, SOF through payload
+// Output: 0 if queued, 1 if the frame is too big or the queue is full
+int NPI_Send(const uint8_t *msg){
+  uint32_t size, i, sr; uint8_t fcs = 0; uint8_t *pt;
+  size = msg[1]+(msg[2]<<8)+6;
+  if(size > NPI_FRAMESIZE || ((TxPutI+1)&(NPI_TXFRAMES-1)) == TxGetI){
+    return 1;
+  }
+  pt = TxQ[TxPutI];                // only the foreground writes this slot
+  pt[0] = SOF;
+  for(i=1; i<size-1; i++){
+    pt[i] = msg[i];
+    fcs = fcs^msg[i];
+  }
+  pt[size-1] = fcs;
+  TxSize[TxPutI] = size;
+  sr = StartCritical();
+  TxPutI = (TxPutI+1)&(NPI_TXFRAMES-1);
+  if(State == IDLE){
+    startTx();
+  }
+  EndCritical(sr);
+  return 0;
+}
+
+// ------------NPI_Receive------------
+// Remove the oldest received frame from the queue.
+// Input: buf - buffer into which the frame is copied
+//        max - size of buf
+// Output: size of the frame, 0 if no frame is waiting
+uint32_t NPI_Receive(uint8_t *buf, uint32_t max){
+  uint32_t size, i;
+  if(RxGetI == RxPutI){
+    return 0;
+  }
+  size = RxSize[RxGetI];
+  for(i=0; i<size && i<max && i<NPI_FRAMESIZE; i++){
+    buf[i] = RxQ[RxGetI][i];
+  }
+  RxGetI = (RxGetI+1)&(NPI_RXFRAMES-1);  // slot may be reused by the ISR now
+  return size;
+}
+
+// ------------NPI_Available------------
+// Input: none
+// Output: number of received frames waiting
+uint32_t NPI_Available(void){
+  return (RxPutI-RxGetI)&(NPI_RXFRAMES-1);
+}
+
+// ------------NPI_TxIdle------------
+// Input: none
+// Output: 1 if every queued frame has been sent and the link is idle
+int NPI_TxIdle(void){
+  return (TxGetI == TxPutI) && (State == IDLE);
+}
+
+// ------------NPI_Abort------------
+// Give up on the frame being sent, release MRDY and go idle.
+// Input: none
+// Output: none
+void NPI_Abort(void){
+  uint32_t sr = StartCritical();
+  if((State == TX_WAIT_SRDY || State == TX_SENDING) && TxGetI != TxPutI){
+    TxGetI = (TxGetI+1)&(NPI_TXFRAMES-1);
+    Stats.Aborted++;
+  }
+  SetMRDY();
+  State = IDLE;
+  startTx();                       // next frame, if any
+  EndCritical(sr);
+}
+
+// ------------NPI_GetStats------------
+// Input: stats - pointer to structure to receive the debugging counts
+// Output: none
+void NPI_GetStats(NPIStats_t *stats){
+  *stats = Stats;
+}
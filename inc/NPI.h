@@ -0,0 +1,120 @@
+/*
+ * NPI.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Interrupt-driven NPI transport to the CC2650 SimpleNP
+// Frames are SOF, LSB length, MSB length, CMD0, CMD1, payload, FCS,
+// where FCS is the 8-bit EOR of all bytes except SOF and FCS itself.
+// Received bytes are parsed one at a time in the EUSCI_A2 RX ISR, and
+// completed frames are queued for the foreground.  Frames to send are
+// queued by NPI_Send and moved out by the MRDY/SRDY handshake, which
+// runs from the SRDY edge interrupt and the UART1 transmit interrupt.
+// Nothing in this module busy-waits.
+
+#ifndef NPI_H_
+#define NPI_H_
+
+#include <stdint.h>
+
+#define NPI_FRAMESIZE 128   // largest frame kept, bytes beyond this are dropped
+#define NPI_RXFRAMES 4      // received frames queued, must be power of 2
+#define NPI_TXFRAMES 4      // frames waiting to be sent, must be power of 2
+
+// return values of NPIParser_Put
+#define NPI_MORE 0          // frame not yet complete
+#define NPI_DONE 1          // frame complete, FCS matches
+#define NPI_ERROR -1        // frame complete, FCS does not match
+
+// Incremental frame parser, one byte at a time
+typedef struct NPIParser {
+  uint8_t *Buf;        // frame is stored here, Buf[0] is SOF
+  uint32_t Max;        // size of Buf, bytes beyond are counted but not stored
+  uint32_t State;      // next field expected
+  uint32_t Len;        // payload length from the frame
+  uint32_t Count;      // bytes of the frame so far, including SOF
+  uint8_t Fcs;         // running EOR
+} NPIParser_t;
+
+// Debugging counts
+typedef struct NPIStats {
+  uint32_t RxFrames;   // good frames received
+  uint32_t TxFrames;   // frames sent
+  uint32_t FcsErr;     // frames received with a bad FCS
+  uint32_t Junk;       // bytes discarded while looking for SOF
+  uint32_t Truncated;  // frames cut short by SRDY going high
+  uint32_t Overrun;    // good frames lost because the receive queue was full
+  uint32_t Aborted;    // frames dropped by NPI_Abort
+} NPIStats_t;
+
+// ------------NPIParser_Init------------
+// Start a parser waiting for SOF.
+// Input: p   - pointer to parser
+//        buf - buffer for the frame
+//        max - size of buf
+// Output: none
+void NPIParser_Init(NPIParser_t *p, uint8_t *buf, uint32_t max);
+
+// ------------NPIParser_Put------------
+// Feed one received byte to the parser.
+// Bytes before SOF are discarded.  A frame is complete after
+// length+6 bytes; p->Count then holds the frame size.
+// Input: p    - pointer to parser
+//        data - received byte
+// Output: NPI_MORE, NPI_DONE or NPI_ERROR; after NPI_DONE or
+//         NPI_ERROR the parser waits for the next SOF
+// Note: constant time, safe to call from an ISR
+int NPIParser_Put(NPIParser_t *p, uint8_t data);
+
+// ------------NPIParser_Busy------------
+// Check for a partial frame.
+// Input: p - pointer to parser
+// Output: 1 if SOF has been seen but the frame is not complete, 0 otherwise
+int NPIParser_Busy(NPIParser_t *p);
+
+// ------------NPI_Init------------
+// Take over UART1 receive and the SRDY pin, and arm their interrupts.
+// GPIO_Init and UART1_Init must be called once prior.
+// Input: none
+// Output: none
+void NPI_Init(void);
+
+// ------------NPI_Send------------
+// Queue a frame for transmission, the FCS is calculated here.
+// The frame is copied, so msg may be changed as soon as this returns.
+// Input: msg - NPI frame, SOF through payload (FCS byte is ignored)
+// Output: 0 if queued, 1 if the frame is too big or the queue is full
+int NPI_Send(const uint8_t *msg);
+
+// ------------NPI_Receive------------
+// Remove the oldest received frame from the queue.
+// Input: buf - buffer into which the frame is copied, starting with SOF
+//        max - size of buf, the rest of the frame is discarded
+// Output: size of the frame, 0 if no frame is waiting
+uint32_t NPI_Receive(uint8_t *buf, uint32_t max);
+
+// ------------NPI_Available------------
+// Input: none
+// Output: number of received frames waiting
+uint32_t NPI_Available(void);
+
+// ------------NPI_TxIdle------------
+// Input: none
+// Output: 1 if every queued frame has been sent and the link is idle
+int NPI_TxIdle(void);
+
+// ------------NPI_Abort------------
+// Give up on the frame being sent, release MRDY and go idle.
+// Call after the SNP has not answered for too long.
+// Input: none
+// Output: none
+void NPI_Abort(void);
+
+// ------------NPI_GetStats------------
+// Input: stats - pointer to structure to receive the debugging counts
+// Output: none
+void NPI_GetStats(NPIStats_t *stats);
+
+#endif /* NPI_H_ */
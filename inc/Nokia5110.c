@@ -78,17 +78,15 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "Nokia5110.h"
+#include "Convert.h"
+#include "Bits.h"
 
 // *************************** Screen dimensions ***************************
 #define SCREENW     84
 #define SCREENH     48
-// The regular 8-bit access for P9OUT  is 0x40004C82.
-// For bit-banding of bit 6 of P9OUT, n=0x4C82 and b=6.
-//    0x42000000 + 32*4C82 + 4*6 = 0x42099040+0x18 = 0x42099058
-// For bit-banding of bit 3 of P9OUT, n=0x4C82 and b=3.
-//    0x42000000 + 32*4C82 + 4*3 = 0x42099040+0x0C = 0x4209904C
-#define DC          (*((volatile uint8_t *)0x42099058))   /* Port 9 Output, bit 6 is DC*/
-#define RESET       (*((volatile uint8_t *)0x4209904C))   /* Port 9 Output, bit 3 is RESET*/
+// bit-band aliases of P9OUT (0x40004C82), 0x42099058 and 0x4209904C
+#define DC          BITS_BAND(&P9->OUT, 6)   /* Port 9 Output, bit 6 is DC*/
+#define RESET       BITS_BAND(&P9->OUT, 3)   /* Port 9 Output, bit 3 is RESET*/
 #define DC_BIT 0x40
 #define RESET_BIT 0x08
 //#define P9DIR                   (*((volatile uint8_t *)0x40004C84))   /* Port 9 Direction */
@@ -329,8 +327,9 @@ void Nokia5110_OutString(char *ptr){
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutUDec(uint16_t n){
-// write this code as part of Lab 11
-
+  char message[6];
+  Convert_UDecN(message, n, 5);
+  Nokia5110_OutString(message);
 }
 
 //********Nokia5110_OutSDec*****************
@@ -340,8 +339,9 @@ void Nokia5110_OutUDec(uint16_t n){
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutSDec(int16_t n){
-// write this code as part of Lab 11
-
+  char message[7];
+  Convert_SDecN(message, n, 6);
+  Nokia5110_OutString(message);
 }
 
 //********Nokia5110_OutUFix1*****************
@@ -352,17 +352,7 @@ void Nokia5110_OutSDec(int16_t n){
 void Nokia5110_OutUFix1(uint16_t n){
   char message[5];
   if(n>999)n=999;
-  if(n>=100){  // 100 to 999
-    message[0] = (n/100+'0'); /* tens digit */
-    n = n%100; //the rest
-  }else { // 0 to 99
-    message[0] = ' '; /* n is between 0.0 and 9.9 */
-  }
-  message[1] = (n/10+'0'); /* ones digit */
-  n = n%10; //the rest
-  message[2] = '.';
-  message[3] = (n+'0'); /* tenths digit */
-  message[4] = 0;
+  Convert_UFix(message, n, 2, 1);  // " 0.0" to "99.9"
   Nokia5110_OutString(message);
 }
 
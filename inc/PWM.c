@@ -88,24 +88,24 @@ void PWM_Init34(uint16_t period, uint16_t duty3, uint16_t duty4){
 
 //***************************PWM_Duty3*******************************
 // change duty cycle of PWM output on P2.6
-// Inputs:  duty3
+// Inputs:  duty3, period-1 or more saturates to period-1
 // Outputs: none
 // period of P2.6 is 2*period*666.7ns, duty cycle is duty3/period
 void PWM_Duty3(uint16_t duty3){
 
   // write this as part of Lab 3
-    if(duty3 >= TIMER_A0->CCR[0]) return; // bad input
+    if(duty3 >= TIMER_A0->CCR[0]) duty3 = TIMER_A0->CCR[0]-1; // saturate
     TIMER_A0->CCR[3] = duty3;        // CCR3 duty cycle is duty3/period
 }
 
 //***************************PWM_Duty4*******************************
 // change duty cycle of PWM output on P2.7
-// Inputs:  duty4
+// Inputs:  duty4, period-1 or more saturates to period-1
 // Outputs: none// period of P2.7 is 2*period*666.7ns, duty cycle is duty2/period
 void PWM_Duty4(uint16_t duty4){
 
   // write this as part of Lab 3
-    if(duty4 >= TIMER_A0->CCR[0]) return; // bad input
+    if(duty4 >= TIMER_A0->CCR[0]) duty4 = TIMER_A0->CCR[0]-1; // saturate
     TIMER_A0->CCR[4] = duty4;        // CCR4 duty cycle is duty4/period
 }
 
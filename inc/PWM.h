@@ -142,7 +142,7 @@ void PWM_Init34(uint16_t period, uint16_t duty3, uint16_t duty4);
  * @remark   Period of P2.6 is period*1.333us, duty cycle is duty3/period
  * @param    duty3 is width of high pulse on P2.6 in 1.333us units
  * @return   none
- * @warning  duty3 must be less than period
+ * @warning  duty3 of period or more saturates to period-1
  * @brief    set duty cycle on PWM3
  */
 void PWM_Duty3(uint16_t duty3);
@@ -152,7 +152,7 @@ void PWM_Duty3(uint16_t duty3);
  * @remark   Period of P2.7 is period*1.333us, duty cycle is duty3/period
  * @param    duty4 is width of high pulse on P2.7 in 1.333us units
  * @return   none
- * @warning  duty4 must be less than period
+ * @warning  duty4 of period or more saturates to period-1
  * @brief    set duty cycle on PWM4
  */
 void PWM_Duty4(uint16_t duty4);
@@ -0,0 +1,354 @@
+/*
+ * Param.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Param.c
+// Typed parameter registry with UART and flash access, BLE is in ParamBLE.c
+
+/*
+// Example usage of Param, tune a 100 Hz wall follower from the PC
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/EUSCIA0.h"
+#include "../inc/TimerA1.h"
+#include "../inc/Param.h"
+
+int32_t Kp, BaseSpeed;
+Param_t Params[] = {
+  {"Kp",        &Kp,        PARAM_INT32, 0,  200,   20, 0},
+  {"BaseSpeed", &BaseSpeed, PARAM_INT32, 0, 7500, 3000, 0},
+};
+
+void Control(void){           // 100 Hz
+  Param_Apply();              // new values only between control steps
+  ...uses Kp and BaseSpeed
+}
+
+int main(void){
+  Clock_Init48MHz();
+  EUSCIA0_Init();
+  Param_Init(Params, PARAM_COUNT(Params));
+  TimerA1_Init(&Control, 5000);
+  EnableInterrupts();
+  while(1){
+    Param_Poll();             // python tools/paramcli.py COM3 set Kp 25
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/CortexM.h"
+#include "../inc/EUSCIA0.h"
+#include "../inc/FlashProgram.h"
+#include "../inc/Param.h"
+
+#define MAGIC 0x314D5250         // "PRM1"
+#define REQSYNC 0xA6
+#define RSPSYNC 0xA7
+
+static Param_t *Table;
+static uint32_t Count;
+static int32_t Staged[PARAM_MAX];    // written by Param_Stage
+static int32_t Pending[PARAM_MAX];   // committed, waiting for Param_Apply
+static uint32_t StagedMask;          // bit i set if Staged[i] is waiting for a commit
+static volatile uint32_t PendingMask;// bit i set if Pending[i] is waiting for Param_Apply
+static uint32_t Image[PARAM_MAX+3];  // flash record, magic, layout, values, check
+static uint8_t Req[8];               // protocol request
+static uint32_t ReqN;                // bytes of Req received
+static uint8_t Fcs;                  // of the response being sent
+
+// value of the variable, widened to 32 bits
+static int32_t load(Param_t *p){
+  switch(p->Type){
+    case PARAM_INT16:  return *(int16_t *)p->pt;
+    case PARAM_UINT16: return *(uint16_t *)p->pt;
+    case PARAM_UINT8:  return *(uint8_t *)p->pt;
+    default:           return *(int32_t *)p->pt;
+  }
+}
+
+static void store(Param_t *p, int32_t value){
+  switch(p->Type){
+    case PARAM_INT16:  *(int16_t *)p->pt = value; break;
+    case PARAM_UINT16: *(uint16_t *)p->pt = value; break;
+    case PARAM_UINT8:  *(uint8_t *)p->pt = value; break;
+    default:           *(int32_t *)p->pt = value; break;
+  }
+}
+
+// FNV-1a of the names and types, flash written by another table is not loaded
+static uint32_t layout(void){
+  uint32_t h = 2166136261u, i; const char *pt;
+  for(i=0; i<Count; i++){
+    for(pt=Table[i].Name; *pt; pt++){
+      h = (h^(uint8_t)*pt)*16777619u;
+    }
+    h = (h^Table[i].Type)*16777619u;
+  }
+  return h^Count;
+}
+
+static uint32_t check(const uint32_t *words, uint32_t n){
+  uint32_t sum = 0, i;
+  for(i=0; i<n; i++){
+    sum = ((sum<<1)|(sum>>31))+words[i];
+  }
+  return ~sum;
+}
+
+// 1 if v fits parameter p
+static int inRange(Param_t *p, int32_t v){
+  if(p->Type == PARAM_UINT32){     // compare without sign
+    return ((uint32_t)v >= (uint32_t)p->Min) && ((uint32_t)v <= (uint32_t)p->Max);
+  }
+  return (v >= p->Min) && (v <= p->Max);
+}
+
+// ------------Param_Init------------
+// Set every parameter from flash, or to its default.
+// Input: table - parameter table
+//        count - number of parameters, at most PARAM_MAX
+// Output: PARAM_OK, or PARAM_BADID if count is too big
+int Param_Init(Param_t *table, uint32_t count){
+  const uint32_t *flash = (const uint32_t *)PARAM_FLASH_ADDR;
+  uint32_t i, saved;
+  if(count > PARAM_MAX){
+    return PARAM_BADID;
+  }
+  Table = table;
+  Count = count;
+  StagedMask = PendingMask = 0;
+  ReqN = 0;
+  saved = (flash[0] == MAGIC) && (flash[1] == layout()) && (flash[count+2] == check(flash, count+2));
+  for(i=0; i<count; i++){
+    if(saved && inRange(&table[i], (int32_t)flash[i+2])){
+      store(&table[i], (int32_t)flash[i+2]);
+    }else{
+      store(&table[i], table[i].Default);
+    }
+  }
+  return PARAM_OK;
+}
+
+// ------------Param_Find------------
+// Input: name - parameter name
+// Output: index of the parameter, -1 if not found
+int Param_Find(const char *name){
+  uint32_t i; const char *a, *b;
+  for(i=0; i<Count; i++){
+    a = Table[i].Name; b = name;
+    while(*a && (*a == *b)){
+      a++; b++;
+    }
+    if(*a == *b){
+      return i;
+    }
+  }
+  return -1;
+}
+
+// ------------Param_Get------------
+// Input: id - index of parameter
+// Output: value now used by the program, 0 if id is not valid
+int32_t Param_Get(uint32_t id){
+  if(id >= Count){
+    return 0;
+  }
+  return load(&Table[id]);
+}
+
+// ------------Param_Stage------------
+// Check and hold a new value until Param_Commit.
+// Input: id    - index of parameter
+//        value - new value
+// Output: PARAM_OK, PARAM_BADID or PARAM_RANGE
+int Param_Stage(uint32_t id, int32_t value){
+  if(id >= Count){
+    return PARAM_BADID;
+  }
+  if(!inRange(&Table[id], value)){
+    return PARAM_RANGE;
+  }
+  Staged[id] = value;
+  StagedMask |= 1u<<id;
+  return PARAM_OK;
+}
+
+// ------------Param_Commit------------
+// Hand every staged value to the next Param_Apply as one change.
+// Input: none
+// Output: none
+void Param_Commit(void){
+  uint32_t i, sr;
+  sr = StartCritical();            // Param_Apply sees all or none
+  for(i=0; i<Count; i++){
+    if(StagedMask&(1u<<i)){
+      Pending[i] = Staged[i];
+    }
+  }
+  PendingMask |= StagedMask;
+  EndCritical(sr);
+  StagedMask = 0;
+}
+
+// ------------Param_Set------------
+// Param_Stage then Param_Commit.
+// Input: id    - index of parameter
+//        value - new value
+// Output: PARAM_OK, PARAM_BADID or PARAM_RANGE
+int Param_Set(uint32_t id, int32_t value){
+  int r = Param_Stage(id, value);
+  if(r == PARAM_OK){
+    Param_Commit();
+  }
+  return r;
+}
+
+// ------------Param_Apply------------
+// Copy committed values into the variables and run the change functions.
+// Input: none
+// Output: number of parameters changed
+uint32_t Param_Apply(void){
+  uint32_t mask, i, n = 0, sr;
+  if(PendingMask == 0){
+    return 0;                      // usual case, one load
+  }
+  sr = StartCritical();
+  mask = PendingMask;
+  PendingMask = 0;
+  for(i=0; i<Count; i++){
+    if(mask&(1u<<i)){
+      store(&Table[i], Pending[i]);
+      n++;
+    }
+  }
+  EndCritical(sr);
+  for(i=0; i<Count; i++){
+    if((mask&(1u<<i)) && Table[i].OnChange){
+      (*Table[i].OnChange)();
+    }
+  }
+  return n;
+}
+
+// ------------Param_Save------------
+// Write the current values to flash.
+// Input: none
+// Output: PARAM_OK or PARAM_FLASH
+int Param_Save(void){
+  uint32_t i;
+  Image[0] = MAGIC;
+  Image[1] = layout();
+  for(i=0; i<Count; i++){
+    Image[i+2] = (uint32_t)load(&Table[i]);
+  }
+  Image[Count+2] = check(Image, Count+2);
+  if(Flash_Erase(PARAM_FLASH_ADDR) == ERROR){
+    return PARAM_FLASH;
+  }
+  if(Flash_WriteArray(Image, PARAM_FLASH_ADDR, Count+3) != (int)(Count+3)){
+    return PARAM_FLASH;
+  }
+  return PARAM_OK;
+}
+
+// ------------Param_Defaults------------
+// Commit the default of every parameter.
+// Input: none
+// Output: none
+void Param_Defaults(void){
+  uint32_t i;
+  for(i=0; i<Count; i++){
+    Param_Stage(i, Table[i].Default);
+  }
+  Param_Commit();
+}
+
+static void out(uint8_t data){
+  Fcs = Fcs^data;
+  EUSCIA0_OutChar(data);
+}
+
+static void out32(int32_t value){
+  out(value); out(value>>8); out(value>>16); out(value>>24);
+}
+
+// run the request in Req
+static void execute(void){
+  uint8_t cmd = Req[1], id = Req[2];
+  int32_t value = Req[3]|(Req[4]<<8)|(Req[5]<<16)|((uint32_t)Req[6]<<24);
+  int status = PARAM_OK;
+  uint32_t len = 0, n;
+  const char *name = "";
+  switch(cmd){
+    case 'N': value = Count; len = 4; break;
+    case 'R':
+    case 'I':
+      if(id >= Count){
+        status = PARAM_BADID;
+      }else if(cmd == 'R'){
+        value = load(&Table[id]); len = 4;
+      }else{
+        name = Table[id].Name;
+        for(n=0; name[n]; n++){};
+        len = 13+n;
+      }
+      break;
+    case 'W': status = Param_Set(id, value); break;
+    case 'B': status = Param_Stage(id, value); break;
+    case 'C': Param_Commit(); break;
+    case 'S': status = Param_Save(); break;
+    case 'D': Param_Defaults(); break;
+    default: status = PARAM_BADID; break;
+  }
+  EUSCIA0_OutChar(RSPSYNC);
+  Fcs = 0;
+  out(cmd); out(id); out(status); out(len);
+  if(len == 4){
+    out32(value);
+  }else if(len){
+    out(Table[id].Type);
+    out32(Table[id].Min); out32(Table[id].Max); out32(Table[id].Default);
+    while(*name){
+      out(*name++);
+    }
+  }
+  EUSCIA0_OutChar(Fcs);
+}
+
+// ------------Param_Input------------
+// Feed one byte of a protocol request.
+// Input: data - received byte
+// Output: none
+void Param_Input(uint8_t data){
+  uint32_t i; uint8_t fcs = 0;
+  if((ReqN == 0) && (data != REQSYNC)){
+    return;                        // not in a request, e.g. terminal typing
+  }
+  Req[ReqN++] = data;
+  if(ReqN < 8){
+    return;
+  }
+  ReqN = 0;
+  for(i=1; i<7; i++){
+    fcs = fcs^Req[i];
+  }
+  if(fcs == Req[7]){
+    execute();                     // bad requests get no answer, the host retries
+  }
+}
+
+// ------------Param_Poll------------
+// Handle every byte waiting in the EUSCI_A0 receive FIFO.
+// Input: none
+// Output: none
+void Param_Poll(void){
+  char data;
+  while(EUSCIA0_InCharNonBlock(&data)){
+    Param_Input(data);
+  }
+}
@@ -0,0 +1,166 @@
+/*
+ * Param.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Typed parameter registry for live tuning
+// Each tuning constant is a variable listed in a const table with its
+// name, type, range, default and an optional change function.  Values
+// can be read and written while the robot runs,
+//   1) over EUSCI_A0 with a small binary protocol (tools/paramcli.py),
+//   2) over BLE with two characteristics (Param_AddBLE),
+//   3) from the program with Param_Set.
+// New values are staged and reach the variables only in Param_Apply,
+// which the program calls at the start of a control tick, so a control
+// step never sees half of a change.  Param_Save keeps the values in
+// the last 4 KB of flash and Param_Init loads them back at reset.
+
+/*
+ Example table
+  int32_t BaseSpeed, Tolerance;
+  Param_t Params[] = {
+  // name         variable     type          min   max   default  change
+    {"BaseSpeed", &BaseSpeed, PARAM_INT32,   0, 7500,   1000,    0},
+    {"Tolerance", &Tolerance, PARAM_INT32,   0,  200,     30,    0},
+  };
+  Param_Init(Params, PARAM_COUNT(Params));
+ */
+
+/*
+ Protocol on EUSCI_A0, 115200 bps, all numbers little endian
+ request  A6 cmd id v0 v1 v2 v3 fcs                 (8 bytes)
+ response A7 cmd id status len payload[len] fcs
+ fcs is the 8-bit EOR of every byte after the sync byte
+ cmd 'N' count          payload count(4)
+     'I' info of id     payload type(1) min(4) max(4) default(4) name
+     'R' read id        payload value(4)
+     'W' write id       value is applied at the next Param_Apply
+     'B' stage id       like 'W', but waits for 'C'
+     'C' commit         every staged value is applied together
+     'S' save to flash
+     'D' defaults       every parameter back to its default
+ status PARAM_OK, PARAM_BADID, PARAM_RANGE or PARAM_FLASH
+ */
+
+#ifndef PARAM_H_
+#define PARAM_H_
+
+#include <stdint.h>
+
+// parameter types, the size of the variable
+#define PARAM_INT32  0
+#define PARAM_UINT32 1
+#define PARAM_INT16  2
+#define PARAM_UINT16 3
+#define PARAM_UINT8  4
+
+#define PARAM_MAX 32             // most parameters in one table
+#ifndef PARAM_FLASH_ADDR
+#define PARAM_FLASH_ADDR 0x0003F000 // last 4 KB sector of flash bank 1
+#endif
+
+// return values
+#define PARAM_OK    0
+#define PARAM_BADID 1            // no such parameter or command
+#define PARAM_RANGE 2            // value outside min to max
+#define PARAM_FLASH 3            // flash erase or write failed
+
+// One parameter, tables are const and stay in flash
+struct Param {
+  char *Name;                    // name used by the host
+  void *pt;                      // variable used by the program
+  uint8_t Type;                  // PARAM_INT32, ...
+  int32_t Min;                   // smallest allowed value
+  int32_t Max;                   // largest allowed value
+  int32_t Default;               // value when nothing is saved in flash
+  void (*OnChange)(void);        // run by Param_Apply after the variable changes, or 0
+};
+typedef const struct Param Param_t;
+
+#define PARAM_COUNT(table) (sizeof(table)/sizeof(table[0]))
+
+// ------------Param_Init------------
+// Set every parameter from flash, or to its default if flash holds
+// no values for this table.
+// Input: table - parameter table
+//        count - number of parameters, at most PARAM_MAX
+// Output: PARAM_OK, or PARAM_BADID if count is too big
+int Param_Init(Param_t *table, uint32_t count);
+
+// ------------Param_Find------------
+// Input: name - parameter name
+// Output: index of the parameter, -1 if not found
+int Param_Find(const char *name);
+
+// ------------Param_Get------------
+// Input: id - index of parameter
+// Output: value now used by the program, 0 if id is not valid
+int32_t Param_Get(uint32_t id);
+
+// ------------Param_Stage------------
+// Check and hold a new value until Param_Commit.
+// Input: id    - index of parameter
+//        value - new value
+// Output: PARAM_OK, PARAM_BADID or PARAM_RANGE
+int Param_Stage(uint32_t id, int32_t value);
+
+// ------------Param_Commit------------
+// Hand every staged value to the next Param_Apply as one change.
+// Input: none
+// Output: none
+void Param_Commit(void);
+
+// ------------Param_Set------------
+// Param_Stage then Param_Commit.
+// Input: id    - index of parameter
+//        value - new value
+// Output: PARAM_OK, PARAM_BADID or PARAM_RANGE
+int Param_Set(uint32_t id, int32_t value);
+
+// ------------Param_Apply------------
+// Copy committed values into the variables and run the change functions.
+// Call at the start of the control tick, in the ISR or loop that reads
+// the variables.
+// Input: none
+// Output: number of parameters changed
+uint32_t Param_Apply(void);
+
+// ------------Param_Save------------
+// Write the current values to flash.
+// Input: none
+// Output: PARAM_OK or PARAM_FLASH
+// Note: takes a few ms, stop the motors first
+int Param_Save(void);
+
+// ------------Param_Defaults------------
+// Commit the default of every parameter.
+// Input: none
+// Output: none
+void Param_Defaults(void);
+
+// ------------Param_Input------------
+// Feed one byte of a protocol request, the answer is sent with EUSCIA0_OutChar.
+// Input: data - received byte
+// Output: none
+void Param_Input(uint8_t data);
+
+// ------------Param_Poll------------
+// Handle every byte waiting in the EUSCI_A0 receive FIFO.
+// EUSCIA0_Init must be called once prior.
+// Input: none
+// Output: none
+void Param_Poll(void);
+
+// ------------Param_AddBLE------------
+// Add two characteristics to the current service,
+//   uuid   "Param ID"    1 byte,  index of the parameter (0xFE save, 0xFD defaults)
+//   uuid+1 "Param Value" 4 bytes, value of that parameter
+// Call between AP_AddService and AP_RegisterService.
+// In ParamBLE.c, which needs AP.c; Param.c alone has no BLE.
+// Input: uuid - 16-bit UUID of the first characteristic
+// Output: APOK or APFAIL
+int Param_AddBLE(uint16_t uuid);
+
+#endif /* PARAM_H_ */
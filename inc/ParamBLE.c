@@ -0,0 +1,57 @@
+/*
+ * ParamBLE.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// ParamBLE.c
+// BLE access to the parameter registry, see Param.h
+// Kept apart from Param.c so a project without the CC2650 links the
+// UART and flash registry without AP.c.
+
+/*
+// Example usage of ParamBLE, the tuning table of Param.c on the phone
+  AP_Init();
+  AP_AddService(0xFFF0);
+  Param_AddBLE(0xFFF1);       // "Param ID" 0xFFF1, "Param Value" 0xFFF2
+  AP_RegisterService();
+  AP_StartAdvertisement();
+ */
+
+#include <stdint.h>
+#include "../inc/AP.h"
+#include "../inc/Param.h"
+
+static uint8_t BleId;                // BLE selected parameter
+static int32_t BleValue;             // BLE value of that parameter
+
+static void bleNothing(void){
+}
+static void bleIdWrite(void){      // phone picked a parameter
+  if(BleId == 0xFE){
+    Param_Save();
+  }else if(BleId == 0xFD){
+    Param_Defaults();
+  }
+  BleValue = Param_Get(BleId);
+}
+static void bleValueRead(void){
+  BleValue = Param_Get(BleId);
+}
+static void bleValueWrite(void){
+  if(Param_Set(BleId, BleValue) != PARAM_OK){
+    BleValue = Param_Get(BleId);   // rejected, show the old value
+  }
+}
+
+// ------------Param_AddBLE------------
+// Add "Param ID" and "Param Value" characteristics to the current service.
+// Input: uuid - 16-bit UUID of the first characteristic
+// Output: APOK or APFAIL
+int Param_AddBLE(uint16_t uuid){
+  if(AP_AddCharacteristic(uuid, 1, &BleId, 0x03, 0x0A, "Param ID", &bleNothing, &bleIdWrite) == APFAIL){
+    return APFAIL;
+  }
+  return AP_AddCharacteristic(uuid+1, 4, &BleValue, 0x03, 0x0A, "Param Value", &bleValueRead, &bleValueWrite);
+}
@@ -0,0 +1,271 @@
+/*
+ * Profile.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Profile.c
+// Trapezoid and S-curve velocity profiles, see Profile.h
+
+/*
+// Example usage of Profile, 100 Hz position loop on tachometer steps
+Profile_t Move;
+
+void Start(void){
+  // 500 steps (305 mm), 600 steps/s, 1000 steps/s^2, 8000 steps/s^3
+  Profile_Start(&Move, 500, 600, 1000, 8000, 100);
+}
+
+void Every10ms(int32_t steps){  // steps since the start
+  Profile_Next(&Move);
+  Motor_Duty(FF*Move.Velocity + KP*(Move.Position - steps), ...);
+}
+ */
+
+#include <stdint.h>
+#include "../inc/Profile.h"
+#include "../inc/Fixed.h"
+
+#define MAXTICKS 0x01000000   // 2^24
+#define MAXQ     0x04000000   // 2^26 tick^2, keeps the square root inside 32 bits
+
+// n/d for a 64-bit n without a 64-bit divide, d from 1 to 2^31-1
+// long division in digits of 32, 16 and 16 bits, so each quotient
+// digit fits Fixed_Div64
+static uint64_t udiv64(uint64_t n, uint32_t d){
+  uint32_t hi = (uint32_t)(n>>32);
+  uint64_t r = ((uint64_t)(hi%d)<<16)|((uint32_t)n>>16);   // below d*2^16
+  uint32_t q1 = Fixed_Div64((int64_t)r, (int32_t)d);
+  uint32_t q0;
+  r = ((r - (uint64_t)q1*d)<<16)|((uint32_t)n&0xFFFF);
+  q0 = Fixed_Div64((int64_t)r, (int32_t)d);
+  return ((uint64_t)(hi/d)<<32) + ((uint64_t)q1<<16) + q0;
+}
+
+// n/d rounded up, d of 64 bits, the result limited to 0xFFFFFFFF
+static uint32_t ceildiv(uint64_t n, uint64_t d){
+  uint64_t q;
+  uint32_t s = 0;
+  if(d>>31){                  // scale d into 31 bits
+    s = 32 - Bits_Clz((uint32_t)(d>>31));
+    d = d>>s;
+    n = (n>>s) + d;           // one more, the shifts lose less than d
+  }
+  q = udiv64(n + d - 1, (uint32_t)d);
+  return (q > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)q;
+}
+
+// floor of the cube root
+static uint32_t cbrt32(uint32_t x){
+  uint32_t lo = 0, hi = 1626, mid;   // 1626^3 > 2^32
+  while(lo < hi){
+    mid = (lo + hi + 1)/2;
+    if((uint64_t)mid*mid*mid <= x){
+      lo = mid;
+    }else{
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+// smallest u >= umin with u*(u+c) >= q
+static uint32_t root(uint32_t q, uint32_t c, uint32_t umin){
+  uint32_t u = (Fixed_SqrtU32(c*c + 4*q) - c)/2;
+  while((uint64_t)u*(u + c) < q){
+    u++;
+  }
+  return (u < umin) ? umin : u;
+}
+
+// fastest move for a given jerk time tj (0 for a trapezoid)
+// returns the ticks, *u and *l get the acceleration and travel
+// factors: accelerating takes u+tj-1 ticks (u for a trapezoid),
+// accelerating and cruising take l ticks
+static uint32_t plan(uint64_t d, uint64_t v, uint64_t a, uint64_t j,
+                     uint32_t tj, uint32_t *u, uint32_t *l){
+  uint32_t q, lv, c, umin, l0;
+  q = ceildiv(d, a);          // u*l >= q keeps the acceleration
+  if(tj){
+    lv = ceildiv(d, j*tj);    // and the jerk within limits
+    if(lv > q){
+      q = lv;
+    }
+    c = tj;                   // one tick at 0 acceleration before slowing down
+    umin = tj + 1;
+  }else{
+    c = 0;
+    umin = 1;
+  }
+  if(q >= MAXQ){
+    return 0xFFFFFFFF;
+  }
+  lv = ceildiv(d, v);         // l >= lv keeps the speed
+  *u = root(q, c, umin);      // no cruise
+  l0 = *u + c;
+  if(lv > l0){                // cruise, accelerate no longer than needed
+    *u = (q + lv - 1)/lv;
+    if(*u < umin){
+      *u = umin;
+    }
+    l0 = lv;
+  }
+  *l = l0;
+  return (tj ? (*u + tj - 1) : *u) + l0;
+}
+
+// ------------Profile_Start------------
+// Plan a move from rest to rest.
+// Input: p        - profile to fill in
+//        distance - signed, in any unit, |distance| < 2^30
+//        vmax     - speed limit, units/s
+//        amax     - acceleration limit, units/s^2
+//        jmax     - jerk limit, units/s^3, 0 for a trapezoid
+//        hz       - control ticks per second
+// Output: number of Profile_Next calls the move takes, 0 if there
+//         is nothing to do
+uint32_t Profile_Start(Profile_t *p, int32_t distance, uint32_t vmax,
+                       uint32_t amax, uint32_t jmax, uint32_t hz){
+  uint64_t d, v, a, j;
+  uint32_t tj, best, n, u, l, bu = 0, bl = 0, btj = 0;
+  p->Position = p->Velocity = p->Acceleration = 0;
+  p->Pos = p->Vel = p->Acc = 0;
+  p->Phase = PROFILE_DONE;
+  p->Tick = 0;
+  p->Distance = 0;
+  if((distance == 0) || (distance >= 0x40000000) || (distance <= -0x40000000) ||
+     (vmax == 0) || (amax == 0) || (hz == 0) || (hz > 10000)){
+    return 0;
+  }
+  d = (uint64_t)((distance < 0) ? -distance : distance)<<32;
+  // limits per tick, units/2^32, at least 1
+  v = udiv64((uint64_t)vmax<<32, hz);
+  a = udiv64(udiv64((uint64_t)amax<<32, hz), hz);
+  j = udiv64(udiv64(udiv64((uint64_t)jmax<<32, hz), hz), hz);
+  if(v == 0) v = 1;
+  if(a == 0) a = 1;
+  if(jmax == 0){
+    best = plan(d, v, a, 0, 0, &bu, &bl);
+  }else{
+    if(j == 0) j = 1;
+    // ramping the acceleration up for longer than a/j only costs time,
+    // and a ramp of tj ticks alone reaches j*tj^2 speed and j*tj^3
+    // distance, start there and try shorter ones until the move gets
+    // slower
+    tj = ceildiv(a, j);
+    n = Fixed_SqrtU32(ceildiv(v, j)) + 1;
+    if(tj > n){
+      tj = n;
+    }
+    n = cbrt32(ceildiv(d, j)) + 1;
+    if(tj > n){
+      tj = n;
+    }
+    best = 0xFFFFFFFF;
+    while(tj){
+      n = plan(d, v, a, j, tj, &u, &l);
+      if(n > best){
+        break;
+      }
+      best = n;
+      bu = u;
+      bl = l;
+      btj = tj;
+      tj--;
+    }
+  }
+  if((best > MAXTICKS) || ((uint64_t)btj*bu >= 0x80000000)){
+    return 0;
+  }
+  p->Tj = btj;
+  if(btj){
+    p->Ta = bu - btj - 1;
+    p->N1 = bu + btj - 1;
+    // j*tj*u*l is the distance
+    p->Step = (int64_t)udiv64(udiv64(d, bl), btj*bu);
+    p->Rest = (int64_t)d - p->Step*btj*bu*bl;
+  }else{
+    p->Ta = bu;
+    p->N1 = bu;
+    p->Step = (int64_t)udiv64(udiv64(d, bl), bu);
+    p->Rest = (int64_t)d - p->Step*bu*bl;
+  }
+  p->Tv = bl - p->N1;
+  p->Hz = hz;
+  p->Distance = distance;
+  p->Phase = PROFILE_ACCEL;
+  return best;
+}
+
+// acceleration magnitude for tick k (1 to N1) of speeding up or slowing
+// down, j, 2j, ... up to tj*j, held for Ta ticks, then down to j
+static int64_t ramp(Profile_t *p, int64_t acc, uint32_t k){
+  if(p->Tj == 0){
+    return p->Step;
+  }
+  if(k <= p->Tj){
+    return acc + p->Step;
+  }
+  if(k > p->Tj + p->Ta + 1){
+    return acc - p->Step;
+  }
+  return acc;
+}
+
+// ------------Profile_Next------------
+// Advance one control tick and update the setpoints.
+// Input: p - profile from Profile_Start
+// Output: ticks left, 0 when Position is the distance and Velocity 0
+uint32_t Profile_Next(Profile_t *p){
+  int64_t pos, vel;
+  uint32_t left;
+  switch(p->Phase){
+    case PROFILE_ACCEL:
+      p->Tick++;
+      p->Acc = ramp(p, p->Acc, p->Tick);
+      p->Vel = p->Vel + p->Acc;
+      p->Pos = p->Pos + p->Vel;
+      left = p->N1 - p->Tick + p->Tv + p->N1;
+      if(p->Tick >= p->N1){
+        p->Pos = p->Pos + p->Rest;  // the rest of the distance, a tiny bit
+        p->Phase = p->Tv ? PROFILE_CRUISE : PROFILE_DECEL;
+        p->Tick = 0;
+      }
+      break;
+    case PROFILE_CRUISE:
+      p->Tick++;
+      p->Acc = 0;
+      p->Pos = p->Pos + p->Vel;
+      left = p->Tv - p->Tick + p->N1;
+      if(p->Tick >= p->Tv){
+        p->Phase = PROFILE_DECEL;
+        p->Tick = 0;
+      }
+      break;
+    case PROFILE_DECEL:
+      // the mirror image of speeding up, the acceleration sequence
+      // reads the same backward, so it is replayed with the sign flipped
+      p->Tick++;
+      p->Acc = -ramp(p, -p->Acc, p->Tick);
+      p->Vel = p->Vel + p->Acc;
+      p->Pos = p->Pos + p->Vel;
+      left = p->N1 - p->Tick;
+      if(left == 0){
+        p->Phase = PROFILE_DONE;  // Vel is 0 and Pos the distance here
+      }
+      break;
+    default:
+      return 0;
+  }
+  // setpoints, rounded to whole units
+  pos = (p->Pos + 0x80000000)>>32;
+  vel = (p->Vel*p->Hz + 0x80000000)>>32;
+  p->Position = (p->Distance < 0) ? -(int32_t)pos : (int32_t)pos;
+  p->Velocity = (p->Distance < 0) ? -(int32_t)vel : (int32_t)vel;
+  p->Acceleration = (int32_t)((((p->Acc*p->Hz)>>16)*p->Hz)>>16);
+  if(p->Distance < 0){
+    p->Acceleration = -p->Acceleration;
+  }
+  return left;
+}
@@ -0,0 +1,82 @@
+/*
+ * Profile.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Velocity profiles for moves of a given distance or angle
+// Profile_Start plans a move from rest to rest with limits on speed,
+// acceleration and (for an S-curve) jerk, in any unit: tachometer
+// steps, mm or binary angle.  Profile_Next is then called once per
+// control tick and gives the position, velocity and acceleration
+// setpoints for that tick.
+//   jerk limit 0   trapezoid, acceleration jumps between 0 and +-a
+//   jerk limit >0  S-curve, acceleration ramps at the jerk limit
+//
+// The tick counts of each phase are whole numbers, rounded up from
+// the time-optimal move, and the peak values are scaled down so the
+// move fits them exactly, so no limit is ever exceeded.  Internally
+// the setpoints are 64-bit, in units/2^32 per tick, and each tick only
+// adds: jerk to acceleration, acceleration to velocity, velocity to
+// position.  The deceleration replays the acceleration in mirror
+// image, so the last tick ends at exactly the distance with velocity
+// exactly 0, no matter how long the move.  The part of the distance
+// the rounded peak values leave over (a few units/2^32 per tick) is
+// added in the tick that reaches cruising speed.
+//
+// Profile_Start takes up to a few hundred us (a square root and
+// divides for each candidate jerk time), Profile_Next a few dozen
+// cycles.  Neither uses floating point or a 64-bit divide.
+// Limits: |distance| below 2^30 units, at most 2^24 ticks, and the
+// square of the ramp ticks below 2^26: |distance|*hz^2/amax and, for
+// an S-curve, |distance|*hz^3/(jmax*jerk ticks).
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+
+#define PROFILE_ACCEL 0       // Profile_t Phase
+#define PROFILE_CRUISE 1
+#define PROFILE_DECEL 2
+#define PROFILE_DONE 3
+
+typedef struct Profile{
+  // setpoints after the last Profile_Next, signed like the distance
+  int32_t Position;       // units from the start
+  int32_t Velocity;       // units/s
+  int32_t Acceleration;   // units/s^2
+  uint32_t Phase;         // PROFILE_ACCEL ... PROFILE_DONE
+  // plan and state, units/2^32 per tick^n
+  int64_t Pos, Vel, Acc;
+  int64_t Step;           // jerk (S-curve) or acceleration (trapezoid)
+  int64_t Rest;           // distance below the scaled peak values
+  uint32_t Tj, Ta, Tv;    // ticks of jerk, constant acceleration, cruise
+  uint32_t N1;            // ticks to accelerate, 2*Tj+Ta
+  uint32_t Tick;          // ticks into the phase
+  uint32_t Hz;
+  int32_t Distance;
+} Profile_t;
+
+// ------------Profile_Start------------
+// Plan a move from rest to rest.
+// Input: p        - profile to fill in
+//        distance - signed, in any unit, |distance| < 2^30
+//        vmax     - speed limit, units/s, more than 0
+//        amax     - acceleration limit, units/s^2, more than 0
+//        jmax     - jerk limit, units/s^3, 0 for a trapezoid
+//        hz       - control ticks per second, 1 to 10000
+// Output: number of Profile_Next calls the move takes, 0 if distance
+//         is 0 or the arguments or the move are out of range (Phase is PROFILE_DONE
+//         and the setpoints stay at 0)
+uint32_t Profile_Start(Profile_t *p, int32_t distance, uint32_t vmax,
+                       uint32_t amax, uint32_t jmax, uint32_t hz);
+
+// ------------Profile_Next------------
+// Advance one control tick and update the setpoints.
+// Input: p - profile from Profile_Start
+// Output: ticks left, 0 when Position is the distance and Velocity 0
+uint32_t Profile_Next(Profile_t *p);
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,499 @@
+/*
+ * Pursuit.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Pursuit.c
+// Pure-pursuit path follower on wheel odometry, see Pursuit.h
+
+/*
+// Example usage of Pursuit, a 600 x 300 mm loop at 100 Hz
+// Motor_Duty and MotorCal_Duty turn the wheel speeds into duties
+#include <stdint.h>
+#include "../inc/Pursuit.h"
+#include "../inc/MotorCal.h"
+#include "../inc/Motor.h"
+#include "../inc/Tachometer.h"
+
+PursuitCmd_t Cmd;
+
+void Start(void){
+  Pursuit_Init(145, 100);            // 145 mm between the wheels
+  Pursuit_SetPose(0, 0, 0);          // facing +x
+  Pursuit_Clear();
+  Pursuit_Add(600, 0, 150);          // corners are 150 mm arcs
+  Pursuit_Add(600, 300, 150);
+  Pursuit_Add(0, 300, 150);
+  Pursuit_Add(0, 0, 0);
+}
+
+void Every10ms(void){
+  uint16_t lt, rt;
+  enum TachDirection ld, rd;
+  int32_t left, right;
+  Tachometer_Get(&lt, &ld, &left, &rt, &rd, &right);
+  Pursuit_Odometry(left, right);
+  if(Pursuit_Update(&Cmd)){
+    Motor_Duty(MotorCal_Duty(0, Cmd.Left), MotorCal_Duty(1, Cmd.Right));
+  }else{
+    Motor_Stop();                    // Pursuit_GetStats has the lap time
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/Pursuit.h"
+#include "../inc/Trig.h"
+#include "../inc/Fixed.h"
+#include "../inc/Maze.h"
+
+#define STRAIGHT 0xFFFF       // Rad of a point that limits nothing
+#define KINK     0x00B6       // 1 deg, smaller turns are straight
+
+static uint32_t Track, Hz;
+static uint32_t Speed, Accel, Lateral;
+static uint32_t LookMin, LookTime, LookMax;
+
+// pose, um and 2^32 per turn
+static int32_t X, Y;
+static uint32_t Heading;
+static uint32_t TurnPerStep;    // heading change per step of right-left
+static int32_t LastLeft, LastRight;
+static uint32_t Fresh;          // 1 if the next Pursuit_Odometry only takes the counts
+static int64_t Rem;             // travel below 1 um, in 1/(2*PURSUIT_STEPS) um
+
+// path, mm, S is the distance along the path to each point and Rad the
+// radius the robot drives there: 0 stop (turn in place or the end),
+// STRAIGHT, else the arc or corner radius that limits the speed
+static int32_t PX[PURSUIT_POINTS], PY[PURSUIT_POINTS];
+static uint32_t S[PURSUIT_POINTS];
+static uint16_t Rad[PURSUIT_POINTS];
+static uint32_t N;
+static uint32_t Corner;         // radius asked for at the last point
+static Angle_t Dir;             // direction of the last segment as asked for
+
+// follower state
+static uint32_t Seg;            // segment from point Seg to Seg+1
+static uint32_t Spinning;
+static uint32_t V;              // mm/s, last speed
+static uint32_t Ticks, MaxErr;
+static uint64_t SumSq;
+
+// um to mm, rounded
+static int32_t mm(int32_t um){
+  return (um >= 0) ? (um + 500)/1000 : -((500 - um)/1000);
+}
+
+static uint32_t radius(uint32_t k){
+  return (k + 1 >= N) ? 0 : Rad[k];
+}
+
+// ------------Pursuit_Init------------
+// Set the robot geometry and control rate, the default limits and
+// lookahead, pose 0 and an empty path.
+// Input: track - mm between the wheels
+//        hz    - Pursuit_Update calls per second
+// Output: none
+void Pursuit_Init(uint32_t track, uint32_t hz){
+  int32_t q;
+  Track = track ? track : 1;
+  Hz = hz ? hz : 1;
+  // 2^32*mm per step/(2*pi*track), as 2^32*mm/(2*steps*track) first
+  q = Fixed_Div64((int64_t)PURSUIT_MM_STEP<<32, 2*PURSUIT_STEPS*Track);
+  TurnPerStep = Fixed_Div64((int64_t)q<<16, TRIG_PI_Q16);
+  Pursuit_SetLimits(PURSUIT_SPEED, PURSUIT_ACCEL, PURSUIT_LATERAL);
+  Pursuit_SetLookahead(PURSUIT_LOOKMIN, PURSUIT_LOOKTIME, PURSUIT_LOOKMAX);
+  Pursuit_SetPose(0, 0, 0);
+  Pursuit_Clear();
+}
+
+// ------------Pursuit_SetLimits------------
+// Input: speed   - top speed, mm/s
+//        accel   - acceleration and braking, mm/s^2
+//        lateral - sideways acceleration in curves, mm/s^2
+// Output: none
+void Pursuit_SetLimits(uint32_t speed, uint32_t accel, uint32_t lateral){
+  Speed = (speed < PURSUIT_VMIN) ? PURSUIT_VMIN : (speed > 2000) ? 2000 : speed;
+  Accel = (accel < 1) ? 1 : (accel > 20000) ? 20000 : accel;
+  Lateral = (lateral < 1) ? 1 : (lateral > 20000) ? 20000 : lateral;
+}
+
+// ------------Pursuit_SetLookahead------------
+// Lookahead = min + speed*time, at most max.
+// Input: min  - mm at a standstill
+//        time - ms of travel added
+//        max  - mm
+// Output: none
+void Pursuit_SetLookahead(uint32_t min, uint32_t time, uint32_t max){
+  LookMin = (min < 10) ? 10 : min;
+  LookTime = (time > 5000) ? 5000 : time;
+  LookMax = (max < LookMin) ? LookMin : max;
+}
+
+// ------------Pursuit_SetPose------------
+// Place the robot.
+// Input: x, y    - mm
+//        heading - binary angle, counterclockwise from +x
+// Output: none
+void Pursuit_SetPose(int32_t x, int32_t y, Angle_t heading){
+  X = x*1000;
+  Y = y*1000;
+  Heading = (uint32_t)heading<<16;
+  Fresh = 1;
+  Rem = 0;
+}
+
+// ------------Pursuit_Pose------------
+// Input: x, y, heading - pointers to storage, any may be 0
+// Output: none
+void Pursuit_Pose(int32_t *x, int32_t *y, Angle_t *heading){
+  if(x){
+    *x = mm(X);
+  }
+  if(y){
+    *y = mm(Y);
+  }
+  if(heading){
+    *heading = (Heading + 0x8000)>>16;
+  }
+}
+
+// ------------Pursuit_Odometry------------
+// Dead reckoning, call every control tick before Pursuit_Update.
+// Input: leftSteps, rightSteps - tachometer step counts since reset
+// Output: none
+void Pursuit_Odometry(int32_t leftSteps, int32_t rightSteps){
+  int32_t dl = leftSteps - LastLeft, dr = rightSteps - LastRight, d, turn;
+  int64_t n;
+  Angle_t mid;
+  LastLeft = leftSteps;
+  LastRight = rightSteps;
+  if(Fresh){
+    Fresh = 0;
+    return;
+  }
+  turn = (int32_t)((uint32_t)(dr - dl)*TurnPerStep);   // wraps like the heading
+  mid = (Heading + (uint32_t)(turn/2) + 0x8000)>>16;
+  // center travel (dl+dr)/2 steps, kept exact to the um
+  n = (int64_t)(dl + dr)*PURSUIT_MM_STEP*1000 + Rem;
+  d = Fixed_Div64(n, 2*PURSUIT_STEPS);
+  Rem = n - (int64_t)d*(2*PURSUIT_STEPS);
+  X = X + (int32_t)(((int64_t)d*Trig_Cos(mid) + 16384)>>15);
+  Y = Y + (int32_t)(((int64_t)d*Trig_Sin(mid) + 16384)>>15);
+  Heading = Heading + (uint32_t)turn;
+}
+
+// append a point, one on top of the last is left out
+static uint32_t put(int32_t x, int32_t y, uint32_t rad){
+  uint32_t len = 0;
+  if(N){
+    len = Trig_Hypot(x - PX[N-1], y - PY[N-1]);
+    if(len == 0){
+      return 0;
+    }
+  }
+  if(N >= PURSUIT_POINTS){
+    return 1;
+  }
+  PX[N] = x;
+  PY[N] = y;
+  S[N] = N ? (S[N-1] + len) : 0;
+  Rad[N] = rad;
+  N++;
+  return 0;
+}
+
+// ------------Pursuit_Clear------------
+// Start a new path at the robot's position and clear the statistics.
+// Input: none
+// Output: none
+void Pursuit_Clear(void){
+  N = 0;
+  put(mm(X), mm(Y), STRAIGHT);
+  Corner = 0;
+  Dir = (Heading + 0x8000)>>16;
+  Seg = 0;
+  Spinning = 0;
+  V = 0;
+  Ticks = MaxErr = 0;
+  SumSq = 0;
+}
+
+// the corner at the last point, now that the next one (x,y) is known:
+// an arc of radius Corner between tangent points t before and after it,
+// or the radius the lookahead cuts it with, or a stop to turn in place
+static uint32_t corner(int32_t x, int32_t y){
+  int32_t cx = PX[N-1], cy = PY[N-1], ox, oy, t, sin, cos, r = Corner;
+  uint32_t lenIn = S[N-1] - S[N-2], lenOut = Trig_Hypot(x - cx, y - cy);
+  uint32_t n, i, in;
+  Angle_t a1 = Trig_Atan2(cy - PY[N-2], cx - PX[N-2]), h, a;
+  int16_t turn = (int16_t)(Trig_Atan2(y - cy, x - cx) - a1);
+  h = (turn < 0) ? -turn : turn;
+  if(h < KINK){
+    return 0;                 // straight on
+  }
+  if((h > PURSUIT_SPIN) || (lenOut == 0)){
+    Rad[N-1] = 0;             // turn in place here
+    return 0;
+  }
+  h = h/2;
+  sin = Trig_Sin(h);          // more than 0 here
+  cos = Trig_Cos(h);          // 1/2 or more here
+  if(r == 0){
+    // the lookahead starts turning about LookMin/2 before the corner
+    r = ((int32_t)LookMin*cos)/(2*sin);
+    Rad[N-1] = (r < 1) ? 1 : (r >= STRAIGHT) ? STRAIGHT-1 : r;
+    return 0;
+  }
+  // tangent length t = r*tan(h), at most all of the way in and half of
+  // the way out (the next corner may need the rest)
+  in = (lenOut/2 < lenIn) ? lenOut/2 : lenIn;
+  if(r > 65534){
+    r = 65534;
+  }
+  t = (r*sin)/cos;
+  if(t > (int32_t)in){
+    t = in;
+    r = (t*cos)/sin;
+  }
+  if(r < 1){
+    Rad[N-1] = 0;
+    return 0;
+  }
+  N--;                        // the corner point becomes the arc
+  // start of the arc, then its center to the inside of the turn
+  cx = cx - ((t*Trig_Cos(a1) + 16384)>>15);
+  cy = cy - ((t*Trig_Sin(a1) + 16384)>>15);
+  a = (turn > 0) ? (a1 + TRIG_90) : (a1 - TRIG_90);
+  ox = cx + ((r*Trig_Cos(a) + 16384)>>15);
+  oy = cy + ((r*Trig_Sin(a) + 16384)>>15);
+  a = a + TRIG_180;           // from the center to the start
+  n = (2*h + PURSUIT_ARC - 1)/PURSUIT_ARC;
+  for(i=0; i<=n; i++){
+    h = a + (turn*(int32_t)i)/(int32_t)n;
+    if(put(ox + ((r*Trig_Cos(h) + 16384)>>15), oy + ((r*Trig_Sin(h) + 16384)>>15), r)){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static uint32_t add(int32_t x, int32_t y, uint32_t radius){
+  if((N >= 2) && corner(x, y)){
+    return 1;
+  }
+  if(put(x, y, STRAIGHT)){
+    return 1;
+  }
+  Corner = radius;
+  return 0;
+}
+
+// ------------Pursuit_Add------------
+// Append a waypoint.
+// Input: x, y   - mm
+//        radius - mm, arc of the corner at this waypoint, 0 for no arc
+// Output: 0 if added, 1 if the path is full
+uint32_t Pursuit_Add(int32_t x, int32_t y, uint32_t radius){
+  if((x != PX[N-1]) || (y != PY[N-1])){
+    Dir = Trig_Atan2(y - PY[N-1], x - PX[N-1]);
+  }
+  return add(x, y, radius);
+}
+
+// ------------Pursuit_AddMove------------
+// Append a Maze.h motion primitive: a turn at the last waypoint, then
+// one cell forward.
+// Input: move   - MAZE_FORWARD, MAZE_RIGHT, MAZE_LEFT or MAZE_UTURN
+//        cell   - mm per cell
+//        radius - mm, arc of the turn, at most cell/2
+// Output: 0 if added, 1 if the path is full or move is not a motion
+uint32_t Pursuit_AddMove(uint32_t move, int32_t cell, uint32_t radius){
+  switch(move){
+    case MAZE_FORWARD: break;
+    case MAZE_RIGHT: Dir = Dir - TRIG_90; break;
+    case MAZE_LEFT:  Dir = Dir + TRIG_90; break;
+    case MAZE_UTURN: Dir = Dir + TRIG_180; break;
+    default: return 1;
+  }
+  // a direction kept from the moves, not measured from rounded points,
+  // so the cells stay on the grid
+  Corner = (radius > (uint32_t)cell/2) ? (uint32_t)cell/2 : radius;
+  return add(PX[N-1] + ((cell*Trig_Cos(Dir) + 16384)>>15),
+             PY[N-1] + ((cell*Trig_Sin(Dir) + 16384)>>15), 0);
+}
+
+// ------------Pursuit_Point------------
+// Read the path, arc points included.
+// Input: i    - point, 0 is the start
+//        x, y - pointers to storage
+// Output: number of points, *x and *y are set if i is below it
+uint32_t Pursuit_Point(uint32_t i, int32_t *x, int32_t *y){
+  if(i < N){
+    *x = PX[i];
+    *y = PY[i];
+  }
+  return N;
+}
+
+// distance along segment k and to the left of it, of the point (x,y)
+static int32_t along(uint32_t k, int32_t x, int32_t y, int32_t *left){
+  int32_t dx = PX[k+1] - PX[k], dy = PY[k+1] - PY[k], len = S[k+1] - S[k];
+  x = x - PX[k];
+  y = y - PY[k];
+  *left = Fixed_Div64((int64_t)dx*y - (int64_t)dy*x, len);
+  return Fixed_Div64((int64_t)dx*x + (int64_t)dy*y, len);
+}
+
+// ------------Pursuit_Update------------
+// Compute the wheel speeds for this control tick.
+// Input: cmd - pointer to the command to fill in
+// Output: 1 while driving, 0 at the end of the path (speeds 0)
+uint32_t Pursuit_Update(PursuitCmd_t *cmd){
+  int32_t rx = mm(X), ry = mm(Y), t, e, gx, gy, dx, dy, xl, yl, kappa, w, l, r;
+  uint32_t k, s, g, len, look, v, v2, m, brake, stop, ld2;
+  int16_t bearing;
+  Angle_t h = (Heading + 0x8000)>>16;
+  cmd->Left = cmd->Right = cmd->Speed = cmd->Curvature = 0;
+  cmd->Error = 0;
+  cmd->Lookahead = 0;
+  cmd->Spinning = 0;
+  // move on to the segment the robot is in, stop corners and the end
+  // count as reached PURSUIT_REACH mm early
+  while(Seg + 1 < N){
+    stop = (radius(Seg+1) == 0);
+    t = along(Seg, rx, ry, &e);
+    if(t < (int32_t)(S[Seg+1] - S[Seg]) - (stop ? PURSUIT_REACH : 0)){
+      break;
+    }
+    Seg++;
+    if(stop){
+      Spinning = 1;           // turn toward the next segment
+      V = 0;
+    }
+  }
+  if(Seg + 1 >= N){
+    Spinning = 0;
+    V = 0;
+    return 0;                 // there
+  }
+  len = S[Seg+1] - S[Seg];
+  t = along(Seg, rx, ry, &e);
+  s = S[Seg] + ((t < 0) ? 0 : ((uint32_t)t > len) ? len : (uint32_t)t);
+  Ticks++;
+  m = (e < 0) ? -e : e;
+  if(m > MaxErr){
+    MaxErr = m;
+  }
+  SumSq = SumSq + (uint64_t)m*m;
+  cmd->Error = e;
+  // goal point, lookahead along the path, not past a stop
+  look = LookMin + (V*LookTime)/1000;
+  if(look > LookMax){
+    look = LookMax;
+  }
+  cmd->Lookahead = look;
+  g = s + look;
+  k = Seg;
+  while((S[k+1] <= g) && (radius(k+1) != 0)){
+    k++;
+  }
+  if(g >= S[k+1]){
+    gx = PX[k+1];
+    gy = PY[k+1];
+  }else{
+    len = S[k+1] - S[k];
+    gx = PX[k] + Fixed_Div64((int64_t)(g - S[k])*(PX[k+1] - PX[k]), len);
+    gy = PY[k] + Fixed_Div64((int64_t)(g - S[k])*(PY[k+1] - PY[k]), len);
+  }
+  // goal in the robot frame, Q15 mm, x ahead and y to the left
+  dx = gx - rx;
+  dy = gy - ry;
+  xl = dx*Trig_Cos(h) + dy*Trig_Sin(h);
+  yl = dy*Trig_Cos(h) - dx*Trig_Sin(h);
+  ld2 = dx*dx + dy*dy;
+  bearing = (int16_t)Trig_Atan2(yl, xl);
+  if(bearing > PURSUIT_BEHIND || bearing < -PURSUIT_BEHIND){
+    Spinning = 1;
+  }
+  if(Spinning && ((bearing > PURSUIT_ALIGNED) || (bearing < -PURSUIT_ALIGNED))){
+    // turn in place, each wheel at 4/s times the heading error in rad
+    // times track/2
+    w = (int32_t)(((int64_t)bearing*Track*4*TRIG_PI_Q16)>>32);
+    m = (w < 0) ? -w : w;
+    m = (m < PURSUIT_VMIN) ? PURSUIT_VMIN : (m > PURSUIT_VSPIN) ? PURSUIT_VSPIN : m;
+    w = (w < 0) ? -(int32_t)m : (int32_t)m;
+    cmd->Left = -w;
+    cmd->Right = w;
+    cmd->Spinning = 1;
+    V = 0;
+    return 1;
+  }
+  Spinning = 0;
+  // curvature of the circle through the goal, 2*yl/ld^2 in 1/m Q16
+  kappa = ld2 ? Fixed_Div64((int64_t)yl*4000, ld2) : 0;
+  cmd->Curvature = kappa;
+  // speed, lateral acceleration on this curvature, then braking to
+  // every slower point ahead, then the acceleration
+  v = Speed;
+  m = (kappa < 0) ? -kappa : kappa;
+  if(m){
+    v2 = Fixed_Div64((int64_t)Lateral*65536000, m);
+    if(v2 < v*v){
+      v = Fixed_SqrtU32(v2);
+    }
+  }
+  brake = (Speed*Speed)/(2*Accel) + 1;
+  for(k=Seg+1; k<N; k++){
+    g = (S[k] > s) ? (S[k] - s) : 0;
+    if(g > brake){
+      break;
+    }
+    m = radius(k);
+    if(m != STRAIGHT){
+      v2 = Lateral*m + 2*Accel*g;
+      if(v2 < v*v){
+        v = Fixed_SqrtU32(v2);
+      }
+    }
+  }
+  m = (Accel + Hz/2)/Hz;
+  if(v > V + m){
+    v = V + (m ? m : 1);
+  }
+  if(v < PURSUIT_VMIN){
+    v = PURSUIT_VMIN;         // creep the last mm
+  }
+  V = v;
+  // wheels v -+ v*kappa*track/2, slowed down together to stay on the
+  // circle if one would be too fast
+  w = Fixed_Div64((int64_t)v*kappa*Track, 131072000);
+  l = (int32_t)v - w;
+  r = (int32_t)v + w;
+  m = (l < 0) ? -l : l;
+  if((r > (int32_t)m) || (-r > (int32_t)m)){
+    m = (r < 0) ? -r : r;
+  }
+  if(m > Speed){
+    l = Fixed_Div64((int64_t)l*Speed, m);
+    r = Fixed_Div64((int64_t)r*Speed, m);
+    v = Fixed_Div64((int64_t)v*Speed, m);
+  }
+  cmd->Left = l;
+  cmd->Right = r;
+  cmd->Speed = v;
+  return 1;
+}
+
+// ------------Pursuit_GetStats------------
+// Input: stats - pointer to storage
+// Output: none
+void Pursuit_GetStats(PursuitStats_t *stats){
+  stats->Ticks = Ticks;
+  stats->Time = Fixed_Div64((int64_t)Ticks*1000, Hz);
+  stats->MaxError = MaxErr;
+  stats->RmsError = Ticks ? Fixed_SqrtU32(Fixed_Div64((int64_t)SumSq, Ticks)) : 0;
+  stats->Length = N ? S[N-1] : 0;
+}
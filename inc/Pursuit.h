@@ -0,0 +1,169 @@
+/*
+ * Pursuit.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Pure-pursuit path follower on wheel odometry
+// The path is a list of waypoints in mm.  Each call of Pursuit_Update
+// looks a distance ahead along the path from the point closest to the
+// robot, and steers on the circle through the robot and that point.
+// Both wheels are given speeds in mm/s, so the robot drives around
+// corners without stopping, instead of stop, rotate, drive.
+// - Corners are rounded when the path is built: the corner at a
+//   waypoint becomes a circular arc of the radius given with it, cut
+//   into points PURSUIT_ARC apart in angle.  Radius 0 leaves the corner
+//   to the lookahead, which cuts it about as much as an arc of half the
+//   lookahead would.
+// - Corners sharper than PURSUIT_SPIN (and a U-turn) are not driven
+//   around: the robot slows down to the corner, turns in place and goes
+//   on.  It does the same whenever the goal point is more than
+//   PURSUIT_BEHIND to the side, e.g. at the start if the path is behind it.
+// - The lookahead grows with speed, from the minimum by the distance
+//   travelled in a given time, up to a maximum.  A short lookahead
+//   tracks closely and cuts less, a long one is smoother.
+// - The speed is limited by the acceleration, by the lateral
+//   acceleration on the curvature being driven, and by braking
+//   distance to every slower corner ahead and to the end.
+// Odometry: Pursuit_Odometry integrates the tachometer steps into x, y
+// (um) and a 32-bit heading, with the heading at the middle of each
+// step.  Positions are mm, x east, y north, headings binary angles
+// (Trig.h) counterclockwise from east, so a left turn is positive.
+// No floating point and no 64-bit divide.  The module does not touch
+// the hardware, so it runs the same on a PC (tools/pursuitsim.c).
+
+#ifndef PURSUIT_H_
+#define PURSUIT_H_
+
+#include <stdint.h>
+#include "Trig.h"
+
+#define PURSUIT_POINTS   128      // path points, arcs included
+#define PURSUIT_ARC      0x0AAB   // 15 deg between arc points, R/115 chord error
+#define PURSUIT_SPIN     0x5555   // 120 deg, sharper corners turn in place
+#define PURSUIT_BEHIND   0x4000   // 90 deg, a goal point further round turns in place
+#define PURSUIT_ALIGNED  0x016C   // 2 deg, turning in place ends here
+#define PURSUIT_REACH    3        // mm from the end or a turn-in-place corner
+#define PURSUIT_VMIN     20       // mm/s, slowest speed while not there yet
+#define PURSUIT_VSPIN    150      // mm/s of each wheel turning in place
+#define PURSUIT_MM_STEP  220      // mm per PURSUIT_STEPS tachometer steps
+#define PURSUIT_STEPS    360
+
+// defaults for Pursuit_SetLimits and Pursuit_SetLookahead
+#define PURSUIT_SPEED    400      // mm/s
+#define PURSUIT_ACCEL    500      // mm/s^2
+#define PURSUIT_LATERAL  1000     // mm/s^2 on curves
+#define PURSUIT_LOOKMIN  60       // mm
+#define PURSUIT_LOOKTIME 50       // ms of travel added to the lookahead
+#define PURSUIT_LOOKMAX  250      // mm
+
+// Wheel command from Pursuit_Update
+typedef struct PursuitCmd{
+  int32_t Left;         // left wheel speed, mm/s, negative is backward
+  int32_t Right;        // right wheel speed, mm/s
+  int32_t Speed;        // speed of the robot center, mm/s
+  int32_t Curvature;    // 1/m in Q16, positive turns left
+  int32_t Error;        // mm from the path, positive is left of it
+  uint32_t Lookahead;   // mm
+  uint32_t Spinning;    // 1 while turning in place
+} PursuitCmd_t;
+
+// Tracking statistics since Pursuit_Clear
+typedef struct PursuitStats{
+  uint32_t Ticks;       // Pursuit_Update calls that drove
+  uint32_t Time;        // ms, Ticks at the control rate
+  uint32_t MaxError;    // mm, largest distance from the path
+  uint32_t RmsError;    // mm, root mean square distance from the path
+  uint32_t Length;      // mm, length of the path with its arcs
+} PursuitStats_t;
+
+// ------------Pursuit_Init------------
+// Set the robot geometry and control rate, the default limits and
+// lookahead, pose 0 and an empty path.
+// Input: track - mm between the wheels
+//        hz    - Pursuit_Update calls per second
+// Output: none
+void Pursuit_Init(uint32_t track, uint32_t hz);
+
+// ------------Pursuit_SetLimits------------
+// Input: speed   - top speed, mm/s
+//        accel   - acceleration and braking, mm/s^2
+//        lateral - sideways acceleration in curves, mm/s^2
+// Output: none
+void Pursuit_SetLimits(uint32_t speed, uint32_t accel, uint32_t lateral);
+
+// ------------Pursuit_SetLookahead------------
+// Lookahead = min + speed*time, at most max.  Set it before adding
+// points, corners without a radius are planned with min.
+// Input: min  - mm at a standstill
+//        time - ms of travel added
+//        max  - mm
+// Output: none
+void Pursuit_SetLookahead(uint32_t min, uint32_t time, uint32_t max);
+
+// ------------Pursuit_SetPose------------
+// Place the robot, e.g. at the start of a course.
+// Input: x, y    - mm
+//        heading - binary angle, counterclockwise from +x
+// Output: none
+// Note: the next Pursuit_Odometry call only takes the step counts
+void Pursuit_SetPose(int32_t x, int32_t y, Angle_t heading);
+
+// ------------Pursuit_Pose------------
+// Input: x, y, heading - pointers to storage, any may be 0
+// Output: none
+void Pursuit_Pose(int32_t *x, int32_t *y, Angle_t *heading);
+
+// ------------Pursuit_Odometry------------
+// Dead reckoning, call every control tick before Pursuit_Update.
+// Input: leftSteps, rightSteps - tachometer step counts since reset,
+//        forward is up, e.g. from Tachometer_Get
+// Output: none
+void Pursuit_Odometry(int32_t leftSteps, int32_t rightSteps);
+
+// ------------Pursuit_Clear------------
+// Start a new path at the robot's position and clear the statistics.
+// Input: none
+// Output: none
+void Pursuit_Clear(void);
+
+// ------------Pursuit_Add------------
+// Append a waypoint.
+// Input: x, y   - mm
+//        radius - mm, the corner at this waypoint becomes an arc of
+//                 this radius (smaller if the segments are short),
+//                 0 for no arc
+// Output: 0 if added, 1 if the path is full
+uint32_t Pursuit_Add(int32_t x, int32_t y, uint32_t radius);
+
+// ------------Pursuit_AddMove------------
+// Append a Maze.h motion primitive: a turn at the last waypoint, then
+// one cell forward, in the direction of the last segment (the robot's
+// heading for the first).
+// Input: move   - MAZE_FORWARD, MAZE_RIGHT, MAZE_LEFT or MAZE_UTURN
+//        cell   - mm per cell
+//        radius - mm, arc of the turn, at most cell/2 (a U-turn turns
+//                 in place)
+// Output: 0 if added, 1 if the path is full or move is not a motion
+uint32_t Pursuit_AddMove(uint32_t move, int32_t cell, uint32_t radius);
+
+// ------------Pursuit_Point------------
+// Read the path, arc points included.
+// Input: i    - point, 0 is the start
+//        x, y - pointers to storage
+// Output: number of points, *x and *y are set if i is below it
+uint32_t Pursuit_Point(uint32_t i, int32_t *x, int32_t *y);
+
+// ------------Pursuit_Update------------
+// Compute the wheel speeds for this control tick.
+// Input: cmd - pointer to the command to fill in
+// Output: 1 while driving, 0 at the end of the path (speeds 0)
+uint32_t Pursuit_Update(PursuitCmd_t *cmd);
+
+// ------------Pursuit_GetStats------------
+// Input: stats - pointer to storage
+// Output: none
+void Pursuit_GetStats(PursuitStats_t *stats);
+
+#endif /* PURSUIT_H_ */
@@ -120,8 +120,9 @@ policies, either expressed or implied, of the FreeBSD Project.
 // reflectance sensor 8 connected to P7.7 (robot's left, robot off road to right)
 
 #include <stdint.h>
-#include "msp432.h"
-#include "..\inc\Clock.h"
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/Reflectance.h"
 
 #define RSLK_MAX 1
 
@@ -277,30 +278,35 @@ uint8_t Reflectance_Center(uint32_t time){
 }
 
 
+// Reflectance_Position for every scan, 333 when no line
+// {332, 237, 142, 47, -47, -142, -237, -332} for bit 0 to bit 7
+const int16_t LinePositionLUT[256]={
+   333,  332,  237,  284,  142,  237,  189,  237,   47,  189,  142,  205,   94,  173,  142,  189,
+   -47,  142,   95,  174,   47,  142,  110,  166,    0,  110,   79,  142,   47,  118,   94,  142,
+  -142,   95,   47,  142,    0,  110,   79,  142,  -47,   79,   47,  118,   15,   94,   71,  123,
+   -94,   47,   16,   95,  -15,   71,   47,  104,  -47,   47,   23,   85,    0,   66,   47,   94,
+  -237,   47,    0,  110,  -47,   79,   47,  118,  -95,   47,   15,   94,  -16,   71,   47,  104,
+  -142,   16,  -15,   71,  -47,   47,   23,   85,  -79,   23,    0,   66,  -23,   47,   28,   79,
+  -189,  -15,  -47,   47,  -79,   23,    0,   66, -110,    0,  -23,   47,  -47,   28,    9,   63,
+  -142,  -23,  -47,   28,  -71,    9,   -9,   47,  -94,   -9,  -28,   31,  -47,   15,    0,   47,
+  -332,    0,  -47,   79,  -95,   47,   15,   94, -142,   15,  -16,   71,  -47,   47,   23,   85,
+  -189,  -15,  -47,   47,  -79,   23,    0,   66, -110,    0,  -23,   47,  -47,   28,    9,   63,
+  -237,  -47,  -79,   23, -110,    0,  -23,   47, -142,  -23,  -47,   28,  -71,    9,   -9,   47,
+  -173,  -47,  -71,    9,  -94,   -9,  -28,   31, -118,  -28,  -47,   15,  -66,    0,  -15,   33,
+  -284,  -79, -110,    0, -142,  -23,  -47,   28, -174,  -47,  -71,    9,  -95,   -9,  -28,   31,
+  -205,  -71,  -94,   -9, -118,  -28,  -47,   15, -142,  -47,  -66,    0,  -85,  -15,  -31,   20,
+  -237,  -94, -118,  -28, -142,  -47,  -66,    0, -166,  -66,  -85,  -15, -104,  -31,  -47,    6,
+  -189,  -85, -104,  -31, -123,  -47,  -63,   -6, -142,  -63,  -79,  -20,  -94,  -33,  -47,    0
+};
+
 // Perform sensor integration
 // Input: data is 8-bit result from line sensor
 // Output: position in 0.1mm relative to center of line
 int32_t Reflectance_Position(uint8_t data){
-    uint32_t position;
-
-    // write this as part of Lab 2
-    // Extract the appropriate bits from the reflectance read data
-    // to multiply to the corresponding weights in W[].
-    // Bit shifting and extraction.
-    int32_t W[8] = {332, 237, 142, 47, -47, -142, -237, -332};
-    int32_t numerator = 0;
-    int32_t denominator = 0;
-    for(int32_t i = 0; i<8; i++){
-        numerator += (data&0x1) *W[i];
-        denominator += data&0x1;
-        data = data>>0x01;
-    }
-    if(denominator == 0) {
-        return 333;  // Return 333 when no line detected (as documented in the header)
-    }
-    position = numerator / denominator;
-
-    return position;
+    // weights {332, 237, 142, 47, -47, -142, -237, -332} for bit 0 to bit 7,
+    // sum of the weights of the set bits over the number of set bits,
+    // precomputed for all 256 scans (333 when no line is detected)
+    return LinePositionLUT[data];
 }
 
 
@@ -147,6 +147,13 @@ uint8_t Reflectance_Center(uint32_t time);
  * */
 int32_t Reflectance_Position(uint8_t data);
 
+/**
+ * Reflectance_Position for all 256 scans, index is the 8-bit result
+ * from the line sensor.  Line.c looks up the same table.
+ * @brief  Position in 0.1mm, 333 if no line.
+ */
+extern const int16_t LinePositionLUT[256];
+
 /**
  * <b>Begin the process of reading the eight sensors</b>:<br>
   1) Turn on the 8 IR LEDs<br>
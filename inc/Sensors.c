@@ -0,0 +1,93 @@
+/*
+ * Sensors.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Sensors.c
+// Consistent snapshot of the robot's sensors, see Sensors.h
+
+/*
+// Example usage of Sensors, 2 kHz IR sampling
+void SensorRead_ISR(void){
+  uint32_t raw17, raw12, raw16;
+  ADC_In17_12_16(&raw17, &raw12, &raw16);
+  Sensors_PutIR(LPF_Calc3(raw16), LPF_Calc2(raw12), LPF_Calc(raw17));
+}
+
+int main(void){
+  SensorFrame_t frame;
+  ...
+  Sensors_Init(0);
+  Tachometer_Init();
+  TimerA1_Init(&SensorRead_ISR, 250);
+  EnableInterrupts();
+  while(1){
+    Sensors_Snapshot(&frame);
+    left = LeftConvert(frame.IRLeft);
+    ...
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/Seqlock.h"
+#include "../inc/Sensors.h"
+
+struct IR{
+  uint32_t Time;
+  uint32_t Left, Center, Right;
+};
+SEQLOCK_DECLARE(struct IR, IR);
+
+static uint32_t (*Clock)(void);
+static uint32_t Samples;        // number of IR samples, default clock
+
+static uint32_t samples(void){
+  return Samples;
+}
+
+// ------------Sensors_Init------------
+// Clear the IR values and select the timestamp clock of the IR samples
+// and the tachometer edges.
+// Input: clock - function returning the current time, or 0 to use the
+//                number of IR samples as the time
+// Output: none
+void Sensors_Init(uint32_t (*clock)(void)){
+  struct IR s = {0, 0, 0, 0};
+  Clock = clock;
+  Samples = 0;
+  Tachometer_SetClock(clock ? clock : &samples);
+  Seqlock_Write(&IR_Lock, IR_Buf, &s, sizeof(s)/4);
+}
+
+// ------------Sensors_PutIR------------
+// Publish one filtered IR sample.  Call from the sampling ISR only.
+// Input: left, center, right - filtered ADC values
+// Output: none
+void Sensors_PutIR(uint32_t left, uint32_t center, uint32_t right){
+  struct IR s;
+  Samples++;
+  s.Time = Clock ? Clock() : Samples;
+  s.Left = left;
+  s.Center = center;
+  s.Right = right;
+  Seqlock_Write(&IR_Lock, IR_Buf, &s, sizeof(s)/4);
+}
+
+// ------------Sensors_Snapshot------------
+// Copy the latest values of all producers.
+// Input: frame - pointer to storage
+// Output: none
+void Sensors_Snapshot(SensorFrame_t *frame){
+  struct IR s;
+  frame->Retries = Seqlock_Read(&IR_Lock, IR_Buf, &s, sizeof(s)/4);
+  frame->Time = Clock ? Clock() : Samples;
+  frame->IRTime = s.Time;
+  frame->IRLeft = s.Left;
+  frame->IRCenter = s.Center;
+  frame->IRRight = s.Right;
+  Tachometer_GetStamped(&frame->LeftTach, &frame->LeftDir, &frame->LeftSteps, &frame->LeftTachTime,
+                        &frame->RightTach, &frame->RightDir, &frame->RightSteps, &frame->RightTachTime);
+}
@@ -0,0 +1,63 @@
+/*
+ * Sensors.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Consistent snapshot of the robot's sensors
+// Each producer ISR publishes its values through a Seqlock, and
+// Sensors_Snapshot() copies all of them into one frame without
+// disabling interrupts.  Values inside one producer always belong
+// together (e.g. the three IR channels come from the same sample);
+// the producer timestamps tell how old each part of the frame is.
+// Producers:
+//   tachometers - TA3 capture ISRs in Tachometer.c, read with
+//                 Tachometer_GetStamped(), each edge stamped on the same clock
+//   IR          - the sampling ISR calls Sensors_PutIR()
+
+#ifndef SENSORS_H_
+#define SENSORS_H_
+
+#include <stdint.h>
+#include "../inc/Tachometer.h"
+
+typedef struct SensorFrame{
+  uint32_t Time;          // time of the snapshot
+  uint32_t IRTime;        // time of the IR sample
+  uint32_t IRLeft;        // filtered ADC, channel 16 P9.1
+  uint32_t IRCenter;      // filtered ADC, channel 12 P4.1
+  uint32_t IRRight;       // filtered ADC, channel 17 P9.0
+  uint32_t LeftTachTime;  // time of the left edge the tach values come from
+  uint32_t RightTachTime; // time of the right edge
+  uint16_t LeftTach;      // period of left wheel (units of 0.083 usec)
+  uint16_t RightTach;     // period of right wheel (units of 0.083 usec)
+  enum TachDirection LeftDir;
+  enum TachDirection RightDir;
+  int32_t LeftSteps;      // 360 steps per ~220 mm
+  int32_t RightSteps;
+  uint32_t Retries;       // IR reads repeated because the ISR ran, for profiling
+} SensorFrame_t;
+
+// ------------Sensors_Init------------
+// Clear the IR values and select the timestamp clock of the IR samples
+// and the tachometer edges.
+// Input: clock - function returning the current time, callable from
+//                any ISR, or 0 to use the number of IR samples as the time
+// Output: none
+void Sensors_Init(uint32_t (*clock)(void));
+
+// ------------Sensors_PutIR------------
+// Publish one filtered IR sample.  Call from the sampling ISR only.
+// Input: left, center, right - filtered ADC values
+// Output: none
+void Sensors_PutIR(uint32_t left, uint32_t center, uint32_t right);
+
+// ------------Sensors_Snapshot------------
+// Copy the latest values of all producers.
+// Input: frame - pointer to storage
+// Output: none
+// Note: safe in the foreground and in ISRs, interrupts stay enabled
+void Sensors_Snapshot(SensorFrame_t *frame);
+
+#endif /* SENSORS_H_ */
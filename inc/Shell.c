@@ -0,0 +1,434 @@
+/*
+ * Shell.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Shell.c
+// Non-blocking command shell with hashed command lookup and background jobs
+
+/*
+// Example usage of Shell, stream a counter at 10 Hz with "count 10hz"
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/EUSCIA0.h"
+#include "../inc/Shell.h"
+#include "../inc/Time.h"
+
+uint32_t Count;
+void CountTask(void){
+  Shell_OutDec(Count++);
+  Shell_OutString("\r\n");
+}
+int Counter(int argc, char *argv[]){
+  int32_t hz;
+  if((argc != 2) || !Shell_Number(argv[1], "hz", &hz) || (hz < 1) || (hz > 1000)){
+    return SHELL_USAGE;
+  }
+  Shell_StartJob("count", &CountTask, 1000/hz, 0, 0);
+  return SHELL_OK;
+}
+ShellCmd_t Commands[] = {
+  {"count", &Counter, "count <1-1000>hz"},
+};
+
+int main(void){
+  Clock_Init48MHz();
+  Time_Init();
+  EUSCIA0_Init();
+  EnableInterrupts();
+  Shell_Init(Commands, 1, &EUSCIA0_OutChar);
+  while(1){
+    Shell_Poll(&EUSCIA0_InCharNonBlock);
+    Shell_Run(Time_NowUs32()/1000);  // wraps after 71 minutes, see Lab5
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/Convert.h"
+#include "../inc/Shell.h"
+
+#define BUILTINS 3
+#define NOTHING  0xFF       // empty hash slot
+
+static int help(int argc, char *argv[]);
+static int jobs(int argc, char *argv[]);
+static int kill(int argc, char *argv[]);
+static ShellCmd_t Builtin[BUILTINS] = {
+  {"help", &help, "help [command]"},
+  {"jobs", &jobs, "jobs"},
+  {"kill", &kill, "kill <job>|all"},
+};
+
+struct Job{
+  char *Name;               // 0 if the slot is free
+  void (*Task)(void);
+  void (*Stop)(void);
+  uint32_t Period;
+  uint32_t Next;            // time of the next call
+  uint32_t End;             // time the job ends
+  uint32_t Forever;         // 1 if End is not used
+};
+static struct Job Jobs[SHELL_JOBS];
+
+static ShellCmd_t *Table;   // user commands
+static uint32_t Count;      // number of user commands
+static uint8_t Index[SHELL_HASHSIZE]; // command number, Builtin after Table
+static void (*Out)(char);
+static char Line[SHELL_LINESIZE];
+static uint32_t Length;     // characters in Line
+static uint32_t Now;        // time of the last Shell_Run
+
+// FNV-1a hash of a word, stops at the end of the word
+static uint32_t hash(const char *s){
+  uint32_t h = 2166136261u;
+  while(*s){
+    h = (h^(uint8_t)*s)*16777619u;
+    s++;
+  }
+  return h;
+}
+
+static int same(const char *a, const char *b){
+  while(*a && (*a == *b)){
+    a++; b++;
+  }
+  return (*a == *b);
+}
+
+static ShellCmd_t *command(uint32_t i){
+  return (i < Count) ? &Table[i] : &Builtin[i - Count];
+}
+
+// hash slot holding name, or the empty slot where it would go
+static uint32_t slot(const char *name){
+  uint32_t i = hash(name)&(SHELL_HASHSIZE-1);
+  while((Index[i] != NOTHING) && !same(command(Index[i])->Name, name)){
+    i = (i+1)&(SHELL_HASHSIZE-1);   // linear probe, the index is at most half full
+  }
+  return i;
+}
+
+static ShellCmd_t *find(const char *name){
+  uint32_t i = slot(name);
+  return (Index[i] == NOTHING) ? 0 : command(Index[i]);
+}
+
+static void prompt(void){
+  Shell_OutString("> ");
+}
+
+// ------------Shell_OutString------------
+// Output a string through the out function.
+// Input: pt - null-terminated string
+// Output: none
+void Shell_OutString(const char *pt){
+  while(*pt){
+    Out(*pt);
+    pt++;
+  }
+}
+
+// ------------Shell_OutDec------------
+// Output a signed decimal number without padding.
+// Input: n - number
+// Output: none
+void Shell_OutDec(int32_t n){
+  char buf[CONVERT_DECSIZE];
+  Convert_SDec(buf, n);
+  Shell_OutString(buf);
+}
+
+// ------------Shell_Init------------
+// Build the hash index, clear the line and the jobs, print the prompt.
+// Input: table - command table
+//        count - number of commands (at most SHELL_MAXCMDS)
+//        out   - function that sends one character
+// Output: 0 if ok, 1 if the table is too big or a name is repeated
+int Shell_Init(ShellCmd_t *table, uint32_t count, void (*out)(char)){
+  uint32_t i, s;
+  int result = 0;
+  Table = table;
+  Count = 0;
+  Out = out;
+  Length = 0;
+  for(i=0; i<SHELL_HASHSIZE; i++){
+    Index[i] = NOTHING;
+  }
+  for(i=0; i<SHELL_JOBS; i++){
+    Jobs[i].Name = 0;
+  }
+  if(count > SHELL_MAXCMDS){
+    count = SHELL_MAXCMDS;
+    result = 1;
+  }
+  Count = count;
+  for(i=0; i<count+BUILTINS; i++){
+    s = slot(command(i)->Name);
+    if(Index[s] == NOTHING){
+      Index[s] = i;
+    }else{
+      result = 1;           // repeated name, the first one wins
+    }
+  }
+  prompt();
+  return result;
+}
+
+// ------------Shell_Execute------------
+// Split a line into words and run the command.
+// Input: line - null-terminated command line, modified in place
+// Output: SHELL_OK, SHELL_USAGE, SHELL_FAIL, or -1 for an unknown command
+int Shell_Execute(char *line){
+  char *argv[SHELL_MAXARGS+1];
+  int argc = 0, result;
+  ShellCmd_t *cmd;
+  while(*line){
+    while((*line == ' ') || (*line == '\t')){
+      *line++ = 0;
+    }
+    if(*line == 0){
+      break;
+    }
+    if(argc == SHELL_MAXARGS){
+      Shell_OutString("too many words\r\n");
+      return SHELL_USAGE;
+    }
+    argv[argc++] = line;
+    while(*line && (*line != ' ') && (*line != '\t')){
+      line++;
+    }
+  }
+  argv[argc] = 0;
+  if(argc == 0){
+    return SHELL_OK;        // empty line
+  }
+  cmd = find(argv[0]);
+  if(cmd == 0){
+    Shell_OutString(argv[0]);
+    Shell_OutString(": unknown, try help\r\n");
+    return -1;
+  }
+  result = cmd->Run(argc, argv);
+  if(result == SHELL_USAGE){
+    Shell_OutString("usage: ");
+    Shell_OutString(cmd->Help);
+    Shell_OutString("\r\n");
+  }else if(result != SHELL_OK){
+    Shell_OutString(argv[0]);
+    Shell_OutString(": failed\r\n");
+  }
+  return result;
+}
+
+// ------------Shell_Input------------
+// Process one received character.
+// Input: letter - received character
+// Output: none
+void Shell_Input(char letter){
+  if((letter == '\r') || (letter == '\n')){
+    if((letter == '\n') && (Length == 0)){
+      return;               // second half of CR LF
+    }
+    Shell_OutString("\r\n");
+    Line[Length] = 0;
+    Length = 0;
+    Shell_Execute(Line);
+    prompt();
+  }else if((letter == '\b') || (letter == 0x7F)){
+    if(Length){
+      Length--;
+      Shell_OutString("\b \b");
+    }
+  }else if((letter >= ' ') && (letter <= '~') && (Length < SHELL_LINESIZE-1)){
+    Line[Length++] = letter;
+    Out(letter);
+  }
+}
+
+// ------------Shell_Poll------------
+// Process all characters that are waiting, without blocking.
+// Input: in - non-blocking receive, returns 1 and stores a character,
+//             or 0 if none is waiting
+// Output: number of characters processed
+uint32_t Shell_Poll(int (*in)(char *datapt)){
+  char letter;
+  uint32_t n = 0;
+  while(in(&letter)){
+    Shell_Input(letter);
+    n++;
+  }
+  return n;
+}
+
+// ------------Shell_Number------------
+// Convert a decimal argument with an optional unit suffix.
+// Input: s     - argument
+//        unit  - suffix that may follow the digits, or 0 for none
+//        value - pointer to result
+// Output: 1 if s is a valid number, 0 otherwise
+int Shell_Number(const char *s, const char *unit, int32_t *value){
+  uint32_t n = 0, digits = 0;
+  int negative = 0;
+  if(*s == '-'){
+    negative = 1;
+    s++;
+  }
+  while((*s >= '0') && (*s <= '9')){
+    if(n > 214748364){
+      return 0;             // too big for int32
+    }
+    n = 10*n + (*s - '0');
+    digits++;
+    s++;
+  }
+  if((digits == 0) || (n > 0x7FFFFFFF)){
+    return 0;
+  }
+  if(*s && !(unit && same(s, unit))){
+    return 0;
+  }
+  *value = negative ? -(int32_t)n : (int32_t)n;
+  return 1;
+}
+
+// ------------Shell_StartJob------------
+// Start a background job, or restart the job with the same name.
+// Input: name     - job name shown by jobs and used by kill
+//        task     - called by Shell_Run() every period ms
+//        period   - ms between calls (at least 1)
+//        duration - ms until the job stops by itself, 0 runs forever
+//        stop     - called once when the job ends, or 0
+// Output: 0 if started, 1 if all SHELL_JOBS slots are busy
+int Shell_StartJob(char *name, void (*task)(void), uint32_t period,
+                   uint32_t duration, void (*stop)(void)){
+  struct Job *j = 0;
+  uint32_t i;
+  for(i=0; i<SHELL_JOBS; i++){
+    if(Jobs[i].Name && same(Jobs[i].Name, name)){
+      j = &Jobs[i];         // restart with the new settings, no stop call
+      break;
+    }
+    if((Jobs[i].Name == 0) && (j == 0)){
+      j = &Jobs[i];
+    }
+  }
+  if(j == 0){
+    return 1;
+  }
+  j->Task = task;
+  j->Stop = stop;
+  j->Period = period ? period : 1;
+  j->Next = Now;
+  j->End = Now + duration;
+  j->Forever = (duration == 0);
+  j->Name = name;
+  return 0;
+}
+
+static void end(struct Job *j){
+  void (*stop)(void) = j->Stop;
+  j->Name = 0;              // free first, stop may start another job
+  if(stop){
+    stop();
+  }
+}
+
+// ------------Shell_StopJob------------
+// Stop a background job and call its stop function.
+// Input: name - job name, or 0 for all jobs
+// Output: number of jobs stopped
+uint32_t Shell_StopJob(const char *name){
+  uint32_t i, n = 0;
+  for(i=0; i<SHELL_JOBS; i++){
+    if(Jobs[i].Name && ((name == 0) || same(Jobs[i].Name, name))){
+      end(&Jobs[i]);
+      n++;
+    }
+  }
+  return n;
+}
+
+// ------------Shell_Run------------
+// Run the background jobs that are due.
+// Input: now - free running time in ms
+// Output: none
+void Shell_Run(uint32_t now){
+  uint32_t i;
+  struct Job *j;
+  Now = now;
+  for(i=0; i<SHELL_JOBS; i++){
+    j = &Jobs[i];
+    if(j->Name == 0){
+      continue;
+    }
+    if(!j->Forever && ((int32_t)(now - j->End) >= 0)){
+      end(j);
+    }else if((int32_t)(now - j->Next) >= 0){
+      j->Next += j->Period;
+      if((int32_t)(now - j->Next) >= 0){
+        j->Next = now + j->Period; // fell behind, skip the missed calls
+      }
+      j->Task();
+    }
+  }
+}
+
+//*************built-in commands****
+static int help(int argc, char *argv[]){
+  ShellCmd_t *cmd;
+  uint32_t i;
+  if(argc > 2){
+    return SHELL_USAGE;
+  }
+  if(argc == 2){
+    cmd = find(argv[1]);
+    if(cmd == 0){
+      return SHELL_FAIL;
+    }
+    Shell_OutString(cmd->Help);
+    Shell_OutString("\r\n");
+    return SHELL_OK;
+  }
+  for(i=0; i<Count+BUILTINS; i++){
+    Shell_OutString(command(i)->Help);
+    Shell_OutString("\r\n");
+  }
+  return SHELL_OK;
+}
+
+static int jobs(int argc, char *argv[]){
+  uint32_t i;
+  (void)argv;
+  if(argc != 1){
+    return SHELL_USAGE;
+  }
+  for(i=0; i<SHELL_JOBS; i++){
+    if(Jobs[i].Name){
+      Shell_OutString(Jobs[i].Name);
+      Shell_OutString(" every ");
+      Shell_OutDec(Jobs[i].Period);
+      Shell_OutString(" ms");
+      if(!Jobs[i].Forever){
+        Shell_OutString(", ");
+        Shell_OutDec(Jobs[i].End - Now);
+        Shell_OutString(" ms left");
+      }
+      Shell_OutString("\r\n");
+    }
+  }
+  return SHELL_OK;
+}
+
+static int kill(int argc, char *argv[]){
+  if(argc != 2){
+    return SHELL_USAGE;
+  }
+  if(Shell_StopJob(same(argv[1], "all") ? 0 : argv[1]) == 0){
+    return SHELL_FAIL;
+  }
+  return SHELL_OK;
+}
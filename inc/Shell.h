@@ -0,0 +1,141 @@
+/*
+ * Shell.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Line-oriented command shell that never blocks
+// Characters are fed one at a time with Shell_Input() (or Shell_Poll()
+// from a non-blocking receive function), so the main loop keeps running
+// sensing and control while a command is being typed.  A completed line
+// is split into words and the first word is looked up in the command
+// table through a hash index built by Shell_Init(), so the cost of a
+// lookup does not grow with the number of commands.
+//
+// Commands that need to keep running (streaming a sensor, driving for a
+// while) start a background job with Shell_StartJob().  Jobs are called
+// from Shell_Run() at their own period until they time out or are
+// stopped with "kill".  The built-in commands are help, jobs and kill.
+//
+// The shell has no hardware dependencies (it only needs Convert.h), all
+// output goes through the character function given to Shell_Init().
+
+/*
+ Example command table
+
+  int Hello(int argc, char *argv[]){
+    Shell_OutString("hello ");
+    Shell_OutString(argc > 1 ? argv[1] : "world");
+    Shell_OutString("\r\n");
+    return SHELL_OK;
+  }
+  ShellCmd_t Commands[] = {
+    {"hello", &Hello, "hello [name]"},
+  };
+  Shell_Init(Commands, sizeof(Commands)/sizeof(Commands[0]), &EUSCIA0_OutChar);
+ */
+
+#ifndef SHELL_H_
+#define SHELL_H_
+
+#include <stdint.h>
+
+#define SHELL_LINESIZE 64   // longest command line, including the null
+#define SHELL_MAXARGS  8    // most words on one line
+#define SHELL_HASHSIZE 64   // hash index slots, power of 2
+#define SHELL_MAXCMDS  (SHELL_HASHSIZE/2-3) // user commands, index at most half full
+#define SHELL_JOBS     4    // background jobs running at the same time
+
+// values returned by a command
+#define SHELL_OK     0
+#define SHELL_USAGE  1      // bad arguments, the help text is printed
+#define SHELL_FAIL   2      // command could not be done
+
+// one command
+// Run is called with the words of the line, argv[0] is the command name.
+// Declared const so the table stays in flash.
+struct ShellCmd {
+  char *Name;
+  int (*Run)(int argc, char *argv[]);
+  char *Help;               // usage line shown by help
+};
+typedef const struct ShellCmd ShellCmd_t;
+
+// ------------Shell_Init------------
+// Build the hash index for a command table, clear the line and the
+// jobs, and print the prompt.
+// Input: table - command table
+//        count - number of commands (at most SHELL_MAXCMDS)
+//        out   - function that sends one character
+// Output: 0 if ok, 1 if the table is too big or a name is repeated
+int Shell_Init(ShellCmd_t *table, uint32_t count, void (*out)(char));
+
+// ------------Shell_Input------------
+// Process one received character.
+// Printable characters are echoed and added to the line, backspace or
+// delete removes the last one, CR or LF runs the line.  Characters that
+// do not fit in the line are dropped.
+// Input: letter - received character
+// Output: none
+void Shell_Input(char letter);
+
+// ------------Shell_Poll------------
+// Process all characters that are waiting, without blocking.
+// Input: in - non-blocking receive, returns 1 and stores a character,
+//             or 0 if none is waiting (e.g. EUSCIA0_InCharNonBlock)
+// Output: number of characters processed
+uint32_t Shell_Poll(int (*in)(char *datapt));
+
+// ------------Shell_Execute------------
+// Split a line into words and run the command.
+// Input: line - null-terminated command line, modified in place
+// Output: SHELL_OK, SHELL_USAGE, SHELL_FAIL, or -1 for an unknown command
+int Shell_Execute(char *line);
+
+// ------------Shell_Number------------
+// Convert a decimal argument with an optional unit suffix,
+// e.g. Shell_Number("100hz", "hz", &n) gives n=100.
+// Input: s     - argument
+//        unit  - suffix that may follow the digits, or 0 for none
+//        value - pointer to result
+// Output: 1 if s is a valid number, 0 otherwise
+int Shell_Number(const char *s, const char *unit, int32_t *value);
+
+// ------------Shell_StartJob------------
+// Start a background job, or restart the job with the same name.
+// Input: name     - job name shown by jobs and used by kill
+//        task     - called by Shell_Run() every period ms
+//        period   - ms between calls (at least 1)
+//        duration - ms until the job stops by itself, 0 runs forever
+//        stop     - called once when the job ends, or 0
+// Output: 0 if started, 1 if all SHELL_JOBS slots are busy
+int Shell_StartJob(char *name, void (*task)(void), uint32_t period,
+                   uint32_t duration, void (*stop)(void));
+
+// ------------Shell_StopJob------------
+// Stop a background job and call its stop function.
+// Input: name - job name, or 0 for all jobs
+// Output: number of jobs stopped
+uint32_t Shell_StopJob(const char *name);
+
+// ------------Shell_Run------------
+// Run the background jobs that are due.
+// Call often from the main loop.
+// Input: now - free running time in ms
+// Output: none
+void Shell_Run(uint32_t now);
+
+// ------------Shell_OutString------------
+// Output helpers for commands and jobs, through the out function
+// Input: pt - null-terminated string
+// Output: none
+void Shell_OutString(const char *pt);
+
+// ------------Shell_OutDec------------
+// Output a signed decimal number without padding.
+// Input: n - number
+// Output: none
+void Shell_OutDec(int32_t n);
+
+#endif /* SHELL_H_ */
@@ -0,0 +1,227 @@
+/*
+ * SoftTimer.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// SoftTimer.c
+// Hashed timer wheel on Timer A2, see SoftTimer.h
+
+/*
+// Example usage of SoftTimer, three tasks on one hardware timer
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/SoftTimer.h"
+
+SoftTimer_t Sample, Control, Report;
+
+int main(void){
+  Clock_Init48MHz();
+  SoftTimer_Init(1000);                                          // 1 ms tick
+  SoftTimer_Start(&Sample, &SampleTask, 1, 1, SOFTTIMER_ISR);    // 1 kHz
+  SoftTimer_Start(&Control, &ControlTask, 5, 10, SOFTTIMER_ISR); // 100 Hz, 5 ms after Sample
+  SoftTimer_Start(&Report, &ReportTask, 1, 500, SOFTTIMER_DEFERRED); // 2 Hz UART output
+  EnableInterrupts();
+  while(1){
+    if(SoftTimer_Run() == 0){
+      WaitForInterrupt();
+    }
+  }
+}
+ */
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/CortexM.h"
+#include "../inc/TimerA2.h"
+#include "../inc/SoftTimer.h"
+
+// State
+#define IDLE    0       // not in any list
+#define ARMED   1       // in a wheel slot
+#define FIRING  2       // taken out of the wheel in this tick, not yet run
+
+static SoftTimer_t *Slot[SOFTTIMER_SLOTS];
+static SoftTimer_t *PendHead, *PendTail;    // deferred tasks, oldest first
+static volatile uint32_t Now;
+
+static void link(SoftTimer_t *t){
+  SoftTimer_t **head = &Slot[t->Expire&(SOFTTIMER_SLOTS-1)];
+  t->Prev = 0;
+  t->Next = *head;
+  if(*head){
+    (*head)->Prev = t;
+  }
+  *head = t;
+  t->State = ARMED;
+}
+
+static void unlink(SoftTimer_t *t){
+  if(t->Prev){
+    t->Prev->Next = t->Next;
+  }else{
+    Slot[t->Expire&(SOFTTIMER_SLOTS-1)] = t->Next;
+  }
+  if(t->Next){
+    t->Next->Prev = t->Prev;
+  }
+  t->State = IDLE;
+}
+
+// queue for SoftTimer_Run, at most once
+static void pend(SoftTimer_t *t){
+  if(t->Queued){
+    if(t->Missed < 0xFF){
+      t->Missed++;
+    }
+    return;
+  }
+  t->Pend = 0;
+  t->PendPrev = PendTail;
+  if(PendTail){
+    PendTail->Pend = t;
+  }else{
+    PendHead = t;
+  }
+  PendTail = t;
+  t->Queued = 1;
+}
+
+// remove from the deferred queue if it is there
+static void unpend(SoftTimer_t *t){
+  if(t->Queued == 0){
+    return;
+  }
+  if(t->PendPrev){
+    t->PendPrev->Pend = t->Pend;
+  }else{
+    PendHead = t->Pend;
+  }
+  if(t->Pend){
+    t->Pend->PendPrev = t->PendPrev;
+  }else{
+    PendTail = t->PendPrev;
+  }
+  t->Queued = 0;
+}
+
+static void tick(void){
+  SoftTimer_t *t, *next, *fire = 0, **last = &fire;
+  uint32_t now = Now + 1;
+  Now = now;
+  // 1) take the expired timers out of this tick's slot
+  for(t=Slot[now&(SOFTTIMER_SLOTS-1)]; t; t=next){
+    next = t->Next;
+    if(t->Expire == now){     // others in the slot are for a later turn
+      unlink(t);
+      t->State = FIRING;
+      t->Fire = 0;
+      *last = t;
+      last = &t->Fire;
+    }
+  }
+  // 2) run or defer, rearming a periodic one just before its task runs,
+  //    so the task may stop or restart it
+  for(t=fire; t; t=t->Fire){
+    if((t->State != FIRING) || (t->Expire != now)){
+      continue;               // stopped or restarted by an earlier task in this tick
+    }
+    if(t->Period){
+      t->Expire = now + t->Period;
+      link(t);
+    }else{
+      t->State = IDLE;
+    }
+    if(t->Mode == SOFTTIMER_ISR){
+      (*t->Task)();
+    }else{
+      pend(t);
+    }
+  }
+}
+
+// ------------SoftTimer_Init------------
+// Start the tick on Timer A2.
+// Input: hz - tick rate, 8 to 10,000, e.g. 1000
+// Output: none
+// Assumes: Clock_Init48MHz() has been called (SMCLK = 12 MHz)
+void SoftTimer_Init(uint32_t hz){
+  uint32_t i;
+  for(i=0; i<SOFTTIMER_SLOTS; i++){
+    Slot[i] = 0;
+  }
+  PendHead = PendTail = 0;
+  Now = 0;
+  TimerA2_Init(&tick, 500000/hz);    // units of 2 us
+}
+
+// ------------SoftTimer_Start------------
+// Start (or restart) a timer.
+// Input: t      - timer storage
+//        task   - function to run
+//        delay  - ticks until the first run (phase offset), at least 1
+//        period - ticks between runs, 0 for a one-shot
+//        mode   - SOFTTIMER_ISR or SOFTTIMER_DEFERRED
+// Output: none
+void SoftTimer_Start(SoftTimer_t *t, void(*task)(void), uint32_t delay,
+                     uint32_t period, uint32_t mode){
+  long sr = StartCritical();
+  if(t->State == ARMED){
+    unlink(t);
+  }
+  unpend(t);
+  t->Task = task;
+  t->Period = period;
+  t->Mode = mode;
+  t->Missed = 0;
+  t->Expire = Now + ((delay == 0) ? 1 : delay);
+  link(t);
+  EndCritical(sr);
+}
+
+// ------------SoftTimer_Stop------------
+// Stop a timer, also drops a pending deferred run.
+// Input: t - timer storage
+// Output: none
+void SoftTimer_Stop(SoftTimer_t *t){
+  long sr = StartCritical();
+  if(t->State == ARMED){
+    unlink(t);
+  }
+  t->State = IDLE;
+  unpend(t);
+  EndCritical(sr);
+}
+
+// ------------SoftTimer_Run------------
+// Run the deferred tasks that are due, in expiry order.
+// Input: none
+// Output: number of tasks run
+uint32_t SoftTimer_Run(void){
+  SoftTimer_t *t;
+  uint32_t n = 0;
+  long sr;
+  while(1){
+    sr = StartCritical();
+    t = PendHead;
+    if(t){
+      unpend(t);
+    }
+    EndCritical(sr);
+    if(t == 0){
+      return n;
+    }
+    (*t->Task)();             // interrupts enabled
+    n++;
+  }
+}
+
+// ------------SoftTimer_Now------------
+// Number of ticks since SoftTimer_Init().
+// Input: none
+// Output: tick count
+uint32_t SoftTimer_Now(void){
+  return Now;
+}
@@ -0,0 +1,87 @@
+/*
+ * SoftTimer.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Software timers multiplexed on Timer A2
+// Any number of one-shot and periodic tasks share the one hardware tick
+// of Timer A2, instead of one timer each.  Timer A0 (PWM), Timer A3
+// (tachometer capture) and Timer A1 stay with their drivers, Timer32
+// Timer 1 with TExaS (PeriodicTask2) and Timer 2 with Time.c, so the
+// wheel links with all of them.
+// Timers live in a hashed timer wheel of SOFTTIMER_SLOTS lists, indexed
+// by expiry tick modulo SOFTTIMER_SLOTS.  Start and stop are O(1); each
+// tick only looks at the timers in one slot.  Delays longer than the
+// wheel simply stay in their slot for more turns.
+// A task runs either in the tick ISR (short work, e.g. sampling) or is
+// deferred to SoftTimer_Run() in the main loop (long work, e.g. UART).
+// The SoftTimer_t storage belongs to the caller and must stay valid
+// (global or static) while the timer is running.
+
+#ifndef SOFTTIMER_H_
+#define SOFTTIMER_H_
+
+#include <stdint.h>
+
+#define SOFTTIMER_SLOTS 64        // power of 2
+
+// where the task runs
+#define SOFTTIMER_ISR      0      // in the Timer A2 ISR
+#define SOFTTIMER_DEFERRED 1      // in SoftTimer_Run()
+
+typedef struct SoftTimer{
+  struct SoftTimer *Next, *Prev;  // wheel slot list
+  struct SoftTimer *Fire;         // expired in this tick
+  struct SoftTimer *Pend, *PendPrev; // waiting for SoftTimer_Run()
+  void (*Task)(void);
+  uint32_t Expire;                // tick of the next run
+  uint32_t Period;                // ticks between runs, 0 for one-shot
+  uint8_t Mode;                   // SOFTTIMER_ISR or SOFTTIMER_DEFERRED
+  uint8_t State;                  // owned by SoftTimer.c
+  uint8_t Queued;                 // 1 while waiting for SoftTimer_Run()
+  uint8_t Missed;                 // deferred runs lost because the last was still pending
+} SoftTimer_t;
+
+// ------------SoftTimer_Init------------
+// Start the tick on Timer A2.
+// Input: hz - tick rate, 8 to 10,000, e.g. 1000
+// Output: none
+// Assumes: Clock_Init48MHz() has been called (SMCLK = 12 MHz)
+// Note: takes over TimerA2_Init()
+void SoftTimer_Init(uint32_t hz);
+
+// ------------SoftTimer_Start------------
+// Start (or restart) a timer.
+// Input: t      - timer storage
+//        task   - function to run
+//        delay  - ticks until the first run (phase offset), at least 1
+//        period - ticks between runs, 0 for a one-shot
+//        mode   - SOFTTIMER_ISR or SOFTTIMER_DEFERRED
+// Output: none
+// Note: may be called from a task
+void SoftTimer_Start(SoftTimer_t *t, void(*task)(void), uint32_t delay,
+                     uint32_t period, uint32_t mode);
+
+// ------------SoftTimer_Stop------------
+// Stop a timer, also drops a pending deferred run.
+// Input: t - timer storage
+// Output: none
+// Note: may be called from a task
+void SoftTimer_Stop(SoftTimer_t *t);
+
+// ------------SoftTimer_Run------------
+// Run the deferred tasks that are due, in expiry order.
+// Call from the main loop.
+// Input: none
+// Output: number of tasks run
+uint32_t SoftTimer_Run(void);
+
+// ------------SoftTimer_Now------------
+// Number of ticks since SoftTimer_Init().
+// Input: none
+// Output: tick count
+uint32_t SoftTimer_Now(void);
+
+#endif /* SOFTTIMER_H_ */
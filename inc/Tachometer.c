@@ -123,6 +123,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/TA3InputCapture.h"
 #include "msp.h"
 #include "Tachometer.h"
+#include "../inc/Seqlock.h"
 
 uint16_t Tachometer_FirstRightTime, Tachometer_SecondRightTime;
 uint16_t Tachometer_FirstLeftTime, Tachometer_SecondLeftTime;
@@ -131,6 +132,19 @@ int Tachometer_LeftSteps = 0;      // incremented with every step forward; decre
 enum TachDirection Tachometer_RightDir = STOPPED;
 enum TachDirection Tachometer_LeftDir = STOPPED;
 
+// One wheel as a consistent set, published by its capture ISR so that
+// Tachometer_Get() never pairs a period from one edge with the step
+// count of another.
+struct TachSide{
+  uint16_t First, Second;     // capture times of the last two edges
+  int32_t Steps;
+  int32_t Dir;                // enum TachDirection
+  uint32_t Time;              // time of the last edge, 0 without a clock
+};
+SEQLOCK_DECLARE(struct TachSide, Left);
+SEQLOCK_DECLARE(struct TachSide, Right);
+static uint32_t (*Clock)(void);   // edge timestamps, see Tachometer_SetClock
+
 //void tachometerRightInt(uint16_t currenttime){
 //  Tachometer_FirstRightTime = Tachometer_SecondRightTime;
 //  Tachometer_SecondRightTime = currenttime;
@@ -146,6 +160,7 @@ enum TachDirection Tachometer_LeftDir = STOPPED;
 //}
 
 void tachometerRightInt(uint16_t currenttime){
+  struct TachSide s;
   Tachometer_FirstRightTime = Tachometer_SecondRightTime;
   Tachometer_SecondRightTime = currenttime;
   if((P10->IN&0x20) == 0){
@@ -157,9 +172,16 @@ void tachometerRightInt(uint16_t currenttime){
     Tachometer_RightSteps = Tachometer_RightSteps + 1;
     Tachometer_RightDir = FORWARD;
   }
+  s.First = Tachometer_FirstRightTime;
+  s.Second = Tachometer_SecondRightTime;
+  s.Steps = Tachometer_RightSteps;
+  s.Dir = Tachometer_RightDir;
+  s.Time = Clock ? Clock() : 0;
+  Seqlock_Write(&Right_Lock, Right_Buf, &s, sizeof(s)/4);
 }
 
 void tachometerLeftInt(uint16_t currenttime){
+  struct TachSide s;
   Tachometer_FirstLeftTime = Tachometer_SecondLeftTime;
   Tachometer_SecondLeftTime = currenttime;
   if((P9->IN&0x04) == 0){
@@ -171,6 +193,12 @@ void tachometerLeftInt(uint16_t currenttime){
     Tachometer_LeftSteps = Tachometer_LeftSteps + 1;
     Tachometer_LeftDir = FORWARD;
   }
+  s.First = Tachometer_FirstLeftTime;
+  s.Second = Tachometer_SecondLeftTime;
+  s.Steps = Tachometer_LeftSteps;
+  s.Dir = Tachometer_LeftDir;
+  s.Time = Clock ? Clock() : 0;
+  Seqlock_Write(&Left_Lock, Left_Buf, &s, sizeof(s)/4);
 }
 
 // ------------Tachometer_Init------------
@@ -194,6 +222,8 @@ void Tachometer_Init(void){
   P10->DIR &= ~0x20;               // make P10.5 in
   P10->REN |= 0x20; // enable pull resistor
   P10->OUT |= 0x20; // pull up
+  Left_Buf[0].Dir = Left_Buf[1].Dir = STOPPED;
+  Right_Buf[0].Dir = Right_Buf[1].Dir = STOPPED;
   TimerA3Capture_Init(&tachometerLeftInt, &tachometerRightInt);
 }
 
@@ -208,12 +238,41 @@ void Tachometer_Init(void){
 // Output: none
 // Assumes: Tachometer_Init() has been called
 // Assumes: Clock_Init48MHz() has been called
+// Note: each wheel's values come from the same edge, without disabling interrupts
 void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
                     uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps){
-  *leftTach = (Tachometer_SecondLeftTime - Tachometer_FirstLeftTime);
-  *leftDir = Tachometer_LeftDir;
-  *leftSteps = Tachometer_LeftSteps;
-  *rightTach = (Tachometer_SecondRightTime - Tachometer_FirstRightTime);
-  *rightDir = Tachometer_RightDir;
-  *rightSteps = Tachometer_RightSteps;
+  uint32_t leftTime, rightTime;
+  Tachometer_GetStamped(leftTach, leftDir, leftSteps, &leftTime,
+                        rightTach, rightDir, rightSteps, &rightTime);
+}
+
+// ------------Tachometer_SetClock------------
+// Select the clock that timestamps the edges.
+// Input: clock - function returning the current time, callable from
+//                the capture ISRs, or 0 for no timestamps
+// Output: none
+void Tachometer_SetClock(uint32_t (*clock)(void)){
+  Clock = clock;
+}
+
+// ------------Tachometer_GetStamped------------
+// Tachometer_Get with the time of the last edge of each wheel.
+// Input: as Tachometer_Get, and
+//        leftTime, rightTime are pointers to store the time of the edge
+//        the wheel's values come from (0 before the first edge or
+//        without a clock)
+// Output: none
+void Tachometer_GetStamped(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps, uint32_t *leftTime,
+                           uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps, uint32_t *rightTime){
+  struct TachSide l, r;
+  Seqlock_Read(&Left_Lock, Left_Buf, &l, sizeof(l)/4);
+  Seqlock_Read(&Right_Lock, Right_Buf, &r, sizeof(r)/4);
+  *leftTach = (l.Second - l.First);
+  *leftDir = (enum TachDirection)l.Dir;
+  *leftSteps = l.Steps;
+  *leftTime = l.Time;
+  *rightTach = (r.Second - r.First);
+  *rightDir = (enum TachDirection)r.Dir;
+  *rightSteps = r.Steps;
+  *rightTime = r.Time;
 }
@@ -106,4 +106,22 @@ void Tachometer_Init(void);
 void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
                     uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps);
 
+/**
+ * Select the clock that timestamps the encoder edges.
+ * @param clock is a function returning the current time, callable from the capture ISRs, or 0 for no timestamps
+ * @return none
+ * @brief Select the edge timestamp clock
+ */
+void Tachometer_SetClock(uint32_t (*clock)(void));
+
+/**
+ * Tachometer_Get with the time of the edge each wheel's values come from.
+ * @param leftTime is pointer to store the time of the last left edge (0 before the first edge or without a clock)
+ * @param rightTime is pointer to store the time of the last right edge
+ * @note the other parameters are as for Tachometer_Get()
+ * @brief Get the most recent tachometer measurement and its time
+ */
+void Tachometer_GetStamped(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps, uint32_t *leftTime,
+                           uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps, uint32_t *rightTime);
+
 #endif /* TACHOMETER_H_ */
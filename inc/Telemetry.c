@@ -0,0 +1,211 @@
+/*
+ * Telemetry.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Telemetry.c
+// Batched BLE notifications of fixed-size telemetry records
+
+/*
+// Example usage of Telemetry, 100 Hz wheel and IR record
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/AP.h"
+#include "../inc/TimerA1.h"
+#include "../inc/Telemetry.h"
+
+struct Record{
+  uint16_t Time;              // ms
+  int16_t Left, Right;        // wheel steps
+  uint16_t Dist;              // center IR, mm
+};                            // 8 bytes, 2 records per notification
+
+void Nothing(void){}
+void Sample(void){            // 100 Hz
+  struct Record r;
+  ...
+  Telemetry_Put(&r);
+}
+
+int main(void){
+  Clock_Init48MHz();
+  AP_Init();
+  AP_AddService(0xFFF0);
+  AP_AddStreamCharacteristic(0xFFF1, "Telemetry", &Nothing);
+  AP_RegisterService();
+  AP_StartAdvertisement();
+  Telemetry_Init(0, sizeof(struct Record));
+  TimerA1_Init(&Sample, 5000); // 100 Hz
+  EnableInterrupts();
+  while(1){
+    AP_BackgroundProcess();   // collects SNP answers
+    Telemetry_Run();
+  }
+}
+ */
+
+#include <stdint.h>
+#include "../inc/AP.h"
+#include "../inc/Telemetry.h"
+
+static uint8_t Fifo[TELEMETRY_SIZE];
+static volatile uint32_t PutI;     // bytes ever put, only Telemetry_Put writes
+static volatile uint32_t GetI;     // bytes ever accepted by the SNP, only the foreground writes
+static uint32_t SendI;             // bytes ever given to AP_NotifyData
+static uint32_t Index;             // notify characteristic
+static uint32_t Size;              // bytes per record
+static uint32_t PerPacket;         // records per notification
+static uint8_t Seq;                // sequence number of the next notification
+static uint8_t Packet[AP_STREAMMAX];
+static uint8_t FlightBytes[AP_PIPELINE]; // bytes in each unanswered notification
+static uint8_t FlightSeq[AP_PIPELINE];   // its sequence number
+static uint32_t FlightGetI, FlightPutI;  // count of notifications ever sent and answered
+static uint32_t Ignore;                  // answers to old notifications after a go back
+static uint32_t Window;                  // notifications allowed in flight, 1 after a reject
+static TelemetryStats_t Stats;
+static void answer(uint32_t i, uint8_t status);
+
+// ------------Telemetry_Init------------
+// Start an empty queue of records.
+// Input: index - notify characteristic from AP_AddStreamCharacteristic
+//        size  - bytes per record, 1 to AP_STREAMMAX-1
+// Output: 0 if ok, 1 if size is out of range
+int Telemetry_Init(uint32_t index, uint32_t size){
+  if((size == 0) || (size > AP_STREAMMAX-1)){
+    return 1;
+  }
+  Index = index;
+  Size = size;
+  PerPacket = (AP_STREAMMAX-1)/size;
+  PutI = GetI = SendI = 0;
+  FlightGetI = FlightPutI = Ignore = 0;
+  Window = AP_PIPELINE;
+  Seq = 0;
+  Stats.Records = Stats.Packets = Stats.Dropped = Stats.Stale = 0;
+  Stats.Busy = Stats.Resent = Stats.MaxQueued = 0;
+  AP_SetNotifyAnswer(&answer);
+  return 0;
+}
+
+// ------------Telemetry_Put------------
+// Queue one record.
+// Input: record - pointer to size bytes
+// Output: 0 if queued, 1 if dropped because the queue is full
+int Telemetry_Put(const void *record){
+  const uint8_t *pt = record;
+  uint32_t put = PutI, i;
+  if(put-GetI+Size > TELEMETRY_SIZE){
+    Stats.Dropped++;
+    return 1;
+  }
+  for(i=0; i<Size; i++){
+    Fifo[(put+i)&(TELEMETRY_SIZE-1)] = pt[i];
+  }
+  PutI = put+Size;                 // publish after the bytes are in
+  if(PutI-GetI > Stats.MaxQueued){
+    Stats.MaxQueued = PutI-GetI;
+  }
+  return 0;
+}
+
+// the SNP answered the oldest notification in flight, runs in AP_RecvMessage
+static void answer(uint32_t i, uint8_t status){
+  uint32_t k;
+  if((i != Index) || (FlightGetI == FlightPutI)){
+    return;                        // not ours
+  }
+  k = FlightGetI%AP_PIPELINE;
+  FlightGetI++;
+  if(Ignore){
+    Ignore--;                      // sent before the go back, sent again since
+    return;
+  }
+  if(status == 0){
+    GetI = GetI+FlightBytes[k];    // SNP has it, space can be reused
+    Stats.Records += FlightBytes[k]/Size;
+    if((Window < AP_PIPELINE) && (PutI-GetI <= PerPacket*Size)){
+      Window++;                    // backlog is gone, the SNP has room again
+    }
+  }else{                           // SNP queue was full, go back and send it again
+    Stats.Resent += (SendI-GetI)/Size;
+    SendI = GetI;
+    Seq = FlightSeq[k];
+    Ignore = FlightPutI-FlightGetI;
+    Window = 1;                    // one at a time until it drains, nothing
+  }                                // in flight can overtake a rejected one
+}
+
+// send n records from the front of the unsent records
+static int send(uint32_t n){
+  uint32_t bytes = n*Size, from = SendI, i;
+  int r;
+  if((FlightPutI-FlightGetI >= Window) || Ignore){ // full, or going back
+    Stats.Busy++;
+    return APBUSY;
+  }
+  Packet[0] = Seq;
+  for(i=0; i<bytes; i++){
+    Packet[1+i] = Fifo[(from+i)&(TELEMETRY_SIZE-1)];
+  }
+  r = AP_NotifyData(Index, Packet, 1+bytes);
+  if(r == APOK){
+    FlightBytes[FlightPutI%AP_PIPELINE] = bytes;
+    FlightSeq[FlightPutI%AP_PIPELINE] = Seq;
+    FlightPutI++;
+    SendI = from+bytes;
+    Seq++;
+    Stats.Packets++;
+  }else if(r == APBUSY){
+    Stats.Busy++;
+  }else if(FlightGetI == FlightPutI){ // nobody listening, old records are of no use
+    Stats.Stale += (PutI-GetI)/Size;
+    GetI = SendI = PutI;
+  }
+  return r;
+}
+
+// ------------Telemetry_Run------------
+// Send as many full notifications as the SNP will take now.
+// Input: none
+// Output: number of notifications queued to the SNP
+uint32_t Telemetry_Run(void){
+  uint32_t sent = 0;
+  while((PutI-SendI)/Size >= PerPacket){
+    if(send(PerPacket) != APOK){
+      break;
+    }
+    sent++;
+  }
+  return sent;
+}
+
+// ------------Telemetry_Flush------------
+// Send queued records even if they do not fill a notification.
+// Input: none
+// Output: APOK if nothing is left to send, APBUSY if the SNP is busy,
+//         APFAIL if the phone is not listening
+int Telemetry_Flush(void){
+  uint32_t n;
+  int r = APOK;
+  while((r == APOK) && ((n = (PutI-SendI)/Size) != 0)){
+    r = send((n > PerPacket) ? PerPacket : n);
+  }
+  return r;
+}
+
+// ------------Telemetry_Queued------------
+// Input: none
+// Output: number of records waiting
+uint32_t Telemetry_Queued(void){
+  return (PutI-GetI)/Size;
+}
+
+// ------------Telemetry_GetStats------------
+// Input: stats - pointer to structure to receive the debugging counts
+// Output: none
+void Telemetry_GetStats(TelemetryStats_t *stats){
+  *stats = Stats;
+}
@@ -0,0 +1,83 @@
+/*
+ * Telemetry.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Streaming robot telemetry over one BLE notify characteristic
+// Fixed-size records are queued with Telemetry_Put (foreground or ISR)
+// and packed by Telemetry_Run into notifications of up to AP_STREAMMAX
+// bytes, which are pipelined to the SNP with AP_NotifyData.
+// Each notification is one sequence byte followed by whole records,
+//   [seq][record 0][record 1]...
+// so the phone can see lost notifications.  Records stay queued until
+// the SNP answers that it has taken them.  When the SNP answers that
+// its queue is full, Telemetry goes back and sends that notification
+// and the ones after it again with the same sequence numbers, so the
+// phone may see a sequence number twice and should keep the first.
+// After such an answer it has only one notification in flight until
+// the backlog is gone, so under overload the resends do not take the
+// link from new records and nothing overtakes a resent notification.
+// When the record queue is full new records are dropped and counted.
+// With 20-byte notifications and AP_PIPELINE outstanding, a 30 ms
+// connection interval carries about 2.5 kB/s of records.
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+
+#define TELEMETRY_SIZE 1024  // bytes of queued records, must be power of 2
+
+// Debugging counts
+typedef struct TelemetryStats {
+  uint32_t Records;    // records accepted by the SNP
+  uint32_t Packets;    // notifications sent, including resends
+  uint32_t Dropped;    // records lost because the queue was full
+  uint32_t Stale;      // records thrown away because the phone was not listening
+  uint32_t Busy;       // times Telemetry_Run found the SNP busy
+  uint32_t Resent;     // records sent again after the SNP queue was full
+  uint32_t MaxQueued;  // most bytes ever waiting
+} TelemetryStats_t;
+
+// ------------Telemetry_Init------------
+// Start an empty queue of records, and take the AP_SetNotifyAnswer hook.
+// Input: index - notify characteristic from AP_AddStreamCharacteristic,
+//                counted from 0 in the order notify characteristics were added
+//        size  - bytes per record, 1 to AP_STREAMMAX-1
+// Output: 0 if ok, 1 if size is out of range
+int Telemetry_Init(uint32_t index, uint32_t size);
+
+// ------------Telemetry_Put------------
+// Queue one record.
+// Input: record - pointer to size bytes
+// Output: 0 if queued, 1 if dropped because the queue is full
+// Note: one producer only, either the foreground or one ISR
+int Telemetry_Put(const void *record);
+
+// ------------Telemetry_Run------------
+// Send as many full notifications as the SNP will take now.
+// Call from the main loop, together with AP_BackgroundProcess.
+// Input: none
+// Output: number of notifications queued to the SNP
+uint32_t Telemetry_Run(void);
+
+// ------------Telemetry_Flush------------
+// Send queued records even if they do not fill a notification.
+// Input: none
+// Output: APOK if nothing is left, APBUSY if the SNP is busy,
+//         APFAIL if the phone is not listening
+int Telemetry_Flush(void);
+
+// ------------Telemetry_Queued------------
+// Input: none
+// Output: number of records waiting
+uint32_t Telemetry_Queued(void);
+
+// ------------Telemetry_GetStats------------
+// Input: stats - pointer to structure to receive the debugging counts
+// Output: none
+void Telemetry_GetStats(TelemetryStats_t *stats);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,120 @@
+/*
+ * Time.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Time.c
+// 64-bit monotonic timebase on Timer32 Timer 2
+
+/*
+// Example usage of Time, 100 Hz control loop and latency measurement
+#include "msp.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/Time.h"
+
+uint64_t Sampled;     // set by the sampling ISR with Time_NowUs()
+uint32_t Latency;     // sample to motor update, us
+
+int main(void){
+  uint64_t next;
+  Clock_Init48MHz();
+  Time_Init();
+  ...
+  EnableInterrupts();
+  next = Time_NowUs();
+  while(1){
+    next = next + 10000;      // every 10 ms
+    Time_DelayUntil(next);
+    Control();
+    Latency = Time_NowUs() - Sampled;
+  }
+}
+ */
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Time.h"
+
+static volatile uint32_t Wraps;   // high 32 bits of the tick count
+
+// ------------Time_Init------------
+// Start the timebase at 0.
+// Input: none
+// Output: none
+// Assumes: Clock_Init48MHz() has been called
+void Time_Init(void){
+  Wraps = 0;
+  TIMER32_2->CONTROL = 0;             // stop while configuring
+  TIMER32_2->LOAD = 0xFFFFFFFF;       // full 32-bit count
+  TIMER32_2->INTCLR = 0x00000001;     // clear Timer32 Timer 2 interrupt
+  // bit7=1,           timer enable
+  // bit6=1,           periodic mode, reloads 0xFFFFFFFF
+  // bit5=1,           interrupt enable
+  // bits3-2=01,       input clock divider /16
+  // bit1=1,           32-bit counter
+  // bit0=0,           wrapping mode
+  TIMER32_2->CONTROL = 0x000000E6;
+  NVIC->IP[6] = NVIC->IP[6]&0xFF00FFFF; // priority 0, so wraps are counted at once
+  NVIC->ISER[0] = 0x04000000;         // enable interrupt 26 in NVIC
+}
+
+void T32_INT2_IRQHandler(void){
+  TIMER32_2->INTCLR = 0x00000001;     // acknowledge Timer32 Timer 2 interrupt
+  Wraps = Wraps + 1;
+}
+
+// ------------Time_NowTicks------------
+// Current time in timer ticks (1/3 us).
+// Input: none
+// Output: ticks since Time_Init()
+uint64_t Time_NowTicks(void){
+  uint32_t hi, lo, pending;
+  do{
+    hi = Wraps;
+    lo = ~TIMER32_2->VALUE;           // counts down, so invert to count up
+    pending = TIMER32_2->RIS&0x01;    // wrapped, but Wraps not yet incremented
+  }while(hi != Wraps);                // repeats at most once per wrap
+  if(pending && (lo < 0x80000000)){
+    hi = hi + 1;    // lo was read after the wrap; called with the ISR masked
+  }
+  return ((uint64_t)hi<<32)|lo;
+}
+
+// ------------Time_NowUs------------
+// Current time in microseconds.
+// Input: none
+// Output: microseconds since Time_Init()
+uint64_t Time_NowUs(void){
+  uint64_t t = Time_NowTicks();
+  uint32_t hi = t>>32, lo = (uint32_t)t;
+  // t/3 without a 64-bit division, 2^32 = 3*1431655765 + 1
+  // t = 3*(hi*1431655765 + lo/3) + hi + lo%3
+  return (uint64_t)hi*1431655765 + lo/3 + (hi + lo%3)/3;
+}
+
+// ------------Time_NowUs32------------
+// Low 32 bits of Time_NowUs().
+// Input: none
+// Output: microseconds since Time_Init(), modulo 2^32
+uint32_t Time_NowUs32(void){
+  return (uint32_t)Time_NowUs();
+}
+
+// ------------Time_DelayUntil------------
+// Wait until an absolute time.
+// Input: deadline - time in microseconds (from Time_NowUs())
+// Output: none
+void Time_DelayUntil(uint64_t deadline){
+  while(Time_NowUs() < deadline){};
+}
+
+// ------------Time_DelayUs------------
+// Wait for a number of microseconds.
+// Input: n - microseconds
+// Output: none
+void Time_DelayUs(uint32_t n){
+  Time_DelayUntil(Time_NowUs() + n);
+}
@@ -0,0 +1,66 @@
+/*
+ * Time.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// 64-bit monotonic timebase on Timer32 Timer 2
+// Timer 2 runs free at 48 MHz/16 = 3 MHz and wraps every 1431 seconds.
+// A wrap interrupt at priority 0 extends it to 64 bits, which does not
+// wrap for about 195,000 years.  All reads are constant time and may be
+// called from any ISR, also with interrupts disabled.
+// One timeline for the whole robot, e.g. stamp the IR sample in the
+// sampling ISR, the control decision and the PWM update, and subtract.
+// Timer32 Timer 1 (Timer32.c) is left free for periodic tasks.
+
+#ifndef TIME_H_
+#define TIME_H_
+
+#include <stdint.h>
+
+#define TIME_TICKS_PER_US 3   // 48 MHz bus clock divided by 16
+
+// ------------Time_Init------------
+// Start the timebase at 0.
+// Input: none
+// Output: none
+// Assumes: Clock_Init48MHz() has been called
+// Note: interrupts enabled in the main program after all devices initialized
+void Time_Init(void);
+
+// ------------Time_NowTicks------------
+// Current time in timer ticks (1/3 us).
+// Input: none
+// Output: ticks since Time_Init()
+uint64_t Time_NowTicks(void);
+
+// ------------Time_NowUs------------
+// Current time in microseconds.
+// Input: none
+// Output: microseconds since Time_Init()
+uint64_t Time_NowUs(void);
+
+// ------------Time_NowUs32------------
+// Low 32 bits of Time_NowUs(), wraps every 71 minutes.
+// Differences of two values are correct across the wrap.
+// Matches the clock parameter of Sensors_Init().
+// Input: none
+// Output: microseconds since Time_Init(), modulo 2^32
+uint32_t Time_NowUs32(void);
+
+// ------------Time_DelayUntil------------
+// Wait until an absolute time.  Returns at once if it has passed, so a
+// loop that adds a fixed period to its deadline runs at a fixed rate
+// without accumulating drift.
+// Input: deadline - time in microseconds (from Time_NowUs())
+// Output: none
+void Time_DelayUntil(uint64_t deadline);
+
+// ------------Time_DelayUs------------
+// Wait for a number of microseconds.
+// Input: n - microseconds
+// Output: none
+void Time_DelayUs(uint32_t n);
+
+#endif /* TIME_H_ */
@@ -0,0 +1,225 @@
+/*
+ * Trig.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Trig.c
+// Fixed-point sine, cosine, atan2 and hypot on binary angles
+
+/*
+// Example usage of Trig, dead reckoning from the tachometer
+// 360 steps = 220 mm of wheel travel, 140 mm between the wheels
+#include <stdint.h>
+#include "../inc/Trig.h"
+
+int32_t X, Y;         // position in um
+Angle_t Heading;      // 65536 per turn
+
+void Odometry(int32_t dLeft, int32_t dRight){   // steps since last call
+  int32_t d = (dLeft + dRight)*(220000/360)/2; // um travelled
+  // (dRight-dLeft)*(220/360)/140 rad, 45.53 binary units per step
+  Heading += ((dRight - dLeft)*1457)>>5;
+  X += (d*Trig_Cos(Heading))>>15;
+  Y += (d*Trig_Sin(Heading))>>15;
+}
+// direction and distance back to the start
+//   home = Trig_Atan2(-Y, -X);  dist = Trig_Hypot(X, Y);
+//   turn = (int16_t)(home - Heading);          // -32768 to 32767
+ */
+
+#include <stdint.h>
+#include "../inc/Trig.h"
+#include "../inc/Bits.h"
+
+#define CORDIC_VECTOR 16      // iterations for atan2 and hypot
+#define CORDIC_ROTATE 30      // iterations for Trig_SinCos31
+#define K_Q32 2608131497u     // 1/gain after 16 iterations, 0.60725 in Q32
+#define K_Q30 652032874       // 1/gain after 30 iterations in Q30
+
+// 32767*sin(i*90/256 deg), one extra entry so i+1 is always valid
+static const int16_t Sine[258] = {
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809,
+  2009, 2210, 2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811,
+  4011, 4210, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800,
+  5998, 6195, 6393, 6590, 6786, 6983, 7179, 7375, 7571, 7767,
+  7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319, 9512, 9704,
+  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+  11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462,
+  13645, 13828, 14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+  15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846, 17018,
+  17189, 17360, 17530, 17700, 17869, 18037, 18204, 18371, 18537, 18703,
+  18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000, 20159, 20317,
+  20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311,
+  23452, 23592, 23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680,
+  24811, 24942, 25072, 25201, 25329, 25456, 25582, 25708, 25832, 25955,
+  26077, 26198, 26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+  27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001, 28105, 28208,
+  28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+  29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037,
+  30117, 30195, 30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+  30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297, 31356, 31414,
+  31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880, 31926,
+  31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250, 32285, 32318,
+  32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737,
+  32745, 32752, 32757, 32761, 32765, 32766, 32767, 32767
+};
+
+// atan(2^-i) as a 32-bit binary angle
+static const uint32_t Atan[CORDIC_ROTATE] = {
+  0x20000000, 0x12E4051E, 0x09FB385B, 0x051111D4, 0x028B0D43,
+  0x0145D7E1, 0x00A2F61E, 0x00517C55, 0x0028BE53, 0x00145F2F,
+  0x000A2F98, 0x000517CC, 0x00028BE6, 0x000145F3, 0x0000A2FA,
+  0x0000517D, 0x000028BE, 0x0000145F, 0x00000A30, 0x00000518,
+  0x0000028C, 0x00000146, 0x000000A3, 0x00000051, 0x00000029,
+  0x00000014, 0x0000000A, 0x00000005, 0x00000003, 0x00000001
+};
+
+// ------------Trig_Sin------------
+// Sine of a binary angle
+// Input: a - angle, 65536 per turn
+// Output: sin(a) in Q15, -32767 to 32767
+int32_t Trig_Sin(Angle_t a){
+  uint32_t i = a&0x3FFF;       // position in the quadrant
+  uint32_t k, f;
+  int32_t y;
+  if(a&0x4000){
+    i = 0x4000 - i;            // 2nd and 4th quadrant mirror the table
+  }
+  k = i>>6;                    // 256 segments per quadrant
+  f = i&0x3F;
+  y = Sine[k] + (((Sine[k+1] - Sine[k])*(int32_t)f + 32)>>6);
+  return (a&0x8000) ? -y : y;
+}
+
+// ------------Trig_Cos------------
+// Cosine of a binary angle
+// Input: a - angle, 65536 per turn
+// Output: cos(a) in Q15, -32767 to 32767
+int32_t Trig_Cos(Angle_t a){
+  return Trig_Sin(a + TRIG_90);
+}
+
+// ------------Trig_SinCos31------------
+// Sine and cosine of a 32-bit binary angle in Q31 by CORDIC
+// Input: a   - angle, 2^32 per turn
+//        sin - pointer to sin(a), Q31
+//        cos - pointer to cos(a), Q31
+// Output: none
+void Trig_SinCos31(uint32_t a, int32_t *sin, int32_t *cos){
+  int32_t x = K_Q30, y = 0, z, t;
+  uint32_t i, flip = 0;
+  if((a + 0x40000000)&0x80000000){
+    a = a + 0x80000000;        // 90 to 270 deg, turn around and negate
+    flip = 1;
+  }
+  z = (int32_t)a;              // -90 to +90 deg
+  for(i=0; i<CORDIC_ROTATE; i++){
+    t = x;
+    if(z >= 0){
+      x = x - (y>>i);
+      y = y + (t>>i);
+      z = z - Atan[i];
+    }else{
+      x = x + (y>>i);
+      y = y - (t>>i);
+      z = z + Atan[i];
+    }
+  }
+  if(flip){
+    x = -x;
+    y = -y;
+  }
+  // Q30 to Q31, 1.0 saturates to 0x7FFFFFFF
+  *cos = (x >= 0x40000000) ? 0x7FFFFFFF : (x <= -0x40000000) ? -0x7FFFFFFF : x*2;
+  *sin = (y >= 0x40000000) ? 0x7FFFFFFF : (y <= -0x40000000) ? -0x7FFFFFFF : y*2;
+}
+
+// CORDIC vectoring, rotates (x,y) onto the +x axis
+// returns the 32-bit angle of (x,y), *len gets the length scaled by 2^shift
+static uint32_t vector(int32_t x, int32_t y, uint32_t *len, int32_t *shift){
+  uint32_t ax = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+  uint32_t ay = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+  uint32_t z = 0, i;
+  int32_t s, t;
+  if((ax|ay) == 0){
+    *len = 0;
+    *shift = 0;
+    return 0;
+  }
+  // scale the larger component to 2^28..2^29-1, so the CORDIC gain
+  // (1.65) times sqrt(2) cannot overflow and small vectors keep precision
+  s = (int32_t)Bits_Clz(ax|ay) - 3;
+  if(s >= 0){
+    x = (int32_t)((uint32_t)x<<s);
+    y = (int32_t)((uint32_t)y<<s);
+  }else{
+    x = x>>(-s);
+    y = y>>(-s);
+  }
+  if(x < 0){
+    x = -x;                    // left half plane, turn around by 180 deg
+    y = -y;
+    z = 0x80000000;
+  }
+  for(i=0; i<CORDIC_VECTOR; i++){
+    t = x;
+    if(y > 0){
+      x = x + (y>>i);
+      y = y - (t>>i);
+      z = z + Atan[i];
+    }else{
+      x = x - (y>>i);
+      y = y + (t>>i);
+      z = z - Atan[i];
+    }
+  }
+  *len = (uint32_t)(((uint64_t)x*K_Q32)>>32);
+  *shift = s;
+  return z;
+}
+
+// ------------Trig_Atan2------------
+// Direction of the vector (x,y)
+// Input: y, x - vector components, any int32 values
+// Output: angle from the +x axis toward +y, 65536 per turn
+Angle_t Trig_Atan2(int32_t y, int32_t x){
+  uint32_t len;
+  int32_t s;
+  return (vector(x, y, &len, &s) + 0x8000)>>16;
+}
+
+// ------------Trig_Hypot------------
+// Length of the vector (x,y)
+// Input: x, y - vector components, any int32 values
+// Output: sqrt(x*x+y*y) rounded
+uint32_t Trig_Hypot(int32_t x, int32_t y){
+  uint32_t len;
+  int32_t s;
+  vector(x, y, &len, &s);
+  if(s > 0){
+    return (len + (1u<<(s-1)))>>s;
+  }
+  return len<<(-s);
+}
+
+// ------------Trig_FromDeg------------
+// Convert degrees to a binary angle
+// Input: deg - any whole number of degrees
+// Output: binary angle, 65536 per turn
+Angle_t Trig_FromDeg(int32_t deg){
+  deg = deg%360;               // keeps deg*65536 inside 32 bits
+  return (Angle_t)((deg*65536 + ((deg < 0) ? -180 : 180))/360);
+}
+
+// ------------Trig_ToDeg------------
+// Convert a binary angle to degrees
+// Input: a - angle, 65536 per turn
+// Output: rounded degrees, -180 to 179
+int32_t Trig_ToDeg(Angle_t a){
+  int32_t d = ((int32_t)(int16_t)a*360 + 32768)>>16;
+  return (d == 180) ? -180 : d;
+}
@@ -0,0 +1,81 @@
+/*
+ * Trig.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: aloy
+ */
+
+// Fixed-point trigonometry without floating point
+// Angles are binary: a full circle is 65536 (Angle_t, 16 bits) or
+// 2^32 (32-bit angles of Trig_SinCos31), so adding and subtracting
+// headings wraps around by itself and no angle ever needs a modulo.
+//   0x4000 = 90 deg, 0x8000 = 180 deg, 1 unit = 0.0055 deg
+// A signed difference of two headings is (int16_t)(a-b).
+//
+// - Trig_Sin/Trig_Cos: Q15 (32767 = 1.0) from a 257-entry quarter-wave
+//   table with linear interpolation, error about 1 LSB
+// - Trig_Atan2/Trig_Hypot: CORDIC vectoring, shifts and adds only
+// - Trig_SinCos31: CORDIC rotation for Q31 results
+// Lab1ref_SineFunction fsin(x) (1000*sin of x degrees) is
+//   (1000*Trig_Sin(Trig_FromDeg(x)) + 16384)>>15
+
+#ifndef TRIG_H_
+#define TRIG_H_
+
+#include <stdint.h>
+
+typedef uint16_t Angle_t;     // binary angle, 65536 per turn
+
+#define TRIG_ONE    32767     // 1.0 in Q15
+#define TRIG_90     0x4000    // binary angles
+#define TRIG_180    0x8000
+#define TRIG_PI_Q12 12868     // pi*4096, for integer arc length math
+#define TRIG_PI_Q16 205887    // pi*65536
+
+// ------------Trig_Sin------------
+// Sine of a binary angle
+// Input: a - angle, 65536 per turn
+// Output: sin(a) in Q15, -32767 to 32767
+int32_t Trig_Sin(Angle_t a);
+
+// ------------Trig_Cos------------
+// Cosine of a binary angle
+// Input: a - angle, 65536 per turn
+// Output: cos(a) in Q15, -32767 to 32767
+int32_t Trig_Cos(Angle_t a);
+
+// ------------Trig_SinCos31------------
+// Sine and cosine of a 32-bit binary angle in Q31 by CORDIC
+// Input: a   - angle, 2^32 per turn (Angle_t<<16 for a 16-bit angle)
+//        sin - pointer to sin(a), Q31
+//        cos - pointer to cos(a), Q31
+// Output: none
+// Note: error is below 100 Q31 LSB (about 2e-8)
+void Trig_SinCos31(uint32_t a, int32_t *sin, int32_t *cos);
+
+// ------------Trig_Atan2------------
+// Direction of the vector (x,y), any scale, e.g. mm or duty
+// Input: y, x - vector components, any int32 values
+// Output: angle from the +x axis toward +y, 65536 per turn,
+//         0 if x and y are both 0
+Angle_t Trig_Atan2(int32_t y, int32_t x);
+
+// ------------Trig_Hypot------------
+// Length of the vector (x,y)
+// Input: x, y - vector components, any int32 values
+// Output: sqrt(x*x+y*y), error 0.5 or relative 1e-5, whichever is larger
+uint32_t Trig_Hypot(int32_t x, int32_t y);
+
+// ------------Trig_FromDeg------------
+// Convert degrees to a binary angle
+// Input: deg - any whole number of degrees
+// Output: binary angle, 65536 per turn
+Angle_t Trig_FromDeg(int32_t deg);
+
+// ------------Trig_ToDeg------------
+// Convert a binary angle to degrees
+// Input: a - angle, 65536 per turn
+// Output: rounded degrees, -180 to 179
+int32_t Trig_ToDeg(Angle_t a);
+
+#endif /* TRIG_H_ */
@@ -80,6 +80,11 @@ int RxFifo_Get(uint8_t *datapt){
   RxGetI = (RxGetI+1)&(FIFOSIZE-1);         // next place to get
   return FIFOSUCCESS; 
 }
+uint32_t TxPutI;      // should be 0 to SIZE-1
+uint32_t TxGetI;      // should be 0 to SIZE-1
+uint8_t TxFIFO[FIFOSIZE];
+void (*RxTask)(uint8_t);   // receive bytes go here instead of RxFIFO, if set
+void (*TxDone)(void);      // called when UART1_Write output is finished
                     
 //------------UART1_InStatus------------
 // Returns how much data available for reading
@@ -95,6 +100,9 @@ uint32_t UART1_InStatus(void){
 // Output: none
 void UART1_Init(void){
   RxFifo_Init();              // initialize FIFOs
+  TxPutI = TxGetI = 0;
+  RxTask = 0;
+  TxDone = 0;
   EUSCI_A2->CTLW0 = 0x0001;         // hold the USCI module in reset mode
   // bit15=0,      no parity bits
   // bit14=x,      not used when parity is disabled
@@ -148,10 +156,58 @@ void UART1_OutChar(uint8_t data){
 // interrupt 18 occurs on :
 // UCRXIFG RX data register is full
 // vector at 0x00000088 in startup_msp432.s
+// UCTXIFG TX data register is empty, armed by UART1_Write
+// UCTXCPTIFG transmit complete, armed when TxFIFO runs empty
 void EUSCIA2_IRQHandler(void){
   if(EUSCI_A2->IFG&0x01){             // RX data register full
-    RxFifo_Put((uint8_t)EUSCI_A2->RXBUF);// clears UCRXIFG
-  } 
+    if(RxTask){
+      (*RxTask)((uint8_t)EUSCI_A2->RXBUF); // clears UCRXIFG
+    }else{
+      RxFifo_Put((uint8_t)EUSCI_A2->RXBUF);// clears UCRXIFG
+    }
+  }
+  if((EUSCI_A2->IE&0x02)&&(EUSCI_A2->IFG&0x02)){ // TX data register empty
+    if(TxPutI != TxGetI){
+      EUSCI_A2->IFG &= ~0x08;         // clear UCTXCPTIFG, more to send
+      EUSCI_A2->TXBUF = TxFIFO[TxGetI];  // clears UCTXIFG
+      TxGetI = (TxGetI+1)&(FIFOSIZE-1);
+    }else{
+      EUSCI_A2->IE = (EUSCI_A2->IE&~0x02)|0x08; // disarm UCTXIFG, wait for transmit complete
+    }
+  }
+  if((EUSCI_A2->IE&0x08)&&(EUSCI_A2->IFG&0x08)){ // last stop bit sent
+    EUSCI_A2->IE &= ~0x08;
+    EUSCI_A2->IFG &= ~0x08;
+    if(TxDone){
+      (*TxDone)();
+    }
+  }
+}
+
+//------------UART1_SetRxTask------------
+// Send received bytes to a function instead of the receive FIFO
+// Input: task is called in the ISR with each byte, 0 to use the FIFO
+// Output: none
+void UART1_SetRxTask(void(*task)(uint8_t)){
+  RxTask = task;
+}
+
+//------------UART1_Write------------
+// Queue bytes for interrupt-driven transmission
+// Input: pt is pointer to the bytes
+//        n is number of bytes
+//        done is called in the ISR when the last byte has been sent, or 0
+// Output: number of bytes queued
+uint32_t UART1_Write(const uint8_t *pt, uint32_t n, void(*done)(void)){
+  uint32_t i = 0;
+  TxDone = done;
+  while((i < n)&&(((TxPutI+1)&(FIFOSIZE-1)) != TxGetI)){
+    TxFIFO[TxPutI] = pt[i];
+    TxPutI = (TxPutI+1)&(FIFOSIZE-1);
+    i++;
+  }
+  EUSCI_A2->IE = (EUSCI_A2->IE&~0x08)|0x02; // arm UCTXIFG, ISR sends the first byte
+  return i;
 }
 
 //------------UART1_OutString------------
@@ -144,3 +144,25 @@ void UART1_FinishOutput(void);
  */
 uint32_t UART1_InStatus(void);
 
+/**
+ * @details   Send received bytes to a function instead of the receive FIFO
+ * @details   The function runs in the EUSCI_A2 ISR, once per byte
+ * @param  task is the function to call with each byte, or 0 to use the FIFO again
+ * @return none
+ * @note   UART1_Init must be called once prior
+ * @brief  Handle receive bytes in the ISR
+ */
+void UART1_SetRxTask(void(*task)(uint8_t));
+
+/**
+ * @details   Queue bytes for interrupt-driven transmission to EUSCI_A2 UART
+ * @details   non-blocking, the UCTXIFG interrupt drains the TxFifo
+ * @param  pt is pointer to the bytes
+ * @param  n is number of bytes
+ * @param  done is called in the ISR when the last byte has left the shift register, or 0
+ * @return number of bytes queued, less than n if the TxFifo is full
+ * @note   UART1_Init must be called once prior; do not mix with UART1_OutChar
+ * @brief  Transmit bytes without waiting
+ */
+uint32_t UART1_Write(const uint8_t *pt, uint32_t n, void(*done)(void));
+
@@ -84,6 +84,9 @@ SECTIONS
     .init_array   :     > MAIN
     .binit        : {}  > MAIN
 
+    /* Log.h format strings, kept in the .out file but not loaded         */
+    .logstr : > 0x00000000, type = COPY
+
     /* The following sections show the usage of the INFO flash memory        */
     /* INFO flash memory is intended to be used for the following            */
     /* device specific purposes:                                             */
@@ -0,0 +1,224 @@
+// apdispatch.c
+// Host test and timing of the AP.c characteristic dispatch and byte order
+//
+//   gcc -O2 -Ihost -I../inc -o apdispatch apdispatch.c ../inc/AP.c host/msp.c
+//   ./apdispatch
+//   add -fsanitize=address,undefined to check the copies for overruns and UB
+//
+// NPI.c is replaced by a model SNP that answers at once and hands out
+// characteristic handles in order.  32 read/write characteristics of
+// 1, 2, 4 and 8 bytes and 8 notify characteristics are added, with the
+// user data at odd addresses.  Then every write, short write, read and
+// CCCD indication goes through AP_BackgroundProcess and every
+// AP_SendNotification is checked against the byte order rules: SNP
+// data is big endian, user data little endian.
+// The same is run with the SNP handing out handles above 255, which
+// AP.c searches for instead of looking up.  Last it times one write
+// indication through AP_BackgroundProcess on both paths.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "msp.h"
+#include "AP.h"
+#include "NPI.h"
+
+#define CHARS   32
+#define NOTIFYS 8
+#define RUNS    2000000
+
+extern uint32_t CharacteristicCount, NotifyCharacteristicCount;
+extern uint8_t HandleIndex[256];
+
+static int Bad;
+static uint16_t NextHandle;
+static uint8_t Sent[NPI_FRAMESIZE];     // last frame from the LP
+static uint8_t Reply[8][NPI_FRAMESIZE];
+static uint32_t ReplyPut, ReplyGet;
+
+static void check(int ok, const char *what, int n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %d\n", what, n);
+    }
+  }
+}
+
+// queue a frame to the LP, payload from byte 5
+static void reply(uint8_t cmd0, uint8_t cmd1, const uint8_t *payload, uint32_t n){
+  uint8_t *f = Reply[ReplyPut%8];
+  f[0] = 0xFE; f[1] = n; f[2] = 0; f[3] = cmd0; f[4] = cmd1;
+  memcpy(&f[5], payload, n);
+  ReplyPut++;
+}
+
+// ---- NPI.c and the drivers AP.c uses ----
+void NPI_Init(void){
+}
+int NPI_Send(const uint8_t *msg){
+  uint8_t p[5] = {0};
+  uint32_t size = msg[1]+6;
+  memcpy(Sent, msg, size);
+  if(msg[3] == 0x35){             // add something, answer with the next handle
+    if(msg[4] == 0x83){
+      p[1] = msg[5];
+      p[2] = NextHandle&0xFF;     // descriptor answer has the handle at 7,8
+      p[3] = NextHandle>>8;
+    }else{
+      p[1] = NextHandle&0xFF;     // value answer has it at 6,7
+      p[2] = NextHandle>>8;
+    }
+    NextHandle++;
+    reply(0x75, msg[4], p, 4);
+  }else if((msg[3] == 0x55) && (msg[4] == 0x89)){
+    reply(0x55, 0x89, p, 1);      // notification sent
+  }
+  return 0;
+}
+uint32_t NPI_Receive(uint8_t *buf, uint32_t max){
+  uint32_t size;
+  if(ReplyGet == ReplyPut){
+    return 0;
+  }
+  size = Reply[ReplyGet%8][1]+6;
+  memcpy(buf, Reply[ReplyGet%8], (size < max) ? size : max);
+  ReplyGet++;
+  return size;
+}
+uint32_t NPI_Available(void){
+  return ReplyPut-ReplyGet;
+}
+int NPI_TxIdle(void){
+  return 1;
+}
+void NPI_Abort(void){
+}
+void NPI_GetStats(NPIStats_t *stats){
+  memset(stats, 0, sizeof(*stats));
+}
+void GPIO_Init(void){
+}
+void UART1_Init(void){
+}
+void Clock_Delay1ms(uint32_t n){
+  (void)n;
+}
+
+static uint32_t Reads, Writes, CCCDs;
+static void readFunc(void){
+  Reads++;
+}
+static void writeFunc(void){
+  Writes++;
+}
+static void cccdFunc(void){
+  CCCDs++;
+}
+
+static uint8_t Data[CHARS+NOTIFYS][9];   // user data, Data[i]+1 is odd
+static uint16_t Handle[CHARS], CCCDHandle[NOTIFYS];
+
+static uint32_t size(uint32_t i){
+  return 1u<<(i%4);                     // 1, 2, 4, 8
+}
+
+// the phone writes n bytes to characteristic i
+static void write(uint32_t i, const uint8_t *bytes, uint32_t n){
+  uint8_t p[7+8] = {0, 0, Handle[i]&0xFF, Handle[i]>>8, 0, 0, 0};
+  memcpy(&p[7], bytes, n);
+  reply(0x55, 0x88, p, 7+n);
+  AP_BackgroundProcess();
+}
+
+static void run(uint16_t first){
+  uint8_t bytes[8], p[7];
+  uint32_t i, j, s, w = Writes, r = Reads, c = CCCDs;
+  CharacteristicCount = NotifyCharacteristicCount = 0;
+  memset(HandleIndex, 0, 256);
+  NextHandle = first;
+  for(i=0; i<CHARS; i++){
+    Handle[i] = NextHandle;
+    check(AP_AddCharacteristic(0xFFF1+i, size(i), &Data[i][1], 0x03, 0x0A, "rw",
+                               &readFunc, &writeFunc) == APOK, "add", i);
+  }
+  for(i=0; i<NOTIFYS; i++){
+    CCCDHandle[i] = NextHandle+1;       // after the value
+    check(AP_AddNotifyCharacteristic(0xFFE1+i, size(i), &Data[CHARS+i][1], "n",
+                                     &cccdFunc) == APOK, "add notify", i);
+  }
+  for(i=0; i<CHARS; i++){
+    s = size(i);
+    for(j=0; j<s; j++){
+      bytes[j] = rand();
+    }
+    write(i, bytes, s);                 // full write, reversed
+    for(j=0; j<s; j++){
+      check(Data[i][1+j] == bytes[s-1-j], "write", i);
+    }
+    p[0] = p[1] = 0;
+    p[2] = Handle[i]&0xFF;
+    p[3] = Handle[i]>>8;
+    reply(0x55, 0x87, p, 4);            // read, reversed back
+    AP_BackgroundProcess();
+    check((Sent[3] == 0x55) && (Sent[4] == 0x87) && (Sent[1] == 7+s), "read frame", i);
+    for(j=0; j<s; j++){
+      check(Sent[12+j] == bytes[j], "read", i);
+    }
+    if(s > 1){                          // short write, zero filled from the top
+      write(i, bytes, 1);
+      check(Data[i][1] == bytes[0], "short write", i);
+      for(j=1; j<s; j++){
+        check(Data[i][1+j] == 0, "short write fill", i);
+      }
+    }
+  }
+  for(i=0; i<NOTIFYS; i++){
+    p[0] = p[1] = 0;
+    p[2] = CCCDHandle[i]&0xFF;
+    p[3] = CCCDHandle[i]>>8;
+    p[4] = 0;
+    p[5] = 1;                           // notify on
+    p[6] = 0;
+    reply(0x55, 0x8B, p, 7);
+    AP_BackgroundProcess();
+    check(AP_GetNotifyCCCD(i) == 1, "CCCD", i);
+    s = size(i);
+    for(j=0; j<s; j++){
+      Data[CHARS+i][1+j] = rand();
+    }
+    check(AP_SendNotification(i) == APOK, "notify", i);
+    for(j=0; j<s; j++){
+      check(Sent[11+j] == Data[CHARS+i][s-j], "notify data", i);
+    }
+  }
+  check(Writes-w == CHARS+3*CHARS/4, "write callbacks", Writes-w);
+  check(Reads-r == CHARS, "read callbacks", Reads-r);
+  check(CCCDs-c == NOTIFYS, "CCCD callbacks", CCCDs-c);
+}
+
+static double timeWrites(void){
+  uint8_t bytes[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  clock_t t;
+  uint32_t k;
+  t = clock();
+  for(k=0; k<RUNS; k++){
+    write(k%CHARS, bytes, size(k%CHARS));
+  }
+  return 1e9*(double)(clock()-t)/CLOCKS_PER_SEC/RUNS;
+}
+
+int main(void){
+  double table, search;
+  srand(1);
+  run(0x1E);
+  table = timeWrites();
+  run(0x1000);
+  search = timeWrites();
+  printf("write indication through AP_BackgroundProcess: %.1f ns with the handle table, "
+         "%.1f ns searching %d characteristics\n", table, search, CHARS);
+  printf("%s, %d errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
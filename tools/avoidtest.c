@@ -0,0 +1,131 @@
+// avoidtest.c
+// Host test of inc/Avoid.c on scripted obstacle fields
+//
+//   gcc -O2 -I../inc -o avoidtest avoidtest.c ../inc/Avoid.c
+//   ./avoidtest
+//
+// Each script holds the IR distances, bump bits and odometric heading
+// fixed for a number of Avoid_Update calls (a call is one 10 ms control
+// tick) and then checks the chosen heading, Blocked and the duties:
+//   open field     straight at the goal, both wheels at maxDuty
+//   wall ahead     turns right (ties go clockwise), inside the duty
+//                  limits, the turn part is KTURN per degree
+//   wall ahead and on the right   turns left
+//   boxed in       walls seen all round while spinning, then Blocked,
+//                  turns in place at maxDuty/2
+//   left bump      backs off at maxDuty/4 straight at the goal
+//   memory         a wall seen ahead is avoided after turning away
+//                  from it until it decays, then the goal is taken
+// Every call checks that both duties are within -maxDuty to maxDuty.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Avoid.h"
+
+#define MAXDUTY  5000
+#define FAR      800      // mm, beyond AVOID_RANGE
+#define NEAR     100      // mm
+#define KTURN    40       // duty per degree, Avoid.c
+#define SECTOR_DEG (360/AVOID_SECTORS)
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+static AvoidCmd_t Cmd;
+
+// n calls with the same field
+static void hold(uint32_t n, int32_t left, int32_t center, int32_t right, uint8_t bump,
+                 int32_t heading, long line){
+  while(n--){
+    Avoid_Update(left, center, right, bump, heading, &Cmd);
+    check((Cmd.Left >= -MAXDUTY) && (Cmd.Left <= MAXDUTY) &&
+          (Cmd.Right >= -MAXDUTY) && (Cmd.Right <= MAXDUTY), "duty limit", line);
+  }
+}
+
+// heading wrapped to -180 to +180
+static int32_t wrap(int32_t a){
+  a = a%360;
+  if(a > 180) a = a-360;
+  if(a < -180) a = a+360;
+  return a;
+}
+
+static void clear(void){
+  Avoid_Init(MAXDUTY, 0);
+  hold(40, FAR, FAR, FAR, 0, 0, __LINE__);
+  check((Cmd.Target == 0) && (Cmd.Blocked == 0) && (Cmd.Density == 0), "open target", Cmd.Target);
+  check((Cmd.Left == Cmd.Right) && (Cmd.Left == Cmd.Speed), "open straight", Cmd.Left-Cmd.Right);
+  check(Cmd.Speed >= MAXDUTY-10, "open speed", Cmd.Speed);
+}
+
+static void wall(void){
+  int32_t turn;
+  Avoid_Init(MAXDUTY, 0);
+  hold(30, FAR, NEAR, FAR, 0, 0, __LINE__);
+  check(Cmd.Blocked == 0, "wall blocked", 0);
+  check((wrap(Cmd.Target) > 45) && (wrap(Cmd.Target) < 90), "wall turns right", Cmd.Target);
+  turn = KTURN*wrap(Cmd.Target);
+  check((Cmd.Left == Cmd.Speed+turn) && (Cmd.Right == Cmd.Speed-turn), "wall duties", Cmd.Left);
+  check((Cmd.Speed > 0) && (Cmd.Speed < MAXDUTY/4), "wall slows", Cmd.Speed);
+  check(Cmd.Density > 500, "wall density", Cmd.Density);
+  Avoid_Init(MAXDUTY, 0);
+  hold(30, FAR, NEAR, NEAR, 0, 0, __LINE__);
+  check((wrap(Cmd.Target) < -45) && (wrap(Cmd.Target) > -90), "wall and right turns left", Cmd.Target);
+  check(Cmd.Left < Cmd.Right, "wall and right duties", Cmd.Left-Cmd.Right);
+}
+
+static void boxed(void){
+  int32_t h;
+  Avoid_Init(MAXDUTY, 0);
+  hold(10, FAR, FAR, FAR, 0, 0, __LINE__);     // up to speed first
+  for(h=0; h<720; h+=SECTOR_DEG){               // walls all round while it spins
+    hold(1, NEAR, NEAR, NEAR, 0x3F, h, __LINE__);
+  }
+  hold(1, NEAR, NEAR, NEAR, 0x3F, 0, __LINE__);
+  check(Cmd.Blocked == 1, "boxed blocked", 0);
+  check((Cmd.Speed == 0) && (Cmd.Left == -Cmd.Right), "boxed in place", Cmd.Speed);
+  check(abs(Cmd.Left) == MAXDUTY/2, "boxed turn", Cmd.Left);
+}
+
+static void bumped(void){
+  Avoid_Init(MAXDUTY, 0);
+  hold(10, FAR, FAR, FAR, 0, 0, __LINE__);
+  hold(40, FAR, FAR, FAR, 0x20, 0, __LINE__);  // bump 5, far left
+  check((Cmd.Target == 0) && (Cmd.Blocked == 0), "bump target", Cmd.Target);
+  check((Cmd.Left == Cmd.Right) && (abs(Cmd.Speed+MAXDUTY/4) <= 10), "bump backs off", Cmd.Speed);
+}
+
+static void memory(void){
+  uint32_t i;
+  Avoid_Init(MAXDUTY, 0);
+  hold(30, FAR, NEAR, FAR, 0, 0, __LINE__);    // wall at heading 0
+  hold(1, FAR, FAR, FAR, 0, 90, __LINE__);     // turned right, IR sees nothing
+  check(wrap(Cmd.Target) > 45, "forgot the wall", Cmd.Target);
+  check(Avoid_Density(0) > 500, "density kept", Avoid_Density(0));
+  for(i=0; (i < 100) && (Cmd.Target != 0); i++){
+    hold(1, FAR, FAR, FAR, 0, 90, __LINE__);
+  }
+  check((i > 5) && (i < 40), "wall decays", i);
+  check(Cmd.Target == 0, "back to the goal", Cmd.Target);
+  check(Cmd.Left < Cmd.Right, "turning back left", Cmd.Left-Cmd.Right);
+}
+
+int main(void){
+  clear();
+  wall();
+  boxed();
+  bumped();
+  memory();
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,151 @@
+// bitstest.c
+// Host test of inc/Bits.h and the tables Bump.c and Reflectance.c look up
+//
+//   gcc -O2 -Ihost -I../inc -o bitstest bitstest.c ../inc/Bump.c ../inc/Reflectance.c host/msp.c
+//   ./bitstest
+//
+// Every input pattern: for all 256 values of P4->IN, Bump_Read and
+// BumpGatherLUT must equal the six-mask formula Bump_Read used before
+// and Bits_Gather(in, 0xED); for all 256 scans of P7->IN,
+// Reflectance_Position and LinePositionLUT must equal the weighted
+// average loop Reflectance_Position used before, and Reflectance_Read
+// and Reflectance_Center must return the pins.  BITS_ALIAS must give
+// the addresses the projects hard-coded for P2->OUT, the motor sleep
+// pins on P3->OUT and the Nokia pins on P9->OUT; the host ports are in
+// host memory, so the TI register addresses are used.  Bits_Clz,
+// Bits_Ctz, Bits_Rbit and Bits_Count (the portable C, as on any host)
+// are compared with the compiler builtins on every power of 2, every
+// value next to one, and 540k values spread over the 32-bit range, and
+// Bits_Gather with a bit-by-bit gather on 1M random values and masks.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "msp.h"
+#include "Bits.h"
+#include "Bump.h"
+#include "Reflectance.h"
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+// ---- drivers Bump.c and Reflectance.c call ----
+volatile uint8_t bumpState;
+uint32_t Clock_GetFreq(void){
+  return 48000000;
+}
+void Clock_Delay1us(uint32_t n){
+  (void)n;
+}
+
+// ---- references, the code before Bits.h ----
+static uint8_t oldBumpRead(uint8_t in){
+  return (in&0x1)|((in>>1)&0x6)|((in>>2)&0x38);
+}
+
+static int32_t oldPosition(uint8_t data){
+  static const int32_t W[8] = {332, 237, 142, 47, -47, -142, -237, -332};
+  int32_t numerator = 0, denominator = 0, i;
+  for(i=0; i<8; i++){
+    numerator += (data&0x1)*W[i];
+    denominator += data&0x1;
+    data = data>>1;
+  }
+  if(denominator == 0){
+    return 333;
+  }
+  return numerator/denominator;
+}
+
+static uint32_t gather(uint32_t x, uint32_t mask){
+  uint32_t r = 0, k = 0, b;
+  for(b=0; b<32; b++){
+    if(mask&(1u<<b)){
+      r |= ((x>>b)&1)<<k;
+      k++;
+    }
+  }
+  return r;
+}
+
+static uint32_t rbit(uint32_t x){
+  uint32_t r = 0, b;
+  for(b=0; b<32; b++){
+    if((x>>b)&1){
+      r |= 1u<<(31-b);
+    }
+  }
+  return r;
+}
+
+static void patterns(void){
+  uint32_t i;
+  for(i=0; i<256; i++){
+    P4->IN = i;
+    check(Bump_Read() == oldBumpRead(i), "Bump_Read", i);
+    check(BumpGatherLUT[i] == oldBumpRead(i), "BumpGatherLUT", i);
+    check(Bits_Gather(i, 0xED) == BumpGatherLUT[i], "Bits_Gather P4", i);
+    check(Reflectance_Position(i) == oldPosition(i), "Reflectance_Position", i);
+    check(LinePositionLUT[i] == oldPosition(i), "LinePositionLUT", i);
+    P7->IN = i;
+    check(Reflectance_Read(1000) == i, "Reflectance_Read", i);
+    check(Reflectance_Center(1000) == ((i>>3)&3), "Reflectance_Center", i);
+  }
+}
+
+static void aliases(void){
+  check(BITS_ALIAS(0x40004C03, 0) == 0x42098060, "P2.0", 0);  // REDLED, P2_0
+  check(BITS_ALIAS(0x40004C03, 1) == 0x42098064, "P2.1", 1);
+  check(BITS_ALIAS(0x40004C03, 2) == 0x42098068, "P2.2", 2);  // BLUELED, P2_2
+  check(BITS_ALIAS(0x40004C03, 4) == 0x42098070, "P2.4", 4);
+  check(BITS_ALIAS(0x40004C22, 7) == 0x4209845C, "P3.7", 7);  // nSLP left
+  check(BITS_ALIAS(0x40004C22, 6) == 0x42098458, "P3.6", 6);  // nSLP right
+  check(BITS_ALIAS(0x40004C82, 6) == 0x42099058, "P9.6", 6);  // Nokia DC
+  check(BITS_ALIAS(0x40004C82, 3) == 0x4209904C, "P9.3", 3);  // Nokia reset
+}
+
+static void one(uint32_t x){
+  check(Bits_Clz(x) == (x ? (uint32_t)__builtin_clz(x) : 32), "Bits_Clz", x);
+  check(Bits_Ctz(x) == (x ? (uint32_t)__builtin_ctz(x) : 32), "Bits_Ctz", x);
+  check(Bits_Rbit(x) == rbit(x), "Bits_Rbit", x);
+  check(Bits_Count(x) == (uint32_t)__builtin_popcount(x), "Bits_Count", x);
+}
+
+static void scans(void){
+  uint64_t k;
+  uint32_t i, x, mask;
+  one(0);
+  one(0xFFFFFFFF);
+  for(i=0; i<32; i++){
+    one(1u<<i);
+    one((1u<<i) - 1);
+    one((1u<<i) + 1);
+    one(~(1u<<i));
+  }
+  for(k=0; k<(1ull<<32); k+=7919){
+    one((uint32_t)k*2654435761u);
+  }
+  x = mask = 1;
+  for(i=0; i<1000000; i++){
+    x = x*1664525 + 1013904223;
+    mask = mask*22695477 + 1;
+    check(Bits_Gather(x, mask) == gather(x, mask), "Bits_Gather", i);
+    check(Bits_Gather(x, mask>>(i%32)) == gather(x, mask>>(i%32)), "Bits_Gather short", i);
+  }
+  check(Bits_Gather(0xFFFFFFFF, 0xFFFFFFFF) == 0xFFFFFFFF && Bits_Gather(0x12345678, 0) == 0, "Bits_Gather edges", 0);
+}
+
+int main(void){
+  patterns();
+  aliases();
+  scans();
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
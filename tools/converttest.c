@@ -0,0 +1,241 @@
+// converttest.c
+// Host test and benchmark of inc/Convert.h against divide-per-digit conversion
+//
+//   gcc -O2 -I../inc -o converttest converttest.c ../inc/BaseConvert.c
+//   ./converttest              22M edge and random values, then the benchmark
+//   ./converttest all          every 32-bit value round trip, a few minutes
+//
+// The reference is the conversion BaseConvert.c did before Convert.h,
+// one divide and one modulo per digit into a reversed buffer, and the
+// overflow-checked digit loop of BaseToDecimal.  Decimal, hex and
+// binary text from Convert.h must match it character for character and
+// parse back to the same value through both Convert_ToU* and
+// BaseToDecimal; DecimalToBase must give the same text and error code
+// for every buffer size.  The fixed-width and fixed-point variants are
+// checked against printf.  The "all" run also checks that the multiply
+// by 0x51EB851F and shift by 37 in Convert.h equals n/100 for every n.
+//
+// The benchmark prints ns per number for the reference and Convert.h.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "BaseConvert.h"
+#include "Convert.h"
+
+static int Bad;
+
+static void check(int ok, const char *what, uint32_t n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %u\n", what, (unsigned)n);
+    }
+  }
+}
+
+// ---- reference, the original divide-per-digit DecimalToBase ----
+// kept out of line like the library function it was, so base is a
+// variable and the divides are real divides, as on the robot
+__attribute__((noinline)) static int8_t refToBase(uint32_t num, uint8_t base, char *output, uint8_t size){
+  uint8_t i = 0, a, b;
+  char temp;
+  if(size < 2){
+    return CONVERT_ERROR_OVERFLOW;
+  }
+  if(num == 0){
+    output[0] = '0';
+    output[1] = 0;
+    return CONVERT_SUCCESS;
+  }
+  while((num > 0) && (i < size-1)){
+    output[i++] = "0123456789ABCDEF"[num%base];
+    num = num/base;
+  }
+  if(num > 0){
+    return CONVERT_ERROR_OVERFLOW;
+  }
+  output[i] = 0;
+  for(a=0, b=i-1; a<b; a++, b--){
+    temp = output[a];
+    output[a] = output[b];
+    output[b] = temp;
+  }
+  return CONVERT_SUCCESS;
+}
+
+static void one(uint32_t n){
+  char a[40], b[40];
+  uint32_t v;
+  Convert_UDec(a, n);
+  refToBase(n, 10, b, sizeof(b));
+  check(strcmp(a, b) == 0, "dec", n);
+  check(Convert_ToUDec(a, &v) == strlen(a) && v == n, "to dec", n);
+  check(BaseToDecimal(a, 10, &v) == CONVERT_SUCCESS && v == n, "base dec", n);
+  Convert_UHex(a, n);
+  refToBase(n, 16, b, sizeof(b));
+  check(strcmp(a, b) == 0, "hex", n);
+  check(Convert_ToUHex(a, &v) == strlen(a) && v == n, "to hex", n);
+  check(BaseToDecimal(a, 16, &v) == CONVERT_SUCCESS && v == n, "base hex", n);
+  Convert_UBin(a, n);
+  refToBase(n, 2, b, sizeof(b));
+  check(strcmp(a, b) == 0, "bin", n);
+  check(Convert_ToUBin(a, &v) == strlen(a) && v == n, "to bin", n);
+  check(BaseToDecimal(a, 2, &v) == CONVERT_SUCCESS && v == n, "base bin", n);
+}
+
+// DecimalToBase against the reference for every buffer size
+static void sizes(uint32_t n){
+  static const uint8_t Base[3] = {2, 10, 16};
+  char a[40], b[40];
+  uint32_t i, size;
+  int8_t ra, rb;
+  for(i=0; i<3; i++){
+    for(size=0; size<=34; size++){
+      ra = DecimalToBase(n, Base[i], a, size);
+      rb = refToBase(n, Base[i], b, size);
+      check(ra == rb && ((ra != CONVERT_SUCCESS) || (strcmp(a, b) == 0)), "size", size);
+    }
+  }
+}
+
+static void fixed(void){
+  char a[40], b[40];
+  uint32_t n, bits, i, m;
+  static const struct{
+    int Kind;           // 0 UDecN, 1 SDecN, 2 UFix, 3 UHexN
+    int32_t N;
+    uint32_t Width, Decimals;
+    const char *Text;
+  } Cases[] = {
+    {0, 42, 5, 0, "   42"}, {0, 123456, 5, 0, "*****"}, {0, 0, 1, 0, "0"},
+    {1, -1234, 6, 0, " -1234"}, {1, -12345, 6, 0, "-12345"}, {1, -123456, 6, 0, "******"},
+    {1, -2147483647-1, 11, 0, "-2147483648"}, {1, 7, 3, 0, "  7"},
+    {2, 1234, 0, 2, "12.34"}, {2, 5, 0, 2, "0.05"}, {2, 5, 2, 1, " 0.5"},
+    {2, 999, 2, 1, "99.9"}, {2, 1000, 2, 1, "**.*"}, {2, -1, 0, 9, "4.294967295"},
+    {3, 0xAB, 4, 0, "00AB"}, {3, -1, 8, 0, "FFFFFFFF"},
+  };
+  for(i=0; i<sizeof(Cases)/sizeof(Cases[0]); i++){
+    switch(Cases[i].Kind){
+      case 0: Convert_UDecN(a, Cases[i].N, Cases[i].Width); break;
+      case 1: Convert_SDecN(a, Cases[i].N, Cases[i].Width); break;
+      case 2: Convert_UFix(a, Cases[i].N, Cases[i].Width, Cases[i].Decimals); break;
+      default: Convert_UHexN(a, Cases[i].N, Cases[i].Width); break;
+    }
+    check(strcmp(a, Cases[i].Text) == 0, "fixed case", i);
+  }
+  for(n=0; n<100000; n++){
+    Convert_UFix(a, n, 0, 2);
+    sprintf(b, "%u.%02u", (unsigned)(n/100), (unsigned)(n%100));
+    check(strcmp(a, b) == 0, "ufix", n);
+    Convert_SDec(a, -(int32_t)n*3);
+    sprintf(b, "%d", -(int)n*3);
+    check(strcmp(a, b) == 0, "sdec", n);
+  }
+  for(bits=1; bits<=32; bits++){
+    for(n=0; n<5000; n++){
+      m = n*2654435761u;
+      Convert_UBinN(a, m, bits);
+      for(i=0; i<bits; i++){
+        b[i] = '0' + ((m>>(bits-1-i))&1);
+      }
+      b[bits] = 0;
+      check(strcmp(a, b) == 0, "binN", bits);
+    }
+  }
+  // parsing stops at the first non-digit, overflow gives 0 characters
+  check(Convert_ToUDec("4294967296", &n) == 0, "dec overflow", 0);
+  check(Convert_ToUDec("4294967295x", &n) == 10 && n == 0xFFFFFFFF, "dec max", n);
+  check(Convert_ToUHex("123456789", &n) == 0, "hex overflow", 0);
+  check(Convert_ToUHex("00000000ffFFffff", &n) == 16 && n == 0xFFFFFFFF, "hex zeros", n);
+  check(Convert_ToUDec("x", &n) == 0, "no digits", 0);
+  check(BaseToDecimal("4294967296", 10, &n) == CONVERT_ERROR_OVERFLOW, "base overflow", 0);
+  check(BaseToDecimal("12a", 10, &n) == CONVERT_ERROR_INVALID, "base invalid", 0);
+  check(BaseToDecimal("0x1A5F", 16, &n) == CONVERT_SUCCESS && n == 0x1A5F, "base 0x", n);
+}
+
+static void all(void){
+  char a[40];
+  uint64_t i;
+  uint32_t n, v;
+  for(i=0; i<=0xFFFFFFFFu; i++){
+    n = (uint32_t)i;
+    Convert_UDec(a, n);
+    check(Convert_ToUDec(a, &v) && v == n, "all dec", n);
+    Convert_UHex(a, n);
+    check(Convert_ToUHex(a, &v) && v == n, "all hex", n);
+    check((uint32_t)(((uint64_t)n*0x51EB851Fu)>>37) == n/100, "div100", n);
+  }
+}
+
+static double ns(clock_t start, uint32_t count){
+  return (double)(clock()-start)*1e9/CLOCKS_PER_SEC/count;
+}
+
+static void benchmark(void){
+  char a[40];
+  volatile uint32_t sink = 0;
+  uint32_t n;
+  clock_t t;
+  double refDec, dec, refHex, hex, refBin, bin;
+  t = clock();
+  for(n=0; n<20000000; n++){ refToBase(n*214u, 10, a, sizeof(a)); sink += a[0]; }
+  refDec = ns(t, 20000000);
+  t = clock();
+  for(n=0; n<20000000; n++){ Convert_UDec(a, n*214u); sink += a[0]; }
+  dec = ns(t, 20000000);
+  t = clock();
+  for(n=0; n<20000000; n++){ refToBase(n*214u, 16, a, sizeof(a)); sink += a[0]; }
+  refHex = ns(t, 20000000);
+  t = clock();
+  for(n=0; n<20000000; n++){ Convert_UHex(a, n*214u); sink += a[0]; }
+  hex = ns(t, 20000000);
+  t = clock();
+  for(n=0; n<5000000; n++){ refToBase(n*859u, 2, a, sizeof(a)); sink += a[0]; }
+  refBin = ns(t, 5000000);
+  t = clock();
+  for(n=0; n<5000000; n++){ Convert_UBin(a, n*859u); sink += a[0]; }
+  bin = ns(t, 5000000);
+  printf("ns per number  reference  Convert.h\n");
+  printf("decimal        %9.1f  %9.1f\n", refDec, dec);
+  printf("hex            %9.1f  %9.1f\n", refHex, hex);
+  printf("binary         %9.1f  %9.1f\n", refBin, bin);
+}
+
+int main(int argc, char **argv){
+  uint32_t n, k;
+  int d;
+  if((argc > 1) && (strcmp(argv[1], "all") == 0)){
+    all();
+  }else{
+    for(n=0; n<2000000; n++){
+      one(n);
+    }
+    for(k=0; k<32; k++){
+      for(d=-3; d<=3; d++){
+        one((1u<<k) + d);
+        sizes((1u<<k) + d);
+      }
+    }
+    for(n=1; n<1000000000u; n=n*10){
+      for(d=-2; d<=2; d++){
+        one(n + d);
+        sizes(n + d);
+      }
+    }
+    one(0xFFFFFFFF);
+    sizes(0xFFFFFFFF);
+    srand(1);
+    for(n=0; n<20000000; n++){
+      one(((uint32_t)rand()<<16)^(uint32_t)rand());
+    }
+    fixed();
+  }
+  printf("%s, %d errors\n", Bad ? "FAIL" : "PASS", Bad);
+  if((Bad == 0) && (argc == 1)){
+    benchmark();
+  }
+  return Bad != 0;
+}
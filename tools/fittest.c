@@ -0,0 +1,195 @@
+// fittest.c
+// Host test of inc/MotorFit.c on synthetic and recorded motor sweeps
+//
+//   gcc -O2 -I../inc -o fittest fittest.c ../inc/MotorFit.c -lm
+//   ./fittest                  20000 synthetic motors
+//   ./fittest sweep.txt        fit a sweep printed by "cal run"
+//
+// A synthetic motor turns at gain*(duty-deadband) mm/s above its
+// deadband, sometimes limited to a top speed.  Its sweep is measured
+// the way MotorCal_Run does it: whole tachometer steps (360 per 220 mm)
+// counted over MOTORCAL_MEASURE ms and turned into mm/s, with up to
+// +/-6 mm/s of noise and the odd low reading, at the MOTORCAL_POINTS
+// duties of the sweep.  For every fit:
+//   a motor that reaches 40 mm/s must fit, one that never moves must not
+//   the inverse table and MotorCal_Lookup are nondecreasing,
+//     MotorCal_Lookup is 0 at 0 and MOTOR_MAX above MaxSpeed
+//   MotorCal_Speed is nondecreasing, 0 up to the deadband
+//   MotorCal_Speed(MotorCal_Lookup(v)) is within 2 mm/s of v
+// For the noise-free straight motors the duty MotorCal_Lookup gives
+// must drive the motor within 3 mm/s of the speed asked for below
+// 100 mm/s and within 3% above, and the deadband must be off by no
+// more than 3 mm/s worth of duty; one step in the window is 1 mm/s.
+//
+// With a file, the lines "duty L+ L- R+ R-" that "cal run" printed are
+// read (anything else in a terminal log is skipped) and the four curves
+// are fitted and printed the way the robot prints them, with the table.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "MotorCal.h"
+#include "Motor.h"
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+static void report(const char *what, double error, double limit, const char *unit){
+  printf("%-36s %8.3g %-10s (limit %g)\n", what, error, unit, limit);
+  if(error > limit){
+    Bad++;
+  }
+}
+
+// ---- synthetic motors ----
+typedef struct{
+  double Deadband, Gain, Top;   // duty, mm/s per duty, mm/s (0 no limit)
+} Motor_t;
+
+static double truth(const Motor_t *m, double duty){
+  double v = (duty <= m->Deadband) ? 0 : m->Gain*(duty - m->Deadband);
+  if((m->Top > 0) && (v > m->Top)){
+    v = m->Top;
+  }
+  return v;
+}
+
+// one point of the sweep, as MotorCal_Run measures it
+static int16_t measure(double v){
+  double steps = v*MOTORCAL_MEASURE*360/220000.0;
+  return (int16_t)(((int32_t)floor(steps)*220000)/(360*MOTORCAL_MEASURE));
+}
+
+static double Worst, WorstLow, WorstDead, WorstTrip;
+static long Fits;
+
+static void one(long run){
+  Motor_t m;
+  double noise, v;
+  uint16_t duty[MOTORCAL_POINTS];
+  int16_t speed[MOTORCAL_POINTS];
+  uint32_t i, d, prev, clean;
+  MotorCalCurve_t c;
+  m.Deadband = rand()%2500;
+  m.Gain = 0.03 + (rand()%1000)/10000.0;
+  m.Top = (rand()%3) ? 0 : 150 + rand()%300;
+  noise = (rand()%4)*2.0;
+  clean = (noise == 0) && (m.Top == 0);
+  for(i=0; i<MOTORCAL_POINTS; i++){
+    duty[i] = i*MOTORCAL_STEP;
+    v = truth(&m, duty[i]);
+    if(v > 0){
+      v += noise*((rand()%2001) - 1000)/1000.0;
+      if((noise > 0) && (rand()%50 == 0)){
+        v -= 20;                  // a wheel that caught on something
+      }
+    }
+    speed[i] = measure((v > 0) ? v : 0);
+  }
+  if(MotorCal_Fit(duty, speed, MOTORCAL_POINTS, &c)){
+    check(truth(&m, MOTORCAL_STEP*(MOTORCAL_POINTS-1)) <= 40, "no fit", run);
+    return;
+  }
+  Fits++;
+  check(truth(&m, MOTORCAL_STEP*(MOTORCAL_POINTS-1)) > 0, "fit without moving", run);
+  for(i=1; i<MOTORCAL_LUT; i++){
+    check(c.Duty[i] >= c.Duty[i-1], "table order", run);
+  }
+  check(MotorCal_Lookup(&c, 0) == 0, "lookup 0", run);
+  check(MotorCal_Lookup(&c, c.MaxSpeed + 1) == MOTOR_MAX, "lookup above", run);
+  prev = 0;
+  for(v=1; v<=c.MaxSpeed; v++){
+    d = MotorCal_Lookup(&c, v);
+    check(d >= prev, "lookup order", run);
+    prev = d;
+    WorstTrip = fmax(WorstTrip, fabs((double)MotorCal_Speed(&c, d) - v));
+    if(clean && (v < 100)){
+      WorstLow = fmax(WorstLow, fabs(truth(&m, d) - v));
+    }else if(clean){
+      Worst = fmax(Worst, fabs(truth(&m, d) - v)/v);
+    }
+  }
+  prev = 0;
+  for(d=0; d<=MOTOR_MAX; d++){
+    v = MotorCal_Speed(&c, d);
+    check(v >= prev, "speed order", run);
+    check((d > c.Deadband) || (v == 0), "speed below deadband", run);
+    prev = v;
+  }
+  if(clean){
+    WorstDead = fmax(WorstDead, fabs(c.Deadband - m.Deadband)*m.Gain);
+  }
+}
+
+static void synthetic(void){
+  long run;
+  srand(1);
+  for(run=0; run<20000; run++){
+    one(run);
+  }
+  printf("%ld of 20000 sweeps fitted\n", Fits);
+  report("speed from MotorCal_Lookup, <100mm/s", WorstLow, 3, "mm/s");
+  report("speed from MotorCal_Lookup, >=100mm/s", Worst, 0.03, "relative");
+  report("deadband, as the speed it is worth", WorstDead, 3, "mm/s");
+  report("MotorCal_Speed of MotorCal_Lookup", WorstTrip, 2, "mm/s");
+}
+
+// ---- a recorded sweep ----
+static const char *Names[4] = {"L+ ", "L- ", "R+ ", "R- "};
+
+static int recorded(const char *name){
+  FILE *f = fopen(name, "r");
+  char line[256];
+  uint16_t duty[MOTORCAL_MAXPOINTS];
+  int16_t speed[4][MOTORCAL_MAXPOINTS];
+  int d, s[4];
+  uint32_t n = 0, c, k;
+  MotorCalCurve_t curve;
+  if(f == 0){
+    perror(name);
+    return 1;
+  }
+  while(fgets(line, sizeof(line), f) && (n < MOTORCAL_MAXPOINTS)){
+    if(sscanf(line, "%d %d %d %d %d", &d, &s[0], &s[1], &s[2], &s[3]) == 5){
+      duty[n] = d;
+      for(c=0; c<4; c++){
+        speed[c][n] = s[c];
+      }
+      n++;
+    }
+  }
+  fclose(f);
+  printf("%u points\n", (unsigned)n);
+  for(c=0; c<4; c++){
+    printf("%s", Names[c]);
+    if((n < 2) || MotorCal_Fit(duty, speed[c], n, &curve)){
+      printf("does not move\n");
+      continue;
+    }
+    printf("deadband %u gain %d mm/s per 1000 duty, max %u mm/s\n   duty",
+           curve.Deadband, (int)((curve.Gain*1000)>>16), curve.MaxSpeed);
+    for(k=0; k<MOTORCAL_LUT; k++){
+      printf(" %u", curve.Duty[k]);
+    }
+    printf("\n");
+  }
+  return 0;
+}
+
+int main(int argc, char **argv){
+  if(argc > 1){
+    return recorded(argv[1]);
+  }
+  synthetic();
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,210 @@
+// fixedtest.c
+// Host test of inc/Fixed.h, intrinsic path against the portable path
+//
+//   gcc -O2 -I../inc -o fixedtest fixedtest.c -lm
+//   ./fixedtest                  about 20 s
+//
+// Fixed.h is included twice.  The first copy is the portable C, renamed
+// Port_*.  The second is the FIXED_DSP path, with __QADD, __QSUB,
+// __SSAT, __SMMUL and __CLZ defined here with the results the ARM
+// architecture manual gives for the instructions.  Every function is
+// run through both on 50M random and edge inputs and must give the
+// same bits.  The portable results are also checked against exact
+// 64-bit or 128-bit arithmetic: add and subtract saturate, the
+// reciprocal is within 1 LSB of 2^32/x, the square root within 1 LSB
+// or 2^-15 of the value, and Fixed_Div64 equals the truncated quotient,
+// saturated, including a quotient of exactly -2^31.  Build it with
+// -fsanitize=undefined to see that no path overflows a signed int.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ---- the portable path ----
+#define FIXED_DSP 0
+#define Fixed_Sat16    Port_Sat16
+#define Fixed_Clamp    Port_Clamp
+#define Fixed_Add      Port_Add
+#define Fixed_Sub      Port_Sub
+#define Fixed_Q15Add   Port_Q15Add
+#define Fixed_Q15Sub   Port_Q15Sub
+#define Fixed_Q15Mul   Port_Q15Mul
+#define Fixed_Q31Mul   Port_Q31Mul
+#define Fixed_Q16Mul   Port_Q16Mul
+#define Fixed_Clz      Port_Clz
+#define Fixed_Q16Recip Port_Q16Recip
+#define Fixed_SqrtU32  Port_SqrtU32
+#define Fixed_Q16Sqrt  Port_Q16Sqrt
+#define Fixed_Div64    Port_Div64
+#include "Fixed.h"
+#undef Fixed_Sat16
+#undef Fixed_Clamp
+#undef Fixed_Add
+#undef Fixed_Sub
+#undef Fixed_Q15Add
+#undef Fixed_Q15Sub
+#undef Fixed_Q15Mul
+#undef Fixed_Q31Mul
+#undef Fixed_Q16Mul
+#undef Fixed_Clz
+#undef Fixed_Q16Recip
+#undef Fixed_SqrtU32
+#undef Fixed_Q16Sqrt
+#undef Fixed_Div64
+#undef FIXED_H_
+#undef FIXED_DSP
+
+// ---- the intrinsic path, CMSIS intrinsics as the instructions behave ----
+static inline int32_t __QADD(int32_t a, int32_t b){
+  int64_t s = (int64_t)a + b;
+  return (s > INT32_MAX) ? INT32_MAX : (s < INT32_MIN) ? INT32_MIN : (int32_t)s;
+}
+static inline int32_t __QSUB(int32_t a, int32_t b){
+  int64_t s = (int64_t)a - b;
+  return (s > INT32_MAX) ? INT32_MAX : (s < INT32_MIN) ? INT32_MIN : (int32_t)s;
+}
+static inline int32_t ssat(int32_t x, uint32_t n){
+  int32_t hi = (int32_t)((1u<<(n-1)) - 1), lo = -hi - 1;
+  return (x > hi) ? hi : (x < lo) ? lo : x;
+}
+#define __SSAT(x, n) ssat((x), (n))
+static inline int32_t __SMMUL(int32_t a, int32_t b){
+  return (int32_t)(((int64_t)a*b)>>32);
+}
+#define FIXED_DSP 1
+#include "Fixed.h"
+
+static long Bad;
+
+static void check(int ok, const char *what, int64_t a, int64_t b){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %lld %lld\n", what, (long long)a, (long long)b);
+    }
+  }
+}
+
+static uint64_t Seed = 88172645463325252ull;
+static uint32_t rnd(void){    // xorshift64
+  Seed ^= Seed<<13;
+  Seed ^= Seed>>7;
+  Seed ^= Seed<<17;
+  return (uint32_t)Seed;
+}
+
+// random inputs, weighted toward the edges and short values
+static int32_t pick(void){
+  static const int32_t Edge[] = {0, 1, -1, 2, -2, 32767, -32768, 32768, -32769,
+    65536, -65536, INT32_MAX, INT32_MIN, INT32_MAX-1, INT32_MIN+1, 0x40000000, -0x40000000};
+  switch(rnd()%4){
+    case 0: return Edge[rnd()%(sizeof(Edge)/sizeof(Edge[0]))];
+    case 1: return (int16_t)rnd();
+    case 2: return (int32_t)rnd()>>(rnd()%31);
+    default: return (int32_t)rnd();
+  }
+}
+
+static int32_t sat32(int64_t x){
+  return (x > INT32_MAX) ? INT32_MAX : (x < INT32_MIN) ? INT32_MIN : (int32_t)x;
+}
+
+#define N 50000000
+static void paths(void){
+  int32_t a, b;
+  int16_t a16, b16;
+  int64_t n;
+  long i;
+  for(i=0; i<N; i++){
+    a = pick();
+    b = pick();
+    a16 = (int16_t)a;
+    b16 = (int16_t)b;
+    check(Fixed_Add(a, b) == Port_Add(a, b), "add", a, b);
+    check(Port_Add(a, b) == sat32((int64_t)a + b), "add exact", a, b);
+    check(Fixed_Sub(a, b) == Port_Sub(a, b), "sub", a, b);
+    check(Port_Sub(a, b) == sat32((int64_t)a - b), "sub exact", a, b);
+    check(Fixed_Sat16(a) == Port_Sat16(a), "sat16", a, 0);
+    check(Fixed_Q15Add(a16, b16) == Port_Q15Add(a16, b16), "q15add", a16, b16);
+    check(Fixed_Q15Sub(a16, b16) == Port_Q15Sub(a16, b16), "q15sub", a16, b16);
+    check(Fixed_Q15Mul(a16, b16) == Port_Q15Mul(a16, b16), "q15mul", a16, b16);
+    check(Fixed_Q31Mul(a, b) == Port_Q31Mul(a, b), "q31mul", a, b);
+    check(Fixed_Q16Mul(a, b) == Port_Q16Mul(a, b), "q16mul", a, b);
+    check(Port_Q16Mul(a, b) == sat32(((int64_t)a*b)>>16), "q16mul exact", a, b);
+    check(Fixed_Q16Recip(a) == Port_Q16Recip(a), "recip", a, 0);
+    check(Fixed_Q16Sqrt(a) == Port_Q16Sqrt(a), "sqrt", a, 0);
+    check(Fixed_Clz((uint32_t)a) == Port_Clz((uint32_t)a), "clz", a, 0);
+    n = (int64_t)((uint64_t)(int64_t)a<<(rnd()%33)) ^ rnd();
+    if(b){
+      check(Fixed_Div64(n, b) == Port_Div64(n, b), "div64", n, b);
+    }
+  }
+}
+
+static void accuracy(void){
+  double r, e, worst = 0, rel = 0;
+  __int128 q;
+  int64_t n;
+  int32_t x, d, want;
+  long i;
+  for(i=0; i<20000000; i++){
+    x = pick();
+    if(x == 0){
+      continue;
+    }
+    r = 4294967296.0/x;
+    if((r > 2147483647.0) || (r < -2147483648.0)){
+      check(Port_Q16Recip(x) == ((x > 0) ? INT32_MAX : -INT32_MAX), "recip sat", x, 0);
+      continue;
+    }
+    e = fabs(Port_Q16Recip(x) - r);
+    worst = (e > worst) ? e : worst;
+  }
+  printf("Fixed_Q16Recip  max error %.3f LSB\n", worst);
+  check(worst <= 1.0, "recip error", (int64_t)(worst*1000), 0);
+  for(i=0; i<20000000; i++){
+    x = pick();
+    if(x <= 0){
+      check(Port_Q16Sqrt(x) == 0, "sqrt negative", x, 0);
+      continue;
+    }
+    r = sqrt((double)x*65536.0);
+    e = fabs(Port_Q16Sqrt(x) - r);
+    check((e <= 1.0) || (e/r <= 1/32768.0), "sqrt error", x, Port_Q16Sqrt(x));
+    if(e > 1.0){
+      rel = (e/r > rel) ? e/r : rel;
+    }
+  }
+  printf("Fixed_Q16Sqrt   max relative error %.3g over 1 LSB (2^-15 is %.3g)\n", rel, 1/32768.0);
+  for(i=0; i<50000000; i++){
+    d = pick();
+    if(d == 0){
+      continue;
+    }
+    n = (int64_t)((uint64_t)(int64_t)pick()<<(rnd()%33)) ^ (int64_t)(int32_t)rnd();
+    if(i < 6){                // quotients of exactly -2^31 and 2^31
+      static const int64_t Edge[6][2] = {
+        {-0x80000000ll, 1}, {0x80000000ll, -1}, {-0x100000000ll, 2},
+        {0x80000000ll, 1}, {-0x80000000ll, -1}, {INT64_MIN, INT32_MIN}};
+      n = Edge[i][0];
+      d = (int32_t)Edge[i][1];
+    }
+    q = (__int128)n/d;
+    want = (q > INT32_MAX) ? INT32_MAX : (q < INT32_MIN) ? INT32_MIN : (int32_t)q;
+    check(Port_Div64(n, d) == want, "div64 exact", n, d);
+  }
+}
+
+static void constants(void){
+  check(Q15(0.5) == 16384 && Q15(1.0) == 32767 && Q15(-1.0) == -32768, "Q15", Q15(0.5), 0);
+  check(Q16(1.2) == 78643 && Q16(-0.5) == -32768 && Q16(40000.0) == INT32_MAX, "Q16", Q16(1.2), 0);
+  check(Q31(0.25) == 0x20000000 && Q31(1.0) == INT32_MAX && Q31(-1.0) == INT32_MIN, "Q31", Q31(0.25), 0);
+}
+
+int main(void){
+  constants();
+  paths();
+  accuracy();
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,466 @@
+// fsmtest.c
+// Host test of inc/FSM.c on the Lab 2 line follower tables
+//
+//   gcc -O2 -I../inc -o fsmtest fsmtest.c ../inc/FSM.c
+//   ./fsmtest                  run from tools/, checks every table under ..
+//   ./fsmtest file.c ...       checks only the tables in these files
+//
+// The tables are read from the lab sources, not copied here: the
+// LINE_FSM(S) list a file gives FSM_TABLE is parsed into the same
+// 8-byte rows the macro makes (names in order are the indices).
+//
+// Scripted inputs, one FSM_Tick per 1 ms tick:
+//   3-state table (Lab2_FSMmain-3states.c): on the line it stays in
+//     Center, a sensor off the line moves it in the same tick, held
+//     inputs alternate at the 500 ms dwell
+//   11-state table (Lab2-FSMmain-11states.c): losing the line goes
+//     Center, Right1, Right_off1, Right_off2, Right_stop at 0, 500,
+//     5500 and 10500 ms and stays stopped; finding the line in
+//     Right_off1 gets back to Center after both 5000 ms dwells
+// Random inputs, 2M ticks per table, changing after 1 to 1500 ticks:
+//   a change that selects a different next state than the entry input
+//     moves the FSM in that tick, unless the state is a timed one
+//   any other transition happens exactly at the end of the dwell
+//   Latency and MaxLatency count only the input-driven transitions,
+//     so MaxLatency stays 0 and never shows a dwell such as 5000 ms
+//   a stop state (all next entries itself) restarts it in Center
+// Every FSM_TABLE(list, table) in the .c files of the tree:
+//   FSM_Validate from the first state with recover input 3 (on the
+//   line), fails on a bad next name or index, an unreachable state or
+//   a dead end; stops (out 0, never left) are listed but allowed
+
+#include <ctype.h>
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "FSM.h"
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+// ---- tables from the sources ----
+typedef struct{
+  char Name[96];                      // file:table
+  uint32_t Size;
+  char States[FSM_MAXSTATES][32];
+  struct FSMState Rows[FSM_MAXSTATES];
+  uint32_t Errors;                    // names that are no state, fields that are no number
+} Table_t;
+
+// file contents, comments removed and strings blanked, lines joined
+static char *load(const char *name){
+  FILE *f = fopen(name, "rb");
+  char *text, *out;
+  long n, i, k = 0;
+  if(f == 0){
+    return 0;
+  }
+  fseek(f, 0, SEEK_END);
+  n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  text = malloc(n + 1);
+  out = malloc(n + 1);
+  n = (long)fread(text, 1, n, f);
+  text[n] = 0;
+  fclose(f);
+  for(i=0; i<n; i++){
+    if((text[i] == '/') && (text[i+1] == '*')){
+      for(i+=2; (i < n) && !((text[i] == '*') && (text[i+1] == '/')); i++){}
+      i++;
+      out[k++] = ' ';
+    }else if((text[i] == '/') && (text[i+1] == '/')){
+      while((i < n) && (text[i] != '\n') && !((text[i] == '\\') && (text[i+1] == '\n' || text[i+1] == '\r'))){
+        i++;
+      }
+      i--;
+    }else if((text[i] == '"') || (text[i] == '\'')){
+      char q = text[i];
+      out[k++] = q;
+      for(i++; (i < n) && (text[i] != q) && (text[i] != '\n'); i++){
+        if(text[i] == '\\'){
+          i++;
+        }
+      }
+      out[k++] = q;
+    }else if((text[i] == '\\') && ((text[i+1] == '\n') || (text[i+1] == '\r'))){
+      i += (text[i+1] == '\r') ? 2 : 1;   // line continuation
+      out[k++] = ' ';
+    }else if(text[i] != '\r'){
+      out[k++] = text[i];
+    }
+  }
+  out[k] = 0;
+  free(text);
+  return out;
+}
+
+static const char *skip(const char *p){
+  while(isspace((unsigned char)*p)){
+    p++;
+  }
+  return p;
+}
+
+// copies an identifier to id, returns the character after it
+static const char *ident(const char *p, char *id, uint32_t size){
+  uint32_t k = 0;
+  p = skip(p);
+  while((isalnum((unsigned char)*p) || (*p == '_')) && (k + 1 < size)){
+    id[k++] = *p++;
+  }
+  id[k] = 0;
+  return p;
+}
+
+// body of "#define list(param) ..." in text, 0 if there is none
+static const char *body(const char *text, const char *list, char *param){
+  const char *p = text, *q;
+  char id[64];
+  while((p = strstr(p, "#define")) != 0){
+    q = ident(p + 7, id, sizeof(id));
+    p += 7;
+    if((strcmp(id, list) == 0) && (*q == '(')){
+      q = ident(q + 1, param, 32);
+      q = skip(q);
+      if(*q == ')'){
+        return q + 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// splits "a, b, c)" into fields, returns the number, *end after the ')'
+static uint32_t fields(const char *p, char f[7][32], const char **end){
+  uint32_t n = 0, k = 0, depth = 0;
+  for(; *p && (*p != '\n'); p++){
+    if((*p == '(') ){
+      depth++;
+    }else if((*p == ')') && (depth == 0)){
+      break;
+    }else if(*p == ')'){
+      depth--;
+    }
+    if((*p == ',') && (depth == 0)){
+      f[n][k] = 0;
+      n++;
+      k = 0;
+      if(n == 7){
+        *end = p;
+        return 8;
+      }
+    }else if(!isspace((unsigned char)*p) && (k < 31)){
+      f[n][k++] = *p;
+    }
+  }
+  f[n][k] = 0;
+  *end = *p ? p + 1 : p;
+  return n + 1;
+}
+
+static uint32_t number(const char *s, uint32_t max, uint32_t *errors){
+  char *end;
+  unsigned long v = strtoul(s, &end, 0);
+  if((*s == 0) || (*end != 0) || (v > max)){
+    (*errors)++;
+    return 0;
+  }
+  return (uint32_t)v;
+}
+
+// parse the state list behind FSM_TABLE(list, table) in text
+static void parse(Table_t *t, const char *text, const char *list){
+  char param[32], f[7][32], call[40];
+  const char *p = body(text, list, param), *end;
+  uint32_t i, j, n, pass;
+  t->Size = 0;
+  t->Errors = 0;
+  if(p == 0){
+    t->Errors++;
+    return;
+  }
+  snprintf(call, sizeof(call), "%s(", param);
+  for(pass=0; pass<2; pass++){             // names first, then the rows
+    const char *q = p, *line = strchr(p, '\n');
+    n = 0;
+    while(((q = strstr(q, call)) != 0) && ((line == 0) || (q < line))){
+      if((q > p) && (isalnum((unsigned char)q[-1]) || (q[-1] == '_'))){
+        q++;
+        continue;
+      }
+      if(fields(q + strlen(call), f, &end) != 7){
+        t->Errors++;
+        q = end;
+        continue;
+      }
+      if(n >= FSM_MAXSTATES){
+        t->Errors++;
+        break;
+      }
+      if(pass == 0){
+        snprintf(t->States[n], sizeof(t->States[n]), "%s", f[0]);
+      }else{
+        t->Rows[n].out = number(f[1], 0xFF, &t->Errors);
+        t->Rows[n].delay = number(f[2], 0xFFFF, &t->Errors);
+        for(j=0; j<4; j++){
+          for(i=0; (i < t->Size) && strcmp(t->States[i], f[3+j]); i++){}
+          t->Rows[n].next[j] = (i < t->Size) ? i : 0xFF;   // 0xFF is BadNext
+          if(i == t->Size){
+            t->Errors++;
+          }
+        }
+      }
+      n++;
+      q = end;
+    }
+    t->Size = n;
+  }
+}
+
+// the table file gives FSM_TABLE(LINE_FSM, fsm)
+static int table(Table_t *t, const char *file){
+  char *text = load(file);
+  if(text == 0){
+    perror(file);
+    Bad++;
+    return 1;
+  }
+  snprintf(t->Name, sizeof(t->Name), "%s", file);
+  parse(t, text, "LINE_FSM");
+  free(text);
+  check(t->Size > 0 && t->Errors == 0, "table parse", t->Errors);
+  return (t->Size == 0);
+}
+
+static uint32_t state(const Table_t *t, const char *name){
+  uint32_t i;
+  for(i=0; i<t->Size; i++){
+    if(strcmp(t->States[i], name) == 0){
+      return i;
+    }
+  }
+  printf("%s has no state %s\n", t->Name, name);
+  Bad++;
+  return 0;
+}
+
+// ---- scripted inputs ----
+static FSM_t Fsm;
+
+// input for ticks ticks, returns the transitions
+static uint32_t hold(uint32_t input, uint32_t ticks){
+  uint32_t before = Fsm.Transitions;
+  while(ticks--){
+    FSM_Tick(&Fsm, input);
+  }
+  return Fsm.Transitions - before;
+}
+
+// the FSM is in state name after input for ticks ticks, and not before
+static void expect(const Table_t *t, uint32_t input, uint32_t ticks, const char *name, long line){
+  uint32_t s = state(t, name), start = Fsm.State;
+  if(ticks > 1){
+    hold(input, ticks - 1);
+    check(Fsm.State == start, "early", line);
+  }
+  hold(input, 1);
+  check(Fsm.State == s, name, line);
+}
+
+static void three(const Table_t *t){
+  uint32_t center = state(t, "Center");
+  FSM_Init(&Fsm, t->Rows, center, 3);
+  check(hold(3, 2000) == 0 && Fsm.State == center, "on the line", 0);
+  expect(t, 1, 1, "Left", __LINE__);          // off to the left, now
+  expect(t, 1, 500, "Center", __LINE__);      // held, at the dwell
+  expect(t, 1, 500, "Left", __LINE__);
+  expect(t, 2, 1, "Right", __LINE__);         // the other side, now
+  expect(t, 3, 500, "Center", __LINE__);      // Right takes 3 and 2 to Center
+  expect(t, 3, 5000, "Center", __LINE__);
+  check(Fsm.Latency == 0 && Fsm.MaxLatency == 0, "latency", Fsm.MaxLatency);
+}
+
+static void eleven(const Table_t *t){
+  FSM_Init(&Fsm, t->Rows, state(t, "Center"), 3);
+  expect(t, 0, 1, "Right1", __LINE__);        // lost the line
+  expect(t, 0, 500, "Right_off1", __LINE__);
+  expect(t, 0, 5000, "Right_off2", __LINE__);
+  expect(t, 0, 5000, "Right_stop", __LINE__);
+  check(hold(3, 20000) == 0, "stays stopped", 0);
+  check(Fsm.MaxLatency == 0, "dwell counted as latency", Fsm.MaxLatency);
+  FSM_Init(&Fsm, t->Rows, state(t, "Center"), 3);
+  expect(t, 0, 1, "Right1", __LINE__);
+  expect(t, 0, 500, "Right_off1", __LINE__);
+  hold(0, 1000);
+  expect(t, 3, 4000, "Right_off2", __LINE__);  // a timed state, ignores the line
+  expect(t, 3, 5000, "Center", __LINE__);      // entered with 3, full dwell
+  FSM_Init(&Fsm, t->Rows, state(t, "Center"), 3);
+  expect(t, 1, 1, "Left1", __LINE__);
+  expect(t, 2, 1, "Right1", __LINE__);         // reacts in the tick
+  expect(t, 3, 1, "Center", __LINE__);
+  check(Fsm.MaxLatency == 0 && Fsm.Transitions == 3, "reaction", Fsm.MaxLatency);
+}
+
+// ---- random inputs ----
+static void wander(const Table_t *t, uint32_t seed){
+  uint32_t tick, input = 3, left = 0, before, entry = 3, time = 0, timed, changed, runs = 0;
+  FSMState_t *s;
+  srand(seed);
+  FSM_Init(&Fsm, t->Rows, 0, 3);
+  for(tick=0; tick<2000000; tick++){
+    if(left == 0){
+      input = rand()%4;
+      left = 1 + rand()%1500;
+    }
+    left--;
+    if(Fsm.Transitions && (t->Rows[Fsm.State].next[0] == Fsm.State) && (t->Rows[Fsm.State].next[1] == Fsm.State)
+     && (t->Rows[Fsm.State].next[2] == Fsm.State) && (t->Rows[Fsm.State].next[3] == Fsm.State)){
+      runs++;                            // stopped for good, put it back on the line
+      FSM_Init(&Fsm, t->Rows, 0, 3);
+      entry = 3;
+      time = 0;
+    }
+    before = Fsm.State;
+    s = &t->Rows[before];
+    timed = (s->next[0] == s->next[1]) && (s->next[0] == s->next[2]) && (s->next[0] == s->next[3]);
+    changed = (input != entry) && (s->next[input] != s->next[entry]);
+    time++;
+    FSM_Tick(&Fsm, input);
+    if(time >= s->delay){
+      check(Fsm.State == s->next[input], "dwell", tick);
+    }else if(changed && !timed){
+      check(Fsm.State == s->next[input], "reaction", tick);
+      check(Fsm.Latency == 0, "latency", tick);
+    }else{
+      check(Fsm.State == before, "left early", tick);
+    }
+    if((time >= s->delay) || (changed && !timed)){
+      entry = input;
+      time = 0;
+    }
+  }
+  check(Fsm.MaxLatency == 0, "MaxLatency", Fsm.MaxLatency);
+  printf("%s: %u ticks, %u stops, %u transitions in the last run, MaxLatency %u\n", t->Name,
+         (unsigned)tick, (unsigned)runs, (unsigned)Fsm.Transitions, (unsigned)Fsm.MaxLatency);
+}
+
+// ---- every table in the tree ----
+static uint32_t Tables;
+
+static void validate(const char *file){
+  static Table_t t;
+  FSMReport_t report;
+  char list[64], name[64], *text = load(file);
+  const char *p, *q;
+  if(text == 0){
+    perror(file);
+    Bad++;
+    return;
+  }
+  for(p = text; (p = strstr(p, "FSM_TABLE")) != 0; p += 9){
+    if(((p > text) && (isalnum((unsigned char)p[-1]) || (p[-1] == '_')))
+     || (*skip(p + 9) != '(')){
+      continue;
+    }
+    q = ident(skip(p + 9) + 1, list, sizeof(list));
+    q = skip(q);
+    if(*q != ','){
+      continue;
+    }
+    q = skip(ident(q + 1, name, sizeof(name)));
+    if(*q != ')'){
+      continue;
+    }
+    snprintf(t.Name, sizeof(t.Name), "%s:%s", file, name);
+    parse(&t, text, list);
+    Tables++;
+    if((t.Size == 0) || t.Errors){
+      printf("%s: %u states, %u parse errors\n", t.Name, (unsigned)t.Size, (unsigned)t.Errors);
+      Bad++;
+      if(t.Size == 0){
+        continue;
+      }                             // unknown names are 0xFF, BadNext below
+    }
+    FSM_Validate(t.Rows, t.Size, 0, 3, 0, &report);
+    printf("%s: %u states, %u bad next, %u unreachable, %u dead ends, %u stops, worst recovery ",
+           t.Name, (unsigned)t.Size, (unsigned)report.BadNext, (unsigned)report.Unreachable,
+           (unsigned)report.DeadEnds, (unsigned)report.Stops);
+    if(report.WorstRecover == FSM_NEVER){
+      printf("never (%s)\n", t.States[report.WorstState]);
+    }else{
+      printf("%u ticks (%s)\n", (unsigned)report.WorstRecover, t.States[report.WorstState]);
+    }
+    if(report.Unreachable){
+      printf("  %s is unreachable\n", t.States[report.FirstUnreachable]);
+    }
+    if(report.DeadEnds){
+      printf("  %s never leaves and drives on\n", t.States[report.FirstDeadEnd]);
+    }
+    check((report.BadNext == 0) && (report.Unreachable == 0) && (report.DeadEnds == 0),
+          "table", (long)Tables);
+  }
+  free(text);
+}
+
+// the .c files under dir, build output and this directory left out
+static void walk(const char *dir){
+  DIR *d = opendir(dir);
+  struct dirent *e;
+  struct stat st;
+  char path[1024];
+  size_t n;
+  if(d == 0){
+    perror(dir);
+    Bad++;
+    return;
+  }
+  while((e = readdir(d)) != 0){
+    n = strlen(e->d_name);
+    snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+    if((e->d_name[0] == '.') || (strcmp(e->d_name, "Debug") == 0) || (strcmp(e->d_name, "tools") == 0)){
+      continue;
+    }
+    if((n > 2) && (strcmp(e->d_name + n - 2, ".c") == 0)){
+      validate(path);
+    }else if((stat(path, &st) == 0) && S_ISDIR(st.st_mode)){
+      walk(path);
+    }
+  }
+  closedir(d);
+}
+
+static Table_t Three, Eleven;
+
+int main(int argc, char **argv){
+  int i;
+  if(argc > 1){
+    for(i=1; i<argc; i++){
+      validate(argv[i]);
+    }
+    printf("%u tables, %s, %ld errors\n", (unsigned)Tables, Bad ? "FAIL" : "PASS", Bad);
+    return Bad != 0;
+  }
+  walk("..");
+  check(Tables >= 3, "tables found", Tables);
+  if(table(&Three, "../Lab2_FSM/Lab2_FSMmain-3states.c") == 0){
+    three(&Three);
+    wander(&Three, 1);
+  }
+  if(table(&Eleven, "../Lab2_FSM/Lab2-FSMmain-11states.c") == 0){
+    eleven(&Eleven);
+    wander(&Eleven, 2);
+  }
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,24 @@
+// msp.c
+// Host memory behind tools/host/msp.h
+
+#include <stdint.h>
+#include <string.h>
+#include "msp.h"
+
+DIO_PORT_Interruptable_Type Host_P[11];
+volatile uint8_t Host_Band[sizeof(DIO_PORT_Interruptable_Type)*11][8];
+Timer_A_Type Host_TIMER_A[4];
+Timer32_Type Host_TIMER32[2];
+ADC14_Type Host_ADC14;
+EUSCI_A_Type Host_EUSCI_A[4];
+NVIC_Type Host_NVIC;
+SysTick_Type Host_SysTick;
+SCB_Type Host_SCB;
+DWT_Type Host_DWT;
+CoreDebug_Type Host_CoreDebug;
+
+uint32_t Host_Read32(const void *p){
+  uint32_t x;
+  memcpy(&x, p, 4);
+  return x;
+}
@@ -0,0 +1,109 @@
+// msp.h
+// Host stand-in for the TI msp.h, for the harnesses in tools/
+//
+// Put this directory first on the include path, before ../inc, and
+// link host/msp.c.  The peripherals are plain structures in host
+// memory, so a harness sets the input registers, runs the driver and
+// its ISRs by calling them, and reads back what the driver wrote.
+// Only the registers and bit names the harnessed modules use are here.
+// The core intrinsics are the portable C equivalents.
+
+#ifndef HOST_MSP_H
+#define HOST_MSP_H
+
+#include <stdint.h>
+
+typedef struct { volatile uint8_t IN, OUT, DIR, REN, DS, SEL0, SEL1, IES, IE, IFG; } DIO_PORT_Interruptable_Type;
+extern DIO_PORT_Interruptable_Type Host_P[11];   // P1 to P10, then PJ
+#define P1  (&Host_P[0])
+#define P2  (&Host_P[1])
+#define P3  (&Host_P[2])
+#define P4  (&Host_P[3])
+#define P5  (&Host_P[4])
+#define P6  (&Host_P[5])
+#define P7  (&Host_P[6])
+#define P8  (&Host_P[7])
+#define P9  (&Host_P[8])
+#define P10 (&Host_P[9])
+#define PJ  (&Host_P[10])
+
+// There is no bit-band region on the host.  BITS_BAND(&Pn->OUT, b) is
+// one byte per port register bit instead, which the driver writes and
+// the harness reads back with the same macro; it does not change the
+// register itself.  Only the ports have bytes.
+extern volatile uint8_t Host_Band[sizeof(DIO_PORT_Interruptable_Type)*11][8];
+#define BITS_BAND(reg, b) Host_Band[(volatile uint8_t *)(reg) - (volatile uint8_t *)Host_P][b]
+
+typedef struct { volatile uint16_t CTL, CCTL[7], R, CCR[7], EX0, IV; } Timer_A_Type;
+extern Timer_A_Type Host_TIMER_A[4];
+#define TIMER_A0 (&Host_TIMER_A[0])
+#define TIMER_A1 (&Host_TIMER_A[1])
+#define TIMER_A2 (&Host_TIMER_A[2])
+#define TIMER_A3 (&Host_TIMER_A[3])
+#define TIMER_A_CCTLN_CCIFG 0x0001
+#define TIMER_A_CCTLN_CCIE  0x0010
+
+typedef struct { volatile uint32_t LOAD, VALUE, CONTROL, INTCLR, RIS, MIS, BGLOAD; } Timer32_Type;
+extern Timer32_Type Host_TIMER32[2];
+#define TIMER32_1 (&Host_TIMER32[0])
+#define TIMER32_2 (&Host_TIMER32[1])
+
+typedef struct { volatile uint32_t CTL0, CTL1, LO0, HI0, LO1, HI1, MCTL[32], MEM[32];
+                 volatile uint32_t IER0, IER1, IFGR0, IFGR1, CLRIFGR0, CLRIFGR1, IV; } ADC14_Type;
+extern ADC14_Type Host_ADC14;
+#define ADC14 (&Host_ADC14)
+#define ADC14_CTL0_ENC         0x00000002
+#define ADC14_CTL0_SC          0x00000001
+#define ADC14_CTL0_BUSY        0x00010000
+#define ADC14_MCTLN_WINC       0x00004000
+#define ADC14_MCTLN_WINCTH     0x00008000
+#define ADC14_IER1_INIE        0x00000002
+#define ADC14_IER1_LOIE        0x00000004
+#define ADC14_IER1_HIIE        0x00000008
+#define ADC14_IFGR1_INIFG      0x00000002
+#define ADC14_IFGR1_LOIFG      0x00000004
+#define ADC14_IFGR1_HIIFG      0x00000008
+#define ADC14_CLRIFGR1_CLRINIFG 0x00000002
+#define ADC14_CLRIFGR1_CLRLOIFG 0x00000004
+#define ADC14_CLRIFGR1_CLRHIIFG 0x00000008
+
+typedef struct { volatile uint16_t CTLW0, CTLW1, BRW, MCTLW, STATW, RXBUF, TXBUF, ABCTL, IRCTL, IE, IFG, IV; } EUSCI_A_Type;
+extern EUSCI_A_Type Host_EUSCI_A[4];
+#define EUSCI_A0 (&Host_EUSCI_A[0])
+#define EUSCI_A1 (&Host_EUSCI_A[1])
+#define EUSCI_A2 (&Host_EUSCI_A[2])
+#define EUSCI_A3 (&Host_EUSCI_A[3])
+#define EUSCI_A_IFG_RXIFG 0x0001
+#define EUSCI_A_IFG_TXIFG 0x0002
+#define EUSCI_A_IE_RXIE   0x0001
+#define EUSCI_A_IE_TXIE   0x0002
+
+typedef struct { volatile uint32_t ISER[8], ICER[8], ISPR[8], ICPR[8], IABR[8], IP[60]; } NVIC_Type;  // IP as 32-bit words, as the drivers use it
+extern NVIC_Type Host_NVIC;
+#define NVIC (&Host_NVIC)
+
+typedef struct { volatile uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+extern SysTick_Type Host_SysTick;
+#define SysTick (&Host_SysTick)
+
+typedef struct { volatile uint8_t SHP[12]; volatile uint32_t CPACR; } SCB_Type;
+extern SCB_Type Host_SCB;
+#define SCB (&Host_SCB)
+
+typedef struct { volatile uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DHCSR, DCRSR, DCRDR, DEMCR; } CoreDebug_Type;
+extern DWT_Type Host_DWT;
+extern CoreDebug_Type Host_CoreDebug;
+#define DWT (&Host_DWT)
+#define CoreDebug (&Host_CoreDebug)
+#define DWT_CTRL_CYCCNTENA_Msk      0x00000001
+#define CoreDebug_DEMCR_TRCENA_Msk  0x01000000
+
+#define __REV(x)  __builtin_bswap32(x)
+#define __DMB()   __sync_synchronize()
+#define __UNALIGNED_UINT32_READ(p) Host_Read32(p)
+#define __LDREXW(p)    (*(p))           // one thread, the store always succeeds
+#define __STREXW(v, p) (*(p) = (v), 0)
+uint32_t Host_Read32(const void *p);
+
+#endif /* HOST_MSP_H */
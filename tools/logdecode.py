@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# logdecode.py
+# Decode the binary log records written by inc/Log.c
+#
+#   python logdecode.py Project.out capture.bin     decode a capture file
+#   python logdecode.py Project.out COM5            decode live from a serial port (needs pyserial)
+#   python logdecode.py Project.out                 list the format strings and their IDs
+#
+# The format strings are read from section .logstr of the .out file,
+# so the decoder must use the .out that is programmed into the robot.
+
+import re
+import struct
+import sys
+
+LEVELS = ["DEBUG", "INFO", "WARN", "ERROR"]
+VALID = 0x00800000
+SYNC = 0xA5
+
+
+def read_dictionary(path):
+    """Map ID (address & 0xFFFF) to format string from an ELF32 file."""
+    data = open(path, "rb").read()
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        sys.exit(path + ": not a little endian ELF32 file")
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+    sections = []
+    for i in range(shnum):
+        name, _, _, addr, offset, size = struct.unpack_from("<IIIIII", data, shoff + i*shentsize)
+        sections.append((name, addr, offset, size))
+    strtab = sections[shstrndx]
+    names = data[strtab[2]:strtab[2] + strtab[3]]
+    formats = {}
+    for name, addr, offset, size in sections:
+        if names[name:names.index(b"\0", name)] != b".logstr":
+            continue
+        raw = data[offset:offset + size]
+        i = 0
+        while i < size:
+            if raw[i] == 0:
+                i += 1              # padding between strings
+                continue
+            end = raw.index(b"\0", i)
+            formats[(addr + i) & 0xFFFF] = raw[i:end].decode("latin-1")
+            i = end + 1
+    return formats
+
+
+CONVERSION = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?([diuxXc%])")
+
+
+def format_record(fmt, args):
+    out = []
+    pos = 0
+    k = 0
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        if m.group(1) == "%":
+            out.append("%")
+            continue
+        v = args[k] if k < len(args) else 0
+        k += 1
+        if m.group(1) in "di":
+            v = v - (1 << 32) if v & 0x80000000 else v
+            out.append((m.group(0)[:-1] + "d") % v)
+        elif m.group(1) == "c":
+            out.append(chr(v & 0xFF))
+        else:
+            out.append((m.group(0).replace("u", "d")) % v)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(formats, stream):
+    """Yield lines of text from an iterator of byte chunks."""
+    buf = b""
+    dropped = 0
+    for chunk in stream:
+        buf += chunk
+        while True:
+            start = buf.find(bytes([SYNC]))
+            if start < 0:
+                buf = b""
+                break
+            buf = buf[start:]
+            if len(buf) < 9:
+                break
+            head, = struct.unpack_from("<I", buf, 1)
+            n = (head >> 16) & 7
+            if not (head & VALID) or n > 4 or (head & 0xFFFF) not in formats:
+                buf = buf[1:]       # not a record, resync
+                continue
+            if len(buf) < 9 + 4*n:
+                break
+            stamp, = struct.unpack_from("<I", buf, 5)
+            args = struct.unpack_from("<%dI" % n, buf, 9)
+            buf = buf[9 + 4*n:]
+            d = head >> 24
+            if d != dropped:
+                yield "%10u  ----- %d records dropped" % (stamp, (d - dropped) & 0xFF)
+                dropped = d
+            level = LEVELS[(head >> 19) & 3]
+            yield "%10u  %-5s %s" % (stamp, level, format_record(formats[head & 0xFFFF], args))
+
+
+def chunks_from_file(path):
+    with open(path, "rb") as f:
+        while True:
+            b = f.read(4096)
+            if not b:
+                return
+            yield b
+
+
+def chunks_from_port(name):
+    import serial
+    port = serial.Serial(name, 115200, timeout=0.1)
+    while True:
+        b = port.read(256)
+        if b:
+            yield b
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__ or "usage: logdecode.py Project.out [capture.bin | port]")
+    formats = read_dictionary(sys.argv[1])
+    if len(sys.argv) == 2:
+        for k in sorted(formats):
+            print("0x%04X  %s" % (k, formats[k]))
+        return
+    source = sys.argv[2]
+    try:
+        stream = chunks_from_file(source)
+        first = next(stream)
+        stream = (c for s in ([first], stream) for c in s)
+    except (FileNotFoundError, IsADirectoryError, PermissionError):
+        stream = chunks_from_port(source)
+    except StopIteration:
+        return
+    for line in decode(formats, stream):
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
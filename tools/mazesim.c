@@ -0,0 +1,310 @@
+// mazesim.c
+// Host simulation of inc/Maze.c on generated mazes
+//
+//   gcc -O2 -I../inc -o mazesim mazesim.c ../inc/Maze.c
+//   ./mazesim                  4 x 4, 8 x 8 and 16 x 16, 50 mazes each
+//   ./mazesim 100              mazes per size
+//
+// Each maze is a random spanning tree of the cells (every cell reaches
+// every other one exactly one way), half of them with one wall in ten
+// knocked out on top so there are loops.  The robot starts in the
+// south-west corner facing north and drives to the center cell, seeing
+// the walls left, ahead and right of each cell it is in with the IR
+// sensors (60 mm for a wall, 400 mm for an opening, 150 mm threshold),
+// Maze_Solve running 16 cells per call as in the MAZE lab.
+//
+// For each size it prints, averaged over the mazes and worst case:
+//   explored  cells visited, out of rows*cols
+//   moves     Maze_Advance calls to reach the goal, against the shortest
+//             path on the real maze
+//   run       the speed run planned as PlanRun in the MAZE lab does,
+//             down the final distances through walls seen open, against
+//             the shortest path of the same mazes, and
+//             in how many mazes that finds no path (unseen walls are
+//             open to the flood fill but not to the plan)
+//   cells     flood fill cells per step (the work Maze_Solve's budget
+//             counts), calls per step, host ns per step
+// It fails if a maze is not solved, the robot drives through a wall,
+// a planned speed run crosses a real wall or beats the shortest path,
+// or Maze_Advance lets the robot leave the grid.
+// The left-hand rule is run on the loop-free mazes for comparison.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Maze.h"
+
+#define BUDGET 16         // SOLVE_BUDGET in the MAZE lab
+#define WALL_MM 150       // WALL_MM in the MAZE lab
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+// ---- the real maze ----
+static uint32_t Rows, Cols;
+static uint8_t North[MAZE_MAX+1][MAZE_MAX];   // north wall of (r,c), south of (r-1,c)
+static uint8_t West[MAZE_MAX][MAZE_MAX+1];    // west wall of (r,c), east of (r,c-1)
+static const int DRow[4] = {-1, 0, 1, 0};     // N, E, S, W
+static const int DCol[4] = { 0, 1, 0,-1};
+
+static uint32_t wall(uint32_t r, uint32_t c, uint32_t d){
+  switch(d){
+    case MAZE_NORTH: return North[r][c];
+    case MAZE_SOUTH: return North[r+1][c];
+    case MAZE_WEST:  return West[r][c];
+    default:         return West[r][c+1];
+  }
+}
+
+static void knock(uint32_t r, uint32_t c, uint32_t d){
+  switch(d){
+    case MAZE_NORTH: North[r][c] = 0; break;
+    case MAZE_SOUTH: North[r+1][c] = 0; break;
+    case MAZE_WEST:  West[r][c] = 0; break;
+    default:         West[r][c+1] = 0; break;
+  }
+}
+
+// depth-first spanning tree, loops knocks out one inner wall in ten more
+static void generate(uint32_t rows, uint32_t cols, int loops){
+  static uint8_t seen[MAZE_MAX][MAZE_MAX], stack[MAZE_MAX*MAZE_MAX];
+  uint32_t r, c, d, n, top, cell, options[4];
+  Rows = rows; Cols = cols;
+  for(r=0; r<=MAZE_MAX; r++){
+    for(c=0; c<=MAZE_MAX; c++){
+      if(c < MAZE_MAX) North[r][c] = 1;
+      if(r < MAZE_MAX) West[r][c] = 1;
+      if((r < MAZE_MAX) && (c < MAZE_MAX)) seen[r][c] = 0;
+    }
+  }
+  seen[0][0] = 1;
+  stack[0] = 0;
+  top = 1;
+  while(top){
+    cell = stack[top-1];
+    r = cell/cols; c = cell%cols;
+    n = 0;
+    for(d=0; d<4; d++){
+      int rr = (int)r+DRow[d], cc = (int)c+DCol[d];
+      if((rr >= 0) && (rr < (int)rows) && (cc >= 0) && (cc < (int)cols) && !seen[rr][cc]){
+        options[n++] = d;
+      }
+    }
+    if(n == 0){
+      top--;
+      continue;
+    }
+    d = options[rand()%n];
+    knock(r, c, d);
+    r = r+DRow[d]; c = c+DCol[d];
+    seen[r][c] = 1;
+    stack[top++] = r*cols+c;
+  }
+  if(loops){
+    for(r=0; r<rows; r++){
+      for(c=0; c<cols; c++){
+        if((r > 0) && (rand()%10 == 0)) North[r][c] = 0;
+        if((c > 0) && (rand()%10 == 0)) West[r][c] = 0;
+      }
+    }
+  }
+}
+
+// breadth-first distance from (r,c) to the goal on the real walls
+static uint32_t shortest(uint32_t r, uint32_t c, uint32_t gr, uint32_t gc){
+  static uint16_t dist[MAZE_MAX*MAZE_MAX], queue[MAZE_MAX*MAZE_MAX];
+  uint32_t head = 0, tail = 1, i, d, cell, n;
+  for(i=0; i<Rows*Cols; i++){
+    dist[i] = 0xFFFF;
+  }
+  dist[r*Cols+c] = 0;
+  queue[0] = r*Cols+c;
+  while(head < tail){
+    cell = queue[head++];
+    r = cell/Cols; c = cell%Cols;
+    if((r == gr) && (c == gc)){
+      return dist[cell];
+    }
+    for(d=0; d<4; d++){
+      if(wall(r, c, d) == 0){
+        n = (r+DRow[d])*Cols+(c+DCol[d]);
+        if(dist[n] == 0xFFFF){
+          dist[n] = dist[cell]+1;
+          queue[tail++] = n;
+        }
+      }
+    }
+  }
+  return MAZE_UNREACHED;
+}
+
+// cells of the speed run from (r,c) heading h, MAZE_UNREACHED if the
+// known map has no way down, PlanRun of the MAZE lab
+static uint32_t plan(uint32_t r, uint32_t c, uint32_t h){
+  uint32_t d, i, dir, rr = r, cc = c, n = 0;
+  while((d = Maze_Distance(r, c)) != 0){
+    for(i=0; i<4; i++){
+      dir = (h+i)&3;                // straight on first
+      rr = r+DRow[dir];
+      cc = c+DCol[dir];
+      if((rr < Rows) && (cc < Cols) && (Maze_Wall(r, c, dir) == 0) && (Maze_Distance(rr, cc) < d)){
+        break;
+      }
+    }
+    if(i == 4){
+      return MAZE_UNREACHED;
+    }
+    check(wall(r, c, dir) == 0, "speed run through a wall", n);
+    r = rr; c = cc; h = dir;
+    n++;
+  }
+  return n;
+}
+
+// ---- one maze ----
+typedef struct{
+  uint32_t Mazes, Explored, Moves, Shortest, Run, RunShortest, Runs, NoRun, Cells, Calls, Steps;
+  uint32_t MaxExplored, MaxMoves, MaxCells;
+  double Ns;
+} Total_t;
+
+static int32_t ir(uint32_t r, uint32_t c, uint32_t d){
+  return wall(r, c, d) ? 60 : 400;
+}
+
+static void solve(Total_t *t, uint32_t solver){
+  uint32_t row = Rows-1, col = 0, heading, move = MAZE_WAIT, steps, cells, calls, gr = Rows/2, gc = Cols/2;
+  uint32_t limit = 4*Rows*Cols, best, run, d;
+  MazeStats_t stats;
+  struct timespec t0, t1;
+  check(Maze_Init(Rows, Cols, row, col, MAZE_NORTH, gr, gc, solver) == 0, "Maze_Init", Rows);
+  best = shortest(row, col, gr, gc);
+  for(steps=0; steps<limit; steps++){
+    Maze_Pose(&row, &col, &heading);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    Maze_SenseIR(ir(row, col, (heading+3)&3), ir(row, col, heading), ir(row, col, (heading+1)&3), WALL_MM);
+    calls = 0;
+    cells = 0;
+    if((solver == MAZE_FLOODFILL) && (Maze_NextMove() == MAZE_WAIT)){   // the map changed
+      do{
+        calls++;
+      }while(Maze_Solve(BUDGET) == 0);
+      Maze_GetStats(&stats);
+      cells = stats.SolveCells;
+    }
+    move = Maze_NextMove();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t->Ns += (t1.tv_sec-t0.tv_sec)*1e9 + (t1.tv_nsec-t0.tv_nsec);
+    t->Cells += cells;
+    t->Calls += calls;
+    t->Steps++;
+    if(cells > t->MaxCells) t->MaxCells = cells;
+    check(calls*BUDGET >= cells, "over budget", cells);
+    if(move >= MAZE_STOP){
+      break;
+    }
+    switch(move){
+      case MAZE_RIGHT: d = (heading+1)&3; break;
+      case MAZE_LEFT:  d = (heading+3)&3; break;
+      case MAZE_UTURN: d = (heading+2)&3; break;
+      default:         d = heading; break;
+    }
+    check(wall(row, col, d) == 0, "drove through a wall", steps);
+    check(Maze_Advance(move) == 0, "Maze_Advance", steps);
+  }
+  check(move == MAZE_STOP, "not solved", steps);
+  Maze_GetStats(&stats);
+  t->Mazes++;
+  t->Explored += stats.Explored;
+  t->Moves += stats.Moves;
+  t->Shortest += best;
+  if(stats.Explored > t->MaxExplored) t->MaxExplored = stats.Explored;
+  if(stats.Moves > t->MaxMoves) t->MaxMoves = stats.Moves;
+  check(stats.Moves >= best, "shorter than the shortest path", stats.Moves);
+  if(solver == MAZE_FLOODFILL){
+    while(Maze_Solve(BUDGET) == 0){}
+    run = plan(Rows-1, 0, MAZE_NORTH);
+    if(run == MAZE_UNREACHED){
+      t->NoRun++;
+    }else{
+      check(run >= best, "speed run shorter than the maze allows", run);
+      t->Run += run;
+      t->RunShortest += best;
+      t->Runs++;
+    }
+  }
+}
+
+static void report(const char *name, const Total_t *t){
+  printf("%-22s explored %5.1f (%3u)  moves %5.1f (%3u)  shortest %5.1f  run %5.1f of %5.1f, none %2u  "
+         "cells/step %5.1f (%3u)  calls/step %4.2f  %6.0f ns/step\n", name,
+         (double)t->Explored/t->Mazes, (unsigned)t->MaxExplored,
+         (double)t->Moves/t->Mazes, (unsigned)t->MaxMoves,
+         (double)t->Shortest/t->Mazes, t->Runs ? (double)t->Run/t->Runs : 0.0,
+         t->Runs ? (double)t->RunShortest/t->Runs : 0.0, (unsigned)t->NoRun,
+         (double)t->Cells/t->Steps, (unsigned)t->MaxCells,
+         (double)t->Calls/t->Steps, t->Ns/t->Steps);
+}
+
+// ---- Maze_Advance on the edges ----
+static void edges(void){
+  static const uint32_t Corner[4][3] = {  // row, col, heading that leaves the grid
+    {0, 0, MAZE_NORTH}, {0, 3, MAZE_EAST}, {3, 3, MAZE_SOUTH}, {3, 0, MAZE_WEST}
+  };
+  uint32_t i, row, col, heading;
+  MazeStats_t stats;
+  for(i=0; i<4; i++){
+    Maze_Init(4, 4, Corner[i][0], Corner[i][1], Corner[i][2], 2, 2, MAZE_FLOODFILL);
+    check(Maze_Advance(MAZE_FORWARD) == 1, "left the grid", i);
+    check(Maze_Advance(MAZE_UTURN) == 0, "back in", i);
+    Maze_Pose(&row, &col, &heading);
+    check((row == Corner[i][0]+DRow[(Corner[i][2]+2)&3]) && (col == Corner[i][1]+DCol[(Corner[i][2]+2)&3]),
+          "pose", i);
+    Maze_Init(4, 4, Corner[i][0], Corner[i][1], (Corner[i][2]+1)&3, 2, 2, MAZE_FLOODFILL);
+    check(Maze_Advance(MAZE_LEFT) == 1, "turned off the grid", i);
+    Maze_Pose(&row, &col, &heading);
+    check((row == Corner[i][0]) && (col == Corner[i][1]) && (heading == Corner[i][2]), "turn kept", i);
+    Maze_GetStats(&stats);
+    check((stats.Moves == 0) && (stats.Explored == 1), "stats", i);
+  }
+  check(Maze_Advance(MAZE_STOP) == 1, "not a move", 0);
+  Maze_Init(0, 4, 0, 0, MAZE_NORTH, 0, 0, MAZE_FLOODFILL);
+  check(Maze_Advance(MAZE_FORWARD) == 1, "no map", 0);
+}
+
+int main(int argc, char **argv){
+  static const uint32_t Size[3] = {4, 8, 16};
+  uint32_t mazes = (argc > 1) ? (uint32_t)atoi(argv[1]) : 50, i, n, loops;
+  char name[40];
+  edges();
+  srand(1);
+  for(i=0; i<3; i++){
+    for(loops=0; loops<2; loops++){
+      Total_t flood = {0}, left = {0};
+      for(n=0; n<mazes; n++){
+        generate(Size[i], Size[i], loops);
+        solve(&flood, MAZE_FLOODFILL);
+        if(!loops){
+          solve(&left, MAZE_LEFTHAND);
+        }
+      }
+      snprintf(name, sizeof(name), "%ux%u %s flood", (unsigned)Size[i], (unsigned)Size[i], loops ? "loops" : "tree");
+      report(name, &flood);
+      if(!loops){
+        snprintf(name, sizeof(name), "%ux%u tree left hand", (unsigned)Size[i], (unsigned)Size[i]);
+        report(name, &left);
+      }
+    }
+  }
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,289 @@
+// motortest.c
+// Host model of the inc/Motor.c output stage, period by period and count by count
+//
+//   gcc -O2 -Ihost -I../inc -o motortest motortest.c ../inc/Motor.c ../inc/PWM.c host/msp.c
+//   ./motortest
+//
+// Motor.c and PWM.c run against host/msp.h.  TA0_0_IRQHandler is called
+// once per 10 ms PWM period, the way CCR0 interrupts at the top, and
+// random Motor_Forward/Backward/Left/Right/Duty/Stop commands come in
+// between, under 20 slew and dead time settings.  After every period:
+//   the duty in CCR3/CCR4 is 0 to MOTOR_MAX,
+//   it moved by no more than the slew limit,
+//   a direction pin (P5.4/P5.5, through BITS_BAND) changed only in a
+//     period with 0 duty, after at least the dead time at 0 (1 minimum),
+//   CCR3/CCR4 changed only in the ISR, or went to 0 on a stop or when
+//     a command woke the drivers,
+// and at the end of each setting the last command is reached exactly.
+// Before any Motor_SetSlew the duty is not limited, a command from
+// stopped is reached two periods later.
+// Saturation, the gain, a bump putting the drivers to sleep, the
+// interrupt setup and the Motor_Periods count are checked directly.
+//
+// The count model runs the TA0 up/down counter (CCR0 = 7500) one count
+// at a time, with the ISR writing the compare registers a latency after
+// the top.  Each output toggles when the counter passes its compare
+// value and resets at the top, as output mode 2 does, so a value
+// written after the counter went below it loses the falling half of the
+// pulse.  Every pulse must be 2*CCR counts wide for latencies under
+// 7500-MOTOR_MAX counts (8 counts of 667 ns, 5.3 us); the longer
+// latencies show the pulses MOTOR_MAX leaves room for.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "Motor.h"
+#include "PWM.h"
+#include "Tachometer.h"
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+// ---- what Motor.c calls ----
+long StartCritical(void){
+  return 0;
+}
+void EndCritical(long sr){
+  (void)sr;
+}
+void DisableInterrupts(void){
+}
+void EnableInterrupts(void){
+}
+// the distance moves are not run here
+int Tachometer_LeftSteps, Tachometer_RightSteps;
+void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
+                    uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps){
+  (void)leftTach; (void)leftDir; (void)leftSteps; (void)rightTach; (void)rightDir; (void)rightSteps;
+  abort();
+}
+
+void TA0_0_IRQHandler(void);
+
+#define DIR_LEFT  BITS_BAND(&P5->OUT, 4)
+#define DIR_RIGHT BITS_BAND(&P5->OUT, 5)
+
+
+// ---- period model ----
+static long Slew, Dead, Periods;
+static int32_t PrevL, PrevR;
+static uint8_t PinL, PinR;
+static long ZeroL, ZeroR;
+
+static void period(void){
+  int32_t l, r;
+  TA0_0_IRQHandler();
+  Periods++;
+  l = TIMER_A0->CCR[3];
+  r = TIMER_A0->CCR[4];
+  check(l <= MOTOR_MAX && r <= MOTOR_MAX, "range", Periods);
+  check(abs(l - PrevL) <= Slew && abs(r - PrevR) <= Slew, "slew", Periods);
+  ZeroL = (l == 0) ? ZeroL + 1 : 0;
+  ZeroR = (r == 0) ? ZeroR + 1 : 0;
+  if(DIR_LEFT != PinL){
+    check(l == 0 && ZeroL >= (Dead ? Dead : 1), "left reversed early", Periods);
+  }
+  if(DIR_RIGHT != PinR){
+    check(r == 0 && ZeroR >= (Dead ? Dead : 1), "right reversed early", Periods);
+  }
+  PrevL = l;
+  PrevR = r;
+  PinL = DIR_LEFT;
+  PinR = DIR_RIGHT;
+}
+
+// Motor_Init and Motor_SetSlew, and the model starts from stopped.
+// Motor_Init clears P5.4 and P5.5 in P5->OUT, which on the host does
+// not reach the BITS_BAND bytes.
+static void init(uint16_t slew, uint16_t dead){
+  Motor_Init();
+  Motor_SetSlew(slew, dead);
+  DIR_LEFT = 0;
+  DIR_RIGHT = 0;
+  Slew = slew ? slew : 100000;
+  Dead = dead;
+  PrevL = PrevR = 0;
+  PinL = PinR = 0;
+  ZeroL = ZeroR = 1000;
+}
+
+static int32_t signedLeft(void){
+  return DIR_LEFT ? -(int32_t)TIMER_A0->CCR[3] : TIMER_A0->CCR[3];
+}
+static int32_t signedRight(void){
+  return DIR_RIGHT ? -(int32_t)TIMER_A0->CCR[4] : TIMER_A0->CCR[4];
+}
+
+// one random command, outside the ISR
+static void command(void){
+  int32_t l = rand()%20000 - 10000, r = rand()%20000 - 10000;
+  uint16_t ccr3 = TIMER_A0->CCR[3], ccr4 = TIMER_A0->CCR[4];
+  uint32_t awake = ((P3->OUT&0xC0) == 0xC0);
+  switch(rand()%6){
+    case 0: Motor_Forward(abs(l), abs(r)); break;
+    case 1: Motor_Backward(abs(l), abs(r)); break;
+    case 2: Motor_Left(abs(l), abs(r)); break;
+    case 3: Motor_Right(abs(l), abs(r)); break;
+    case 4: Motor_Duty(l, r); break;
+    default:
+      if(rand()%4 == 0){
+        Motor_Stop();
+        check(TIMER_A0->CCR[3] == 0 && TIMER_A0->CCR[4] == 0 && (P3->OUT&0xC0) == 0, "stop", Periods);
+        PrevL = PrevR = 0;
+        return;
+      }
+      Motor_Duty(l, r);
+      break;
+  }
+  if(awake){
+    check(TIMER_A0->CCR[3] == ccr3 && TIMER_A0->CCR[4] == ccr4, "written outside the ISR", Periods);
+  }else{
+    check(TIMER_A0->CCR[3] == 0 && TIMER_A0->CCR[4] == 0, "wake from 0", Periods);
+    PrevL = PrevR = 0;
+  }
+  check((P3->OUT&0xC0) == 0xC0, "awake", Periods);
+}
+
+static void periods(void){
+  static const long Slews[] = {375, 1, 100, MOTOR_MAX, 0}, Deads[] = {2, 0, 1, 5};
+  uint32_t s, d, k, n;
+  for(s=0; s<5; s++){
+    for(d=0; d<4; d++){
+      init(Slews[s], Deads[d]);
+      srand(s*7 + d);
+      for(k=0; k<2000; k++){
+        command();
+        for(n=rand()%80; n; n--){
+          period();
+        }
+      }
+      Motor_Duty(-9000, 3000);
+      for(n=0; n<20000; n++){
+        period();
+      }
+      check(signedLeft() == -MOTOR_MAX && signedRight() == 3000, "settle", s*4 + d);
+    }
+  }
+}
+
+// Motor_Init alone, no slew limit and no dead time
+static void defaults(void){
+  Motor_Init();
+  DIR_LEFT = 0;
+  DIR_RIGHT = 0;
+  Motor_Duty(MOTOR_MAX, -MOTOR_MAX);
+  TA0_0_IRQHandler();
+  TA0_0_IRQHandler();
+  check(signedLeft() == MOTOR_MAX && signedRight() == -MOTOR_MAX, "default slew", signedLeft());
+  Motor_Duty(-4000, 4000);
+  TA0_0_IRQHandler();
+  TA0_0_IRQHandler();
+  TA0_0_IRQHandler();
+  check(signedLeft() == -4000 && signedRight() == 4000, "default dead time", signedLeft());
+  Motor_Stop();
+}
+
+static void direct(void){
+  uint32_t n;
+  init(0, 0);
+  check((TIMER_A0->CCTL[0]&TIMER_A_CCTLN_CCIE) && TIMER_A0->CCR[0] == 7500, "TA0 CCR0 interrupt", TIMER_A0->CCTL[0]);
+  check((NVIC->IP[2]&0xFF) == 0x20 && (NVIC->ISER[0]&0x100), "NVIC", NVIC->IP[2]);
+  n = Motor_Periods();
+  Motor_Duty(100000, -100000);                // saturates, not dropped
+  period();
+  period();
+  check(Motor_Periods() == n + 2, "Motor_Periods", Motor_Periods() - n);
+  check(signedLeft() == MOTOR_MAX && signedRight() == -MOTOR_MAX, "saturate", signedLeft());
+  Motor_SetGain(MOTOR_GAIN_ONE/2);             // applies to the running command
+  Motor_Duty(4000, -2000);
+  period();
+  period();
+  check(signedLeft() == 2000 && signedRight() == -1000, "gain", signedLeft());
+  Motor_SetGain(10*MOTOR_GAIN_ONE);            // limited to 2.0, then saturates
+  period();
+  period();
+  check(signedLeft() == 7492 && signedRight() == -4000, "gain limit", signedLeft());
+  Motor_SetGain(MOTOR_GAIN_ONE);
+  init(MOTOR_SLEW, MOTOR_DEADTIME);
+  P3->OUT &= ~0xC0;                            // a bump puts the drivers to sleep
+  Motor_Forward(3000, 3000);
+  check(TIMER_A0->CCR[3] == 0 && TIMER_A0->CCR[4] == 0, "bump ramp", TIMER_A0->CCR[3]);
+  for(n=0; n<20; n++){
+    period();
+  }
+  check(signedLeft() == 3000 && signedRight() == 3000, "bump resume", signedLeft());
+  PWM_Duty3(9000);
+  check(TIMER_A0->CCR[3] == 7499, "PWM_Duty3", TIMER_A0->CCR[3]);
+}
+
+// ---- count model ----
+// returns the pulses that were not 2*CCR counts wide
+static long counts(uint32_t latency, uint32_t periods){
+  uint32_t p, out[2], high[2], i;
+  int32_t c, dir;
+  uint16_t ccr[2];
+  long wrong = 0;
+  init(MOTOR_SLEW, MOTOR_DEADTIME);
+  srand(latency);
+  for(p=0; p<periods; p++){
+    if(p%50 == 0){
+      Motor_Duty(rand()%16000 - 8000, rand()%16000 - 8000);
+    }
+    out[0] = out[1] = 0;                      // reset at the top
+    high[0] = high[1] = 0;
+    c = 7500;
+    dir = -1;
+    ccr[0] = TIMER_A0->CCR[3];                // what is latched from the last period
+    ccr[1] = TIMER_A0->CCR[4];
+    while(!((dir > 0) && (c == 7500))){
+      if((dir < 0) && (c == 7500 - (int32_t)latency)){
+        TA0_0_IRQHandler();                   // writes CCR3/CCR4 a latency after the top
+        ccr[0] = TIMER_A0->CCR[3];
+        ccr[1] = TIMER_A0->CCR[4];
+      }
+      c += dir;
+      if(c == 0){
+        dir = 1;
+      }
+      for(i=0; i<2; i++){
+        if(ccr[i] && (c == ccr[i])){
+          out[i] ^= 1;                        // toggle at CCRn
+        }
+        high[i] += out[i];
+      }
+    }
+    for(i=0; i<2; i++){
+      if(high[i] != 2u*ccr[i]){
+        wrong++;
+      }
+    }
+  }
+  return wrong;
+}
+
+int main(void){
+  uint32_t latency;
+  long wrong;
+  defaults();
+  periods();
+  direct();
+  printf("%ld periods\n", Periods);
+  for(latency=0; latency<=16; latency+=(latency < 8) ? 1 : 4){
+    wrong = counts(latency, 4000);
+    printf("latency %2u counts: %ld of 8000 pulses wrong\n", (unsigned)latency, wrong);
+    if(latency < 7500 - MOTOR_MAX){
+      check(wrong == 0, "pulse", latency);
+    }
+  }
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,229 @@
+// npitest.c
+// Host test of inc/NPI.c, the frame parser and the MRDY/SRDY transport
+//
+//   gcc -O2 -Ihost -I../inc -o npitest npitest.c ../inc/NPI.c host/msp.c
+//   ./npitest                  seed 1
+//   ./npitest 7                another seed
+//
+// Parser: 200 frames of 0 to 140 payload bytes, with junk bytes between
+// them, every tenth with a bad FCS, fed in chunks of 1 to 17 bytes.
+// Each result and each stored byte is checked against the frame that
+// was sent; frames over NPI_FRAMESIZE keep only their first bytes.
+//
+// Transport: a model of the SNP plays the other side of the handshake
+// on the host registers.  It answers MRDY by dropping SRDY, takes the
+// frame from UART1_Write, and sends its own frames by dropping SRDY,
+// feeding the bytes to the UART1 receive task and raising SRDY, some of
+// them cut short.  The two sides run in random interleavings; every
+// frame must arrive once, in order, unless the test cut it short.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msp.h"
+#include "CortexM.h"
+#include "GPIO.h"
+#include "UART1.h"
+#include "NPI.h"
+
+#define FRAMES 200
+#define MAXLEN 140
+
+static int Bad;
+
+static void check(int ok, const char *what, int n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %d\n", what, n);
+    }
+  }
+}
+
+// build a frame of len payload bytes into buf, returns the size
+static uint32_t frame(uint8_t *buf, uint32_t len, int corrupt){
+  uint32_t i, n = 0;
+  uint8_t fcs = 0;
+  buf[n++] = 0xFE;
+  buf[n++] = len&0xFF;
+  buf[n++] = len>>8;
+  buf[n++] = 0x55;
+  buf[n++] = rand();
+  for(i=0; i<len; i++){
+    buf[n++] = rand();
+  }
+  for(i=1; i<n; i++){
+    fcs = fcs^buf[i];
+  }
+  buf[n++] = corrupt ? fcs^0x01 : fcs;
+  return n;
+}
+
+static void parser(void){
+  static uint8_t stream[FRAMES*(MAXLEN+10)], ref[FRAMES][MAXLEN+6];
+  static uint32_t size[FRAMES];
+  uint8_t buf[NPI_FRAMESIZE];
+  NPIParser_t p;
+  uint32_t n = 0, i = 0, f, j, chunk, got = 0;
+  int r, done = 0, err = 0, bad = 0;
+  for(f=0; f<FRAMES; f++){
+    for(j=rand()%3; j; j--){
+      stream[n++] = 0x11;           // junk, never SOF
+    }
+    size[f] = frame(ref[f], rand()%(MAXLEN+1), (f%10) == 3);
+    bad += (f%10) == 3;
+    memcpy(&stream[n], ref[f], size[f]);
+    n += size[f];
+  }
+  NPIParser_Init(&p, buf, sizeof(buf));
+  while(i < n){
+    for(chunk=1+rand()%17; chunk && (i < n); chunk--, i++){
+      r = NPIParser_Put(&p, stream[i]);
+      if(r == NPI_MORE){
+        continue;
+      }
+      check(got < FRAMES, "parser extra frame", got);
+      check(p.Count == size[got], "parser size", got);
+      check(memcmp(buf, ref[got], (size[got] < sizeof(buf)) ? size[got] : sizeof(buf)) == 0,
+            "parser data", got);
+      check((r == NPI_ERROR) == ((got%10) == 3), "parser result", got);
+      done += (r == NPI_DONE);
+      err += (r == NPI_ERROR);
+      got++;
+    }
+  }
+  check(NPIParser_Busy(&p) == 0, "parser busy at end", 0);
+  printf("parser: %u frames, %d good, %d bad FCS (%d sent), %u bytes\n",
+         got, done, err, bad, n);
+}
+
+// ---- transport ----
+void PORT2_IRQHandler(void);
+static void (*RxTask)(uint8_t);
+static const uint8_t *TxPt;
+static uint32_t TxN;
+static void (*TxDone)(void);
+
+void UART1_SetRxTask(void(*task)(uint8_t)){
+  RxTask = task;
+}
+uint32_t UART1_Write(const uint8_t *pt, uint32_t n, void(*done)(void)){
+  check(TxPt == 0, "UART1_Write while busy", 0);
+  TxPt = pt;
+  TxN = n;
+  TxDone = done;
+  return n;
+}
+long StartCritical(void){
+  return 0;
+}
+void EndCritical(long sr){
+  (void)sr;
+}
+
+static int mrdy(void){
+  return (P6->OUT&0x01) != 0;
+}
+static void srdy(int level){       // SNP drives SRDY, edge interrupt
+  if(level){
+    P2->IN |= 0x20;
+  }else{
+    P2->IN &= ~0x20;
+  }
+  PORT2_IRQHandler();
+}
+
+static void transport(void){
+  static uint8_t sent[FRAMES][MAXLEN+6], recv[FRAMES][MAXLEN+6], msg[MAXLEN+6];
+  static uint32_t sentSize[FRAMES], recvSize[FRAMES];
+  uint8_t buf[NPI_FRAMESIZE];
+  uint32_t lpSent = 0, lpGot = 0, snpGot = 0, snpSent = 0, cut = 0, steps, k, n, size;
+  uint32_t snp = 0, pos = 0, stop = 0;   // SNP: 0 idle, 1 sending, 2 receiving
+  NPIStats_t s;
+  P2->IN = 0x20;
+  P6->OUT = 0;
+  NPI_Init();
+  check(mrdy(), "MRDY low after init", 0);
+  for(steps=0; (steps < 2000000) && ((lpGot < FRAMES) || (snpGot < FRAMES)); steps++){
+    switch(rand()%4){
+      case 0:                       // LP: queue a frame
+        if(lpSent < FRAMES){
+          size = frame(msg, rand()%(NPI_FRAMESIZE-5), 0);
+          if(NPI_Send(msg) == 0){
+            memcpy(sent[lpSent], msg, size);
+            sentSize[lpSent++] = size;
+          }
+        }
+        break;
+      case 1:                       // LP: take a frame
+        n = NPI_Receive(buf, sizeof(buf));
+        if(n){
+          while(lpGot < snpSent && recvSize[lpGot] == 0){
+            lpGot++;                // cut short, never arrives
+          }
+          check(lpGot < snpSent, "LP got an extra frame", lpGot);
+          check(n == recvSize[lpGot] && memcmp(buf, recv[lpGot], n) == 0,
+                "LP got a wrong frame", lpGot);
+          lpGot++;
+        }
+        break;
+      case 2:                       // UART1: one write completes
+        if(TxPt){
+          check(snp == 2 && !mrdy(), "SNP not listening", snpGot);
+          check(TxN == sentSize[snpGot] && memcmp(TxPt, sent[snpGot], TxN) == 0,
+                "SNP got a wrong frame", snpGot);
+          TxPt = 0;
+          snpGot++;
+          TxDone();
+          check(mrdy(), "MRDY low after send", snpGot);
+          srdy(1);                  // SNP done
+          snp = 0;
+        }
+        break;
+      case 3:                       // SNP
+        if(snp == 0){
+          if(!mrdy()){
+            snp = 2;                // LP wants to send
+            srdy(0);
+          }else if((snpSent < FRAMES) && (rand()%2)){
+            recvSize[snpSent] = frame(recv[snpSent], rand()%(NPI_FRAMESIZE-5), 0);
+            stop = (rand()%8 == 0) ? 1+rand()%(recvSize[snpSent]-1) : recvSize[snpSent];
+            pos = 0;
+            snp = 1;
+            srdy(0);
+            check(!mrdy(), "MRDY high with SRDY low", snpSent);
+          }
+        }else if(snp == 1){         // a few bytes of the frame
+          for(k=1+rand()%9; k && (pos < stop); k--){
+            RxTask(recv[snpSent][pos++]);
+          }
+          if(pos == stop){
+            if(stop < recvSize[snpSent]){
+              recvSize[snpSent] = 0;
+              cut++;
+            }
+            snpSent++;
+            srdy(1);
+            snp = 0;
+          }
+        }
+        break;
+    }
+  }
+  NPI_GetStats(&s);
+  check(snpGot == FRAMES && lpGot >= FRAMES - 1, "transport stalled", (int)steps);
+  check(s.Truncated == cut, "truncated count", s.Truncated);
+  printf("transport: LP sent %u, SNP got %u, SNP sent %u (%u cut short), LP got %u, "
+         "stats rx %u tx %u fcs %u trunc %u overrun %u, %u steps\n",
+         lpSent, snpGot, snpSent, cut, lpGot, s.RxFrames, s.TxFrames, s.FcsErr,
+         s.Truncated, s.Overrun, steps);
+}
+
+int main(int argc, char **argv){
+  srand((argc > 1) ? atoi(argv[1]) : 1);
+  parser();
+  transport();
+  printf("%s, %d errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# paramcli.py
+# Read and write the tuning parameters of inc/Param.c over the LaunchPad serial port
+#
+#   python paramcli.py COM5 list                          names, values and ranges
+#   python paramcli.py COM5 get BaseSpeed
+#   python paramcli.py COM5 set BaseSpeed 1200 Tolerance 20   applied together
+#   python paramcli.py COM5 save                          keep the values in flash
+#   python paramcli.py COM5 defaults
+#   python paramcli.py COM5 sweep BaseSpeed 800 2000 200 5    step every 5 s
+#
+# Needs pyserial.  Other output on the port (text, log records) is skipped.
+
+import struct
+import sys
+import time
+
+REQSYNC = 0xA6
+RSPSYNC = 0xA7
+TYPES = ["int32", "uint32", "int16", "uint16", "uint8"]
+STATUS = ["ok", "no such parameter", "out of range", "flash failed"]
+
+
+class Robot:
+    def __init__(self, name):
+        import serial
+        self.port = serial.Serial(name, 115200, timeout=0.2)
+        self.port.reset_input_buffer()
+        self.names = None
+
+    def request(self, cmd, pid=0, value=0):
+        body = struct.pack("<cBi", cmd.encode(), pid, value)
+        fcs = 0
+        for b in body:
+            fcs ^= b
+        for attempt in range(3):
+            self.port.write(bytes([REQSYNC]) + body + bytes([fcs]))
+            answer = self.answer(cmd)
+            if answer is not None:
+                return answer
+        sys.exit("no answer from robot")
+
+    def answer(self, cmd):
+        deadline = time.time() + 0.5
+        while time.time() < deadline:
+            b = self.port.read(1)
+            if not b or b[0] != RSPSYNC:
+                continue
+            head = self.port.read(4)
+            if len(head) < 4 or chr(head[0]) != cmd:
+                continue
+            payload = self.port.read(head[3])
+            fcs = self.port.read(1)
+            check = 0
+            for x in head + payload:
+                check ^= x
+            if len(payload) == head[3] and fcs and fcs[0] == check:
+                return head[2], payload
+        return None
+
+    def table(self):
+        if self.names is None:
+            status, payload = self.request("N")
+            count, = struct.unpack("<i", payload)
+            self.names = []
+            for pid in range(count):
+                status, payload = self.request("I", pid)
+                ptype, lo, hi, default = struct.unpack_from("<Biii", payload)
+                self.names.append((payload[13:].decode(), TYPES[ptype], lo, hi, default))
+        return self.names
+
+    def find(self, name):
+        for pid, p in enumerate(self.table()):
+            if p[0] == name:
+                return pid
+        sys.exit("no parameter " + name)
+
+    def get(self, pid):
+        status, payload = self.request("R", pid)
+        return struct.unpack("<i", payload)[0]
+
+    def check(self, status, what):
+        if status:
+            sys.exit(what + ": " + STATUS[status])
+
+    def set(self, pairs):
+        for name, value in pairs:
+            status, _ = self.request("B", self.find(name), int(value))
+            self.check(status, name)
+        self.request("C")
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit("usage: paramcli.py port list|get|set|save|defaults|sweep ...")
+    robot = Robot(sys.argv[1])
+    cmd, args = sys.argv[2], sys.argv[3:]
+    if cmd == "list":
+        for pid, (name, ptype, lo, hi, default) in enumerate(robot.table()):
+            print("%2d %-16s %8d  %-6s %d..%d default %d" % (pid, name, robot.get(pid), ptype, lo, hi, default))
+    elif cmd == "get":
+        for name in args:
+            print(name, robot.get(robot.find(name)))
+    elif cmd == "set":
+        robot.set(zip(args[0::2], args[1::2]))
+    elif cmd == "save":
+        robot.check(robot.request("S")[0], "save")
+    elif cmd == "defaults":
+        robot.request("D")
+    elif cmd == "sweep":
+        name, start, stop, step, dwell = args[0], int(args[1]), int(args[2]), int(args[3]), float(args[4])
+        original = robot.get(robot.find(name))
+        try:
+            for value in range(start, stop + (1 if step > 0 else -1), step):
+                robot.set([(name, value)])
+                print("%.1f %s %d" % (time.time(), name, value), flush=True)
+                time.sleep(dwell)
+        finally:
+            robot.set([(name, original)])
+    else:
+        sys.exit("unknown command " + cmd)
+
+
+if __name__ == "__main__":
+    main()
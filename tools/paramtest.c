@@ -0,0 +1,215 @@
+// paramtest.c
+// Host test of inc/Param.c and ParamBLE.c, the protocol, staging, flash and BLE access
+//
+//   gcc -O2 -no-pie -Ihost -I../inc -o paramtest paramtest.c ../inc/Param.c ../inc/ParamBLE.c host/msp.c
+//   ./paramtest
+//
+// The flash sector is host memory mapped at PARAM_FLASH_ADDR (hence
+// -no-pie, which keeps the program clear of that address), so
+// Param_Init reads what Param_Save wrote just as on the robot.  Requests
+// go in through Param_Input byte by byte and the responses are parsed
+// back the way tools/paramcli.py does.  The BLE characteristics are
+// captured from AP_AddCharacteristic and driven like AP.c would.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "msp.h"
+#include "AP.h"
+#include "FlashProgram.h"
+#include "Param.h"
+
+static int Bad;
+
+static void check(int ok, const char *what, int n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %d\n", what, n);
+    }
+  }
+}
+
+// ---- drivers Param.c and ParamBLE.c use ----
+static uint8_t Out[256];
+static uint32_t OutN;
+static int FlashFail, Erases;
+void EUSCIA0_OutChar(char letter){
+  if(OutN < sizeof(Out)){
+    Out[OutN++] = letter;
+  }
+}
+int EUSCIA0_InCharNonBlock(char *datapt){
+  (void)datapt;
+  return 0;
+}
+int Flash_Erase(uint32_t addr){
+  Erases++;
+  if(FlashFail){
+    return ERROR;
+  }
+  memset((void *)(uintptr_t)addr, 0xFF, 4096);
+  return NOERROR;
+}
+int Flash_WriteArray(uint32_t *source, uint32_t addr, uint16_t count){
+  memcpy((void *)(uintptr_t)addr, source, 4*count);
+  return count;
+}
+long StartCritical(void){
+  return 0;
+}
+void EndCritical(long sr){
+  (void)sr;
+}
+
+static uint8_t *BlePt[2];
+static void (*BleRead[2])(void), (*BleWrite[2])(void);
+static uint32_t BleN;
+int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t permission,
+  uint8_t properties, char name[], void(*ReadFunc)(void), void(*WriteFunc)(void)){
+  (void)uuid; (void)thesize; (void)permission; (void)properties; (void)name;
+  if(BleN >= 2){
+    return APFAIL;
+  }
+  BlePt[BleN] = pt;
+  BleRead[BleN] = ReadFunc;
+  BleWrite[BleN] = WriteFunc;
+  BleN++;
+  return APOK;
+}
+
+// ---- the table ----
+static int32_t Kp;
+static uint32_t Period;
+static int16_t Offset;
+static uint16_t Speed;
+static uint8_t Mode;
+static int Changes;
+static void changed(void){
+  Changes++;
+}
+static Param_t Table[] = {
+  {"Kp",     &Kp,     PARAM_INT32,  -100,   100,   20, &changed},
+  {"Period", &Period, PARAM_UINT32,    1, 100000, 1000, 0},
+  {"Offset", &Offset, PARAM_INT16,  -500,   500,  -30, 0},
+  {"Speed",  &Speed,  PARAM_UINT16,    0, 60000, 3000, 0},
+  {"Mode",   &Mode,   PARAM_UINT8,     0,     3,    1, 0},
+};
+#define COUNT PARAM_COUNT(Table)
+
+// send a request, returns the status or -1 for no answer, value and
+// payload from the response
+static int request(uint8_t cmd, uint8_t id, int32_t value, int corrupt,
+                   int32_t *rvalue, uint8_t *payload){
+  uint8_t r[8] = {0xA6, cmd, id, value, value>>8, value>>16, value>>24, 0}, fcs = 0;
+  uint32_t i, len;
+  for(i=1; i<7; i++){
+    r[7] ^= r[i];
+  }
+  r[7] ^= corrupt;
+  OutN = 0;
+  Param_Input('x');                     // terminal typing is ignored
+  for(i=0; i<8; i++){
+    Param_Input(r[i]);
+  }
+  if(OutN == 0){
+    return -1;
+  }
+  len = Out[4];
+  check((Out[0] == 0xA7) && (Out[1] == cmd) && (Out[2] == id) && (OutN == 6+len),
+        "response frame", cmd);
+  for(i=1; i<OutN-1; i++){
+    fcs ^= Out[i];
+  }
+  check(fcs == Out[OutN-1], "response fcs", cmd);
+  if(rvalue && (len >= 4)){
+    *rvalue = Out[5]|(Out[6]<<8)|(Out[7]<<16)|((uint32_t)Out[8]<<24);
+  }
+  if(payload){
+    memcpy(payload, &Out[5], len);
+  }
+  return Out[3];
+}
+
+static void defaults(void){
+  check(Kp == 20 && Period == 1000 && Offset == -30 && Speed == 3000 && Mode == 1,
+        "defaults", Kp);
+}
+
+int main(void){
+  uint8_t payload[64];
+  int32_t v = 0;
+  uint32_t i;
+  if(mmap((void *)(uintptr_t)PARAM_FLASH_ADDR, 4096, PROT_READ|PROT_WRITE,
+          MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED_NOREPLACE, -1, 0) != (void *)(uintptr_t)PARAM_FLASH_ADDR){
+    printf("cannot map the flash sector at %#x, build with -no-pie\n", PARAM_FLASH_ADDR);
+    return 1;
+  }
+  memset((void *)(uintptr_t)PARAM_FLASH_ADDR, 0xFF, 4096);     // erased
+  check(Param_Init(Table, PARAM_MAX+1) == PARAM_BADID, "too many", 0);
+  check(Param_Init(Table, COUNT) == PARAM_OK, "init", 0);
+  defaults();
+  // lookup and info
+  check(Param_Find("Speed") == 3 && Param_Find("Spee") == -1 && Param_Find("Speeds") == -1, "find", 0);
+  check(request('N', 0, 0, 0, &v, 0) == PARAM_OK && v == COUNT, "count", v);
+  check(request('I', 2, 0, 0, 0, payload) == PARAM_OK && payload[0] == PARAM_INT16
+        && memcmp(&payload[13], "Offset", 6) == 0, "info", 2);
+  check(request('I', COUNT, 0, 0, 0, 0) == PARAM_BADID, "info bad id", 0);
+  check(request('R', 2, 0, 0, &v, 0) == PARAM_OK && v == -30, "read int16", v);
+  check(request('Q', 0, 0, 0, 0, 0) == PARAM_BADID, "bad command", 0);
+  check(request('W', 0, 50, 1, 0, 0) == -1, "bad fcs answered", 0);
+  // a write reaches the variable only in Param_Apply
+  check(request('W', 0, 50, 0, 0, 0) == PARAM_OK && Kp == 20, "write staged", Kp);
+  check(Param_Apply() == 1 && Kp == 50 && Changes == 1, "apply", Kp);
+  check(Param_Apply() == 0, "apply twice", 0);
+  check(request('W', 0, 101, 0, 0, 0) == PARAM_RANGE, "range", 0);
+  check(request('W', 4, -1, 0, 0, 0) == PARAM_RANGE, "range uint8", 0);
+  check(request('W', 9, 1, 0, 0, 0) == PARAM_BADID, "write bad id", 0);
+  // a batch is all or nothing
+  check(request('B', 1, 20000, 0, 0, 0) == PARAM_OK, "stage", 1);
+  check(request('B', 3, 59999, 0, 0, 0) == PARAM_OK, "stage", 3);
+  check(Param_Apply() == 0 && Period == 1000, "stage before commit", Period);
+  check(request('C', 0, 0, 0, 0, 0) == PARAM_OK, "commit", 0);
+  check(Param_Apply() == 2 && Period == 20000 && Speed == 59999, "commit apply", Speed);
+  check(request('W', 2, -500, 0, 0, 0) == PARAM_OK && Param_Apply() == 1 && Offset == -500, "int16", Offset);
+  check(request('R', 2, 0, 0, &v, 0) == PARAM_OK && v == -500, "read back", v);
+  // flash
+  check(request('S', 0, 0, 0, 0, 0) == PARAM_OK, "save", 0);
+  Kp = 0; Period = 0; Offset = 0; Speed = 0; Mode = 0;
+  Param_Init(Table, COUNT);
+  check(Kp == 50 && Period == 20000 && Offset == -500 && Speed == 59999 && Mode == 1, "reload", Kp);
+  Param_Init(Table, COUNT-1);           // other layout, saved values are not used
+  check(Kp == 20 && Offset == -30, "layout", Kp);
+  Param_Init(Table, COUNT);
+  ((uint32_t *)(uintptr_t)PARAM_FLASH_ADDR)[3] ^= 1;   // damaged
+  Param_Init(Table, COUNT);
+  defaults();
+  FlashFail = 1;
+  check(request('S', 0, 0, 0, 0, 0) == PARAM_FLASH, "flash fail", 0);
+  FlashFail = 0;
+  check(request('W', 1, 5, 0, 0, 0) == PARAM_OK && request('D', 0, 0, 0, 0, 0) == PARAM_OK, "defaults cmd", 0);
+  Param_Apply();
+  defaults();
+  // BLE, AP.c copies the phone's bytes in and then calls the write function
+  check(Param_AddBLE(0xFFF5) == APOK && BleN == 2, "BLE add", BleN);
+  *BlePt[0] = 3;                        // Speed
+  BleWrite[0]();
+  memcpy(&v, BlePt[1], 4);
+  check(v == 3000, "BLE id", v);
+  v = 1234;
+  memcpy(BlePt[1], &v, 4);
+  BleWrite[1]();
+  check(Param_Apply() == 1 && Speed == 1234, "BLE write", Speed);
+  v = 70000;
+  memcpy(BlePt[1], &v, 4);
+  BleWrite[1]();
+  memcpy(&v, BlePt[1], 4);
+  check(v == 1234 && Param_Apply() == 0, "BLE range", v);
+  *BlePt[0] = 0xFE;                     // save
+  i = Erases;
+  BleWrite[0]();
+  check(Erases == (int)i+1, "BLE save", Erases);
+  printf("%s, %d errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,359 @@
+// proftest.c
+// Host test of inc/Profile.c and the profiled moves in inc/MotorProfile.c
+//
+//   gcc -O2 -Ihost -I../inc -o proftest proftest.c ../inc/Profile.c ../inc/MotorProfile.c ../inc/MotorFit.c host/msp.c -lm
+//   ./proftest
+//
+// Profiles: 200000 random plans, trapezoids and S-curves, distances up
+// to 200000 units either way, at 100 and 1000 ticks per second.  Every
+// plan must take the number of ticks Profile_Start said, counting down
+// by one per Profile_Next, move monotonically, end on exactly the
+// distance with speed 0 and Phase PROFILE_DONE, and never exceed the
+// speed, acceleration or jerk limit.  Against the continuous
+// time-optimal move it may be slower by the rounding up of each phase
+// to whole ticks, never faster by more than a tick.  Only plans out of
+// the limits in Profile.h may return 0.  A speed,
+// acceleration or tick rate of 0 and a distance of 0 plan nothing.
+//
+// Moves: Motor_Duty, Motor_Stop, Motor_Periods, Tachometer_Get and
+// MotorCal_Curve/MotorCal_Duty are stand-ins around a model of two
+// wheels.  Each has a deadband, a gain and a 60 ms time constant that
+// differ up to 20% from the calibrated curve MotorCal_Fit made of a
+// nominal wheel, and the duty reaches it one 10 ms period late, ramping
+// at MOTOR_SLEW as after Motor_SetSlew(MOTOR_SLEW, MOTOR_DEADTIME).
+// Motor_Periods runs one period of the model every second call, so the
+// wait in MotorProfile.c sees one period go by.  On random drives and turns, with duties from 0 (the deadband) to
+// MOTOR_MAX:
+//   the move returns MOTOR_MOVE_DONE with both wheels counted within 1
+//     step of the distance, never more than 3 steps past the end on the
+//     way, and 1 s after the stop, coasting from the last correction,
+//     within 5 steps (3 mm)
+//   a duty in the deadband moves at MOTOR_MOVE_VMIN instead of not at
+//     all, 0 cm and 0 degrees do nothing and return MOTOR_MOVE_DONE
+//   a bump (Motor_Stop from the ISR) returns MOTOR_MOVE_STOPPED and the
+//     drivers stay asleep, a blocked wheel returns MOTOR_MOVE_STALLED
+//     with the motors stopped
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "Motor.h"
+#include "MotorCal.h"
+#include "MotorProfile.h"
+#include "Profile.h"
+#include "Tachometer.h"
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+static void report(const char *what, double error, double limit, const char *unit){
+  printf("%-36s %8.3g %-10s (limit %g)\n", what, error, unit, limit);
+  if(error > limit){
+    Bad++;
+  }
+}
+
+// ---- profiles ----
+#define Q32 4294967296.0
+
+// time of the continuous time-optimal move, s
+static double optimal(double d, double v, double a, double j){
+  double tj, ap, ta, t1, vp, lo, hi, m;
+  int i;
+  if(j <= 0){                         // trapezoid
+    return (d >= v*v/a) ? d/v + v/a : 2*sqrt(d/a);
+  }
+  tj = (v*j < a*a) ? sqrt(v/j) : a/j;
+  ap = j*tj;
+  ta = fmax(v/ap - tj, 0);
+  t1 = 2*tj + ta;
+  vp = ap*(tj + ta);
+  if(d >= vp*t1){
+    return d/vp + t1;
+  }
+  lo = 0;                             // short move, bisect the peak speed
+  hi = vp;
+  for(i=0; i<200; i++){
+    m = (lo + hi)/2;
+    tj = (m*j < a*a) ? sqrt(m/j) : a/j;
+    ta = fmax(m/(j*tj) - tj, 0);
+    if(m*(2*tj + ta) < d){
+      lo = m;
+    }else{
+      hi = m;
+    }
+  }
+  tj = (lo*j < a*a) ? sqrt(lo/j) : a/j;
+  ta = fmax(lo/(j*tj) - tj, 0);
+  return 2*(2*tj + ta);
+}
+
+static void profiles(void){
+  Profile_t p;
+  uint32_t n, k, left, ticks, v, a, j, hz, cases = 0;
+  int32_t d, last;
+  int64_t lastAcc;
+  double vs, as, js, tj, extra, worstExtra = 0, worstFast = 0, sum = 0;
+  srand(7);
+  for(n=0; n<200000; n++){
+    d = ((rand()%2) ? 1 : -1)*(1 + rand()%((n < 1000) ? 200000 : 5000));
+    v = 1 + rand()%3000;
+    a = 1 + rand()%20000;
+    j = (rand()%3 == 0) ? 0 : 1 + rand()%200000;
+    hz = (rand()%4 == 0) ? 1000 : 100;
+    if(n%7 == 0){                     // what MotorProfile.c asks for
+      v = MOTOR_MOVE_VMIN + rand()%700;
+      a = 800;
+      j = 8000;
+      hz = 100;
+      d = ((rand()%2) ? 1 : -1)*(1 + rand()%2000);
+    }
+    ticks = Profile_Start(&p, d, v, a, j, hz);
+    if(ticks == 0){             // out of the Profile.h limits
+      tj = j ? fmax(fmin(fmin((double)a/j, sqrt((double)v/j)), cbrt(abs(d)/(2.0*j)))*hz, 1) : 1;
+      check((optimal(abs(d), v, a, j)*hz > (1<<24) - 16) || ((double)abs(d)*hz*hz/a > (1<<26) - 16) ||
+            (j && ((double)abs(d)*hz*hz*hz/(j*tj) > (1<<26)*0.9)), "not planned", n);
+      continue;
+    }
+    cases++;
+    last = 0;
+    lastAcc = 0;
+    vs = as = js = 0;
+    for(k=1; k<=ticks; k++){
+      left = Profile_Next(&p);
+      check(left == ticks - k, "ticks left", n);
+      vs = fmax(vs, fabs((double)p.Vel)*hz/Q32);
+      as = fmax(as, fabs((double)p.Acc)*hz*hz/Q32);
+      js = fmax(js, fabs((double)(p.Acc - lastAcc))*hz*hz*hz/Q32);
+      check((d > 0) ? (p.Position >= last) : (p.Position <= last), "monotonic", n);
+      last = p.Position;
+      lastAcc = p.Acc;
+    }
+    js = fmax(js, fabs((double)lastAcc)*hz*hz*hz/Q32);
+    check((p.Position == d) && (p.Velocity == 0) && (p.Vel == 0) && (p.Phase == PROFILE_DONE) &&
+          (p.Pos == ((int64_t)llabs(d)<<32)), "end", n);
+    check(Profile_Next(&p) == 0 && p.Position == d, "after the end", n);
+    check(vs <= v*(1 + 1e-9), "speed limit", n);
+    check(as <= a*(1 + 1e-9), "acceleration limit", n);
+    check((j == 0) || (js <= j*(1 + 1e-9)), "jerk limit", n);
+    extra = ticks - optimal(abs(d), v, a, j)*hz;   // ticks slower
+    worstFast = fmax(worstFast, -extra);
+    if(ticks > 20){
+      worstExtra = fmax(worstExtra, extra/ticks);
+      sum += extra/ticks;
+    }
+  }
+  printf("%u profiles\n", (unsigned)cases);
+  report("faster than the continuous optimum", worstFast, 1, "ticks");
+  report("slower than it, worst", worstExtra, 0.25, "relative");
+  report("slower than it, mean", sum/cases, 0.01, "relative");
+  check(Profile_Start(&p, 100, 0, 800, 8000, 100) == 0, "vmax 0", 0);
+  check(Profile_Start(&p, 100, 500, 0, 8000, 100) == 0, "amax 0", 0);
+  check(Profile_Start(&p, 100, 500, 800, 8000, 0) == 0, "hz 0", 0);
+  check(Profile_Start(&p, 0, 500, 800, 8000, 100) == 0 && p.Position == 0 && p.Phase == PROFILE_DONE, "distance 0", 0);
+}
+
+// ---- what MotorProfile.c calls ----
+typedef struct{
+  double Deadband, Gain;              // duty, mm/s per duty
+  double Speed, Steps;                // mm/s, tachometer steps
+  int32_t Target, Next, Out;          // commanded, latched, at the motor
+} Wheel_t;
+
+static Wheel_t W[2];
+static uint32_t Periods, Calls, BumpAt, Duties;
+static MotorCalCurve_t Cal[4];
+
+void Motor_Duty(int32_t left, int32_t right){
+  W[0].Target = (left > MOTOR_MAX) ? MOTOR_MAX : (left < -MOTOR_MAX) ? -MOTOR_MAX : left;
+  W[1].Target = (right > MOTOR_MAX) ? MOTOR_MAX : (right < -MOTOR_MAX) ? -MOTOR_MAX : right;
+  P3->OUT |= 0xC0;
+  Duties++;
+}
+
+void Motor_Stop(void){
+  uint32_t i;
+  for(i=0; i<2; i++){
+    W[i].Target = W[i].Next = W[i].Out = 0;
+  }
+  P3->OUT &= ~0xC0;
+}
+
+// one 10 ms period: the latched duty reaches the motor, the next one
+// moves toward the target by up to MOTOR_SLEW, 1 ms model steps
+static void run(void){
+  uint32_t i, ms;
+  double v;
+  for(i=0; i<2; i++){
+    Wheel_t *w = &W[i];
+    w->Out = w->Next;
+    if(w->Target > w->Next + MOTOR_SLEW){
+      w->Next += MOTOR_SLEW;
+    }else if(w->Target < w->Next - MOTOR_SLEW){
+      w->Next -= MOTOR_SLEW;
+    }else{
+      w->Next = w->Target;
+    }
+    v = (abs(w->Out) > w->Deadband) ? (abs(w->Out) - w->Deadband)*w->Gain : 0;
+    v = (w->Out < 0) ? -v : v;
+    for(ms=0; ms<10; ms++){
+      w->Speed += (v - w->Speed)*0.001/0.060;
+      w->Steps += w->Speed*0.001*360/220;
+    }
+  }
+  Periods++;
+  if(Periods == BumpAt){
+    Motor_Stop();                     // the bump ISR
+  }
+}
+
+uint32_t Motor_Periods(void){
+  if(Calls++&1){
+    run();
+  }
+  return Periods;
+}
+
+void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
+                    uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps){
+  *leftTach = *rightTach = 0;
+  *leftDir = *rightDir = STOPPED;
+  *leftSteps = (int32_t)floor(W[0].Steps);
+  *rightSteps = (int32_t)floor(W[1].Steps);
+}
+
+const MotorCalCurve_t *MotorCal_Curve(uint32_t curve){
+  return &Cal[curve&3];
+}
+
+int32_t MotorCal_Duty(uint32_t wheel, int32_t speed){
+  const MotorCalCurve_t *c = MotorCal_Curve((wheel&1)*2 + (speed < 0));
+  if(speed < 0){
+    return -(int32_t)MotorCal_Lookup(c, -speed);
+  }
+  return MotorCal_Lookup(c, speed);
+}
+
+// ---- moves ----
+// the calibration of a nominal wheel, deadband 600, 0.07 mm/s per duty
+static void calibrate(void){
+  uint16_t duty[MOTORCAL_POINTS];
+  int16_t speed[MOTORCAL_POINTS];
+  uint32_t i;
+  for(i=0; i<MOTORCAL_POINTS; i++){
+    duty[i] = i*MOTORCAL_STEP;
+    speed[i] = (duty[i] > 600) ? (int16_t)((duty[i] - 600)*0.07) : 0;
+  }
+  for(i=0; i<4; i++){
+    check(MotorCal_Fit(duty, speed, MOTORCAL_POINTS, &Cal[i]) == 0, "calibration", i);
+  }
+}
+
+// a robot at rest whose wheels are off the calibration by up to 30%
+static void robot(uint32_t bumpAt){
+  uint32_t i;
+  for(i=0; i<2; i++){
+    W[i].Deadband = 600*(0.8 + (rand()%41)/100.0);
+    W[i].Gain = 0.07*(0.8 + (rand()%41)/100.0);
+    W[i].Speed = W[i].Steps = 0;
+    W[i].Target = W[i].Next = W[i].Out = 0;
+  }
+  P3->OUT &= ~0xC0;
+  Periods = Calls = Duties = 0;
+  BumpAt = bumpAt;
+}
+
+// how far past the end a wheel is, in steps, 0 if short of it
+static double past(double steps, int32_t target){
+  return (target > 0) ? fmax(steps - target, 0) : fmax(target - steps, 0);
+}
+
+static double WorstEnd, WorstCoast, WorstOver;
+
+static void drive(long n, int32_t cm, int32_t degrees, uint16_t duty){
+  int32_t target[2];
+  uint32_t result, coast;
+  double over = 0;
+  robot(0);
+  if(degrees){
+    target[0] = (abs(degrees)*((145*12868)/220))>>12;
+    target[0] = (degrees > 0) ? target[0] : -target[0];
+    target[1] = -target[0];
+    result = Motor_ProfiledRotateAngle(degrees, duty);
+  }else{
+    target[0] = target[1] = (cm*360)/22;
+    result = Motor_ProfiledForwardDist(cm, duty, duty);
+  }
+  check(result == MOTOR_MOVE_DONE, "result", n);
+  WorstEnd = fmax(WorstEnd, fmax(fabs(floor(W[0].Steps) - target[0]), fabs(floor(W[1].Steps) - target[1])));
+  check((P3->OUT&0xC0) == 0, "stopped at the end", n);
+  for(coast=0; coast<100; coast++){
+    run();
+    over = fmax(over, fmax(past(W[0].Steps, target[0]), past(W[1].Steps, target[1])));
+  }
+  WorstCoast = fmax(WorstCoast, fmax(fabs(W[0].Steps - target[0]), fabs(W[1].Steps - target[1])));
+  WorstOver = fmax(WorstOver, over);
+}
+
+static void moves(void){
+  long n;
+  uint32_t slow, result;
+  int32_t cm;
+  calibrate();
+  srand(11);
+  for(n=0; n<3000; n++){
+    if(n%2){
+      drive(n, 0, (rand()%2 ? 1 : -1)*(1 + rand()%360), rand()%(MOTOR_MAX + 1));
+    }else{
+      drive(n, (rand()%2 ? 1 : -1)*(1 + rand()%100), 0, rand()%(MOTOR_MAX + 1));
+    }
+  }
+  report("end of the move", WorstEnd, 1, "steps");
+  report("1 s after the stop", WorstCoast, 5, "steps");
+  report("past the end on the way", WorstOver, 3, "steps");
+
+  // a duty in the deadband still moves, at MOTOR_MOVE_VMIN
+  robot(0);
+  result = Motor_ProfiledForwardDist(20, 0, 0);
+  slow = Periods;
+  check(result == MOTOR_MOVE_DONE && abs((int32_t)floor(W[0].Steps) - 327) <= 1, "deadband duty", (long)W[0].Steps);
+  check(slow > 327*100/MOTOR_MOVE_VMIN && slow < 327*100/MOTOR_MOVE_VMIN + 150, "at MOTOR_MOVE_VMIN", slow);
+  printf("20 cm at duty 0: %u periods, %d steps\n", (unsigned)slow, (int)W[0].Steps);
+  robot(0);
+  check(Motor_ProfiledForwardDist(0, 3000, 3000) == MOTOR_MOVE_DONE && Duties == 0 && Periods == 0, "0 cm", Duties);
+  check(Motor_ProfiledRotateAngle(0, 3000) == MOTOR_MOVE_DONE && Duties == 0 && Periods == 0, "0 degrees", Duties);
+
+  // a bump half way
+  for(n=0; n<100; n++){
+    cm = 10 + rand()%50;
+    robot(2 + rand()%100);
+    result = Motor_ProfiledForwardDist(cm, 3000, 3000);
+    check(result == MOTOR_MOVE_STOPPED || Periods < BumpAt, "bump", n);
+    if(result == MOTOR_MOVE_STOPPED){
+      check(Periods <= BumpAt + 1 && (P3->OUT&0xC0) == 0 && W[0].Target == 0 && W[1].Target == 0, "stays stopped", n);
+    }
+  }
+
+  // a blocked wheel
+  robot(0);
+  W[1].Gain = 0;
+  result = Motor_ProfiledForwardDist(30, 3000, 3000);
+  check(result == MOTOR_MOVE_STALLED && (P3->OUT&0xC0) == 0 && W[0].Target == 0, "stalled", result);
+}
+
+int main(void){
+  profiles();
+  moves();
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
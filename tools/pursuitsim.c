@@ -0,0 +1,198 @@
+// pursuitsim.c
+// Host kinematic simulation of inc/Pursuit.c against stop-rotate-drive
+//
+//   gcc -O2 -I../inc -o pursuitsim pursuitsim.c ../inc/Pursuit.c ../inc/Trig.c ../inc/Profile.c -lm
+//   ./pursuitsim               all courses, lookahead 40, 60 (default), 80 and 120 mm
+//   ./pursuitsim 300 150       cell size and corner radius in mm
+//
+// The robot is a differential drive with the track of Motor.c.  Each
+// wheel follows its speed command with a first-order lag (the motor),
+// the command takes effect one control tick late (the PWM latch), and
+// the tachometers count whole steps, 360 per 220 mm.  The plant runs
+// at 1 kHz in floating point, the controller at 100 Hz on the steps
+// only, like on the robot.
+//
+// For each course it prints the time to the end, the largest and the
+// RMS distance of the true robot position from the path (Pursuit_Point,
+// arcs included), and how far from the last waypoint the robot stops.
+// The baseline is the time stop-rotate-drive takes with the Profile
+// limits of Motor.c (800 steps/s^2, 8000 steps/s^3) at the same top
+// speed, each cell and each turn a move from rest to rest.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Pursuit.h"
+#include "Profile.h"
+#include "Maze.h"
+
+#define TRACK   145     // mm, WHEELBASE in Motor.c
+#define HZ      100     // control ticks per s
+#define PLANT   10      // plant steps per control tick
+#define TAU     0.060   // s, wheel speed time constant
+#define TIMEOUT 60      // s
+#define PI      3.14159265358979
+
+typedef struct Course{
+  const char *Name;
+  int32_t X, Y;         // start, mm
+  int32_t Heading;      // deg
+  const uint8_t *Moves; // Maze.h moves, or 0 for the points
+  uint32_t Count;
+  const int32_t *Points;  // x, y pairs, mm
+} Course_t;
+
+// 4 x 4 maze, south-west corner to north-east corner, no dead ends
+static const uint8_t Route[] = {
+  MAZE_FORWARD, MAZE_FORWARD, MAZE_RIGHT, MAZE_FORWARD, MAZE_LEFT,
+  MAZE_FORWARD, MAZE_RIGHT, MAZE_FORWARD, MAZE_LEFT, MAZE_RIGHT
+};
+// same with a dead end, back out with a U-turn
+static const uint8_t DeadEnd[] = {
+  MAZE_FORWARD, MAZE_RIGHT, MAZE_FORWARD, MAZE_UTURN, MAZE_FORWARD,
+  MAZE_RIGHT, MAZE_FORWARD, MAZE_FORWARD
+};
+// 600 x 600 mm square, once around counterclockwise
+static const int32_t Square[] = {600, 0, 600, 600, 0, 600, 0, 0};
+
+static int32_t Cell = 300, Radius = 150;
+
+static Course_t Courses[] = {
+  {"maze route", 0, 0, 90, Route, sizeof(Route), 0},
+  {"dead end", 0, 0, 90, DeadEnd, sizeof(DeadEnd), 0},
+  {"square lap", 0, 0, 0, 0, sizeof(Square)/sizeof(Square[0])/2, Square},
+};
+
+// distance from (x,y) to the path
+static double offPath(double x, double y){
+  int32_t ax, ay, bx, by;
+  uint32_t i, n = Pursuit_Point(0, &ax, &ay);
+  double best = 1e9, dx, dy, t, d;
+  for(i=1; i<n; i++){
+    Pursuit_Point(i, &bx, &by);
+    dx = bx - ax;
+    dy = by - ay;
+    t = ((x - ax)*dx + (y - ay)*dy)/(dx*dx + dy*dy);
+    t = (t < 0) ? 0 : (t > 1) ? 1 : t;
+    d = hypot(x - ax - t*dx, y - ay - t*dy);
+    if(d < best){
+      best = d;
+    }
+    ax = bx;
+    ay = by;
+  }
+  return best;
+}
+
+static void build(const Course_t *c, uint32_t radius){
+  uint32_t i;
+  Pursuit_SetPose(c->X, c->Y, (uint16_t)((c->Heading*65536)/360));
+  Pursuit_Clear();
+  for(i=0; i<c->Count; i++){
+    if(c->Moves){
+      Pursuit_AddMove(c->Moves[i], Cell, radius);
+    }else{
+      Pursuit_Add(c->Points[2*i], c->Points[2*i+1], radius);
+    }
+  }
+}
+
+// drive the course, returns the time in s
+static double drive(const Course_t *c, uint32_t radius, double *maxErr,
+                    double *rmsErr, double *endErr){
+  PursuitCmd_t cmd;
+  double x = c->X, y = c->Y, th = c->Heading*PI/180;
+  double vl = 0, vr = 0, dl = 0, dr = 0, dt = 1.0/(HZ*PLANT), e, sum = 0;
+  int32_t cl = 0, cr = 0, ex, ey;   // commands latched for this tick
+  uint32_t tick, i, n, driving = 1;
+  build(c, radius);
+  *maxErr = 0;
+  for(tick=0; driving && (tick < TIMEOUT*HZ); tick++){
+    Pursuit_Odometry((int32_t)floor(dl*PURSUIT_STEPS/PURSUIT_MM_STEP),
+                     (int32_t)floor(dr*PURSUIT_STEPS/PURSUIT_MM_STEP));
+    driving = Pursuit_Update(&cmd);
+    for(i=0; i<PLANT; i++){
+      vl = vl + (cl - vl)*dt/TAU;
+      vr = vr + (cr - vr)*dt/TAU;
+      dl = dl + vl*dt;
+      dr = dr + vr*dt;
+      x = x + (vl + vr)/2*cos(th)*dt;
+      y = y + (vl + vr)/2*sin(th)*dt;
+      th = th + (vr - vl)/TRACK*dt;
+    }
+    cl = cmd.Left;              // takes effect at the next period
+    cr = cmd.Right;
+    e = offPath(x, y);
+    sum = sum + e*e;
+    if(e > *maxErr){
+      *maxErr = e;
+    }
+  }
+  *rmsErr = sqrt(sum/tick);
+  n = Pursuit_Point(0, &ex, &ey);
+  Pursuit_Point(n - 1, &ex, &ey);
+  *endErr = hypot(x - ex, y - ey);
+  return driving ? -1 : (double)tick/HZ;
+}
+
+// ticks of one Motor.c move of steps at vmax steps/s
+static uint32_t profile(int32_t steps, uint32_t vmax){
+  Profile_t p;
+  return Profile_Start(&p, steps, vmax, 800, 8000, HZ);
+}
+
+// stop-rotate-drive time of a course in s, the square is driven as
+// cells of its sides
+static double baseline(const Course_t *c){
+  uint32_t vmax = (PURSUIT_SPEED*PURSUIT_STEPS)/PURSUIT_MM_STEP, ticks = 0, i;
+  int32_t spin90 = (int32_t)(TRACK*PI/4*PURSUIT_STEPS/PURSUIT_MM_STEP + 0.5);
+  int32_t cell = (Cell*PURSUIT_STEPS)/PURSUIT_MM_STEP;
+  for(i=0; i<c->Count; i++){
+    if(c->Moves){
+      if((c->Moves[i] == MAZE_RIGHT) || (c->Moves[i] == MAZE_LEFT)){
+        ticks += profile(spin90, vmax);
+      }else if(c->Moves[i] == MAZE_UTURN){
+        ticks += profile(2*spin90, vmax);
+      }
+      ticks += profile(cell, vmax);
+    }else{
+      if(i){
+        ticks += profile(spin90, vmax);
+      }
+      ticks += profile((600*PURSUIT_STEPS)/PURSUIT_MM_STEP, vmax);
+    }
+  }
+  return (double)ticks/HZ;
+}
+
+int main(int argc, char **argv){
+  static const uint32_t Look[] = {40, 60, 80, 120};
+  double t, maxErr, rmsErr, endErr;
+  uint32_t i, j;
+  if(argc > 1){
+    Cell = atoi(argv[1]);
+  }
+  if(argc > 2){
+    Radius = atoi(argv[2]);
+  }
+  printf("cell %d mm, corner radius %d mm, %d mm/s, %d mm/s^2, %d mm/s^2 lateral\n",
+         (int)Cell, (int)Radius, PURSUIT_SPEED, PURSUIT_ACCEL, PURSUIT_LATERAL);
+  printf("%-12s %7s %7s %7s %7s %7s %7s\n", "course", "look", "radius",
+         "time s", "max mm", "rms mm", "end mm");
+  for(i=0; i<sizeof(Courses)/sizeof(Courses[0]); i++){
+    for(j=0; j<sizeof(Look)/sizeof(Look[0]); j++){
+      Pursuit_Init(TRACK, HZ);
+      Pursuit_SetLookahead(Look[j], PURSUIT_LOOKTIME, PURSUIT_LOOKMAX);
+      t = drive(&Courses[i], Radius, &maxErr, &rmsErr, &endErr);
+      printf("%-12s %7u %7d %7.2f %7.1f %7.1f %7.1f\n", Courses[i].Name,
+             Look[j], (int)Radius, t, maxErr, rmsErr, endErr);
+    }
+    Pursuit_Init(TRACK, HZ);
+    t = drive(&Courses[i], 0, &maxErr, &rmsErr, &endErr);
+    printf("%-12s %7u %7d %7.2f %7.1f %7.1f %7.1f\n", Courses[i].Name,
+           PURSUIT_LOOKMIN, 0, t, maxErr, rmsErr, endErr);
+    printf("%-12s %7s %7s %7.2f\n", Courses[i].Name, "stop", "", baseline(&Courses[i]));
+  }
+  return 0;
+}
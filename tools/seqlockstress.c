@@ -0,0 +1,106 @@
+// seqlockstress.c
+// Host stress test of inc/Seqlock.h with one writer and several readers
+//
+//   gcc -O2 -pthread -Ihost -I../inc -o seqlockstress seqlockstress.c host/msp.c
+//   ./seqlockstress            3 readers, 2 s
+//   ./seqlockstress 7 10       7 readers, 10 s
+//
+// The writer thread publishes frames as fast as it can, like a sensor
+// ISR that never stops.  Every word of a frame is derived from its
+// count, so a reader can tell a frame that mixes two writes.  The
+// readers copy frames in a loop and check each one.  On the robot the
+// reader of a torn copy would be preempted by the ISR; here the threads
+// run truly in parallel, which is the harder case.
+// Prints the number of reads, retries and torn frames, and fails if a
+// frame was torn or the count went backwards.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "msp.h"
+#include "Seqlock.h"
+
+#define WORDS   12      // about the size of SensorFrame_t
+#define READERS 16
+
+struct Frame{
+  uint32_t Count;
+  uint32_t Word[WORDS-1];
+};
+SEQLOCK_DECLARE(struct Frame, Frame);
+
+static volatile int Running = 1;
+
+typedef struct Stats{
+  uint64_t Reads, Retries, Torn, Backwards;
+} Stats_t;
+
+static void *writer(void *arg){
+  struct Frame f;
+  uint32_t i, n = 0;
+  (void)arg;
+  while(Running){
+    n++;
+    f.Count = n;
+    for(i=0; i<WORDS-1; i++){
+      f.Word[i] = n*(2*i+3) ^ (0x9E3779B9u*i);
+    }
+    Seqlock_Write(&Frame_Lock, Frame_Buf, &f, sizeof(f)/4);
+  }
+  return 0;
+}
+
+static void *reader(void *arg){
+  Stats_t *s = (Stats_t *)arg;
+  struct Frame f;
+  uint32_t i, last = 0;
+  while(Running){
+    s->Retries += Seqlock_Read(&Frame_Lock, Frame_Buf, &f, sizeof(f)/4);
+    s->Reads++;
+    for(i=0; i<WORDS-1; i++){
+      if(f.Word[i] != (f.Count*(2*i+3) ^ (0x9E3779B9u*i))){
+        s->Torn++;
+        break;
+      }
+    }
+    if(f.Count < last){
+      s->Backwards++;
+    }
+    last = f.Count;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv){
+  static Stats_t stats[READERS];
+  pthread_t w, r[READERS];
+  Stats_t sum = {0, 0, 0, 0};
+  int readers = (argc > 1) ? atoi(argv[1]) : 3;
+  int seconds = (argc > 2) ? atoi(argv[2]) : 2;
+  int i;
+  struct timespec t = {seconds, 0};
+  if((readers < 1) || (readers > READERS)){
+    readers = 3;
+  }
+  pthread_create(&w, 0, writer, 0);
+  for(i=0; i<readers; i++){
+    pthread_create(&r[i], 0, reader, &stats[i]);
+  }
+  nanosleep(&t, 0);
+  Running = 0;
+  pthread_join(w, 0);
+  for(i=0; i<readers; i++){
+    pthread_join(r[i], 0);
+    sum.Reads += stats[i].Reads;
+    sum.Retries += stats[i].Retries;
+    sum.Torn += stats[i].Torn;
+    sum.Backwards += stats[i].Backwards;
+  }
+  printf("%d readers, %llu writes, %llu reads, %llu retries, %llu torn, %llu backwards\n",
+         readers, (unsigned long long)Frame_Lock.Seq, (unsigned long long)sum.Reads,
+         (unsigned long long)sum.Retries, (unsigned long long)sum.Torn,
+         (unsigned long long)sum.Backwards);
+  return (sum.Torn || sum.Backwards) ? 1 : 0;
+}
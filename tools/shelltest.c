@@ -0,0 +1,285 @@
+// shelltest.c
+// Host test of inc/Shell.c with scripted input
+//
+//   gcc -O2 -Wall -I../inc -o shelltest shelltest.c ../inc/Shell.c
+//   ./shelltest
+//
+// The script is typed in through Shell_Poll a character at a time, the
+// way the Lab 5 main feeds it from EUSCIA0_InCharNonBlock, and the echo
+// and command output are captured and compared with the transcript the
+// terminal would show.  The command index is filled to SHELL_MAXCMDS
+// with generated names to check every name is found and nothing else
+// is.  The jobs run from Shell_Run on a simulated ms clock, including
+// across the 32-bit wrap, and their call times are checked against the
+// period, the duration and kill.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Shell.h"
+
+static int Bad;
+
+static void check(int ok, const char *what, int n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %d\n", what, n);
+    }
+  }
+}
+
+// ---- terminal ----
+static char Screen[4096];
+static uint32_t ScreenN;
+static void out(char letter){
+  if(ScreenN < sizeof(Screen)-1){
+    Screen[ScreenN++] = letter;
+    Screen[ScreenN] = 0;
+  }
+}
+static void clear(void){
+  ScreenN = 0;
+  Screen[0] = 0;
+}
+
+static const char *Script;
+static int in(char *datapt){
+  if(*Script == 0){
+    return 0;
+  }
+  *datapt = *Script++;
+  return 1;
+}
+static uint32_t type(const char *s){
+  Script = s;
+  return Shell_Poll(&in);
+}
+
+// ---- commands ----
+static int Argc;
+static char Args[SHELL_MAXARGS][SHELL_LINESIZE];
+static int Ticks, Stops;
+static void tick(void){
+  Ticks++;
+}
+static void stopped(void){
+  Stops++;
+}
+
+static int Echo(int argc, char *argv[]){
+  int i;
+  Argc = argc;
+  for(i=0; i<argc; i++){
+    strcpy(Args[i], argv[i]);
+  }
+  return SHELL_OK;
+}
+
+// motor fwd <duty> <time>ms, like the Lab 5 command
+static int Motor(int argc, char *argv[]){
+  int32_t duty, time;
+  if((argc != 4) || strcmp(argv[1], "fwd") || !Shell_Number(argv[2], 0, &duty)
+   || !Shell_Number(argv[3], "ms", &time) || (time <= 0)){
+    return SHELL_USAGE;
+  }
+  Shell_StartJob("motor", &tick, 10, time, &stopped);
+  Shell_OutString("duty "); Shell_OutDec(duty); Shell_OutString("\r\n");
+  return SHELL_OK;
+}
+
+static int Fail(int argc, char *argv[]){
+  (void)argc; (void)argv;
+  return SHELL_FAIL;
+}
+
+static ShellCmd_t Commands[] = {
+  {"echo", &Echo, "echo [words]"},
+  {"motor", &Motor, "motor fwd <duty> <time>ms"},
+  {"fail", &Fail, "fail"},
+};
+
+// ---- transcripts ----
+static void transcript(void){
+  clear();
+  check(Shell_Init(Commands, 3, &out) == 0, "init", 0);
+  check(strcmp(Screen, "> ") == 0, "prompt", (int)ScreenN);
+  clear();
+  check(type("echo a  b\tc\r\n") == 13, "poll count", 0);
+  check(strcmp(Screen, "echo a  bc\r\n> ") == 0, "echo screen", (int)ScreenN);  // typed tab dropped
+  check(Argc == 3 && !strcmp(Args[1], "a") && !strcmp(Args[2], "bc"), "words", Argc);
+  {
+    char line[] = "\techo a\t b  ";
+    check(Shell_Execute(line) == SHELL_OK && Argc == 3 && !strcmp(Args[2], "b"), "tabs", Argc);
+  }
+  clear();
+  type("motr\r");
+  check(strcmp(Screen, "motr\r\nmotr: unknown, try help\r\n> ") == 0, "unknown", 0);
+  clear();
+  type("motor x\r");
+  check(strcmp(Screen, "motor x\r\nusage: motor fwd <duty> <time>ms\r\n> ") == 0, "usage", 0);
+  clear();
+  type("fail\n");
+  check(strcmp(Screen, "fail\r\nfail: failed\r\n> ") == 0, "fail", 0);
+  clear();
+  type("help kill\r");
+  check(strcmp(Screen, "help kill\r\nkill <job>|all\r\n> ") == 0, "help one", 0);
+  clear();
+  type("help\r");
+  check(strcmp(Screen, "help\r\necho [words]\r\nmotor fwd <duty> <time>ms\r\nfail\r\n"
+                       "help [command]\r\njobs\r\nkill <job>|all\r\n> ") == 0, "help all", 0);
+  clear();
+  type("jobs now\r");
+  check(strstr(Screen, "usage: jobs") != 0, "jobs args", 0);
+  // editing: backspace and delete, control characters, empty lines
+  clear();
+  type("ecx\bho\x01 z\x7fy\r\r\n\n");
+  check(strcmp(Screen, "ecx\b \bho z\b \by\r\n> \r\n> ") == 0, "edit screen", (int)ScreenN);
+  check(Argc == 2 && !strcmp(Args[1], "y"), "edit words", Argc);
+  type("\b\b\r");                       // backspace on an empty line
+  check(Argc == 2, "empty backspace", Argc);
+  // a long line keeps its first SHELL_LINESIZE-1 characters
+  {
+    char line[2*SHELL_LINESIZE];
+    memset(line, 'x', sizeof(line));
+    memcpy(line, "echo ", 5);
+    line[sizeof(line)-2] = '\r';
+    line[sizeof(line)-1] = 0;
+    type(line);
+    check(Argc == 2 && strlen(Args[1]) == SHELL_LINESIZE-1-5, "long line", (int)strlen(Args[1]));
+  }
+  // too many words
+  clear();
+  type("echo 1 2 3 4 5 6 7 8\r");
+  check(strstr(Screen, "too many words") != 0, "words limit", 0);
+  type("echo 1 2 3 4 5 6 7\r");
+  check(Argc == SHELL_MAXARGS, "most words", Argc);
+}
+
+// ---- command index ----
+static char Names[SHELL_MAXCMDS+1][8];
+static struct ShellCmd Big[SHELL_MAXCMDS+1];
+static void lookup(void){
+  char line[16];
+  uint32_t i;
+  for(i=0; i<=SHELL_MAXCMDS; i++){
+    sprintf(Names[i], "c%u", (unsigned)(i*7919u)%1000);
+    Big[i].Name = Names[i];
+    Big[i].Run = &Echo;
+    Big[i].Help = Names[i];
+  }
+  check(Shell_Init(Big, SHELL_MAXCMDS, &out) == 0, "full index", 0);
+  for(i=0; i<SHELL_MAXCMDS; i++){
+    strcpy(line, Names[i]);
+    Argc = 0;
+    check(Shell_Execute(line) == SHELL_OK && Argc == 1 && !strcmp(Args[0], Names[i]), "find", (int)i);
+  }
+  for(i=0; i<1000; i++){                // names not in the table
+    sprintf(line, "d%u", (unsigned)i);
+    check(Shell_Execute(line) == -1, "not found", (int)i);
+  }
+  strcpy(line, "jobs");
+  check(Shell_Execute(line) == SHELL_OK, "builtin", 0);
+  check(Shell_Init(Big, SHELL_MAXCMDS+1, &out) == 1, "too many", 0);
+  Big[1].Name = Names[0];
+  check(Shell_Init(Big, 2, &out) == 1, "repeated", 0);
+  Big[1].Name = "help";
+  check(Shell_Init(Big, 2, &out) == 1, "builtin repeated", 0);
+  Big[1].Name = Names[1];
+}
+
+// ---- numbers ----
+static void numbers(void){
+  static const struct{
+    const char *S, *Unit;
+    int Ok;
+    int32_t Value;
+  } Cases[] = {
+    {"100hz", "hz", 1, 100}, {"100", "hz", 1, 100}, {"-5", 0, 1, -5},
+    {"1000ms", "ms", 1, 1000}, {"2147483647", 0, 1, 2147483647},
+    {"-2147483647", 0, 1, -2147483647}, {"2147483648", 0, 0, 0},
+    {"99999999999", 0, 0, 0}, {"12x", "hz", 0, 0}, {"hz", "hz", 0, 0},
+    {"", 0, 0, 0}, {"-", 0, 0, 0}, {"100hz", 0, 0, 0}, {"100h", "hz", 0, 0},
+    {"100hzz", "hz", 0, 0}, {"0", 0, 1, 0}, {"007", 0, 1, 7},
+  };
+  uint32_t i;
+  int32_t v;
+  for(i=0; i<sizeof(Cases)/sizeof(Cases[0]); i++){
+    v = 12345;
+    check(Shell_Number(Cases[i].S, Cases[i].Unit, &v) == Cases[i].Ok, "number ok", (int)i);
+    check(v == (Cases[i].Ok ? Cases[i].Value : 12345), "number value", (int)i);
+  }
+}
+
+// ---- jobs ----
+static uint32_t Clock, Last, Gap, Calls;  // ms
+static void timed(void){
+  if(Calls && (Clock - Last > Gap)){
+    Gap = Clock - Last;
+  }
+  Last = Clock;
+  Calls++;
+}
+static void run(uint32_t ms){
+  while(ms--){
+    Shell_Run(Clock);
+    Clock++;
+  }
+}
+
+static void jobs(uint32_t start){
+  uint32_t i;
+  Clock = start;
+  clear();
+  Shell_Init(Commands, 3, &out);
+  Shell_Run(Clock);
+  // a forever job runs at its period
+  Calls = Gap = 0;
+  check(Shell_StartJob("ir", &timed, 10, 0, 0) == 0, "start", 0);
+  run(1000);
+  check(Calls == 100 && Gap == 10, "period", (int)Calls);
+  // a timed job from a command stops by itself and calls stop once
+  Ticks = Stops = 0;
+  type("motor fwd 3000 250ms\r");
+  check(strstr(Screen, "duty 3000") != 0, "motor cmd", 0);
+  clear();
+  type("jobs\r");
+  check(strstr(Screen, "ir every 10 ms\r\n") && strstr(Screen, "motor every 10 ms, 250 ms left\r\n"), "jobs list", 0);
+  run(1000);
+  check(Ticks == 25 && Stops == 1, "duration", Ticks);
+  // the slots fill up, a restart reuses the slot
+  check(Shell_StartJob("a", &tick, 5, 0, &stopped) == 0, "slot a", 0);
+  check(Shell_StartJob("b", &tick, 5, 0, &stopped) == 0, "slot b", 0);
+  check(Shell_StartJob("c", &tick, 5, 0, &stopped) == 0, "slot c", 0);
+  check(Shell_StartJob("d", &tick, 5, 0, &stopped) == 1, "full", 0);
+  check(Shell_StartJob("b", &tick, 7, 0, &stopped) == 0, "restart", 0);
+  check(Stops == 1, "restart no stop", Stops);
+  // kill one, then all
+  clear();
+  type("kill b\rkill b\r");
+  check(Stops == 2 && strstr(Screen, "kill: failed") != 0, "kill", Stops);
+  type("kill all\r");
+  check(Stops == 4, "kill all", Stops);
+  Calls = 0;
+  run(100);
+  check(Calls == 0, "killed", (int)Calls);
+  // a late Shell_Run skips the missed calls, it does not catch up
+  Calls = Gap = 0;
+  Shell_StartJob("slow", &timed, 10, 0, 0);
+  run(50);
+  i = Calls;
+  Clock += 95;
+  run(50);
+  check(Calls - i <= 6 && Calls - i >= 5, "skip", (int)(Calls - i));
+  Shell_StopJob(0);
+}
+
+int main(void){
+  transcript();
+  lookup();
+  numbers();
+  jobs(1000);
+  jobs(0xFFFFFFFFu - 400);              // the ms clock wraps during the jobs
+  printf("%s, %d errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
@@ -0,0 +1,283 @@
+// telemetrysim.c
+// Host throughput test of inc/Telemetry.c and AP_NotifyData over a model SNP
+//
+//   gcc -O2 -Ihost -I../inc -o telemetrysim telemetrysim.c ../inc/Telemetry.c ../inc/AP.c host/msp.c
+//   ./telemetrysim             offered loads from 0.5 to 4 kB/s, 8-byte records, 20 s each
+//
+// NPI.c is replaced by a model of the link and the SNP on a simulated
+// clock.  Frames take 87 us per byte on the UART.  The SNP answers each
+// notification 2 ms after it arrives, keeps up to 6 of them, and sends
+// up to 4 to the phone per 30 ms connection interval, at most 2.1 kB/s
+// of 8-byte records.  A notification that finds the SNP full is
+// answered with an error.  The main loop runs every 50 us of simulated
+// time and puts records at the offered rate.  The phone keeps the first
+// copy of each record, and every record that Telemetry_Put accepted
+// must reach it.
+//
+// For each load it prints the bytes per second of records the phone
+// got, the records dropped because the queue was full, the records
+// resent after an error answer, the error answers, the largest queue,
+// and the records that reached the phone after a later one.  It fails
+// if a record is lost, if a record arrives after a later one, or if an
+// offered load above what the SNP can carry (SATURATION) gets less
+// than 95% of it through; resending must not eat the link.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "msp.h"
+#include "AP.h"
+#include "NPI.h"
+#include "Telemetry.h"
+
+#define BYTE_NS     87000       // UART1 at 115,200 baud
+#define ANSWER_NS   2000000     // SNP answers a notification after 2 ms
+#define INTERVAL_NS 30000000    // connection interval
+#define PER_INTERVAL 4          // notifications per connection interval
+#define SNP_QUEUE   6           // notifications the SNP keeps
+#define LOOP_NS     50000       // main loop period
+#define RECORD      8           // bytes per record
+#define SECONDS     20
+#define PER_NOTIFY  ((AP_STREAMMAX-1)/RECORD*RECORD)   // record bytes per notification
+#define SATURATION  ((uint32_t)((uint64_t)PER_INTERVAL*PER_NOTIFY*1000000000/INTERVAL_NS)) // B/s
+
+extern uint32_t NotifyRejects;
+
+static uint64_t Now;            // simulated time, ns
+static int Bad;
+
+// frames from the LP, each done at its time
+static uint8_t TxQ[NPI_TXFRAMES][NPI_FRAMESIZE];
+static uint64_t TxDoneAt[NPI_TXFRAMES];
+static uint32_t TxPut, TxGet;
+
+// frames to the LP, each ready at its time
+#define RXQ 64
+static uint8_t RxQ[RXQ][NPI_FRAMESIZE];
+static uint64_t RxAt[RXQ];
+static uint32_t RxPut, RxGet, RxOverrun;
+
+// SNP notification queue, the payloads
+static uint8_t SnpQ[SNP_QUEUE][AP_STREAMMAX];
+static uint32_t SnpLen[SNP_QUEUE], SnpPut, SnpGet;
+static uint64_t NextInterval;
+
+// phone
+#define MAXRECORDS (SECONDS*1000)
+static uint8_t PhoneGot[MAXRECORDS];    // copies of each record count seen
+static uint32_t PhoneNext;      // one past the highest count seen
+static uint32_t PhoneLate, PhoneDups, PhoneRecords;
+
+static void reply(const uint8_t *payload, uint32_t n, uint8_t cmd0, uint8_t cmd1, uint64_t at){
+  uint8_t *f;
+  uint32_t i;
+  uint8_t fcs = 0;
+  if(RxPut-RxGet >= NPI_RXFRAMES){
+    RxOverrun++;                // the LP receive queue is full
+    return;
+  }
+  f = RxQ[RxPut%RXQ];
+  f[0] = 0xFE; f[1] = n; f[2] = 0; f[3] = cmd0; f[4] = cmd1;
+  memcpy(&f[5], payload, n);
+  for(i=1; i<5+n; i++){
+    fcs = fcs^f[i];
+  }
+  f[5+n] = fcs;
+  RxAt[RxPut%RXQ] = at;
+  RxPut++;
+}
+
+// the SNP takes a frame from the LP
+static void snp(const uint8_t *f){
+  static const uint8_t charValue[] = {0x00, 0x1E, 0x00};          // status, handle 0x001E
+  static const uint8_t descriptor[] = {0x00, 0x84, 0x1F, 0x00};   // status, header, CCCD 0x001F
+  uint8_t status[1] = {0};
+  uint32_t n = f[1]+(f[2]<<8);
+  if((f[3] == 0x55) && (f[4] == 0x89)){    // notification, data from byte 11
+    if(SnpPut-SnpGet < SNP_QUEUE){
+      SnpLen[SnpPut%SNP_QUEUE] = n-6;
+      memcpy(SnpQ[SnpPut%SNP_QUEUE], &f[11], n-6);
+      SnpPut++;
+    }else{
+      status[0] = 0x01;         // full
+    }
+    reply(status, 1, 0x55, 0x89, Now+ANSWER_NS);
+  }else if((f[3] == 0x35) && (f[4] == 0x82)){
+    reply(charValue, sizeof(charValue), 0x75, 0x82, Now+ANSWER_NS);
+  }else if((f[3] == 0x35) && (f[4] == 0x83)){
+    reply(descriptor, sizeof(descriptor), 0x75, 0x83, Now+ANSWER_NS);
+  }else{
+    reply(status, 1, f[3]+0x40, f[4], Now+ANSWER_NS);
+  }
+}
+
+// the phone gets a notification, [seq][records]
+// A record sent again after an error answer may come after later ones,
+// the phone puts it back in order by its count.
+static void phone(const uint8_t *p, uint32_t n){
+  uint32_t i, count;
+  for(i=1; i+RECORD<=n; i+=RECORD){
+    memcpy(&count, &p[i], 4);
+    if(count >= MAXRECORDS){
+      continue;
+    }
+    if(PhoneGot[count]){
+      PhoneDups++;              // resent, the first copy was kept
+    }else{
+      PhoneRecords++;
+      if(count+1 < PhoneNext){
+        PhoneLate++;            // after a later record
+      }
+    }
+    if(count >= PhoneNext){
+      PhoneNext = count+1;
+    }
+    PhoneGot[count]++;
+  }
+}
+
+// run the link and the SNP up to Now
+static void run(void){
+  uint32_t k;
+  while((TxGet != TxPut) && (TxDoneAt[TxGet%NPI_TXFRAMES] <= Now)){
+    snp(TxQ[TxGet%NPI_TXFRAMES]);
+    TxGet++;
+  }
+  while(NextInterval <= Now){
+    for(k=0; (k < PER_INTERVAL) && (SnpGet != SnpPut); k++){
+      phone(SnpQ[SnpGet%SNP_QUEUE], SnpLen[SnpGet%SNP_QUEUE]);
+      SnpGet++;
+    }
+    NextInterval += INTERVAL_NS;
+  }
+}
+
+// ---- NPI.c and the drivers AP.c uses ----
+void NPI_Init(void){
+}
+int NPI_Send(const uint8_t *msg){
+  uint32_t size = msg[1]+(msg[2]<<8)+6, last;
+  uint64_t start = Now;
+  run();
+  if(TxPut-TxGet >= NPI_TXFRAMES){
+    return 1;
+  }
+  if(TxPut != TxGet){
+    last = (TxPut-1)%NPI_TXFRAMES;
+    if(TxDoneAt[last] > start){
+      start = TxDoneAt[last];   // after the frame ahead of it
+    }
+  }
+  memcpy(TxQ[TxPut%NPI_TXFRAMES], msg, size);
+  TxDoneAt[TxPut%NPI_TXFRAMES] = start+(uint64_t)size*BYTE_NS;
+  TxPut++;
+  return 0;
+}
+uint32_t NPI_Receive(uint8_t *buf, uint32_t max){
+  uint32_t size;
+  Now += 250;                   // AP.c polls in 0.25 us loops
+  run();
+  if((RxGet == RxPut) || (RxAt[RxGet%RXQ] > Now)){
+    return 0;
+  }
+  size = RxQ[RxGet%RXQ][1]+6;
+  memcpy(buf, RxQ[RxGet%RXQ], (size < max) ? size : max);
+  RxGet++;
+  return size;
+}
+uint32_t NPI_Available(void){
+  run();
+  return (RxGet != RxPut) && (RxAt[RxGet%RXQ] <= Now);
+}
+int NPI_TxIdle(void){
+  Now += 250;
+  run();
+  return TxGet == TxPut;
+}
+void NPI_Abort(void){
+  if(TxGet != TxPut){
+    TxGet++;
+  }
+}
+void NPI_GetStats(NPIStats_t *stats){
+  memset(stats, 0, sizeof(*stats));
+}
+void GPIO_Init(void){
+}
+void UART1_Init(void){
+}
+void Clock_Delay1ms(uint32_t n){
+  Now += (uint64_t)n*1000000;
+  run();
+}
+
+static void nothing(void){
+}
+
+// one load in records per second
+static void load(uint32_t rate){
+  static int added = 0;
+  uint8_t record[RECORD] = {0}, cccd[7] = {0x00, 0x00, 0x1F, 0x00, 0x00, 0x01, 0x00};
+  uint32_t count = 0, rejects = NotifyRejects, got, slow;
+  uint64_t end, owed = 0;
+  TelemetryStats_t s;
+  if(!added){
+    if(AP_AddStreamCharacteristic(0xFFF1, "Telemetry", &nothing) != APOK){
+      printf("add characteristic failed\n");
+      return;
+    }
+    reply(cccd, sizeof(cccd), 0x55, 0x8B, Now);  // phone turns notifications on
+    while(NPI_Available() == 0){
+      Now += LOOP_NS;
+    }
+    AP_BackgroundProcess();
+    added = 1;
+  }
+  Telemetry_Init(0, RECORD);
+  PhoneNext = PhoneLate = PhoneDups = PhoneRecords = 0;
+  memset(PhoneGot, 0, sizeof(PhoneGot));
+  end = Now+(uint64_t)SECONDS*1000000000;
+  while(Now < end){
+    owed += (uint64_t)rate*LOOP_NS;
+    while(owed >= 1000000000){
+      owed -= 1000000000;
+      memcpy(record, &count, 4);
+      if(Telemetry_Put(record) == 0){
+        count++;                // the phone must see every count
+      }
+    }
+    AP_BackgroundProcess();
+    Telemetry_Run();
+    Now += LOOP_NS;
+    run();
+  }
+  while((Telemetry_Queued() || (SnpGet != SnpPut)) && (Now < end+(uint64_t)SECONDS*1000000000)){
+    AP_BackgroundProcess();     // drain
+    Telemetry_Flush();
+    Now += LOOP_NS;
+    run();
+  }
+  Telemetry_GetStats(&s);
+  got = (PhoneRecords*RECORD)/SECONDS;
+  slow = (rate*RECORD > SATURATION) && (got < SATURATION*95/100);
+  printf("%6u %8u %8u %8u %8u %8u %8u %6s\n", rate*RECORD,
+         got, s.Dropped, s.Resent, NotifyRejects-rejects, s.MaxQueued, PhoneLate,
+         (PhoneRecords != count) ? "LOST" : PhoneLate ? "LATE" : slow ? "SLOW" : "ok");
+  if((PhoneRecords != count) || PhoneLate || slow){
+    Bad = 1;
+  }
+}
+
+int main(void){
+  static const uint32_t Rates[] = {64, 128, 187, 250, 375, 500};
+  uint32_t i;
+  printf("SNP carries at most %u B/s of records\n", SATURATION);
+  printf("%6s %8s %8s %8s %8s %8s %8s\n", "B/s", "got B/s", "dropped",
+         "resent", "rejects", "maxq B", "late");
+  for(i=0; i<sizeof(Rates)/sizeof(Rates[0]); i++){
+    load(Rates[i]);
+  }
+  printf("LP receive overruns %u\n", RxOverrun);
+  printf("%s\n", (Bad || RxOverrun) ? "FAIL" : "PASS");
+  return Bad || RxOverrun;
+}
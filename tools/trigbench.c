@@ -0,0 +1,152 @@
+// trigbench.c
+// Host accuracy and speed of inc/Trig.c against Lab1's fsin and libm
+//
+//   gcc -O2 -I../inc -o trigbench trigbench.c ../inc/Trig.c -lm
+//   ./trigbench
+//
+// The errors are against libm in double precision:
+//   Trig_Sin/Trig_Cos  every one of the 65536 angles, in Q15 LSB
+//   fsin               every whole degree, in units of 1/1000, with
+//                      Trig_Sin scaled to the same 1000*sin(x) for
+//                      comparison (the conversion shown in Trig.h)
+//   Trig_Atan2         3M vectors over the whole int32 range, including
+//                      the corners and short vectors, in binary units
+//   Trig_Hypot         the same vectors, relative error above 65536
+//                      and absolute below
+//   Trig_SinCos31      2M angles, in Q31 LSB
+// The program fails if an error is above the limit printed next to it.
+//
+// The times are ns per call on this host, with its hardware FPU doing
+// the libm calls; on the MSP432 the float calls would use the
+// single-precision FPU and the double ones are emulated in software.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Trig.h"
+
+// fsin, 1000*sin(x deg), from Lab 1 as it is, without its test main
+#define main SineFunction_main
+#include "../Lab1ref_SineFunction/SineFunction.c"
+#undef main
+
+static volatile int32_t Sink;
+static int Bad;
+
+static void report(const char *what, double error, double limit, const char *unit){
+  printf("%-28s %10.3g %-10s (limit %g)\n", what, error, unit, limit);
+  if(error > limit){
+    Bad++;
+  }
+}
+
+static double now(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec*1e9 + t.tv_nsec;
+}
+
+static void accuracy(void){
+  double e, sinErr = 0, fsinErr = 0, trigErr = 0, atanErr = 0, hypotRel = 0;
+  double hypotAbs = 0, sin31Err = 0, angle, h;
+  int32_t d, v, x, y, s, c;
+  uint32_t a, i;
+  for(a=0; a<65536; a++){
+    e = fabs(Trig_Sin(a) - TRIG_ONE*sin(a*2*M_PI/65536));
+    sinErr = (e > sinErr) ? e : sinErr;
+    e = fabs(Trig_Cos(a) - TRIG_ONE*cos(a*2*M_PI/65536));
+    sinErr = (e > sinErr) ? e : sinErr;
+  }
+  for(d=-180; d<180; d++){
+    e = fabs(fsin(d) - 1000*sin(d*M_PI/180));
+    fsinErr = (e > fsinErr) ? e : fsinErr;
+    v = (1000*Trig_Sin(Trig_FromDeg(d)) + 16384)>>15;
+    e = fabs(v - 1000*sin(d*M_PI/180));
+    trigErr = (e > trigErr) ? e : trigErr;
+    if(Trig_ToDeg(Trig_FromDeg(d)) != d){
+      printf("degrees %d\n", (int)d);
+      Bad++;
+    }
+  }
+  srand(2);
+  for(i=0; i<3000000; i++){
+    x = (int32_t)(((uint32_t)rand()<<1)^(uint32_t)rand()^((uint32_t)rand()<<17));
+    y = (int32_t)(((uint32_t)rand()<<1)^(uint32_t)rand()^((uint32_t)rand()<<17));
+    if(i%3 == 1){             // short vectors too
+      x >>= rand()%31;
+      y >>= rand()%31;
+    }
+    if(i == 0){ x = INT32_MIN; y = INT32_MIN; }
+    if(i == 1){ x = -5; y = 0; }
+    if(i == 2){ x = 0; y = 7; }
+    if(i == 3){ x = INT32_MAX; y = INT32_MIN; }
+    if((x == 0) && (y == 0)){
+      continue;
+    }
+    angle = atan2(y, x)*65536/(2*M_PI);
+    e = fabs(remainder((Angle_t)Trig_Atan2(y, x) - angle, 65536.0));
+    atanErr = (e > atanErr) ? e : atanErr;
+    h = hypot(x, y);
+    e = fabs(Trig_Hypot(x, y) - h);
+    if(h >= 65536){
+      hypotRel = (e/h > hypotRel) ? e/h : hypotRel;
+    }else{
+      hypotAbs = (e > hypotAbs) ? e : hypotAbs;
+    }
+  }
+  for(i=0; i<2000000; i++){
+    a = ((uint32_t)rand()<<16)^(uint32_t)rand()^((uint32_t)rand()<<31);
+    if(i < 4){
+      a = i<<30;              // the axes
+    }
+    Trig_SinCos31(a, &s, &c);
+    angle = (double)a*2*M_PI/4294967296.0;
+    e = fabs(s - 2147483647.0*sin(angle));
+    sin31Err = (e > sin31Err) ? e : sin31Err;
+    e = fabs(c - 2147483647.0*cos(angle));
+    sin31Err = (e > sin31Err) ? e : sin31Err;
+  }
+  report("Trig_Sin/Trig_Cos", sinErr, 1.5, "Q15 LSB");
+  report("fsin", fsinErr, 4, "1/1000");
+  report("Trig_Sin as 1000*sin", trigErr, 1, "1/1000");
+  report("Trig_Atan2", atanErr, 1, "1/65536");
+  report("Trig_Hypot above 65536", hypotRel, 2e-5, "relative");
+  report("Trig_Hypot below 65536", hypotAbs, 1, "absolute");
+  report("Trig_SinCos31", sin31Err, 64, "Q31 LSB");
+}
+
+#define N 10000000
+static void speed(void){
+  double t[9];
+  int32_t i;
+  t[0] = now();
+  for(i=0; i<N; i++) Sink += fsin((i%360) - 180);
+  t[1] = now();
+  for(i=0; i<N; i++) Sink += Trig_Sin(i*7);
+  t[2] = now();
+  for(i=0; i<N; i++) Sink += (int32_t)(32767*sinf(i*0.0001f));
+  t[3] = now();
+  for(i=0; i<N; i++) Sink += (int32_t)(32767*sin(i*0.0001));
+  t[4] = now();
+  for(i=0; i<N; i++) Sink += Trig_Atan2(i - N/2, i*3 + 1);
+  t[5] = now();
+  for(i=0; i<N; i++) Sink += (int32_t)(atan2(i - N/2, i*3 + 1)*10430.378);
+  t[6] = now();
+  for(i=0; i<N; i++) Sink += Trig_Hypot(i - N/2, i*3 + 1);
+  t[7] = now();
+  for(i=0; i<N; i++) Sink += (int32_t)hypot(i - N/2, i*3 + 1);
+  t[8] = now();
+  printf("ns per call: fsin %.1f, Trig_Sin %.1f, sinf %.1f, sin %.1f\n",
+         (t[1]-t[0])/N, (t[2]-t[1])/N, (t[3]-t[2])/N, (t[4]-t[3])/N);
+  printf("             Trig_Atan2 %.1f, atan2 %.1f, Trig_Hypot %.1f, hypot %.1f\n",
+         (t[5]-t[4])/N, (t[6]-t[5])/N, (t[7]-t[6])/N, (t[8]-t[7])/N);
+}
+
+int main(void){
+  accuracy();
+  speed();
+  printf("%s, %d errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}
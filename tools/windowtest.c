@@ -0,0 +1,208 @@
+// windowtest.c
+// Host test of the ADC14 window comparator driver and the IR threshold mapping
+//
+//   gcc -O2 -Ihost -I../inc -o windowtest windowtest.c ../inc/ADC14.c host/msp.c
+//   ./windowtest
+//
+// The mapping: for every sensor, every distance from -10 to 6000 mm and
+// every ADC result, Convert(n) < mm must hold exactly when
+// n >= ToADC(mm), with the default and the calibrated parameters.
+// IRDistance.c is included to see its parameters: where the model
+// A/(n+B)+C goes below 0 (the calibrated C is negative) Convert clamps
+// to 5000 mm, but the result is closer than any threshold, and that is
+// what the comparator must report.
+//
+// The comparator: convert() stands in for one conversion into
+// ADC14MEMx with the TRM semantics.  When ADC14ENC is set and the MCTL
+// has ADC14WINC, HIIFG is set for a result above ADC14HI0, LOIFG below
+// ADC14LO0 and INIFG in between, on every conversion whether enabled or
+// not.  If an enabled flag is set and interrupt 24 is enabled in the
+// NVIC, ADC14_IRQHandler runs before the next conversion, and writes to
+// ADC14CLRIFGR1 clear the flags.  The driver is set up the way the
+// Lab 5 guard command does it, then a noisy (+/-30 count) approach from
+// 400 to 100 mm and back is converted.  The task must run exactly twice,
+// on the conversion that crosses each threshold and on the right side
+// of it; the same run without hysteresis shows the chatter it prevents.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "msp.h"
+#include "ADC14.h"
+#include "../inc/IRDistance.c"
+
+#define GUARD_MM         150
+#define GUARD_HYSTERESIS 30   // mm, as in Lab5_UARTmain.c
+
+static long Bad;
+
+static void check(int ok, const char *what, long n){
+  if(!ok){
+    Bad++;
+    if(Bad < 20){
+      printf("%s %ld\n", what, n);
+    }
+  }
+}
+
+// ---- CortexM.c ----
+long StartCritical(void){
+  return 0;
+}
+void EndCritical(long sr){
+  (void)sr;
+}
+
+void ADC14_IRQHandler(void);
+
+// ---- the comparator ----
+static void settle(void){     // ADC14CLRIFGR1 is write 1 to clear
+  ADC14->IFGR1 &= ~ADC14->CLRIFGR1;
+  ADC14->CLRIFGR1 = 0;
+}
+
+static uint32_t Isrs;
+static void convert(uint32_t mem, uint32_t result){
+  ADC14->MEM[mem] = result;
+  if((ADC14->CTL0&ADC14_CTL0_ENC) && (ADC14->MCTL[mem]&ADC14_MCTLN_WINC)){
+    if(result > ADC14->HI0){
+      ADC14->IFGR1 |= ADC14_IFGR1_HIIFG;
+    }else if(result < ADC14->LO0){
+      ADC14->IFGR1 |= ADC14_IFGR1_LOIFG;
+    }else{
+      ADC14->IFGR1 |= ADC14_IFGR1_INIFG;
+    }
+  }
+  if((ADC14->IFGR1&ADC14->IER1) && (NVIC->ISER[0]&0x01000000)){
+    ADC14_IRQHandler();
+    settle();
+    Isrs++;
+  }
+}
+
+// ---- threshold mapping ----
+static void mapping(const char *name, int32_t (*conv)(int32_t), int32_t (*toAdc)(int32_t),
+                    const int32_t *a, const int32_t *b, const int32_t *c){
+  int32_t mm, n, t, d;
+  long wrong = 0;
+  for(mm=-10; mm<=6000; mm++){
+    t = toAdc(mm);
+    for(n=0; n<16384; n++){
+      d = conv(n);
+      if((n + *b > 0) && (*a/(n + *b) + *c < 0)){
+        d = *a/(n + *b) + *c;   // closer than the model reaches
+      }
+      if((d < mm) != (n >= t)){
+        if(wrong++ < 3){
+          printf("%s %d mm, n %d, convert %d, threshold %d\n", name, (int)mm, (int)n, (int)conv(n), (int)t);
+        }
+      }
+    }
+  }
+  check(wrong == 0, name, wrong);
+}
+
+// ---- the driver ----
+static uint32_t Calls, Near;
+static long WrongSide;
+static uint32_t Result;
+static void task(uint32_t near){
+  int32_t d = CenterConvert(Result);
+  Calls++;
+  Near = near;
+  if(near ? (d >= GUARD_MM) : (d < GUARD_MM + GUARD_HYSTERESIS)){
+    WrongSide++;
+  }
+}
+
+// arm like "guard 150mm" in Lab 5
+static void guard(uint32_t hysteresis){
+  int32_t hi = CenterToADC(GUARD_MM);
+  if(hi){
+    hi--;                     // n >= hi is closer than mm, the comparator is n > HI
+  }
+  ADC_WindowInit(1, hysteresis ? CenterToADC(GUARD_MM + GUARD_HYSTERESIS) : hi + 1, hi, &task);
+  settle();
+}
+
+// 400 mm to 100 mm and back, +/-30 counts of noise, returns the calls
+static uint32_t approach(int hysteresis){
+  uint32_t i, firstNear = 0, firstAbove = 0, hi = ADC14->HI0;
+  int32_t n, mm;
+  Calls = Near = 0;
+  WrongSide = 0;
+  srand(1);
+  for(i=0; i<40000; i++){
+    mm = (i < 20000) ? 400 - (int32_t)i*300/20000 : 100 + ((int32_t)i - 20000)*300/20000;
+    n = CenterToADC(mm + 1) + rand()%61 - 30;
+    n = (n < 0) ? 0 : (n > 16383) ? 16383 : n;
+    Result = n;
+    if((n > (int32_t)hi) && !firstAbove){
+      firstAbove = i;
+    }
+    convert(0, 5000);         // left and right are far
+    convert(1, n);
+    convert(2, 5000);
+    if(Near && !firstNear){
+      firstNear = i;
+      check((i == firstAbove) && (CenterConvert(n) < GUARD_MM), "late near", i);
+    }
+    check(ADC_WindowNear() == Near, "state", i);
+  }
+  if(hysteresis){
+    check(WrongSide == 0, "wrong side", WrongSide);
+  }
+  return Calls;
+}
+
+int main(void){
+  uint32_t calls, mctl;
+  mapping("left default", &LeftConvert, &LeftToADC, &Left_A, &Left_B, &Left_C);
+  mapping("center default", &CenterConvert, &CenterToADC, &Center_A, &Center_B, &Center_C);
+  mapping("right default", &RightConvert, &RightToADC, &Right_A, &Right_B, &Right_C);
+  CalibrateIRSensors();
+  printf("calibrated center A %d, B %d, C %d\n", (int)Center_A, (int)Center_B, (int)Center_C);
+  mapping("left calibrated", &LeftConvert, &LeftToADC, &Left_A, &Left_B, &Left_C);
+  mapping("center calibrated", &CenterConvert, &CenterToADC, &Center_A, &Center_B, &Center_C);
+  mapping("right calibrated", &RightConvert, &RightToADC, &Right_A, &Right_B, &Right_C);
+
+  ADC0_InitSWTriggerCh17_12_16();
+  mctl = ADC14->MCTL[1];
+  guard(1);
+  check((ADC14->MCTL[1]&~ADC14_MCTLN_WINC) == (mctl&~ADC14_MCTLN_WINCTH), "MCTL", ADC14->MCTL[1]);
+  check((ADC14->MCTL[0]&ADC14_MCTLN_WINC) == 0, "MEM0 compared", 0);
+  check((ADC14->CTL0&ADC14_CTL0_ENC) != 0, "ENC", ADC14->CTL0);
+  check(ADC14->IER1 == ADC14_IER1_HIIE && ADC14->IFGR1 == 0, "armed", ADC14->IER1);
+  check((NVIC->IP[6]&0xFF) == 0x20 && (NVIC->ISER[0]&0x01000000), "NVIC", NVIC->IP[6]);
+  printf("guard %d mm: HI0 %u, LO0 %u (%d mm)\n", GUARD_MM, (unsigned)ADC14->HI0,
+         (unsigned)ADC14->LO0, GUARD_MM + GUARD_HYSTERESIS);
+  Isrs = 0;
+  calls = approach(1);
+  printf("with hysteresis:    %u calls, %u interrupts in 120000 conversions\n", (unsigned)calls, (unsigned)Isrs);
+  check(calls == 2, "calls", calls);
+
+  // the thresholds move, the state stays
+  convert(1, 16000);
+  check(ADC_WindowNear() == 1, "near", 0);
+  ADC_WindowSet(CenterToADC(300), CenterToADC(250) - 1);
+  check(ADC_WindowNear() == 1 && ADC14->IER1 == ADC14_IER1_LOIE, "set keeps", ADC14->IER1);
+  convert(1, CenterToADC(290));
+  check(Near == 1, "between", 0);
+  convert(1, CenterToADC(301));
+  check(Near == 0, "released", 0);
+
+  // stopped, nothing runs
+  ADC_WindowStop();
+  calls = Calls;
+  convert(1, 16000);
+  convert(1, 0);
+  check(Calls == calls && ADC_WindowNear() == 0, "stopped", Calls - calls);
+  ADC14->IFGR1 = 0;
+
+  guard(0);
+  calls = approach(0);
+  printf("without hysteresis: %u calls\n", (unsigned)calls);
+  check(calls > 2, "chatter", calls);
+  printf("%s, %ld errors\n", Bad ? "FAIL" : "PASS", Bad);
+  return Bad != 0;
+}